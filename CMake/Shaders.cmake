@@ -0,0 +1,58 @@
+if (NOT RETINA_ENABLE_RUNTIME_SHADER_COMPILER)
+  find_program(RETINA_GLSLC_EXECUTABLE glslc HINTS $ENV{VULKAN_SDK}/bin REQUIRED)
+endif ()
+
+set(RETINA_SHADER_STAGES vert tesc tese geom frag comp mesh task rgen rint rahit rchit rmiss rcall)
+
+set(RETINA_SHADER_COMPILE_OPTIONS
+  --target-env=vulkan1.3
+  --target-spv=spv1.6
+  -std=460core
+  -fpreserve-bindings
+  # Resolved per configuration at build time, multi-config generators never see "CMAKE_BUILD_TYPE"
+  $<$<CONFIG:Debug>:-g>
+  $<IF:$<CONFIG:Debug>,-O0,-O>
+)
+
+# Compiles every "<Name>.<stage>.glsl" under "directory" to "RETINA_COMPILED_SHADER_DIRECTORY", mirroring
+# its path relative to the source tree. Files without a stage extension are includes and only tracked as dependencies
+function(retina_compile_shaders target directory)
+  if (RETINA_ENABLE_RUNTIME_SHADER_COMPILER)
+    return()
+  endif ()
+
+  file(GLOB_RECURSE shader_sources CONFIGURE_DEPENDS ${directory}/*.glsl)
+  set(shader_outputs)
+  foreach (shader_source ${shader_sources})
+    get_filename_component(shader_name ${shader_source} NAME_WLE)
+    get_filename_component(shader_stage ${shader_name} LAST_EXT)
+    string(REPLACE "." "" shader_stage "${shader_stage}")
+    if (NOT shader_stage IN_LIST RETINA_SHADER_STAGES)
+      continue()
+    endif ()
+
+    file(RELATIVE_PATH shader_relative_path ${CMAKE_SOURCE_DIR} ${shader_source})
+    set(shader_output ${RETINA_COMPILED_SHADER_DIRECTORY}/${shader_relative_path}.spv)
+    get_filename_component(shader_output_directory ${shader_output} DIRECTORY)
+    add_custom_command(
+      OUTPUT ${shader_output}
+      COMMAND ${CMAKE_COMMAND} -E make_directory ${shader_output_directory}
+      COMMAND ${RETINA_GLSLC_EXECUTABLE}
+        ${RETINA_SHADER_COMPILE_OPTIONS}
+        -fshader-stage=${shader_stage}
+        -I ${RETINA_MAIN_SHADER_DIRECTORY}
+        -I ${directory}
+        -MD -MF ${shader_output}.d
+        -o ${shader_output}
+        ${shader_source}
+      MAIN_DEPENDENCY ${shader_source}
+      DEPFILE ${shader_output}.d
+      COMMENT "Compiling shader ${shader_relative_path}"
+      VERBATIM
+    )
+    list(APPEND shader_outputs ${shader_output})
+  endforeach ()
+
+  add_custom_target(${target}.Shaders DEPENDS ${shader_outputs})
+  add_dependencies(${target} ${target}.Shaders)
+endfunction()
@@ -2,6 +2,7 @@
 
 #include <Retina/Core/Event/EventDispatcher.hpp>
 #include <Retina/Core/STL/ArcPtr.hpp>
+#include <Retina/Core/STL/ChunkedArray.hpp>
 #include <Retina/Core/STL/Defer.hpp>
 #include <Retina/Core/STL/EnableIntrusiveReferenceCount.hpp>
 #include <Retina/Core/STL/FixedSlotVector.hpp>
@@ -18,6 +19,7 @@
 #include <Retina/Core/Traits.hpp>
 #include <Retina/Core/Types.hpp>
 #include <Retina/Core/Utility.hpp>
+#include <Retina/Core/WorkerPool.hpp>
 
 namespace Retina {
   using namespace Core::Literals;
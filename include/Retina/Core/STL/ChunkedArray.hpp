@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Retina/Core/STL/UniquePtr.hpp>
+#include <Retina/Core/Macros.hpp>
+#include <Retina/Core/Types.hpp>
+
+#include <array>
+
+namespace Retina::Core {
+  // Fixed capacity array whose elements are allocated "C" at a time, the first time an index in a chunk is written.
+  // Reading an index from a chunk that was never written yields a default constructed element
+  template <typename T, usize N, usize C = 1024>
+    requires (N % C == 0)
+  class CChunkedArray {
+  public:
+    using ChunkType = std::array<T, C>;
+
+    constexpr CChunkedArray() noexcept = default;
+    constexpr ~CChunkedArray() noexcept = default;
+    RETINA_DELETE_COPY(CChunkedArray, constexpr);
+    RETINA_DEFAULT_MOVE(CChunkedArray, constexpr);
+
+    RETINA_NODISCARD RETINA_INLINE constexpr auto operator [](usize index) noexcept -> T&;
+    RETINA_NODISCARD RETINA_INLINE constexpr auto operator [](usize index) const noexcept -> const T&;
+
+    RETINA_NODISCARD RETINA_INLINE constexpr auto GetChunkCount() const noexcept -> usize;
+    RETINA_NODISCARD RETINA_INLINE constexpr static auto GetCapacity() noexcept -> usize;
+
+  private:
+    std::array<CUniquePtr<ChunkType>, N / C> _chunks = {};
+  };
+
+  template <typename T, usize N, usize C>
+    requires (N % C == 0)
+  constexpr auto CChunkedArray<T, N, C>::operator [](usize index) noexcept -> T& {
+    auto& chunk = _chunks[index / C];
+    if (!chunk) {
+      chunk = MakeUnique<ChunkType>();
+    }
+    return (*chunk)[index % C];
+  }
+
+  template <typename T, usize N, usize C>
+    requires (N % C == 0)
+  constexpr auto CChunkedArray<T, N, C>::operator [](usize index) const noexcept -> const T& {
+    static const auto empty = T();
+    const auto& chunk = _chunks[index / C];
+    if (!chunk) {
+      return empty;
+    }
+    return (*chunk)[index % C];
+  }
+
+  template <typename T, usize N, usize C>
+    requires (N % C == 0)
+  constexpr auto CChunkedArray<T, N, C>::GetChunkCount() const noexcept -> usize {
+    auto count = 0_usize;
+    for (const auto& chunk : _chunks) {
+      count += static_cast<bool>(chunk);
+    }
+    return count;
+  }
+
+  template <typename T, usize N, usize C>
+    requires (N % C == 0)
+  constexpr auto CChunkedArray<T, N, C>::GetCapacity() noexcept -> usize {
+    return N;
+  }
+}
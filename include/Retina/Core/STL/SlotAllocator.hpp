@@ -7,30 +7,61 @@
 #include <bit>
 
 namespace Retina::Core {
+  // Three level bitmap, a set bit in "_summary" marks a full word in "_slots" and a set bit in "_root"
+  // marks a full word in "_summary". Allocating only scans "_root" and always returns the lowest free slot
   template <usize N>
     requires (N % 64 == 0)
   class CSlotAllocator {
   public:
-    constexpr CSlotAllocator() noexcept = default;
+    RETINA_INLINE constexpr CSlotAllocator() noexcept;
     constexpr ~CSlotAllocator() noexcept = default;
     RETINA_DEFAULT_COPY_MOVE(CSlotAllocator, constexpr);
 
     RETINA_NODISCARD RETINA_INLINE constexpr auto Allocate() noexcept -> uint64;
-    RETINA_NODISCARD RETINA_INLINE constexpr auto Free(uint64 slot) noexcept -> void;
+    RETINA_INLINE constexpr auto Free(uint64 slot) noexcept -> void;
+
+    RETINA_NODISCARD RETINA_INLINE constexpr auto IsAllocated(uint64 slot) const noexcept -> bool;
 
   private:
-    std::array<uint64, N / 64> _slots = {};
+    constexpr static auto SLOT_WORD_COUNT = N / 64;
+    constexpr static auto SUMMARY_WORD_COUNT = (SLOT_WORD_COUNT + 63) / 64;
+    constexpr static auto ROOT_WORD_COUNT = (SUMMARY_WORD_COUNT + 63) / 64;
+
+    std::array<uint64, SLOT_WORD_COUNT> _slots = {};
+    std::array<uint64, SUMMARY_WORD_COUNT> _summary = {};
+    std::array<uint64, ROOT_WORD_COUNT> _root = {};
   };
 
+  template <usize N>
+    requires (N % 64 == 0)
+  constexpr CSlotAllocator<N>::CSlotAllocator() noexcept {
+    // Bits past the end of a level stand for words that do not exist, they are marked full so they are never descended into
+    for (auto i = SLOT_WORD_COUNT; i < SUMMARY_WORD_COUNT * 64; ++i) {
+      _summary[i / 64] |= 1_u64 << (i % 64);
+    }
+    for (auto i = SUMMARY_WORD_COUNT; i < ROOT_WORD_COUNT * 64; ++i) {
+      _root[i / 64] |= 1_u64 << (i % 64);
+    }
+  }
+
   template <usize N>
     requires (N % 64 == 0)
   constexpr auto CSlotAllocator<N>::Allocate() noexcept -> uint64 {
-    for (usize i = 0; i < _slots.size(); ++i) {
-      if (_slots[i] != -1_u64) {
-        const auto bit = std::countr_one(_slots[i]);
-        _slots[i] |= 1_u64 << bit;
-        return i * 64 + bit;
+    for (usize i = 0; i < _root.size(); ++i) {
+      if (_root[i] == -1_u64) {
+        continue;
+      }
+      const auto summary = i * 64 + std::countr_one(_root[i]);
+      const auto word = summary * 64 + std::countr_one(_summary[summary]);
+      const auto bit = std::countr_one(_slots[word]);
+      _slots[word] |= 1_u64 << bit;
+      if (_slots[word] == -1_u64) {
+        _summary[summary] |= 1_u64 << (word % 64);
+        if (_summary[summary] == -1_u64) {
+          _root[i] |= 1_u64 << (summary % 64);
+        }
       }
+      return word * 64 + bit;
     }
     return -1_u64;
   }
@@ -38,8 +69,16 @@ namespace Retina::Core {
   template <usize N>
     requires (N % 64 == 0)
   constexpr auto CSlotAllocator<N>::Free(uint64 slot) noexcept -> void {
-    const auto index = slot / 64;
-    const auto bit = slot % 64;
-    _slots[index] &= ~(1_u64 << bit);
+    const auto word = slot / 64;
+    const auto summary = word / 64;
+    _slots[word] &= ~(1_u64 << (slot % 64));
+    _summary[summary] &= ~(1_u64 << (word % 64));
+    _root[summary / 64] &= ~(1_u64 << (summary % 64));
+  }
+
+  template <usize N>
+    requires (N % 64 == 0)
+  constexpr auto CSlotAllocator<N>::IsAllocated(uint64 slot) const noexcept -> bool {
+    return _slots[slot / 64] & (1_u64 << (slot % 64));
   }
 }
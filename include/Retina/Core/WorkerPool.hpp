@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Retina/Core/STL/UniquePtr.hpp>
+
+#include <Retina/Core/Macros.hpp>
+#include <Retina/Core/Types.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Retina::Core {
+  // Fixed set of threads started once and fed from a single FIFO queue. Tasks must not wait on other tasks of the same pool
+  class CWorkerPool {
+  public:
+    using TaskFunction = std::move_only_function<void()>;
+
+    CWorkerPool() noexcept = default;
+    ~CWorkerPool() noexcept;
+    RETINA_DELETE_COPY_MOVE(CWorkerPool);
+
+    // A "workerCount" of zero starts one worker per hardware thread
+    RETINA_NODISCARD static auto Make(uint32 workerCount = 0) noexcept -> CUniquePtr<CWorkerPool>;
+
+    RETINA_NODISCARD auto GetWorkerCount() const noexcept -> uint32;
+
+    // Index of the calling thread within the pool that owns it, "-1_u32" on threads that are not workers
+    RETINA_NODISCARD static auto GetWorkerIndex() noexcept -> uint32;
+
+    template <typename F>
+    RETINA_NODISCARD auto Submit(F&& function) noexcept -> std::future<std::invoke_result_t<F>>;
+
+  private:
+    auto Enqueue(TaskFunction task) noexcept -> void;
+    auto Run(uint32 workerIndex) noexcept -> void;
+
+  private:
+    std::deque<TaskFunction> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _isStopping = false;
+
+    std::vector<std::jthread> _workers;
+  };
+
+  template <typename F>
+  auto CWorkerPool::Submit(F&& function) noexcept -> std::future<std::invoke_result_t<F>> {
+    RETINA_PROFILE_SCOPED();
+    auto task = std::packaged_task<std::invoke_result_t<F>()>(std::forward<F>(function));
+    auto future = task.get_future();
+    Enqueue([task = std::move(task)] mutable {
+      task();
+    });
+    return future;
+  }
+}
@@ -24,9 +24,25 @@ namespace Retina::Graphics {
       const SBufferCreateInfo& createInfo
     ) noexcept -> std::vector<Core::CArcPtr<CBuffer>>;
 
+    // Binds the buffer at "offset" inside memory owned by someone else, the memory must outlive the buffer
+    RETINA_NODISCARD static auto MakeAliased(
+      const CDevice& device,
+      const SBufferCreateInfo& createInfo,
+      VmaAllocation allocation,
+      uint64 offset
+    ) noexcept -> Core::CArcPtr<CBuffer>;
+
+    RETINA_NODISCARD static auto QueryMemoryRequirements(
+      const CDevice& device,
+      const SBufferCreateInfo& createInfo
+    ) noexcept -> VkMemoryRequirements;
+
     RETINA_NODISCARD auto GetHandle() const noexcept -> VkBuffer;
     RETINA_NODISCARD auto GetAllocation() const noexcept -> VmaAllocation;
     RETINA_NODISCARD auto GetAllocationInfo() const noexcept -> VmaAllocationInfo;
+    RETINA_NODISCARD auto IsAliased() const noexcept -> bool;
+    RETINA_NODISCARD auto GetAliasOffset() const noexcept -> uint64;
+    RETINA_NODISCARD auto GetMemoryRequirements() const noexcept -> const VkMemoryRequirements&;
 
     RETINA_NODISCARD auto GetSizeBytes() const noexcept -> usize;
     RETINA_NODISCARD auto GetAddress() const noexcept -> usize;
@@ -66,6 +82,8 @@ namespace Retina::Graphics {
     VkBuffer _handle = {};
     VmaAllocation _allocation = {};
     VmaAllocationInfo _allocationInfo = {};
+    bool _isAliased = false;
+    uint64 _aliasOffset = 0;
     VkMemoryRequirements _memoryRequirements = {};
 
     usize _size = 0;
@@ -4,6 +4,7 @@
 
 #include <Retina/Graphics/Enum.hpp>
 #include <Retina/Graphics/Forward.hpp>
+#include <Retina/Graphics/QueueInfo.hpp>
 
 namespace Retina::Graphics {
   enum class EHeapType {
@@ -28,6 +29,13 @@ namespace Retina::Graphics {
     ),
   };
 
+  // Enough for bindless storage access and copies, anything bound as index, vertex or indirect
+  // argument buffer has to ask for it explicitly
+  const inline auto DEFAULT_BUFFER_USAGE_FLAGS =
+    EBufferUsageFlag::E_TRANSFER_SRC |
+    EBufferUsageFlag::E_TRANSFER_DST |
+    EBufferUsageFlag::E_STORAGE_BUFFER;
+
   struct SBufferMemoryRange {
     uint64 Offset = 0;
     uint64 Size = WHOLE_SIZE;
@@ -38,5 +46,10 @@ namespace Retina::Graphics {
     EBufferCreateFlag Flags = {};
     EHeapType Heap = {};
     uint64 Capacity = 0;
+    EBufferUsageFlag Usage = DEFAULT_BUFFER_USAGE_FLAGS;
+    // The buffer is owned exclusively by the queue family of "Domain", cross domain buffers are shared
+    // concurrently by every family instead and need no ownership transfers
+    EQueueDomain Domain = EQueueDomain::E_GRAPHICS;
+    bool IsCrossDomain = false;
   };
 }
@@ -5,6 +5,7 @@
 
 #include <vulkan/vulkan.h>
 
+#include <array>
 #include <vector>
 #include <span>
 
@@ -41,6 +42,9 @@ namespace Retina::Graphics {
     RETINA_NODISCARD auto GetCommandPool() const noexcept -> CCommandPool&;
     RETINA_NODISCARD auto GetQueue() const noexcept -> const CQueue&;
 
+    // Reset on every "Begin"
+    RETINA_NODISCARD auto GetStatistics() const noexcept -> const SCommandBufferStatistics&;
+
     RETINA_NODISCARD auto GetDebugName() const noexcept -> std::string_view;
     auto SetDebugName(std::string_view name) noexcept -> void;
 
@@ -80,17 +84,42 @@ namespace Retina::Graphics {
       uint32 firstInstance = 0
     ) noexcept -> CCommandBuffer&;
 
+    auto DrawIndexedIndirectCount(
+      const CBuffer& buffer,
+      usize offset,
+      const CBuffer& countBuffer,
+      usize countOffset,
+      uint32 maxDrawCount
+    ) noexcept -> CCommandBuffer&;
+
     auto DrawMeshTasks(uint32 x = 1, uint32 y = 1, uint32 z = 1) noexcept -> CCommandBuffer&;
 
     auto Dispatch(uint32 x = 1, uint32 y = 1, uint32 z = 1) noexcept -> CCommandBuffer&;
+    auto DispatchIndirect(const CBuffer& buffer, usize offset = 0) noexcept -> CCommandBuffer&;
 
     auto Barrier(const SMemoryBarrierInfo& barrierInfo) noexcept -> CCommandBuffer&;
     auto MemoryBarrier(const SMemoryBarrier& barrier) noexcept -> CCommandBuffer&;
     auto BufferMemoryBarrier(const SBufferMemoryBarrier& barrier) noexcept -> CCommandBuffer&;
     auto ImageMemoryBarrier(const SImageMemoryBarrier& barrier) noexcept -> CCommandBuffer&;
 
+    // Barriers are held back and recorded as one dependency right before the next draw, dispatch, copy, clear,
+    // "BeginRendering" or "End". Only needed by hand before recording on the raw handle
+    auto FlushBarriers() noexcept -> CCommandBuffer&;
+
+    // Forgets every tracked binding, for after something else recorded state commands on the raw handle
+    auto InvalidateState() noexcept -> CCommandBuffer&;
+
+    // Hands an exclusively owned resource over to another queue family. The release is recorded on the owning
+    // queue, the acquire on the receiving one in a submission that waits for the release. Both sides take the
+    // same barrier, "SourceStage" of the acquire has to cover the stage its semaphore wait blocks
+    auto ReleaseOwnership(const CQueue& destQueue, SBufferMemoryBarrier barrier) noexcept -> CCommandBuffer&;
+    auto ReleaseOwnership(const CQueue& destQueue, SImageMemoryBarrier barrier) noexcept -> CCommandBuffer&;
+    auto AcquireOwnership(const CQueue& sourceQueue, SBufferMemoryBarrier barrier) noexcept -> CCommandBuffer&;
+    auto AcquireOwnership(const CQueue& sourceQueue, SImageMemoryBarrier barrier) noexcept -> CCommandBuffer&;
+
     auto ClearBuffer(const CBuffer& buffer, uint32 value = 0, const SBufferMemoryRange& range = {}) noexcept -> CCommandBuffer&;
     auto CopyBuffer(const CBuffer& source, const CBuffer& dest, const SBufferCopyRegion& copyRegion) noexcept -> CCommandBuffer&;
+    auto CopyBufferRegions(const CBuffer& source, const CBuffer& dest, std::span<const SBufferCopyRegion> copyRegions) noexcept -> CCommandBuffer&;
     auto CopyBufferToImage(const CBuffer& source, const CImage& dest, const SBufferImageCopyRegion& copyRegion) noexcept -> CCommandBuffer&;
 
     auto ClearImage(const CImageView& imageView, const SClearValue& clearValue) noexcept -> CCommandBuffer&;
@@ -101,15 +130,51 @@ namespace Retina::Graphics {
     auto EndNamedRegion() noexcept -> CCommandBuffer&;
 
   private:
+    auto EnqueueMemoryBarrier(const VkMemoryBarrier2& barrier) noexcept -> void;
+    auto EnqueueBufferMemoryBarrier(const VkBufferMemoryBarrier2& barrier) noexcept -> void;
+    auto EnqueueImageMemoryBarrier(const VkImageMemoryBarrier2& barrier) noexcept -> void;
+
+  private:
+    // Bindings of a single bind point, "DescriptorPipeline" is the pipeline whose layout the descriptors were bound with
+    struct SBindPointState {
+      VkPipeline Pipeline = {};
+      const IPipeline* DescriptorPipeline = nullptr;
+      uint32 FirstSet = 0;
+      VkDescriptorSet DescriptorSet = {};
+      bool HasDescriptorBufferOffsets = false;
+    };
+
+    struct SPushConstantState {
+      const IPipeline* Pipeline = nullptr;
+      uint32 Offset = 0;
+      std::vector<uint8> Values;
+    };
+
     struct SInternalState {
       std::optional<SRenderingInfo> RenderingInfo = std::nullopt;
       const IPipeline* Pipeline = nullptr;
+      VkBuffer DescriptorBuffer = {};
+      // Graphics and compute, other bind points are never tracked
+      std::array<SBindPointState, 2> BindPoints = {};
+      SPushConstantState PushConstants = {};
+      std::optional<SViewport> Viewport = std::nullopt;
+      std::optional<SScissor> Scissor = std::nullopt;
+    };
+
+    // Pending barriers on the same resource never overlap and none chains after the global one (or the other way around),
+    // so their order inside the dependency does not matter
+    struct SPendingBarriers {
+      std::vector<VkMemoryBarrier2> MemoryBarriers;
+      std::vector<VkBufferMemoryBarrier2> BufferMemoryBarriers;
+      std::vector<VkImageMemoryBarrier2> ImageMemoryBarriers;
     };
 
   private:
     VkCommandBuffer _handle = {};
     SCommandBufferCreateInfo _createInfo = {};
     SInternalState _currentState = {};
+    SPendingBarriers _pendingBarriers = {};
+    SCommandBufferStatistics _statistics = {};
 
     Core::CArcPtr<CCommandPool> _commandPool;
     Core::CArcPtr<const CQueue> _queue;
@@ -51,6 +51,8 @@ namespace Retina::Graphics {
     EResourceAccessFlag SourceAccess = EResourceAccessFlag::E_MEMORY_WRITE;
     EResourceAccessFlag DestAccess = EResourceAccessFlag::E_MEMORY_WRITE | EResourceAccessFlag::E_MEMORY_READ;
     SBufferMemoryRange MemoryRange = {};
+    uint32 SourceQueueFamily = QUEUE_FAMILY_IGNORED;
+    uint32 DestQueueFamily = QUEUE_FAMILY_IGNORED;
   };
 
   struct SImageMemoryBarrier {
@@ -62,6 +64,8 @@ namespace Retina::Graphics {
     EImageLayout OldLayout = EImageLayout::E_UNDEFINED;
     EImageLayout NewLayout = EImageLayout::E_UNDEFINED;
     SImageSubresourceRange SubresourceRange = {};
+    uint32 SourceQueueFamily = QUEUE_FAMILY_IGNORED;
+    uint32 DestQueueFamily = QUEUE_FAMILY_IGNORED;
   };
 
   struct SMemoryBarrierInfo {
@@ -132,6 +136,15 @@ namespace Retina::Graphics {
     std::optional<SAttachmentInfo> StencilAttachment = std::nullopt;
   };
 
+  struct SCommandBufferStatistics {
+    // Only counts state commands that may be elided: pipeline, descriptor, push constant, viewport and scissor binds
+    uint32 EmittedCommandCount = 0;
+    uint32 SkippedCommandCount = 0;
+    // Pipeline barrier commands recorded, and barriers folded into a pending one on the same resource
+    uint32 PipelineBarrierCount = 0;
+    uint32 MergedBarrierCount = 0;
+  };
+
   struct SCommandBufferCreateInfo {
     std::string Name;
     ECommandBufferLevel Level = ECommandBufferLevel::E_PRIMARY;
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <Retina/Graphics/Forward.hpp>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Retina::Graphics {
+  // One command pool per recording thread and frame in flight, so threads record without sharing a pool. The lock
+  // only covers finding the calling thread's pool. Beginning a frame resets every pool of that frame, their command
+  // buffers are handed out again instead of being allocated anew
+  class CCommandPoolAllocator {
+  public:
+    CCommandPoolAllocator(const CQueue& queue) noexcept;
+    ~CCommandPoolAllocator() noexcept = default;
+    RETINA_DELETE_COPY(CCommandPoolAllocator);
+    RETINA_DEFAULT_MOVE(CCommandPoolAllocator);
+
+    RETINA_NODISCARD static auto Make(const CQueue& queue, uint32 frameCount) noexcept -> Core::CUniquePtr<CCommandPoolAllocator>;
+
+    RETINA_NODISCARD auto GetFrameCount() const noexcept -> uint32;
+    RETINA_NODISCARD auto GetQueue() const noexcept -> const CQueue&;
+
+    // The device has to be done with the commands recorded the last time "frameIndex" was begun,
+    // and no thread may still be recording
+    auto BeginFrame(uint32 frameIndex) noexcept -> void;
+
+    // Safe to call from any thread, the command buffer stays valid until its frame is begun again
+    RETINA_NODISCARD auto Allocate() noexcept -> CCommandBuffer&;
+
+  private:
+    struct SThreadCommandPool {
+      std::thread::id ThreadId;
+      Core::CArcPtr<CCommandPool> CommandPool;
+      std::vector<Core::CArcPtr<CCommandBuffer>> CommandBuffers;
+      uint32 AllocatedCount = 0;
+    };
+
+    RETINA_NODISCARD auto GetThreadCommandPool() noexcept -> SThreadCommandPool&;
+
+  private:
+    std::mutex _mutex;
+    std::vector<std::vector<Core::CUniquePtr<SThreadCommandPool>>> _frames;
+    uint32 _frameIndex = 0;
+
+    Core::CReferenceWrapper<const CQueue> _queue;
+  };
+}
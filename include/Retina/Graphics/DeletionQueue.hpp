@@ -4,9 +4,14 @@
 
 #include <Retina/Graphics/DeletionQueueInfo.hpp>
 
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace Retina::Graphics {
+  // Deletions are grouped by the main timeline value they were enqueued at. Host timeline values only grow,
+  // so buckets are ordered and "Tick" only ever looks at the buckets it retires. Safe to enqueue from any thread
   class CDeletionQueue {
   public:
     CDeletionQueue(const CDevice& device) noexcept;
@@ -21,7 +26,13 @@ namespace Retina::Graphics {
     auto Flush() noexcept -> void;
 
   private:
-    std::vector<SDeletionQueuePacket> _packets;
+    auto Retire(std::vector<SDeletionQueueBucket>& buckets) noexcept -> void;
+
+  private:
+    std::mutex _mutex;
+    std::deque<SDeletionQueueBucket> _buckets;
+    // Emptied bucket storage, handed to new buckets so steady state enqueues do not allocate
+    std::vector<std::vector<std::move_only_function<void()>>> _freeDeletions;
 
     Core::CReferenceWrapper<const CDevice> _device;
   };
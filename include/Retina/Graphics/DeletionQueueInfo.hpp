@@ -4,9 +4,13 @@
 
 #include <Retina/Graphics/Forward.hpp>
 
+#include <functional>
+#include <vector>
+
 namespace Retina::Graphics {
-  struct SDeletionQueuePacket {
+  // Every deletion enqueued while the main timeline was at "TimelineValue"
+  struct SDeletionQueueBucket {
     uint64 TimelineValue = 0;
-    std::move_only_function<void()> Deletion;
+    std::vector<std::move_only_function<void()>> Deletions;
   };
 }
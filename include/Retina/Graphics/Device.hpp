@@ -29,9 +29,14 @@ namespace Retina::Graphics {
 
     RETINA_NODISCARD auto GetMainTimeline() const noexcept -> CHostDeviceTimeline&;
     RETINA_NODISCARD auto GetDeletionQueue() const noexcept -> CDeletionQueue&;
+    RETINA_NODISCARD auto GetPipelineCache() const noexcept -> const CPipelineCache&;
+    RETINA_NODISCARD auto GetPipelineLibraryCache() const noexcept -> CPipelineLibraryCache&;
 
     RETINA_NODISCARD auto GetShaderResourceTable() const noexcept -> CShaderResourceTable&;
 
+    // Shared by pipeline builds and background pipeline links
+    RETINA_NODISCARD auto GetWorkerPool() const noexcept -> Core::CWorkerPool&;
+
     template <typename T>
     RETINA_NODISCARD auto GetRayTracingProperty(T SDeviceRayTracingProperties::* property) const noexcept -> T;
 
@@ -62,8 +67,11 @@ namespace Retina::Graphics {
 
     Core::CUniquePtr<CHostDeviceTimeline> _mainTimeline;
     Core::CUniquePtr<CDeletionQueue> _deletionQueue;
+    Core::CUniquePtr<CPipelineCache> _pipelineCache;
+    Core::CUniquePtr<CPipelineLibraryCache> _pipelineLibraryCache;
 
     Core::CUniquePtr<CShaderResourceTable> _shaderResourceTable;
+    Core::CUniquePtr<Core::CWorkerPool> _workerPool;
 
     std::vector<SDeviceMemoryType> _memoryTypes;
     std::vector<SDeviceMemoryHeap> _memoryHeaps;
@@ -4,6 +4,7 @@
 
 #include <Retina/Graphics/Enum.hpp>
 
+#include <filesystem>
 #include <string>
 
 namespace Retina::Graphics {
@@ -44,10 +45,15 @@ namespace Retina::Graphics {
     bool AccelerationStructure = false;
     bool MemoryBudget = false;
     bool MemoryPriority = false;
+    bool GraphicsPipelineLibrary = false;
+    bool DescriptorBuffer = false;
   };
 
   struct SDeviceCreateInfo {
     std::string Name;
     SDeviceFeature Features = {};
+    SDeviceFeature OptionalFeatures = {};
+    // Where the pipeline cache persists between runs, nothing is persisted when empty
+    std::filesystem::path PipelineCachePath;
   };
 }
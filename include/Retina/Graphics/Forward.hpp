@@ -45,11 +45,15 @@ namespace Retina::Graphics {
   union SClearValue;
   struct SAttachmentInfo;
   struct SRenderingInfo;
+  struct SCommandBufferStatistics;
   struct SCommandBufferCreateInfo;
 
   // <Retina/Graphics/CommandPool.hpp>
   class CCommandPool;
 
+  // <Retina/Graphics/CommandPoolAllocator.hpp>
+  class CCommandPoolAllocator;
+
   // <Retina/Graphics/CommandPoolInfo.hpp>
   struct SCommandPoolCreateInfo;
 
@@ -60,7 +64,7 @@ namespace Retina::Graphics {
   class CDeletionQueue;
 
   // <Retina/Graphics/DeletionQueueInfo.hpp>
-  struct SDeletionQueuePacket;
+  struct SDeletionQueueBucket;
 
   // <Retina/Graphics/DescriptorLayout.hpp>
   class CDescriptorLayout;
@@ -137,6 +141,18 @@ namespace Retina::Graphics {
   // <Retina/Graphics/Pipeline.hpp>
   class IPipeline;
 
+  // <Retina/Graphics/PipelineBuilder.hpp>
+  class CPipelineBuilder;
+
+  // <Retina/Graphics/PipelineCache.hpp>
+  class CPipelineCache;
+
+  // <Retina/Graphics/PipelineCacheInfo.hpp>
+  struct SPipelineCacheCreateInfo;
+
+  // <Retina/Graphics/PipelineLibraryCache.hpp>
+  class CPipelineLibraryCache;
+
   // <Retina/Graphics/PipelineInfo.hpp>
   enum class EPipelineType;
   struct SViewport;
@@ -152,6 +168,7 @@ namespace Retina::Graphics {
   struct SPipelineDynamicStateInfo;
   struct SPipelineRenderingInfo;
   struct SPipelinePushConstantInfo;
+  struct SPipelineSpecializationConstant;
   struct SComputePipelineCreateInfo;
   struct SGraphicsPipelineCreateInfo;
   struct SMeshShadingPipelineCreateInfo;
@@ -164,6 +181,21 @@ namespace Retina::Graphics {
   struct SQueueCreateInfo;
   struct SQueueSemaphoreSubmitInfo;
 
+  // <Retina/Graphics/RenderGraph.hpp>
+  class CRenderGraph;
+
+  // <Retina/Graphics/RenderGraphInfo.hpp>
+  enum class ERenderGraphAccess;
+  struct SRenderGraphAccessInfo;
+  struct SRenderGraphImage;
+  struct SRenderGraphBuffer;
+  struct SRenderGraphImageUsage;
+  struct SRenderGraphBufferUsage;
+  struct SRenderGraphImportInfo;
+  struct SRenderGraphPassInfo;
+  struct SRenderGraphSubmitInfo;
+  struct SRenderGraphStatistics;
+
   // <Retina/Graphics/Sampler.hpp>
   class CSampler;
 
@@ -190,6 +222,14 @@ namespace Retina::Graphics {
   // <Retina/Graphics/TimelineSemaphore.hpp>
   class CTimelineSemaphore;
 
+  // <Retina/Graphics/TransientResourcePool.hpp>
+  class CTransientResourcePool;
+
+  // <Retina/Graphics/TransientResourcePoolInfo.hpp>
+  struct STransientImageInfo;
+  struct STransientBufferInfo;
+  struct STransientResourcePoolStatistics;
+
   // <Retina/Graphics/TypedBuffer.hpp>
   template <typename T>
   class CTypedBuffer;
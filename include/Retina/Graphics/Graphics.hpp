@@ -7,6 +7,7 @@
 #include <Retina/Graphics/CommandBuffer.hpp>
 #include <Retina/Graphics/CommandBufferInfo.hpp>
 #include <Retina/Graphics/CommandPool.hpp>
+#include <Retina/Graphics/CommandPoolAllocator.hpp>
 #include <Retina/Graphics/CommandPoolInfo.hpp>
 #include <Retina/Graphics/ComputePipeline.hpp>
 #include <Retina/Graphics/DescriptorLayout.hpp>
@@ -34,9 +35,15 @@
 #include <Retina/Graphics/Macros.hpp>
 #include <Retina/Graphics/MeshShadingPipeline.hpp>
 #include <Retina/Graphics/Pipeline.hpp>
+#include <Retina/Graphics/PipelineBuilder.hpp>
+#include <Retina/Graphics/PipelineCache.hpp>
+#include <Retina/Graphics/PipelineCacheInfo.hpp>
+#include <Retina/Graphics/PipelineLibraryCache.hpp>
 #include <Retina/Graphics/PipelineInfo.hpp>
 #include <Retina/Graphics/Queue.hpp>
 #include <Retina/Graphics/QueueInfo.hpp>
+#include <Retina/Graphics/RenderGraph.hpp>
+#include <Retina/Graphics/RenderGraphInfo.hpp>
 #include <Retina/Graphics/Sampler.hpp>
 #include <Retina/Graphics/SamplerInfo.hpp>
 #include <Retina/Graphics/Semaphore.hpp>
@@ -44,4 +51,6 @@
 #include <Retina/Graphics/Swapchain.hpp>
 #include <Retina/Graphics/SwapchainInfo.hpp>
 #include <Retina/Graphics/TimelineSemaphore.hpp>
+#include <Retina/Graphics/TransientResourcePool.hpp>
+#include <Retina/Graphics/TransientResourcePoolInfo.hpp>
 #include <Retina/Graphics/TypedBuffer.hpp>
@@ -2,6 +2,8 @@
 
 #include <Retina/Graphics/Pipeline.hpp>
 
+#include <future>
+
 namespace Retina::Graphics {
   class CGraphicsPipeline : public IPipeline {
   public:
@@ -18,7 +20,13 @@ namespace Retina::Graphics {
     RETINA_NODISCARD auto GetDebugName() const noexcept -> std::string_view;
     auto SetDebugName(std::string_view name) noexcept -> void;
 
+    // Replaces the fast linked handle once the optimized link finished, the old handle is destroyed through the deletion queue.
+    // Returns true when there is nothing left to wait for
+    auto TryPromoteOptimizedHandle() noexcept -> bool;
+
   private:
+    std::future<VkPipeline> _optimizedHandle;
+
     SGraphicsPipelineCreateInfo _createInfo = {};
   };
 }
@@ -17,15 +17,30 @@ namespace Retina::Graphics {
       const SImageCreateInfo& createInfo
     ) noexcept -> Core::CArcPtr<CImage>;
 
+    // Binds the image at "offset" inside memory owned by someone else, the memory must outlive the image
+    RETINA_NODISCARD static auto MakeAliased(
+      const CDevice& device,
+      const SImageCreateInfo& createInfo,
+      VmaAllocation allocation,
+      uint64 offset
+    ) noexcept -> Core::CArcPtr<CImage>;
+
     RETINA_NODISCARD static auto FromSwapchain(
       const CDevice& device,
       const CSwapchain& swapchain,
       const SImageCreateInfo& info
     ) noexcept -> std::vector<Core::CArcPtr<CImage>>;
 
+    RETINA_NODISCARD static auto QueryMemoryRequirements(
+      const CDevice& device,
+      const SImageCreateInfo& createInfo
+    ) noexcept -> VkMemoryRequirements;
+
     RETINA_NODISCARD auto GetHandle() const noexcept -> VkImage;
     RETINA_NODISCARD auto GetAllocation() const noexcept -> VmaAllocation;
     RETINA_NODISCARD auto GetAllocationInfo() const noexcept -> const VmaAllocationInfo&;
+    RETINA_NODISCARD auto IsAliased() const noexcept -> bool;
+    RETINA_NODISCARD auto GetAliasOffset() const noexcept -> uint64;
 
     RETINA_NODISCARD auto GetMemoryRequirements() const noexcept -> const VkMemoryRequirements&;
     RETINA_NODISCARD auto GetSparseMemoryRequirements() const noexcept -> const VkSparseImageMemoryRequirements&;
@@ -52,6 +67,8 @@ namespace Retina::Graphics {
     VkImage _handle = {};
     VmaAllocation _allocation = {};
     VmaAllocationInfo _allocationInfo = {};
+    bool _isAliased = false;
+    uint64 _aliasOffset = 0;
 
     VkMemoryRequirements _memoryRequirements = {};
     VkSparseImageMemoryRequirements _sparseMemoryRequirements = {};
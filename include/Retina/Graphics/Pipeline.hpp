@@ -14,23 +14,71 @@ namespace spirv_cross {
 
 namespace Retina::Graphics {
   namespace Details {
+    // SPIR-V of a single stage together with everything pipeline creation reflects from it
+    struct SShaderBinary {
+      std::vector<uint32> Spirv;
+      EShaderStageFlag Stage = {};
+      uint32 PushConstantSize = 0;
+      // Component count of every fragment shader output, in reflection order
+      std::vector<uint32> OutputComponentCounts;
+    };
+
+    // Shader sources read between the two calls are cached and shared, batches may overlap
+    auto BeginShaderSourceBatch() noexcept -> void;
+    auto EndShaderSourceBatch() noexcept -> void;
+
+    // Loads the SPIR-V compiled at build time, or compiles the source when the runtime shader compiler is enabled
+    RETINA_NODISCARD auto LoadShader(
+      const std::filesystem::path& path,
+      std::span<const std::filesystem::path> includeDirectories,
+      EShaderStageFlag stage
+    ) noexcept -> SShaderBinary;
+
+#if defined(RETINA_ENABLE_RUNTIME_SHADER_COMPILER)
+    // Served from the on-disk shader cache when neither the source, its includes nor the options changed
     RETINA_NODISCARD auto CompileShaderFromSource(
       const std::filesystem::path& path,
       std::span<const std::filesystem::path> includeDirectories,
       EShaderStageFlag stage
-    ) noexcept -> std::vector<uint32>;
+    ) noexcept -> SShaderBinary;
+#else
+    RETINA_NODISCARD auto LoadCompiledShader(const std::filesystem::path& path, EShaderStageFlag stage) noexcept -> SShaderBinary;
+#endif
+
+    // Backing storage of a "VkSpecializationInfo", every constant is stored as a 32 bit value
+    struct SSpecializationData {
+      std::vector<VkSpecializationMapEntry> MapEntries;
+      std::vector<uint32> Data;
+    };
+
+    RETINA_NODISCARD auto MakeSpecializationData(
+      std::span<const SPipelineSpecializationConstant> constants
+    ) noexcept -> SSpecializationData;
+
+    RETINA_NODISCARD auto MakeNativeSpecializationInfo(const SSpecializationData& data) noexcept -> VkSpecializationInfo;
 
     RETINA_NODISCARD auto MakeShaderModule(const CDevice& device, std::span<const uint32> spirv) noexcept -> VkShaderModule;
 
     RETINA_NODISCARD auto ExecutionModelToShaderStage(const spirv_cross::CompilerGLSL& compiler) noexcept -> EShaderStageFlag;
 
+    RETINA_NODISCARD auto ReflectShaderBinary(std::vector<uint32> spirv) noexcept -> SShaderBinary;
+
     RETINA_NODISCARD auto ReflectPushConstantRange(
-      std::span<const spirv_cross::CompilerGLSL* const> compilers
+      std::span<const SShaderBinary* const> shaders
     ) noexcept -> SPipelinePushConstantInfo;
 
+    RETINA_NODISCARD auto ReflectColorBlendAttachments(
+      const SShaderBinary& fragmentShader
+    ) noexcept -> std::vector<SPipelineColorBlendAttachmentInfo>;
+
     RETINA_NODISCARD auto MakeDescriptorLayoutHandles(
       std::span<const Core::CReferenceWrapper<const CDescriptorLayout>> layouts
     ) noexcept -> std::vector<VkDescriptorSetLayout>;
+
+    // Layouts backed by a descriptor buffer can only be used by pipelines created for descriptor buffers
+    RETINA_NODISCARD auto MakeDescriptorLayoutPipelineFlags(
+      std::span<const Core::CReferenceWrapper<const CDescriptorLayout>> layouts
+    ) noexcept -> VkPipelineCreateFlags;
   }
 
   class IPipeline : public Core::IEnableIntrusiveReferenceCount<IPipeline> {
@@ -38,6 +86,8 @@ namespace Retina::Graphics {
     struct SPipelineLayout {
       VkPipelineLayout Handle = {};
       SPipelinePushConstantInfo PushConstant = {};
+      // Kept to tell whether bindings made with another pipeline's layout are still valid for this one
+      std::vector<VkDescriptorSetLayout> DescriptorLayouts;
     };
 
   public:
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <Retina/Graphics/PipelineInfo.hpp>
+
+#include <future>
+#include <vector>
+
+namespace Retina::Graphics {
+  // Compiles shaders and creates pipelines on the device worker pool, a batch costs about as much as its slowest pipelines.
+  // Pipelines built into a caller provided slot must not be read before "Wait" returns
+  class CPipelineBuilder {
+  public:
+    CPipelineBuilder(const CDevice& device) noexcept;
+    ~CPipelineBuilder() noexcept;
+    RETINA_DELETE_COPY(CPipelineBuilder);
+    RETINA_DEFAULT_MOVE(CPipelineBuilder);
+
+    RETINA_NODISCARD static auto Make(const CDevice& device) noexcept -> Core::CUniquePtr<CPipelineBuilder>;
+
+    RETINA_NODISCARD auto GetDevice() const noexcept -> const CDevice&;
+
+    RETINA_NODISCARD auto Build(
+      const SComputePipelineCreateInfo& createInfo
+    ) noexcept -> std::shared_future<Core::CArcPtr<CComputePipeline>>;
+    RETINA_NODISCARD auto Build(
+      const SGraphicsPipelineCreateInfo& createInfo
+    ) noexcept -> std::shared_future<Core::CArcPtr<CGraphicsPipeline>>;
+    RETINA_NODISCARD auto Build(
+      const SMeshShadingPipelineCreateInfo& createInfo
+    ) noexcept -> std::shared_future<Core::CArcPtr<CMeshShadingPipeline>>;
+
+    auto Build(const SComputePipelineCreateInfo& createInfo, Core::CArcPtr<CComputePipeline>& pipeline) noexcept -> void;
+    auto Build(const SGraphicsPipelineCreateInfo& createInfo, Core::CArcPtr<CGraphicsPipeline>& pipeline) noexcept -> void;
+    auto Build(const SMeshShadingPipelineCreateInfo& createInfo, Core::CArcPtr<CMeshShadingPipeline>& pipeline) noexcept -> void;
+
+    // Blocks until every pipeline built so far exists and ends the batch, shader sources are read again by the next one
+    auto Wait() noexcept -> void;
+
+  private:
+    auto BeginBatch() noexcept -> void;
+
+  private:
+    std::vector<std::shared_future<void>> _pending;
+
+    Core::CReferenceWrapper<const CDevice> _device;
+  };
+}
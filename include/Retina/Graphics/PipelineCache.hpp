@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <Retina/Graphics/PipelineCacheInfo.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <chrono>
+
+namespace Retina::Graphics {
+  // Device wide cache shared by every pipeline, persisted to disk so drivers can skip backend compilation
+  class CPipelineCache {
+  public:
+    CPipelineCache(const CDevice& device) noexcept;
+    ~CPipelineCache() noexcept;
+    RETINA_DELETE_COPY(CPipelineCache);
+    RETINA_DEFAULT_MOVE(CPipelineCache);
+
+    RETINA_NODISCARD static auto Make(
+      const CDevice& device,
+      const SPipelineCacheCreateInfo& createInfo
+    ) noexcept -> Core::CUniquePtr<CPipelineCache>;
+
+    RETINA_NODISCARD auto GetHandle() const noexcept -> VkPipelineCache;
+    RETINA_NODISCARD auto GetCreateInfo() const noexcept -> const SPipelineCacheCreateInfo&;
+    RETINA_NODISCARD auto GetDevice() const noexcept -> const CDevice&;
+
+    RETINA_NODISCARD auto GetDebugName() const noexcept -> std::string_view;
+    auto SetDebugName(std::string_view name) noexcept -> void;
+
+    // Writes to a temporary file first and renames it over the old one, a crash never leaves a torn cache behind
+    auto Save() noexcept -> void;
+    auto Tick() noexcept -> void;
+
+  private:
+    VkPipelineCache _handle = {};
+
+    // Drivers may update the blob in place without changing its size, only its contents tell whether it changed
+    uint64 _savedHash = 0;
+    std::chrono::steady_clock::time_point _lastSaveTime = {};
+
+    SPipelineCacheCreateInfo _createInfo = {};
+    Core::CReferenceWrapper<const CDevice> _device;
+  };
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <Retina/Graphics/Forward.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+namespace Retina::Graphics {
+  struct SPipelineCacheCreateInfo {
+    std::string Name;
+    // Loaded on creation when it was written for the same driver and device, empty disables persistence
+    std::filesystem::path Path;
+    // The cache is saved on destruction, and on "Tick" at most this often once it has grown
+    std::chrono::seconds SaveInterval = std::chrono::seconds(60);
+  };
+}
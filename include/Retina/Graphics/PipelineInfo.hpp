@@ -8,6 +8,7 @@
 
 #include <filesystem>
 #include <span>
+#include <variant>
 
 namespace Retina::Graphics {
   enum class EPipelineType {
@@ -22,6 +23,8 @@ namespace Retina::Graphics {
     float32 Y = 0.0f;
     float32 Width = 0.0f;
     float32 Height = 0.0f;
+
+    RETINA_NODISCARD constexpr auto operator <=>(const SViewport&) const noexcept = default;
   };
 
   struct SScissor {
@@ -29,6 +32,8 @@ namespace Retina::Graphics {
     int32 Y = 0;
     uint32 Width = 0;
     uint32 Height = 0;
+
+    RETINA_NODISCARD constexpr auto operator <=>(const SScissor&) const noexcept = default;
   };
 
   struct SPipelineStencilState {
@@ -120,6 +125,14 @@ namespace Retina::Graphics {
     EShaderStageFlag Stages = {};
     uint32 Offset = 0;
     uint32 Size = 0;
+
+    RETINA_NODISCARD constexpr auto operator <=>(const SPipelinePushConstantInfo&) const noexcept = default;
+  };
+
+  // Matched against "layout (constant_id = Id)" in every stage of the pipeline, stages that do not declare "Id" ignore it
+  struct SPipelineSpecializationConstant {
+    uint32 Id = 0;
+    std::variant<bool, int32, uint32, float32> Value = 0_u32;
   };
 
   const inline auto DEFAULT_PIPELINE_TESSELLATION_STATE_INFO = SPipelineTessellationStateInfo();
@@ -134,6 +147,7 @@ namespace Retina::Graphics {
     std::string Name;
     std::filesystem::path ComputeShader;
     std::vector<std::filesystem::path> IncludeDirectories;
+    std::vector<SPipelineSpecializationConstant> SpecializationConstants;
 
     std::vector<Core::CReferenceWrapper<const CDescriptorLayout>> DescriptorLayouts;
   };
@@ -143,6 +157,7 @@ namespace Retina::Graphics {
     std::filesystem::path VertexShader;
     std::optional<std::filesystem::path> FragmentShader = std::nullopt;
     std::vector<std::filesystem::path> IncludeDirectories;
+    std::vector<SPipelineSpecializationConstant> SpecializationConstants;
 
     std::vector<Core::CReferenceWrapper<const CDescriptorLayout>> DescriptorLayouts;
 
@@ -162,6 +177,7 @@ namespace Retina::Graphics {
     std::optional<std::filesystem::path> TaskShader = std::nullopt;
     std::optional<std::filesystem::path> FragmentShader = std::nullopt;
     std::vector<std::filesystem::path> IncludeDirectories;
+    std::vector<SPipelineSpecializationConstant> SpecializationConstants;
 
     std::vector<Core::CReferenceWrapper<const CDescriptorLayout>> DescriptorLayouts;
 
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Retina::Graphics {
+  // Device wide store of graphics pipeline libraries, pipelines that share a part of their state
+  // link against the same library instead of compiling that part again
+  class CPipelineLibraryCache {
+  public:
+    CPipelineLibraryCache(const CDevice& device) noexcept;
+    ~CPipelineLibraryCache() noexcept;
+    RETINA_DELETE_COPY(CPipelineLibraryCache);
+    RETINA_DEFAULT_MOVE(CPipelineLibraryCache);
+
+    RETINA_NODISCARD static auto Make(const CDevice& device) noexcept -> Core::CUniquePtr<CPipelineLibraryCache>;
+
+    RETINA_NODISCARD auto GetLibraryCount() const noexcept -> usize;
+    RETINA_NODISCARD auto GetDevice() const noexcept -> const CDevice&;
+
+    // Returns the library stored under "key", it is created from "createInfo" if there is none yet. Safe to call from any thread.
+    // The key is compared in full, it has to describe every piece of state the library is built from
+    RETINA_NODISCARD auto Acquire(std::string key, const VkGraphicsPipelineCreateInfo& createInfo) noexcept -> VkPipeline;
+
+    // Pipelines whose optimized link is still compiling, "Tick" swaps it in once it is done
+    auto Register(CGraphicsPipeline& pipeline) noexcept -> void;
+    auto Unregister(const CGraphicsPipeline& pipeline) noexcept -> void;
+    auto Tick() noexcept -> void;
+
+  private:
+    Core::FlatHashMap<std::string, VkPipeline> _libraries;
+    std::vector<CGraphicsPipeline*> _pending;
+    mutable std::mutex _mutex;
+
+    Core::CReferenceWrapper<const CDevice> _device;
+  };
+}
@@ -6,7 +6,10 @@
 
 #include <vulkan/vulkan.h>
 
+#include <atomic>
 #include <mutex>
+#include <span>
+#include <vector>
 
 namespace Retina::Graphics {
   class CQueue : public Core::IEnableIntrusiveReferenceCount<CQueue> {
@@ -30,17 +33,43 @@ namespace Retina::Graphics {
     RETINA_NODISCARD auto GetDebugName() const noexcept -> std::string_view;
     auto SetDebugName(std::string_view name) noexcept -> void;
 
-    auto Submit(const SQueueSubmitInfo& submitInfo, const CFence* fence = nullptr) noexcept -> void;
+    // Every submission signals the queue timeline, the returned value can be waited on from other queues
+    RETINA_NODISCARD auto GetTimeline() const noexcept -> const CTimelineSemaphore&;
+    RETINA_NODISCARD auto GetTimelineValue() const noexcept -> uint64;
+
+    auto Submit(const SQueueSubmitInfo& submitInfo, const CFence* fence = nullptr) noexcept -> uint64;
+    // One "vkQueueSubmit2" for the whole batch, submission "i" signals the queue timeline with the returned value
+    // minus "submitInfos.size() - 1 - i". The fence is signaled once every submission completed
+    auto Submit(std::span<const SQueueSubmitInfo> submitInfos, const CFence* fence = nullptr) noexcept -> uint64;
+    // Records "submission" on a pooled command buffer, the returned queue timeline value is reached once it completed
+    RETINA_NODISCARD auto SubmitAsync(std::move_only_function<void(CCommandBuffer&)>&& submission) noexcept -> uint64;
     auto Submit(std::move_only_function<void(CCommandBuffer&)>&& submission) noexcept -> void;
 
+    // Pooled command buffers keep the queue alive, the device releases them before it drops its queues
+    auto ReleaseImmediateContexts() noexcept -> void;
+
     auto WaitIdle() const noexcept -> void;
     auto Lock() noexcept -> void;
     auto Unlock() noexcept -> void;
 
+  private:
+    struct SImmediateContext {
+      Core::CArcPtr<CCommandBuffer> CommandBuffer;
+      uint64 Value = 0;
+    };
+
+    RETINA_NODISCARD auto AcquireImmediateContext() noexcept -> Core::CArcPtr<CCommandBuffer>;
+
   private:
     VkQueue _handle = {};
     std::mutex _mutex;
 
+    std::atomic<uint64> _timelineValue = 0;
+    Core::CArcPtr<CTimelineSemaphore> _timeline;
+
+    std::mutex _immediateContextMutex;
+    std::vector<SImmediateContext> _immediateContexts;
+
     SQueueCreateInfo _createInfo = {};
     Core::CReferenceWrapper<const CDevice> _device;
   };
@@ -8,6 +8,12 @@
 #include <string>
 
 namespace Retina::Graphics {
+  constexpr static auto MAX_QUEUE_SUBMIT_BATCH_SIZE = 16_u32;
+  // Limits of a single submission, its arrays are stored inline so building one never allocates
+  constexpr static auto MAX_QUEUE_SUBMIT_COMMAND_BUFFERS = 16_u32;
+  constexpr static auto MAX_QUEUE_SUBMIT_SEMAPHORES = 8_u32;
+  constexpr static auto MAX_QUEUE_SUBMIT_TIMELINES = 4_u32;
+
   enum class EQueueDomain {
     E_GRAPHICS,
     E_COMPUTE,
@@ -27,10 +33,14 @@ namespace Retina::Graphics {
     uint64 Value = -1_u64;
   };
 
+  using CQueueSubmitCommandBuffers = Core::CFixedVector<Core::CReferenceWrapper<const CCommandBuffer>, MAX_QUEUE_SUBMIT_COMMAND_BUFFERS>;
+  using CQueueSubmitSemaphores = Core::CFixedVector<SQueueSemaphoreSubmitInfo, MAX_QUEUE_SUBMIT_SEMAPHORES>;
+  using CQueueSubmitTimelines = Core::CFixedVector<Core::CReferenceWrapper<CHostDeviceTimeline>, MAX_QUEUE_SUBMIT_TIMELINES>;
+
   struct SQueueSubmitInfo {
-    std::vector<Core::CReferenceWrapper<const CCommandBuffer>> CommandBuffers;
-    std::vector<SQueueSemaphoreSubmitInfo> WaitSemaphores;
-    std::vector<SQueueSemaphoreSubmitInfo> SignalSemaphores;
-    std::vector<Core::CReferenceWrapper<CHostDeviceTimeline>> Timelines;
+    CQueueSubmitCommandBuffers CommandBuffers;
+    CQueueSubmitSemaphores WaitSemaphores;
+    CQueueSubmitSemaphores SignalSemaphores;
+    CQueueSubmitTimelines Timelines;
   };
 }
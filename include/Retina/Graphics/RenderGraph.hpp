@@ -0,0 +1,164 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <Retina/Graphics/CommandBufferInfo.hpp>
+#include <Retina/Graphics/RenderGraphInfo.hpp>
+
+#include <array>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Retina::Graphics {
+  // Single frame graph, resources and passes are declared every frame and discarded by "Submit".
+  // Passes may run on the async compute queue, dependencies between the queues wait on queue timeline values
+  class CRenderGraph {
+  public:
+    CRenderGraph(const CDevice& device) noexcept;
+    ~CRenderGraph() noexcept = default;
+    RETINA_DELETE_COPY(CRenderGraph);
+    RETINA_DEFAULT_MOVE(CRenderGraph);
+
+    // Command buffers are recorded from one set of pools per frame in flight, "frameCount" of them
+    RETINA_NODISCARD static auto Make(const CDevice& device, uint32 frameCount) noexcept -> Core::CUniquePtr<CRenderGraph>;
+
+    RETINA_NODISCARD auto GetStatistics() const noexcept -> const SRenderGraphStatistics&;
+    RETINA_NODISCARD auto GetDevice() const noexcept -> const CDevice&;
+
+    // Importing the same resource twice returns the same handle, the first import info is kept.
+    // Resources sharing memory through a transient pool are ordered so their lifetimes never overlap
+    RETINA_NODISCARD auto ImportImage(const CImage& image, const SRenderGraphImportInfo& importInfo = {}) noexcept -> SRenderGraphImage;
+    RETINA_NODISCARD auto ImportBuffer(const CBuffer& buffer, const SRenderGraphImportInfo& importInfo = {}) noexcept -> SRenderGraphBuffer;
+
+    auto AddPass(SRenderGraphPassInfo&& passInfo) noexcept -> CRenderGraph&;
+
+    // Culls, schedules and records every pass, submits them to their queues, then resets the graph
+    auto Submit(const SRenderGraphSubmitInfo& submitInfo) noexcept -> void;
+
+  private:
+    struct SResourceState {
+      EImageLayout Layout = EImageLayout::E_UNDEFINED;
+      EPipelineStageFlag WriteStage = EPipelineStageFlag::E_NONE;
+      EResourceAccessFlag WriteAccess = EResourceAccessFlag::E_NONE;
+      // Reads since the last write, all of them already have the write made visible
+      EPipelineStageFlag ReadStage = EPipelineStageFlag::E_NONE;
+      EResourceAccessFlag ReadAccess = EResourceAccessFlag::E_NONE;
+      // Image barrier emitted for this subresource in the batch that is being built
+      uint32 BatchBarrierIndex = -1_u32;
+      // Batch of the last access, the stages above belong to the queue that batch was submitted to
+      uint32 Batch = -1_u32;
+    };
+
+    struct SAliasState {
+      bool IsAliased = false;
+      bool IsAccessed = false;
+      // Other resources whose memory overlaps this one, images are indexed first and buffers after them
+      std::vector<uint32> Aliases;
+    };
+
+    struct SImageResource {
+      const CImage* Image = nullptr;
+      SRenderGraphImportInfo ImportInfo = {};
+      uint32 LevelCount = 0;
+      uint32 LayerCount = 0;
+      std::vector<SResourceState> States;
+      SAliasState Alias = {};
+    };
+
+    struct SBufferResource {
+      const CBuffer* Buffer = nullptr;
+      SRenderGraphImportInfo ImportInfo = {};
+      SResourceState State = {};
+      SAliasState Alias = {};
+    };
+
+    struct SPendingImageBarrier {
+      uint32 Image = 0;
+      uint32 Level = 0;
+      uint32 Layer = 0;
+      EPipelineStageFlag SourceStage = EPipelineStageFlag::E_NONE;
+      EPipelineStageFlag DestStage = EPipelineStageFlag::E_NONE;
+      EResourceAccessFlag SourceAccess = EResourceAccessFlag::E_NONE;
+      EResourceAccessFlag DestAccess = EResourceAccessFlag::E_NONE;
+      EImageLayout OldLayout = EImageLayout::E_UNDEFINED;
+      EImageLayout NewLayout = EImageLayout::E_UNDEFINED;
+    };
+
+    struct SBarrierBatch {
+      SMemoryBarrier MemoryBarrier = {
+        .SourceStage = EPipelineStageFlag::E_NONE,
+        .DestStage = EPipelineStageFlag::E_NONE,
+        .SourceAccess = EResourceAccessFlag::E_NONE,
+        .DestAccess = EResourceAccessFlag::E_NONE,
+      };
+      std::vector<SPendingImageBarrier> ImageBarriers;
+    };
+
+    struct SSubmissionStep {
+      SMemoryBarrierInfo Barrier = {};
+      std::vector<uint32> Passes;
+    };
+
+    struct SSubmission {
+      EQueueDomain Queue = EQueueDomain::E_GRAPHICS;
+      std::vector<SSubmissionStep> Steps;
+      // Waits on the other queue, either on a submission of this graph or on a value of a previous one
+      uint32 WaitSubmission = -1_u32;
+      uint64 WaitValue = 0;
+      EPipelineStageFlag WaitStage = EPipelineStageFlag::E_NONE;
+      // Another submission waits on this one, later work of the queue goes into a new submission
+      bool IsClosed = false;
+      uint64 SignalValue = 0;
+    };
+
+    auto FindAliases() noexcept -> void;
+    RETINA_NODISCARD auto GetAliasState(uint32 resourceIndex) noexcept -> SAliasState&;
+    RETINA_NODISCARD auto GetResourceStates(uint32 resourceIndex) noexcept -> std::span<SResourceState>;
+
+    RETINA_NODISCARD auto CullPasses() const noexcept -> std::vector<bool>;
+    // Groups the passes that survived culling into dependency levels, each level shares one barrier batch
+    RETINA_NODISCARD auto SchedulePasses(const std::vector<bool>& isPassAlive) const noexcept -> std::vector<std::vector<uint32>>;
+
+    RETINA_NODISCARD auto GetQueue(EQueueDomain domain) const noexcept -> CQueue&;
+    auto MakeSubmission(EQueueDomain domain) noexcept -> uint32;
+    RETINA_NODISCARD auto GetOpenSubmission(EQueueDomain domain) noexcept -> uint32;
+    RETINA_NODISCARD auto GetWaitingSubmission() noexcept -> SSubmission&;
+    auto WaitForSubmission(uint32 submissionIndex, EPipelineStageFlag stage) noexcept -> void;
+    auto WaitForValue(uint64 value, EPipelineStageFlag stage) noexcept -> void;
+    // Moves a subresource to the queue recording the current batch, the stages of the previous queue are
+    // replaced by a semaphore wait on its submission
+    auto AcquireQueue(SResourceState& state, uint32 resourceIndex, const SRenderGraphAccessInfo& accessInfo) noexcept -> void;
+
+    // The first access of aliased memory waits on whatever used it before, the previous frame if nothing did in this one
+    auto AcquireAliasedMemory(uint32 resourceIndex, const SRenderGraphAccessInfo& accessInfo) noexcept -> void;
+    auto AccessImage(SBarrierBatch& batch, uint32 imageIndex, const SImageSubresourceRange& range, ERenderGraphAccess access) noexcept -> void;
+    auto AccessBuffer(SBarrierBatch& batch, uint32 bufferIndex, ERenderGraphAccess access) noexcept -> void;
+    auto AccessResource(SBarrierBatch& batch, SResourceState& state, const SRenderGraphAccessInfo& accessInfo) noexcept -> void;
+    // Merges the pending barriers of a batch, adjacent subresources sharing a scope become one barrier
+    RETINA_NODISCARD auto ResolveBatch(SBarrierBatch& batch) noexcept -> SMemoryBarrierInfo;
+    // Appends the resolved batch and the passes it guards to the open submission of the current queue
+    auto CommitBatch(SBarrierBatch& batch, std::vector<uint32>&& passes) noexcept -> void;
+
+  private:
+    std::vector<SImageResource> _images;
+    std::vector<SBufferResource> _buffers;
+    std::vector<SRenderGraphPassInfo> _passes;
+
+    bool _isAsyncCompute = false;
+    EQueueDomain _currentQueue = EQueueDomain::E_GRAPHICS;
+    std::vector<SSubmission> _submissions;
+    std::vector<uint32> _batchSubmissions;
+    std::array<uint32, 2> _openSubmissions = {};
+
+    // Last timeline value each queue accessed a resource (or aliased memory block) at, kept across frames
+    std::array<std::unordered_map<const void*, uint64>, 2> _queueAccessValues;
+    std::array<Core::CUniquePtr<CCommandPoolAllocator>, 2> _commandPools;
+    // Recording threads of its own, frame recording must not queue up behind pipeline builds on the device pool
+    Core::CUniquePtr<Core::CWorkerPool> _workerPool;
+
+    SRenderGraphStatistics _statistics = {};
+
+    Core::CReferenceWrapper<const CDevice> _device;
+  };
+}
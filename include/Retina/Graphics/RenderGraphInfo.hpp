@@ -0,0 +1,226 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <Retina/Graphics/Enum.hpp>
+#include <Retina/Graphics/Forward.hpp>
+#include <Retina/Graphics/ImageInfo.hpp>
+#include <Retina/Graphics/QueueInfo.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Retina::Graphics {
+  enum class ERenderGraphAccess {
+    E_NONE,
+    E_INDIRECT_COMMAND_READ,
+    E_INDEX_READ,
+    E_GRAPHICS_SHADER_STORAGE_READ,
+    E_FRAGMENT_SHADER_SAMPLED_READ,
+    E_COMPUTE_SHADER_SAMPLED_READ,
+    E_COMPUTE_SHADER_STORAGE_READ,
+    E_COMPUTE_SHADER_STORAGE_WRITE,
+    E_COMPUTE_SHADER_STORAGE_READ_WRITE,
+    E_COLOR_ATTACHMENT_WRITE,
+    E_COLOR_ATTACHMENT_READ_WRITE,
+    E_DEPTH_STENCIL_ATTACHMENT_WRITE,
+    E_DEPTH_STENCIL_ATTACHMENT_READ,
+    E_TRANSFER_READ,
+    E_TRANSFER_WRITE,
+    // Work the graph cannot see into (e.g. DLSS), synchronized against everything
+    E_GENERAL_READ_WRITE,
+    E_PRESENT,
+  };
+
+  struct SRenderGraphAccessInfo {
+    EPipelineStageFlag Stage = EPipelineStageFlag::E_NONE;
+    EResourceAccessFlag Access = EResourceAccessFlag::E_NONE;
+    EImageLayout Layout = EImageLayout::E_UNDEFINED;
+    bool IsWrite = false;
+  };
+
+  struct SRenderGraphImage {
+    uint32 Index = -1_u32;
+  };
+
+  struct SRenderGraphBuffer {
+    uint32 Index = -1_u32;
+  };
+
+  struct SRenderGraphImageUsage {
+    SRenderGraphImage Image = {};
+    ERenderGraphAccess Access = ERenderGraphAccess::E_NONE;
+    SImageSubresourceRange SubresourceRange = {};
+  };
+
+  struct SRenderGraphBufferUsage {
+    SRenderGraphBuffer Buffer = {};
+    ERenderGraphAccess Access = ERenderGraphAccess::E_NONE;
+  };
+
+  struct SRenderGraphImportInfo {
+    // How the resource was last used before the graph, "E_NONE" discards image contents
+    ERenderGraphAccess InitialAccess = ERenderGraphAccess::E_NONE;
+    // Anything other than "E_NONE" exports the resource, keeping its writers alive
+    ERenderGraphAccess FinalAccess = ERenderGraphAccess::E_NONE;
+  };
+
+  struct SRenderGraphPassInfo {
+    std::string Name;
+    std::vector<SRenderGraphImageUsage> Images;
+    std::vector<SRenderGraphBufferUsage> Buffers;
+    // Passes with side effects are never culled
+    bool HasSideEffects = false;
+    // "E_COMPUTE" runs the pass on the async compute queue, it falls back to graphics when both queues are the same
+    EQueueDomain Queue = EQueueDomain::E_GRAPHICS;
+    std::move_only_function<void(CCommandBuffer&)> Execute;
+  };
+
+  struct SRenderGraphSubmitInfo {
+    // Recorded by the caller, executed on the graphics queue ahead of every pass
+    CQueueSubmitCommandBuffers CommandBuffers;
+    // Waited on by the submission carrying "CommandBuffers", signaled by the last graphics submission. The graph
+    // may add a wait on the other queue, one wait semaphore has to be left free
+    CQueueSubmitSemaphores WaitSemaphores;
+    CQueueSubmitSemaphores SignalSemaphores;
+    // Signaled once the work of both queues completed
+    CQueueSubmitTimelines Timelines;
+    // Passes of a submission are recorded on up to this many threads, into command buffers submitted in order.
+    // Anything above one requires pass callbacks that are safe to run concurrently with each other
+    uint32 RecordingThreadCount = 1;
+    // Resets the command pools of this frame, the device has to be done with the last submission of the same index
+    uint32 FrameIndex = 0;
+  };
+
+  struct SRenderGraphStatistics {
+    uint32 PassCount = 0;
+    uint32 CulledPassCount = 0;
+    uint32 LevelCount = 0;
+    uint32 BarrierBatchCount = 0;
+    uint32 ImageBarrierCount = 0;
+    uint32 AsyncComputePassCount = 0;
+    uint32 SubmissionCount = 0;
+  };
+
+  RETINA_NODISCARD RETINA_INLINE constexpr auto GetRenderGraphAccessInfo(ERenderGraphAccess access) noexcept -> SRenderGraphAccessInfo {
+    switch (access) {
+      case ERenderGraphAccess::E_NONE:
+        return {};
+      case ERenderGraphAccess::E_INDIRECT_COMMAND_READ:
+        return {
+          .Stage = EPipelineStageFlag::E_DRAW_INDIRECT,
+          .Access = EResourceAccessFlag::E_INDIRECT_COMMAND_READ,
+        };
+      case ERenderGraphAccess::E_INDEX_READ:
+        return {
+          .Stage = EPipelineStageFlag::E_INDEX_INPUT,
+          .Access = EResourceAccessFlag::E_INDEX_READ,
+        };
+      case ERenderGraphAccess::E_GRAPHICS_SHADER_STORAGE_READ:
+        return {
+          .Stage =
+            EPipelineStageFlag::E_PRE_RASTERIZATION_SHADERS |
+            EPipelineStageFlag::E_FRAGMENT_SHADER,
+          .Access = EResourceAccessFlag::E_SHADER_STORAGE_READ,
+          .Layout = EImageLayout::E_GENERAL,
+        };
+      case ERenderGraphAccess::E_FRAGMENT_SHADER_SAMPLED_READ:
+        return {
+          .Stage = EPipelineStageFlag::E_FRAGMENT_SHADER,
+          .Access = EResourceAccessFlag::E_SHADER_SAMPLED_READ,
+          .Layout = EImageLayout::E_SHADER_READ_ONLY_OPTIMAL,
+        };
+      case ERenderGraphAccess::E_COMPUTE_SHADER_SAMPLED_READ:
+        return {
+          .Stage = EPipelineStageFlag::E_COMPUTE_SHADER,
+          .Access = EResourceAccessFlag::E_SHADER_SAMPLED_READ,
+          .Layout = EImageLayout::E_SHADER_READ_ONLY_OPTIMAL,
+        };
+      case ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_READ:
+        return {
+          .Stage = EPipelineStageFlag::E_COMPUTE_SHADER,
+          .Access = EResourceAccessFlag::E_SHADER_STORAGE_READ,
+          .Layout = EImageLayout::E_GENERAL,
+        };
+      case ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_WRITE:
+        return {
+          .Stage = EPipelineStageFlag::E_COMPUTE_SHADER,
+          .Access = EResourceAccessFlag::E_SHADER_STORAGE_WRITE,
+          .Layout = EImageLayout::E_GENERAL,
+          .IsWrite = true,
+        };
+      case ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_READ_WRITE:
+        return {
+          .Stage = EPipelineStageFlag::E_COMPUTE_SHADER,
+          .Access =
+            EResourceAccessFlag::E_SHADER_STORAGE_READ |
+            EResourceAccessFlag::E_SHADER_STORAGE_WRITE,
+          .Layout = EImageLayout::E_GENERAL,
+          .IsWrite = true,
+        };
+      case ERenderGraphAccess::E_COLOR_ATTACHMENT_WRITE:
+        return {
+          .Stage = EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
+          .Access = EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
+          .Layout = EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
+          .IsWrite = true,
+        };
+      case ERenderGraphAccess::E_COLOR_ATTACHMENT_READ_WRITE:
+        return {
+          .Stage = EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
+          .Access =
+            EResourceAccessFlag::E_COLOR_ATTACHMENT_READ |
+            EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
+          .Layout = EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
+          .IsWrite = true,
+        };
+      case ERenderGraphAccess::E_DEPTH_STENCIL_ATTACHMENT_WRITE:
+        return {
+          .Stage =
+            EPipelineStageFlag::E_EARLY_FRAGMENT_TESTS |
+            EPipelineStageFlag::E_LATE_FRAGMENT_TESTS,
+          .Access =
+            EResourceAccessFlag::E_DEPTH_STENCIL_ATTACHMENT_READ |
+            EResourceAccessFlag::E_DEPTH_STENCIL_ATTACHMENT_WRITE,
+          .Layout = EImageLayout::E_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+          .IsWrite = true,
+        };
+      case ERenderGraphAccess::E_DEPTH_STENCIL_ATTACHMENT_READ:
+        return {
+          .Stage =
+            EPipelineStageFlag::E_EARLY_FRAGMENT_TESTS |
+            EPipelineStageFlag::E_LATE_FRAGMENT_TESTS,
+          .Access = EResourceAccessFlag::E_DEPTH_STENCIL_ATTACHMENT_READ,
+          .Layout = EImageLayout::E_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+        };
+      case ERenderGraphAccess::E_TRANSFER_READ:
+        return {
+          .Stage = EPipelineStageFlag::E_TRANSFER,
+          .Access = EResourceAccessFlag::E_TRANSFER_READ,
+          .Layout = EImageLayout::E_TRANSFER_SRC_OPTIMAL,
+        };
+      case ERenderGraphAccess::E_TRANSFER_WRITE:
+        return {
+          .Stage = EPipelineStageFlag::E_TRANSFER,
+          .Access = EResourceAccessFlag::E_TRANSFER_WRITE,
+          .Layout = EImageLayout::E_TRANSFER_DST_OPTIMAL,
+          .IsWrite = true,
+        };
+      case ERenderGraphAccess::E_GENERAL_READ_WRITE:
+        return {
+          .Stage = EPipelineStageFlag::E_ALL_COMMANDS,
+          .Access =
+            EResourceAccessFlag::E_MEMORY_READ |
+            EResourceAccessFlag::E_MEMORY_WRITE,
+          .Layout = EImageLayout::E_GENERAL,
+          .IsWrite = true,
+        };
+      case ERenderGraphAccess::E_PRESENT:
+        return {
+          .Layout = EImageLayout::E_PRESENT_SRC_KHR,
+        };
+      default: std::unreachable();
+    }
+  }
+}
@@ -3,22 +3,30 @@
 #include <Retina/Core/Core.hpp>
 
 #include <Retina/Graphics/Resources/ShaderResource.hpp>
+#include <Retina/Graphics/DescriptorSetInfo.hpp>
 #include <Retina/Graphics/Enum.hpp>
 #include <Retina/Graphics/Forward.hpp>
 #include <Retina/Graphics/TypedBuffer.hpp>
 
 #include <array>
+#include <mutex>
+#include <span>
+#include <variant>
+#include <vector>
 
 namespace Retina::Graphics {
   constexpr static auto MAX_SAMPLER_RESOURCE_SLOTS = 1024_u32;
   constexpr static auto MAX_BUFFER_RESOURCE_SLOTS = 1048576_u32;
   constexpr static auto MAX_IMAGE_RESOURCE_SLOTS = 262144_u32;
 
+  // Bindless table of every sampler, buffer and image shaders can reach. Backed by a descriptor buffer when the
+  // device supports it, descriptors are then copied straight into mapped memory instead of going through the driver.
+  // Resources may be made, looked up and destroyed from any thread, only the slot bookkeeping is done under a lock
   class CShaderResourceTable {
   public:
     CShaderResourceTable(const CDevice& device) noexcept;
     ~CShaderResourceTable() noexcept = default;
-    RETINA_DEFAULT_COPY_MOVE(CShaderResourceTable);
+    RETINA_DELETE_COPY_MOVE(CShaderResourceTable);
 
     RETINA_NODISCARD static auto Make(const CDevice& device) noexcept -> Core::CUniquePtr<CShaderResourceTable>;
 
@@ -27,6 +35,9 @@ namespace Retina::Graphics {
 
     RETINA_NODISCARD auto GetDescriptorLayout() const noexcept -> const CDescriptorLayout&;
 
+    RETINA_NODISCARD auto HasDescriptorBuffer() const noexcept -> bool;
+    RETINA_NODISCARD auto GetDescriptorBuffer() const noexcept -> const CBuffer&;
+
     template <typename T>
     RETINA_NODISCARD RETINA_INLINE auto MakeBuffer(
       const SBufferCreateInfo& createInfo
@@ -47,6 +58,12 @@ namespace Retina::Graphics {
       EImageLayout layout = EImageLayout::E_GENERAL
     ) noexcept -> CShaderResource<CImage>;
 
+    // Takes a slot for an image created elsewhere (e.g. by a transient resource pool)
+    RETINA_NODISCARD auto RegisterImage(
+      Core::CArcPtr<CImage> image,
+      EImageLayout layout = EImageLayout::E_GENERAL
+    ) noexcept -> CShaderResource<CImage>;
+
     RETINA_NODISCARD auto MakeImageView(
       const CImage& image,
       const SImageViewCreateInfo& createInfo,
@@ -65,23 +82,52 @@ namespace Retina::Graphics {
     auto GetImageResourceFromHandle(uint32 handle) const noexcept -> CShaderResource<CImage>;
     auto GetImageViewResourceFromHandle(uint32 handle) const noexcept -> CShaderResource<CImageView>;
 
+    // The slot is recycled and the resource released once the device is past the current main timeline value,
+    // frames still in flight may keep using it until then
     auto Destroy(CShaderResource<CSampler> handle) noexcept -> void;
     template <typename T>
     auto Destroy(CShaderResource<CTypedBuffer<T>> resource) noexcept -> void;
     auto Destroy(CShaderResource<CImage> handle) noexcept -> void;
     auto Destroy(CShaderResource<CImageView> handle) noexcept -> void;
 
+    // Descriptor set writes are queued and go out as a single update, every queue submission flushes them first
+    auto Flush() noexcept -> void;
+
   private:
+    struct SDescriptorBufferBinding {
+      usize Offset = 0;
+      usize Stride = 0;
+    };
+
+    struct SPendingDescriptorWrite {
+      EDescriptorType Type = {};
+      uint32 Slot = 0;
+      std::variant<SImageDescriptor, SBufferDescriptor> Descriptor;
+    };
+
+  private:
+    auto Write(std::span<const SDescriptorWriteInfo> writes) noexcept -> void;
+    auto DestroyBuffer(uint32 slot) noexcept -> void;
+
+  private:
+    // Guards the slot allocators and the storage, never held while a resource is created or destroyed
+    mutable std::mutex _slotMutex;
     Core::CSlotAllocator<MAX_SAMPLER_RESOURCE_SLOTS> _samplerSlots;
     Core::CSlotAllocator<MAX_BUFFER_RESOURCE_SLOTS> _bufferSlots;
     Core::CSlotAllocator<MAX_IMAGE_RESOURCE_SLOTS> _imageSlots;
 
-    std::array<Core::CArcPtr<CSampler>, MAX_SAMPLER_RESOURCE_SLOTS> _samplerStorage;
-    std::array<Core::CArcPtr<CBuffer>, MAX_BUFFER_RESOURCE_SLOTS> _bufferStorage;
-    std::array<Core::CArcPtr<CImage>, MAX_IMAGE_RESOURCE_SLOTS> _imageStorage;
-    std::array<Core::CArcPtr<CImageView>, MAX_IMAGE_RESOURCE_SLOTS> _imageViewStorage;
+    // Slots are handed out lowest first, so only the chunks covering the live resources are ever allocated
+    Core::CChunkedArray<Core::CArcPtr<CSampler>, MAX_SAMPLER_RESOURCE_SLOTS> _samplerStorage;
+    Core::CChunkedArray<Core::CArcPtr<CBuffer>, MAX_BUFFER_RESOURCE_SLOTS> _bufferStorage;
+    Core::CChunkedArray<Core::CArcPtr<CImage>, MAX_IMAGE_RESOURCE_SLOTS> _imageStorage;
+    Core::CChunkedArray<Core::CArcPtr<CImageView>, MAX_IMAGE_RESOURCE_SLOTS> _imageViewStorage;
 
+    Core::CArcPtr<CDescriptorLayout> _descriptorLayout;
     Core::CArcPtr<CDescriptorSet> _descriptorSet;
+    Core::CArcPtr<CBuffer> _descriptorBuffer;
+    std::vector<SDescriptorBufferBinding> _descriptorBufferBindings;
+    std::mutex _pendingWriteMutex;
+    std::vector<SPendingDescriptorWrite> _pendingWrites;
     Core::CArcPtr<CTypedBuffer<uint64>> _addressBuffer;
 
     Core::CReferenceWrapper<const CDevice> _device;
@@ -92,10 +138,13 @@ namespace Retina::Graphics {
     const SBufferCreateInfo& createInfo
   ) noexcept -> CShaderResource<CTypedBuffer<T>> {
     RETINA_PROFILE_SCOPED();
-    auto x = std::unique_ptr<T>();
     auto buffer = CTypedBuffer<T>::Make(_device, createInfo);
-    const auto slot = _bufferSlots.Allocate();
-    _bufferStorage[slot] = buffer;
+    auto slot = -1_u64;
+    {
+      const auto lock = std::lock_guard(_slotMutex);
+      slot = _bufferSlots.Allocate();
+      _bufferStorage[slot] = buffer;
+    }
     _addressBuffer->Write(buffer->GetAddress(), slot);
     return CShaderResource<CTypedBuffer<T>>::Make(*buffer, slot);
   }
@@ -109,11 +158,17 @@ namespace Retina::Graphics {
     auto buffers = CTypedBuffer<T>::Make(_device, count, createInfo);
     auto resources = std::vector<CShaderResource<CTypedBuffer<T>>>();
     resources.reserve(count);
+    auto slots = std::vector<uint64>(count);
+    {
+      const auto lock = std::lock_guard(_slotMutex);
+      for (auto i = 0_u32; i < count; ++i) {
+        slots[i] = _bufferSlots.Allocate();
+        _bufferStorage[slots[i]] = buffers[i];
+      }
+    }
     for (auto i = 0_u32; i < count; ++i) {
-      const auto slot = _bufferSlots.Allocate();
-      _bufferStorage[slot] = buffers[i];
-      _addressBuffer->Write(buffers[i]->GetAddress(), slot);
-      resources.emplace_back(CShaderResource<CTypedBuffer<T>>::Make(*buffers[i], slot));
+      _addressBuffer->Write(buffers[i]->GetAddress(), slots[i]);
+      resources.emplace_back(CShaderResource<CTypedBuffer<T>>::Make(*buffers[i], slots[i]));
     }
     return resources;
   }
@@ -121,12 +176,17 @@ namespace Retina::Graphics {
   template <typename T>
   auto CShaderResourceTable::IsAllocated(CShaderResource<CTypedBuffer<T>> handle) const noexcept -> bool {
     RETINA_PROFILE_SCOPED();
-    return handle.IsValid() && _bufferStorage[handle.GetHandle()];
+    if (!handle.IsValid()) {
+      return false;
+    }
+    const auto lock = std::lock_guard(_slotMutex);
+    return _bufferStorage[handle.GetHandle()];
   }
 
   template <typename T>
   auto CShaderResourceTable::GetBufferResourceFromHandle(uint32 handle) const noexcept -> CShaderResource<CTypedBuffer<T>> {
     RETINA_PROFILE_SCOPED();
+    const auto lock = std::lock_guard(_slotMutex);
     return CShaderResource<T>::Make(*_bufferStorage[handle], handle);
   }
 
@@ -134,8 +194,7 @@ namespace Retina::Graphics {
   auto CShaderResourceTable::Destroy(CShaderResource<CTypedBuffer<T>> handle) noexcept -> void {
     RETINA_PROFILE_SCOPED();
     if (handle.IsValid()) {
-      _bufferSlots.Free(handle.GetHandle());
-      _bufferStorage[handle.GetHandle()] = {};
+      DestroyBuffer(handle.GetHandle());
     }
   }
 }
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <Retina/Graphics/TransientResourcePoolInfo.hpp>
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+#include <span>
+#include <vector>
+
+namespace Retina::Graphics {
+  // Places render targets and scratch buffers with disjoint lifetimes in shared memory blocks.
+  // Images that are only ever used as attachments get lazily allocated memory when the device has it
+  class CTransientResourcePool {
+  public:
+    CTransientResourcePool(const CDevice& device) noexcept;
+    ~CTransientResourcePool() noexcept;
+    RETINA_DELETE_COPY(CTransientResourcePool);
+    RETINA_DEFAULT_MOVE(CTransientResourcePool);
+
+    RETINA_NODISCARD static auto Make(const CDevice& device) noexcept -> Core::CUniquePtr<CTransientResourcePool>;
+
+    // Indexed like the requests passed to the last "Allocate"
+    RETINA_NODISCARD auto GetImages() const noexcept -> std::span<const Core::CArcPtr<CImage>>;
+    RETINA_NODISCARD auto GetBuffers() const noexcept -> std::span<const Core::CArcPtr<CBuffer>>;
+
+    RETINA_NODISCARD auto GetStatistics() const noexcept -> const STransientResourcePoolStatistics&;
+    RETINA_NODISCARD auto GetDevice() const noexcept -> const CDevice&;
+
+    // Replaces every resource handed out before, the previous memory is released through the deletion queue
+    auto Allocate(
+      std::span<const STransientImageInfo> images,
+      std::span<const STransientBufferInfo> buffers = {}
+    ) noexcept -> void;
+
+  private:
+    auto Release() noexcept -> void;
+
+  private:
+    std::vector<VmaAllocation> _blocks;
+    std::vector<Core::CArcPtr<CImage>> _images;
+    std::vector<Core::CArcPtr<CBuffer>> _buffers;
+
+    STransientResourcePoolStatistics _statistics = {};
+
+    Core::CReferenceWrapper<const CDevice> _device;
+  };
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <Retina/Graphics/BufferInfo.hpp>
+#include <Retina/Graphics/Forward.hpp>
+#include <Retina/Graphics/ImageInfo.hpp>
+
+namespace Retina::Graphics {
+  // "FirstUse" and "LastUse" are an inclusive range of pass indices, resources whose ranges
+  // do not overlap may be placed in the same memory
+  struct STransientImageInfo {
+    SImageCreateInfo CreateInfo = {};
+    uint32 FirstUse = 0;
+    uint32 LastUse = 0;
+  };
+
+  struct STransientBufferInfo {
+    SBufferCreateInfo CreateInfo = {};
+    uint32 FirstUse = 0;
+    uint32 LastUse = 0;
+  };
+
+  struct STransientResourcePoolStatistics {
+    uint32 BlockCount = 0;
+    uint32 AliasedResourceCount = 0;
+    uint32 LazyImageCount = 0;
+    // Memory the aliased resources would take on their own, against what the blocks actually take
+    uint64 RequestedBytes = 0;
+    uint64 AllocatedBytes = 0;
+  };
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <limits>
+
+namespace Retina::Sandbox {
+  struct SAabb {
+    glm::vec3 Min = glm::vec3(std::numeric_limits<float32>::max());
+    glm::vec3 Max = glm::vec3(std::numeric_limits<float32>::lowest());
+  };
+
+  struct SSphere {
+    glm::vec3 Center = {};
+    float32 Radius = 0.0f;
+  };
+
+  // Plane normals point inwards, a point is inside if "dot(plane.xyz, point) + plane.w >= 0" for every plane
+  struct SFrustum {
+    std::array<glm::vec4, 6> Planes = {};
+  };
+
+  RETINA_NODISCARD auto IsAabbValid(const SAabb& aabb) noexcept -> bool;
+  RETINA_NODISCARD auto MakeAabbUnion(const SAabb& left, const SAabb& right) noexcept -> SAabb;
+  RETINA_NODISCARD auto GetAabbCenter(const SAabb& aabb) noexcept -> glm::vec3;
+  RETINA_NODISCARD auto GetAabbSurfaceArea(const SAabb& aabb) noexcept -> float32;
+  RETINA_NODISCARD auto TransformAabb(const SAabb& aabb, const glm::mat4& transform) noexcept -> SAabb;
+
+  // Works with any projection, the far plane of an infinite projection degenerates into a plane that always passes
+  RETINA_NODISCARD auto MakeFrustum(const glm::mat4& projView) noexcept -> SFrustum;
+}
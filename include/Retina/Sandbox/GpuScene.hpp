@@ -0,0 +1,176 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <Retina/Sandbox/GpuSceneBuffer.hpp>
+#include <Retina/Sandbox/MeshletModel.hpp>
+#include <Retina/Sandbox/Model.hpp>
+#include <Retina/Sandbox/RangeAllocator.hpp>
+#include <Retina/Sandbox/SceneBvh.hpp>
+#include <Retina/Sandbox/TransformSystem.hpp>
+
+#include <Retina/Graphics/Graphics.hpp>
+
+#include <glm/glm.hpp>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Retina::Sandbox {
+  struct SGpuSceneCreateInfo {
+    uint32 FramesInFlight = 1;
+  };
+
+  struct SGpuSceneRange {
+    uint32 Offset = 0;
+    uint32 Size = 0;
+  };
+
+  class CGpuScene {
+  private:
+    struct SModel {
+      SGpuSceneRange Meshlets;
+      SGpuSceneRange Vertices;
+      SGpuSceneRange Indices;
+      SGpuSceneRange Primitives;
+      SGpuSceneRange Materials;
+
+      // Offsets and indices are relative to the ranges above
+      std::vector<SMeshlet> LocalMeshlets;
+      std::vector<SMeshletInstance> LocalMeshletInstances;
+      std::vector<SNode> Nodes;
+      std::vector<SAabb> MeshBounds;
+      uint32 PrimitiveCount = 0;
+
+      std::vector<uint32> Instances;
+    };
+
+    struct SInstance {
+      uint32 Model = 0;
+      uint32 RootNode = 0;
+      uint32 FirstNode = 0;
+      std::vector<uint32> MeshletInstanceSlots;
+    };
+
+    struct SMeshletInstanceOwner {
+      uint32 Instance = 0;
+      uint32 Index = 0;
+    };
+
+  public:
+    CGpuScene(const Graphics::CDevice& device) noexcept;
+    ~CGpuScene() noexcept = default;
+    RETINA_DELETE_COPY_MOVE(CGpuScene);
+
+    RETINA_NODISCARD static auto Make(
+      const Graphics::CDevice& device,
+      const SGpuSceneCreateInfo& createInfo
+    ) noexcept -> Core::CUniquePtr<CGpuScene>;
+
+    RETINA_NODISCARD auto GetMeshletBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<SMeshlet>>&;
+    RETINA_NODISCARD auto GetMeshletInstanceBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<SMeshletInstance>>&;
+    RETINA_NODISCARD auto GetMaterialBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<SMaterial>>&;
+    RETINA_NODISCARD auto GetTransformBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<STransformRecord>>&;
+    RETINA_NODISCARD auto GetPositionBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<glm::vec3>>&;
+    RETINA_NODISCARD auto GetVertexBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<SMeshletVertex>>&;
+    RETINA_NODISCARD auto GetIndexBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<uint32>>&;
+    RETINA_NODISCARD auto GetPrimitiveBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<uint8>>&;
+
+    RETINA_NODISCARD auto GetMeshletInstanceCount() const noexcept -> uint32;
+    // Sum of the primitive counts of every meshlet instance, the upper bound of an expanded index buffer is three times this
+    RETINA_NODISCARD auto GetMeshletInstancePrimitiveCount() const noexcept -> uint32;
+
+    RETINA_NODISCARD auto GetTransformSystem() noexcept -> CTransformSystem&;
+    RETINA_NODISCARD auto GetTransformSystem() const noexcept -> const CTransformSystem&;
+    RETINA_NODISCARD auto GetInstanceRootNode(uint32 instance) const noexcept -> uint32;
+    // Items are transform nodes that reference a mesh, bounds are in world space
+    RETINA_NODISCARD auto GetBvh() const noexcept -> const CSceneBvh&;
+
+    // "materials" must already reference shader resource handles, material indices of the model index into it
+    RETINA_NODISCARD auto AddModel(const CMeshletModel& model, std::span<const SMaterial> materials) noexcept -> uint32;
+    // Also removes every instance of the model
+    auto RemoveModel(uint32 model) noexcept -> void;
+
+    auto AddInstance(uint32 model, const glm::mat4& transform = glm::mat4(1.0f)) noexcept -> uint32;
+    auto RemoveInstance(uint32 instance) noexcept -> void;
+
+    // Must be called exactly once per frame, before "Flush"
+    auto Update() noexcept -> void;
+    auto Flush(Graphics::CCommandBuffer& commands, uint32 frameIndex) noexcept -> void;
+
+  private:
+    RETINA_NODISCARD auto AllocateRange(CRangeAllocator& allocator, uint32 size) noexcept -> SGpuSceneRange;
+
+    RETINA_NODISCARD auto MakeMeshlet(const SModel& model, uint32 meshlet) const noexcept -> SMeshlet;
+    RETINA_NODISCARD auto MakeMeshletInstance(const SInstance& instance, uint32 meshletInstance) const noexcept -> SMeshletInstance;
+
+    auto WriteDirtyModels() noexcept -> void;
+    auto WriteDirtyMeshletInstances() noexcept -> void;
+    auto WriteDirtyTransforms() noexcept -> void;
+    auto UpdateBvh() noexcept -> void;
+
+    auto CompactGeometry() noexcept -> void;
+    RETINA_NODISCARD auto RelocateRange(CRangeAllocator& allocator, SGpuSceneRange& range) noexcept -> std::optional<uint32>;
+
+    template <typename F>
+    auto ForEachBuffer(F&& function) noexcept -> void;
+
+  private:
+    SGpuSceneCreateInfo _createInfo = {};
+
+    CGpuSceneBuffer<SMeshlet> _meshletBuffer;
+    CGpuSceneBuffer<SMeshletInstance> _meshletInstanceBuffer;
+    CGpuSceneBuffer<SMaterial> _materialBuffer;
+    CGpuSceneBuffer<STransformRecord> _transformBuffer;
+    CGpuSceneBuffer<glm::vec3> _positionBuffer;
+    CGpuSceneBuffer<SMeshletVertex> _vertexBuffer;
+    CGpuSceneBuffer<uint32> _indexBuffer;
+    CGpuSceneBuffer<uint8> _primitiveBuffer;
+
+    CRangeAllocator _meshletAllocator;
+    CRangeAllocator _vertexAllocator;
+    CRangeAllocator _indexAllocator;
+    CRangeAllocator _primitiveAllocator;
+    CRangeAllocator _materialAllocator;
+
+    CTransformSystem _transformSystem;
+
+    // Rebuilt when nodes are added or removed, refit when only transforms change
+    CSceneBvh _bvh;
+    std::vector<uint32> _bvhItems;
+    std::vector<SAabb> _nodeLocalBounds;
+    std::vector<SAabb> _nodeWorldBounds;
+    bool _isBvhDirty = false;
+
+    std::vector<std::optional<SModel>> _models;
+    std::vector<uint32> _freeModels;
+    std::vector<std::optional<SInstance>> _instances;
+    std::vector<uint32> _freeInstances;
+
+    // Meshlet instances stay densely packed, removal moves the last one into the hole
+    std::vector<SMeshletInstanceOwner> _meshletInstanceOwners;
+    uint32 _meshletInstancePrimitiveCount = 0;
+
+    // Records are written once per frame so no two copy regions of a flush overlap
+    std::vector<uint32> _dirtyModels;
+    std::vector<uint32> _dirtyMeshletInstances;
+
+    uint32 _compactionCursor = 0;
+
+    Core::CReferenceWrapper<const Graphics::CDevice> _device;
+  };
+
+  template <typename F>
+  auto CGpuScene::ForEachBuffer(F&& function) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    function(_meshletBuffer);
+    function(_meshletInstanceBuffer);
+    function(_materialBuffer);
+    function(_transformBuffer);
+    function(_positionBuffer);
+    function(_vertexBuffer);
+    function(_indexBuffer);
+    function(_primitiveBuffer);
+  }
+}
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <Retina/Graphics/Graphics.hpp>
+
+#include <algorithm>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Retina::Sandbox {
+  // Device local buffer that grows by reallocation plus a GPU copy, all writes and moves are recorded
+  // on the host and flushed into a command buffer once per frame
+  template <typename T>
+  class CGpuSceneBuffer {
+  public:
+    CGpuSceneBuffer() noexcept = default;
+    ~CGpuSceneBuffer() noexcept = default;
+    RETINA_DELETE_COPY(CGpuSceneBuffer);
+    RETINA_DEFAULT_MOVE(CGpuSceneBuffer);
+
+    // "Heap" is always device only, every reallocation is made with the same usage and queue domain
+    RETINA_NODISCARD RETINA_INLINE static auto Make(
+      const Graphics::CDevice& device,
+      Graphics::SBufferCreateInfo createInfo,
+      uint32 framesInFlight
+    ) noexcept -> CGpuSceneBuffer;
+
+    RETINA_NODISCARD RETINA_INLINE auto GetResource() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<T>>&;
+    RETINA_NODISCARD RETINA_INLINE auto GetHandle() const noexcept -> uint32;
+    // Includes growth that has not been flushed yet
+    RETINA_NODISCARD RETINA_INLINE auto GetCapacity() const noexcept -> usize;
+
+    RETINA_INLINE auto Reserve(usize capacity) noexcept -> void;
+    RETINA_INLINE auto Write(usize offset, const T& value) noexcept -> void;
+    RETINA_INLINE auto Write(usize offset, std::span<const T> values) noexcept -> void;
+    // Regions must not overlap each other, pending writes into the source range follow it to the destination
+    RETINA_INLINE auto Move(usize source, usize dest, usize count) noexcept -> void;
+    // Drops pending writes into a range that was freed before they were flushed
+    RETINA_INLINE auto Discard(usize offset, usize count) noexcept -> void;
+
+    RETINA_NODISCARD RETINA_INLINE auto HasPendingWork() const noexcept -> bool;
+
+    // Frees what was retired the last time "frameIndex" was flushed and performs the pending reallocation
+    RETINA_INLINE auto FlushGrowth(Graphics::CCommandBuffer& commands, uint32 frameIndex) noexcept -> void;
+    RETINA_INLINE auto FlushMoves(Graphics::CCommandBuffer& commands) noexcept -> void;
+    RETINA_INLINE auto FlushWrites(Graphics::CCommandBuffer& commands, uint32 frameIndex) noexcept -> void;
+
+  private:
+    // Splits pending writes that straddle "byteOffset" in the destination so ranges can be handled as a whole
+    RETINA_INLINE auto SplitPendingWrites(usize byteOffset) noexcept -> void;
+
+  private:
+    const Graphics::CDevice* _device = nullptr;
+    Graphics::SBufferCreateInfo _createInfo = {};
+    usize _capacity = 0;
+    Graphics::CShaderResource<Graphics::CTypedBuffer<T>> _buffer;
+
+    std::vector<T> _pendingValues;
+    std::vector<Graphics::SBufferCopyRegion> _pendingWrites;
+    std::vector<Graphics::SBufferCopyRegion> _pendingMoves;
+
+    std::vector<std::vector<Graphics::CShaderResource<Graphics::CTypedBuffer<T>>>> _retiredBuffers;
+    std::vector<Core::CArcPtr<Graphics::CTypedBuffer<T>>> _stagingBuffers;
+  };
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::Make(
+    const Graphics::CDevice& device,
+    Graphics::SBufferCreateInfo createInfo,
+    uint32 framesInFlight
+  ) noexcept -> CGpuSceneBuffer {
+    RETINA_PROFILE_SCOPED();
+    auto self = CGpuSceneBuffer();
+    self._device = &device;
+    self._capacity = std::max<usize>(createInfo.Capacity, 1);
+    self._createInfo = std::move(createInfo);
+    self._createInfo.Heap = Graphics::EHeapType::E_DEVICE_ONLY;
+    self._createInfo.Capacity = self._capacity;
+    self._buffer = device.GetShaderResourceTable().MakeBuffer<T>(self._createInfo);
+    self._retiredBuffers.resize(framesInFlight);
+    self._stagingBuffers.resize(framesInFlight);
+    return self;
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::GetResource() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<T>>& {
+    RETINA_PROFILE_SCOPED();
+    return _buffer;
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::GetHandle() const noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    return _buffer.GetHandle();
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::GetCapacity() const noexcept -> usize {
+    RETINA_PROFILE_SCOPED();
+    return _capacity;
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::Reserve(usize capacity) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (capacity > _capacity) {
+      _capacity = std::max(capacity, _capacity * 2);
+    }
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::Write(usize offset, const T& value) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    Write(offset, std::span(&value, 1));
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::Write(usize offset, std::span<const T> values) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (values.empty()) {
+      return;
+    }
+    RETINA_ASSERT_WITH(offset + values.size() <= _capacity, "Write out of bounds");
+    const auto sourceOffset = _pendingValues.size() * sizeof(T);
+    const auto destOffset = offset * sizeof(T);
+    _pendingValues.insert(_pendingValues.end(), values.begin(), values.end());
+    // Consecutive writes into consecutive elements collapse into a single copy region
+    if (!_pendingWrites.empty()) {
+      auto& last = _pendingWrites.back();
+      if (last.SourceOffset + last.Size == sourceOffset && last.DestOffset + last.Size == destOffset) {
+        last.Size += values.size_bytes();
+        return;
+      }
+    }
+    _pendingWrites.push_back({
+      .SourceOffset = sourceOffset,
+      .DestOffset = destOffset,
+      .Size = values.size_bytes(),
+    });
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::Move(usize source, usize dest, usize count) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (count == 0 || source == dest) {
+      return;
+    }
+    const auto sourceBegin = source * sizeof(T);
+    const auto sourceEnd = (source + count) * sizeof(T);
+    SplitPendingWrites(sourceBegin);
+    SplitPendingWrites(sourceEnd);
+    for (auto& write : _pendingWrites) {
+      if (write.DestOffset >= sourceBegin && write.DestOffset + write.Size <= sourceEnd) {
+        write.DestOffset = write.DestOffset - sourceBegin + dest * sizeof(T);
+      }
+    }
+    _pendingMoves.push_back({
+      .SourceOffset = sourceBegin,
+      .DestOffset = dest * sizeof(T),
+      .Size = count * sizeof(T),
+    });
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::Discard(usize offset, usize count) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto begin = offset * sizeof(T);
+    const auto end = (offset + count) * sizeof(T);
+    SplitPendingWrites(begin);
+    SplitPendingWrites(end);
+    std::erase_if(_pendingWrites, [&](const Graphics::SBufferCopyRegion& write) noexcept {
+      return write.DestOffset >= begin && write.DestOffset + write.Size <= end;
+    });
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::HasPendingWork() const noexcept -> bool {
+    RETINA_PROFILE_SCOPED();
+    return _capacity > _buffer->GetCapacity() || !_pendingWrites.empty() || !_pendingMoves.empty();
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::SplitPendingWrites(usize byteOffset) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto writeCount = _pendingWrites.size();
+    for (auto i = 0_u64; i < writeCount; ++i) {
+      auto& write = _pendingWrites[i];
+      if (write.DestOffset < byteOffset && byteOffset < write.DestOffset + write.Size) {
+        const auto headSize = byteOffset - write.DestOffset;
+        const auto tail = Graphics::SBufferCopyRegion {
+          .SourceOffset = write.SourceOffset + headSize,
+          .DestOffset = byteOffset,
+          .Size = write.Size - headSize,
+        };
+        write.Size = headSize;
+        _pendingWrites.push_back(tail);
+      }
+    }
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::FlushGrowth(Graphics::CCommandBuffer& commands, uint32 frameIndex) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    // The GPU finished the last frame that used this slot, nothing retired back then is referenced anymore
+    for (const auto& buffer : _retiredBuffers[frameIndex]) {
+      _device->GetShaderResourceTable().Destroy(buffer);
+    }
+    _retiredBuffers[frameIndex].clear();
+
+    if (_capacity <= _buffer->GetCapacity()) {
+      return;
+    }
+    _createInfo.Capacity = _capacity;
+    auto buffer = _device->GetShaderResourceTable().MakeBuffer<T>(_createInfo);
+    commands.CopyBuffer(*_buffer, *buffer, {});
+    _retiredBuffers[frameIndex].emplace_back(_buffer);
+    _buffer = buffer;
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::FlushMoves(Graphics::CCommandBuffer& commands) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    commands.CopyBufferRegions(*_buffer, *_buffer, _pendingMoves);
+    _pendingMoves.clear();
+  }
+
+  template <typename T>
+  auto CGpuSceneBuffer<T>::FlushWrites(Graphics::CCommandBuffer& commands, uint32 frameIndex) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (_pendingWrites.empty()) {
+      return;
+    }
+    // Each frame in flight owns one persistently mapped staging buffer, by now the GPU is done reading it
+    auto& stagingBuffer = _stagingBuffers[frameIndex];
+    if (!stagingBuffer || stagingBuffer->GetCapacity() < _pendingValues.size()) {
+      const auto capacity = stagingBuffer
+        ? std::max(_pendingValues.size(), stagingBuffer->GetCapacity() * 2)
+        : _pendingValues.size();
+      stagingBuffer = Graphics::CTypedBuffer<T>::Make(*_device, {
+        .Name = _createInfo.Name + "Staging" + std::to_string(frameIndex),
+        .Heap = Graphics::EHeapType::E_HOST_ONLY_COHERENT,
+        .Capacity = capacity,
+        .Usage = Graphics::EBufferUsageFlag::E_TRANSFER_SRC,
+        .Domain = _createInfo.Domain,
+      });
+    }
+    stagingBuffer->Write(std::span<const T>(_pendingValues));
+    commands.CopyBufferRegions(*stagingBuffer, *_buffer, _pendingWrites);
+    _pendingValues.clear();
+    _pendingWrites.clear();
+  }
+}
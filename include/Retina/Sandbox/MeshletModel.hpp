@@ -2,6 +2,7 @@
 
 #include <Retina/Core/Core.hpp>
 
+#include <Retina/Sandbox/Bounds.hpp>
 #include <Retina/Sandbox/Model.hpp>
 
 #include <expected>
@@ -38,7 +39,9 @@ namespace Retina::Sandbox {
 
     RETINA_NODISCARD auto GetMeshlets() const noexcept -> std::span<const SMeshlet>;
     RETINA_NODISCARD auto GetMeshletInstances() const noexcept -> std::span<const SMeshletInstance>;
-    RETINA_NODISCARD auto GetTransforms() const noexcept -> std::span<const glm::mat4>;
+    RETINA_NODISCARD auto GetNodes() const noexcept -> std::span<const SNode>;
+    // Object space bounds, indexed by "SNode::Mesh"
+    RETINA_NODISCARD auto GetMeshBounds() const noexcept -> std::span<const SAabb>;
     RETINA_NODISCARD auto GetPositions() const noexcept -> std::span<const glm::vec3>;
     RETINA_NODISCARD auto GetVertices() const noexcept -> std::span<const SMeshletVertex>;
     RETINA_NODISCARD auto GetIndices() const noexcept -> std::span<const uint32>;
@@ -49,7 +52,7 @@ namespace Retina::Sandbox {
   private:
     std::vector<SMeshlet> _meshlets;
     std::vector<SMeshletInstance> _meshletInstances;
-    std::vector<glm::mat4> _transforms;
+    std::vector<SAabb> _meshBounds;
     std::vector<glm::vec3> _positions;
     std::vector<SMeshletVertex> _vertices;
     std::vector<uint32> _indices;
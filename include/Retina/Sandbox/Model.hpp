@@ -31,8 +31,9 @@ namespace Retina::Sandbox {
   };
 
   struct SNode {
-    uint32 Mesh = 0;
-    glm::mat4 Transform = {};
+    uint32 Parent = -1_u32;
+    uint32 Mesh = -1_u32;
+    glm::mat4 LocalTransform = {};
   };
 
   struct STexture {
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <map>
+#include <optional>
+
+namespace Retina::Sandbox {
+  // First-fit free-list allocator over a linear range of elements, adjacent free blocks are coalesced
+  class CRangeAllocator {
+  public:
+    CRangeAllocator() noexcept = default;
+    ~CRangeAllocator() noexcept = default;
+    RETINA_DEFAULT_COPY_MOVE(CRangeAllocator);
+
+    RETINA_NODISCARD static auto Make(uint32 capacity) noexcept -> CRangeAllocator;
+
+    RETINA_NODISCARD auto GetCapacity() const noexcept -> uint32;
+    RETINA_NODISCARD auto GetUsedSize() const noexcept -> uint32;
+    RETINA_NODISCARD auto GetFreeSize() const noexcept -> uint32;
+    RETINA_NODISCARD auto GetFreeBlockCount() const noexcept -> usize;
+
+    RETINA_NODISCARD auto Allocate(uint32 size) noexcept -> std::optional<uint32>;
+    // Only succeeds if the allocation ends at or before "limit", used to move allocations towards the front
+    RETINA_NODISCARD auto AllocateBelow(uint32 size, uint32 limit) noexcept -> std::optional<uint32>;
+    auto Free(uint32 offset, uint32 size) noexcept -> void;
+    auto Grow(uint32 capacity) noexcept -> void;
+
+  private:
+    auto AllocateFromBlock(std::map<uint32, uint32>::iterator block, uint32 size) noexcept -> uint32;
+
+  private:
+    uint32 _capacity = 0;
+    uint32 _usedSize = 0;
+    std::map<uint32, uint32> _freeBlocks;
+  };
+}
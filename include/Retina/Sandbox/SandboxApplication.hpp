@@ -5,6 +5,8 @@
 #include <Retina/Sandbox/Camera.hpp>
 #include <Retina/Sandbox/FrameCounter.hpp>
 #include <Retina/Sandbox/FrameTimer.hpp>
+#include <Retina/Sandbox/GpuScene.hpp>
+#include <Retina/Sandbox/GpuSceneBuffer.hpp>
 #include <Retina/Sandbox/Logger.hpp>
 #include <Retina/Sandbox/MeshletModel.hpp>
 #include <Retina/Sandbox/Model.hpp>
@@ -26,6 +28,15 @@
 #define FRAMES_IN_FLIGHT 2
 
 namespace Retina::Sandbox {
+  // Only defined here, the material passes get both as specialization constants
+  constexpr auto MATERIAL_TILE_SIZE = 8_u32;
+  constexpr auto MATERIAL_SHADER_COUNT = 4_u32;
+  // Classification bins a tile with one invocation per material shader
+  static_assert(MATERIAL_TILE_SIZE * MATERIAL_TILE_SIZE >= MATERIAL_SHADER_COUNT);
+
+  // Pass callbacks only read state that stays put while the graph records, so they may run concurrently
+  constexpr auto RENDER_GRAPH_RECORDING_THREAD_COUNT = 4_u32;
+
   struct SViewInfo {
     glm::mat4 Projection = {};
     glm::mat4 PrevProjection = {};
@@ -57,6 +68,7 @@ namespace Retina::Sandbox {
     auto GetCurrentFrameIndex() noexcept -> uint32;
 
     auto InitializeGUI() noexcept -> void;
+    auto InitializeRenderTargets() noexcept -> void;
     auto InitializeTonemapPass() noexcept -> void;
     auto InitializeVisbufferPass() noexcept -> void;
     auto InitializeVisbufferResolvePass() noexcept -> void;
@@ -70,8 +82,6 @@ namespace Retina::Sandbox {
 
     CFrameTimer _timer = {};
 
-    CMeshletModel _model = {};
-
     Core::CUniquePtr<CCamera> _camera;
 
     Core::CUniquePtr<WSI::CWindow> _window;
@@ -80,7 +90,12 @@ namespace Retina::Sandbox {
     Core::CArcPtr<Graphics::CInstance> _instance;
     Core::CArcPtr<Graphics::CDevice> _device;
     Core::CArcPtr<Graphics::CSwapchain> _swapchain;
-    std::vector<Core::CArcPtr<Graphics::CCommandBuffer>> _commandBuffers;
+    Core::CUniquePtr<Graphics::CCommandPoolAllocator> _commandPools;
+    Core::CUniquePtr<Graphics::CRenderGraph> _renderGraph;
+    // Every render target below lives in here, sharing memory where their lifetimes allow it
+    Core::CUniquePtr<Graphics::CTransientResourcePool> _transientPool;
+    // Pass pipelines are built concurrently, they are ready once "Wait" returns
+    Core::CUniquePtr<Graphics::CPipelineBuilder> _pipelineBuilder;
 
     std::vector<Core::CArcPtr<Graphics::CBinarySemaphore>> _imageAvailableSemaphores;
     std::vector<Core::CArcPtr<Graphics::CBinarySemaphore>> _presentReadySemaphores;
@@ -88,14 +103,8 @@ namespace Retina::Sandbox {
 
     std::vector<Graphics::CShaderResource<Graphics::CTypedBuffer<SViewInfo>>> _viewBuffer;
 
-    Graphics::CShaderResource<Graphics::CTypedBuffer<SMeshlet>> _meshletBuffer;
-    Graphics::CShaderResource<Graphics::CTypedBuffer<SMeshletInstance>> _meshletInstanceBuffer;
-    Graphics::CShaderResource<Graphics::CTypedBuffer<SMaterial>> _materialBuffer;
-    Graphics::CShaderResource<Graphics::CTypedBuffer<glm::mat4>> _transformBuffer;
-    Graphics::CShaderResource<Graphics::CTypedBuffer<glm::vec3>> _positionBuffer;
-    Graphics::CShaderResource<Graphics::CTypedBuffer<SMeshletVertex>> _vertexBuffer;
-    Graphics::CShaderResource<Graphics::CTypedBuffer<uint32>> _indexBuffer;
-    Graphics::CShaderResource<Graphics::CTypedBuffer<uint8>> _primitiveBuffer;
+    Core::CUniquePtr<CGpuScene> _scene;
+    std::vector<SBvhRange> _visibleNodeRanges;
 
     std::vector<Graphics::CShaderResource<Graphics::CImage>> _textures;
     Graphics::CShaderResource<Graphics::CSampler> _linearSampler;
@@ -118,6 +127,13 @@ namespace Retina::Sandbox {
       Graphics::CShaderResource<Graphics::CImage> VelocityImage;
       Graphics::CShaderResource<Graphics::CImage> DepthImage;
       Core::CArcPtr<Graphics::CMeshShadingPipeline> MainPipeline;
+
+      // Vertex shader path for devices without mesh shaders
+      CGpuSceneBuffer<Graphics::SDrawIndexedIndirectCommand> DrawCommandBuffer;
+      Graphics::CShaderResource<Graphics::CTypedBuffer<uint32>> DrawCountBuffer;
+      CGpuSceneBuffer<uint32> ExpandedIndexBuffer;
+      Core::CArcPtr<Graphics::CComputePipeline> ExpandPipeline;
+      Core::CArcPtr<Graphics::CGraphicsPipeline> FallbackPipeline;
     } _visbuffer;
 
     struct {
@@ -126,7 +142,14 @@ namespace Retina::Sandbox {
       Graphics::CShaderResource<Graphics::CImage> AlbedoImage;
       Graphics::CShaderResource<Graphics::CImage> NormalImage;
       Graphics::CShaderResource<Graphics::CImage> ShaderMaterialIdImage;
-      Core::CArcPtr<Graphics::CGraphicsPipeline> MainPipeline;
+
+      uint32 TileCapacity = 0;
+      Graphics::CShaderResource<Graphics::CTypedBuffer<uint32>> TileBuffer;
+      Graphics::CShaderResource<Graphics::CTypedBuffer<Graphics::SDispatchIndirectCommand>> TileDispatchBuffer;
+      Core::CArcPtr<Graphics::CTypedBuffer<Graphics::SDispatchIndirectCommand>> TileDispatchResetBuffer;
+      Core::CArcPtr<Graphics::CComputePipeline> ClassifyPipeline;
+      // Indexed by material shader, each one specialized on its "SHADER_ID"
+      std::array<Core::CArcPtr<Graphics::CComputePipeline>, MATERIAL_SHADER_COUNT> ShadePipelines;
     } _visbufferResolve;
 
     struct {
@@ -161,6 +184,7 @@ namespace Retina::Sandbox {
 
       Graphics::CShaderResource<Graphics::CImage> MainImage;
       Core::CArcPtr<Graphics::CGraphicsPipeline> MainPipeline;
+      Core::CArcPtr<Graphics::CGraphicsPipeline> PassthroughPipeline;
       Core::CArcPtr<Graphics::CGraphicsPipeline> CopyPipeline;
     } _tonemap;
   };
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <Retina/Sandbox/Bounds.hpp>
+
+#include <span>
+#include <vector>
+
+namespace Retina::Sandbox {
+  struct SBvhNode {
+    SAabb Bounds = {};
+    // Every subtree covers a contiguous range of the item list, interior nodes included
+    uint32 FirstItem = 0;
+    uint32 ItemCount = 0;
+    // Index of the left child, the right child directly follows it, -1 for leaves
+    uint32 Child = -1;
+    uint32 Parent = -1;
+  };
+
+  struct SBvhRange {
+    uint32 Offset = 0;
+    uint32 Count = 0;
+  };
+
+  // Binned SAH bounding volume hierarchy over arbitrary items, queries return ranges of "GetItems()"
+  class CSceneBvh {
+  public:
+    CSceneBvh() noexcept = default;
+    ~CSceneBvh() noexcept = default;
+    RETINA_DELETE_COPY(CSceneBvh);
+    RETINA_DEFAULT_MOVE(CSceneBvh);
+
+    // "bounds" is indexed by item, only the items listed in "items" are inserted
+    RETINA_NODISCARD static auto Make(std::span<const uint32> items, std::span<const SAabb> bounds) noexcept -> CSceneBvh;
+
+    RETINA_NODISCARD auto GetNodes() const noexcept -> std::span<const SBvhNode>;
+    RETINA_NODISCARD auto GetItems() const noexcept -> std::span<const uint32>;
+
+    // Only walks the ancestors of "dirtyItems", the topology is kept so quality degrades with large movement
+    auto Refit(std::span<const SAabb> bounds, std::span<const uint32> dirtyItems) noexcept -> void;
+
+    // Ranges are appended to "ranges", adjacent ranges are merged
+    auto QueryFrustum(const SFrustum& frustum, std::vector<SBvhRange>& ranges) const noexcept -> void;
+    auto QuerySphere(const SSphere& sphere, std::vector<SBvhRange>& ranges) const noexcept -> void;
+
+  private:
+    auto BuildLevel(std::span<const uint32> level, std::span<const SAabb> bounds, std::vector<uint32>& nextLevel) noexcept -> void;
+
+  private:
+    std::vector<SBvhNode> _nodes;
+    std::vector<uint32> _items;
+
+    // Indexed by item slot, the position of an item in "_items"
+    std::vector<SAabb> _itemBounds;
+    std::vector<uint32> _itemLeaves;
+
+    // Indexed by item, -1 if the item is not part of the hierarchy
+    std::vector<uint32> _itemSlots;
+
+    std::vector<uint32> _refitNodes;
+    std::vector<uint8> _isRefitQueued;
+  };
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <Retina/Core/Core.hpp>
+
+#include <Retina/Sandbox/Model.hpp>
+#include <Retina/Sandbox/RangeAllocator.hpp>
+
+#include <glm/glm.hpp>
+
+#include <span>
+#include <vector>
+
+namespace Retina::Sandbox {
+  // Matches the scalar layout of "STransform" in Meshlet.glsl
+  struct STransformRecord {
+    glm::mat4 World = {};
+    glm::mat4 PrevWorld = {};
+    glm::mat3 Normal = {};
+  };
+  static_assert(sizeof(STransformRecord) == 164, "Invalid transform record size");
+
+  class CTransformSystem {
+  public:
+    CTransformSystem() noexcept = default;
+    ~CTransformSystem() noexcept = default;
+    RETINA_DELETE_COPY(CTransformSystem);
+    RETINA_DEFAULT_MOVE(CTransformSystem);
+
+    // Number of node slots, node indices are always below this value
+    RETINA_NODISCARD auto GetCapacity() const noexcept -> usize;
+    RETINA_NODISCARD auto GetNodeCount() const noexcept -> usize;
+    RETINA_NODISCARD auto GetParent(uint32 node) const noexcept -> uint32;
+    RETINA_NODISCARD auto GetLocalTransform(uint32 node) const noexcept -> const glm::mat4&;
+    RETINA_NODISCARD auto GetWorldTransform(uint32 node) const noexcept -> const glm::mat4&;
+    RETINA_NODISCARD auto GetPrevWorldTransform(uint32 node) const noexcept -> const glm::mat4&;
+
+    // Node indices whose record changed during the last call to Update, sorted in ascending order
+    RETINA_NODISCARD auto GetDirtyRecords() const noexcept -> std::span<const uint32>;
+    RETINA_NODISCARD auto MakeRecord(uint32 node) const noexcept -> STransformRecord;
+
+    // Node parents are relative to "nodes", root nodes are attached to "parent", returns the index of the first node
+    auto AddNodes(std::span<const SNode> nodes, uint32 parent = -1_u32) noexcept -> uint32;
+    // Children outside of the removed range are not reparented, they have to be removed as well
+    auto RemoveNodes(uint32 firstNode, uint32 count) noexcept -> void;
+    auto SetLocalTransform(uint32 node, const glm::mat4& transform) noexcept -> void;
+
+    // Must be called exactly once per frame, the previous world transforms are rotated here
+    auto Update() noexcept -> void;
+
+  private:
+    // Dirty roots head disjoint subtrees, each one is walked on its own thread into its own list of changed nodes
+    struct SDirtySubtree {
+      uint32 Root = -1_u32;
+      std::vector<uint32> ChangedNodes;
+    };
+
+    auto Reserve(uint32 capacity) noexcept -> void;
+    auto RebuildChildren() noexcept -> void;
+    // Recomputes the world transform of the subtree root and everything below it, only touches nodes of that subtree
+    auto PropagateSubtree(SDirtySubtree& subtree) noexcept -> void;
+
+  private:
+    CRangeAllocator _nodeAllocator = {};
+
+    std::vector<uint32> _parents;
+    std::vector<glm::mat4> _localTransforms;
+    std::vector<glm::mat4> _worldTransforms;
+    std::vector<glm::mat4> _prevWorldTransforms;
+    std::vector<uint8> _isAlive;
+    std::vector<uint8> _isNew;
+    std::vector<uint8> _isDirty;
+
+    // Children of every node, "_childOffsets[node]" is the first entry of "node" in "_children"
+    std::vector<uint32> _childOffsets;
+    std::vector<uint32> _children;
+    bool _isTopologyDirty = false;
+
+    // Nodes marked dirty since the last update, Update only walks the subtrees below them
+    std::vector<uint32> _dirtyNodes;
+    // Only the first "_dirtySubtreeCount" entries belong to the current update, the rest keep their storage around
+    std::vector<SDirtySubtree> _dirtySubtrees;
+    uint32 _dirtySubtreeCount = 0;
+    std::vector<uint32> _changedNodes;
+    std::vector<uint32> _dirtyRecords;
+    std::vector<uint32> _mergedDirtyRecords;
+  };
+}
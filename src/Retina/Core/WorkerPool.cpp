@@ -0,0 +1,74 @@
+#include <Retina/Core/WorkerPool.hpp>
+
+#include <algorithm>
+
+namespace Retina::Core {
+  namespace Details {
+    thread_local constinit auto CURRENT_WORKER_INDEX = -1_u32;
+  }
+
+  CWorkerPool::~CWorkerPool() noexcept {
+    RETINA_PROFILE_SCOPED();
+    {
+      const auto lock = std::lock_guard(_mutex);
+      _isStopping = true;
+    }
+    _condition.notify_all();
+    // Workers drain the queue before they exit, every future handed out is satisfied
+    _workers.clear();
+  }
+
+  auto CWorkerPool::Make(uint32 workerCount) noexcept -> CUniquePtr<CWorkerPool> {
+    RETINA_PROFILE_SCOPED();
+    if (workerCount == 0) {
+      workerCount = std::max(std::thread::hardware_concurrency(), 1_u32);
+    }
+    auto self = MakeUnique<CWorkerPool>();
+    self->_workers.reserve(workerCount);
+    for (auto i = 0_u32; i < workerCount; ++i) {
+      self->_workers.emplace_back([pool = self.Get(), i] {
+        pool->Run(i);
+      });
+    }
+    return self;
+  }
+
+  auto CWorkerPool::GetWorkerCount() const noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    return _workers.size();
+  }
+
+  auto CWorkerPool::GetWorkerIndex() noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    return Details::CURRENT_WORKER_INDEX;
+  }
+
+  auto CWorkerPool::Enqueue(TaskFunction task) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    {
+      const auto lock = std::lock_guard(_mutex);
+      _tasks.emplace_back(std::move(task));
+    }
+    _condition.notify_one();
+  }
+
+  auto CWorkerPool::Run(uint32 workerIndex) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    Details::CURRENT_WORKER_INDEX = workerIndex;
+    while (true) {
+      auto task = TaskFunction();
+      {
+        auto lock = std::unique_lock(_mutex);
+        _condition.wait(lock, [this] {
+          return _isStopping || !_tasks.empty();
+        });
+        if (_tasks.empty()) {
+          return;
+        }
+        task = std::move(_tasks.front());
+        _tasks.pop_front();
+      }
+      task();
+    }
+  }
+}
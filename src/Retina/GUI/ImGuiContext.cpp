@@ -6,6 +6,7 @@
 #include <Retina/Graphics/GraphicsPipeline.hpp>
 #include <Retina/Graphics/Image.hpp>
 #include <Retina/Graphics/ImageView.hpp>
+#include <Retina/Graphics/PipelineBuilder.hpp>
 #include <Retina/Graphics/Sampler.hpp>
 #include <Retina/Graphics/Queue.hpp>
 
@@ -56,6 +57,38 @@ namespace Retina::GUI {
   ) noexcept -> Core::CUniquePtr<CImGuiContext> {
     RETINA_PROFILE_SCOPED();
     auto self = Core::MakeUnique<CImGuiContext>(window, device);
+
+    // Compiles while the font atlas is built and uploaded below
+    auto pipelineBuilder = Graphics::CPipelineBuilder::Make(device);
+    const auto pipeline = pipelineBuilder->Build(Graphics::SGraphicsPipelineCreateInfo {
+      .Name = "ImGuiContext_MainPipeline",
+      .VertexShader = Details::WithShaderPath("ImGui.vert.glsl"),
+      .FragmentShader = Details::WithShaderPath("ImGui.frag.glsl"),
+      .DescriptorLayouts = { device.GetShaderResourceTable().GetDescriptorLayout() },
+      .ColorBlendState = {
+        .Attachments = {
+          {
+            .BlendEnable = true,
+            .SourceColorBlendFactor = Graphics::EBlendFactor::E_ONE,
+            .DestColorBlendFactor = Graphics::EBlendFactor::E_ONE_MINUS_SRC_ALPHA,
+            .ColorBlendOperator = Graphics::EBlendOperator::E_ADD,
+            .SourceAlphaBlendFactor = Graphics::EBlendFactor::E_ONE,
+            .DestAlphaBlendFactor = Graphics::EBlendFactor::E_ONE_MINUS_SRC_ALPHA,
+            .AlphaBlendOperator = Graphics::EBlendOperator::E_ADD,
+          }
+        }
+      },
+      .DynamicState = { {
+        Graphics::EDynamicState::E_VIEWPORT,
+        Graphics::EDynamicState::E_SCISSOR,
+      } },
+      .RenderingInfo = { {
+        .ColorAttachmentFormats = {
+          Graphics::EResourceFormat::E_R16G16B16A16_SFLOAT,
+        },
+      } }
+    });
+
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
     ImGui::StyleColorsDark();
@@ -76,11 +109,13 @@ namespace Retina::GUI {
       .Name = "ImGuiContext_MainVertexBufferStaging",
       .Heap = Graphics::EHeapType::E_HOST_ONLY_CACHED,
       .Capacity = 1 << 20,
+      .Usage = Graphics::EBufferUsageFlag::E_TRANSFER_SRC,
     });
     auto indexBufferStaging = Graphics::CTypedBuffer<uint16>::Make(device, createInfo.MaxTimelineDifference, {
       .Name = "ImGuiContext_MainIndexBufferStaging",
       .Heap = Graphics::EHeapType::E_HOST_ONLY_CACHED,
       .Capacity = 1 << 20,
+      .Usage = Graphics::EBufferUsageFlag::E_TRANSFER_SRC,
     });
     auto vertexBuffer = device.GetShaderResourceTable().MakeBuffer<SVertexFormat>({
       .Name = "ImGuiContext_MainVertexBuffer",
@@ -91,34 +126,7 @@ namespace Retina::GUI {
       .Name = "ImGuiContext_MainIndexBuffer",
       .Heap = Graphics::EHeapType::E_DEVICE_ONLY,
       .Capacity = 1 << 20,
-    });
-    auto pipeline = Graphics::CGraphicsPipeline::Make(device, {
-      .Name = "ImGuiContext_MainPipeline",
-      .VertexShader = Details::WithShaderPath("ImGui.vert.glsl"),
-      .FragmentShader = Details::WithShaderPath("ImGui.frag.glsl"),
-      .DescriptorLayouts = { device.GetShaderResourceTable().GetDescriptorLayout() },
-      .ColorBlendState = {
-        .Attachments = {
-          {
-            .BlendEnable = true,
-            .SourceColorBlendFactor = Graphics::EBlendFactor::E_ONE,
-            .DestColorBlendFactor = Graphics::EBlendFactor::E_ONE_MINUS_SRC_ALPHA,
-            .ColorBlendOperator = Graphics::EBlendOperator::E_ADD,
-            .SourceAlphaBlendFactor = Graphics::EBlendFactor::E_ONE,
-            .DestAlphaBlendFactor = Graphics::EBlendFactor::E_ONE_MINUS_SRC_ALPHA,
-            .AlphaBlendOperator = Graphics::EBlendOperator::E_ADD,
-          }
-        }
-      },
-      .DynamicState = { {
-        Graphics::EDynamicState::E_VIEWPORT,
-        Graphics::EDynamicState::E_SCISSOR,
-      } },
-      .RenderingInfo = { {
-        .ColorAttachmentFormats = {
-          Graphics::EResourceFormat::E_R16G16B16A16_SFLOAT,
-        },
-      } }
+      .Usage = Graphics::DEFAULT_BUFFER_USAGE_FLAGS | Graphics::EBufferUsageFlag::E_INDEX_BUFFER,
     });
 
     auto fontSampler = device.GetShaderResourceTable().MakeSampler({
@@ -149,6 +157,7 @@ namespace Retina::GUI {
         .Name = "ImGuiContext_FontStagingBuffer",
         .Heap = Graphics::EHeapType::E_HOST_ONLY_CACHED,
         .Capacity = static_cast<uint32>(width * height),
+        .Usage = Graphics::EBufferUsageFlag::E_TRANSFER_SRC,
       });
       staging->Write({
         reinterpret_cast<uint32*>(pixels),
@@ -189,7 +198,7 @@ namespace Retina::GUI {
     self->_indexBuffer = indexBuffer;
     self->_fontTexture = fontTexture;
     self->_fontSampler = fontSampler;
-    self->_pipeline = std::move(pipeline);
+    self->_pipeline = pipeline.get();
     self->_createInfo = createInfo;
     return self;
   }
@@ -12,21 +12,6 @@
 
 namespace Retina::Graphics {
   namespace Details {
-    constexpr static auto DEFAULT_BUFFER_USAGE_FLAGS =
-      VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
-      VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
-      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-      VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
-      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
-      VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
-      VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
-      VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-      VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR |
-      VK_BUFFER_USAGE_SHADER_BINDING_TABLE_BIT_KHR |
-      VK_BUFFER_USAGE_MICROMAP_BUILD_INPUT_READ_ONLY_BIT_EXT |
-      VK_BUFFER_USAGE_MICROMAP_STORAGE_BIT_EXT;
-
     RETINA_NODISCARD RETINA_INLINE auto GetBufferDeviceAddress(
       const CDevice& device,
       VkBuffer buffer
@@ -36,6 +21,51 @@ namespace Retina::Graphics {
       bufferDeviceAddressInfo.buffer = buffer;
       return vkGetBufferDeviceAddress(device.GetHandle(), &bufferDeviceAddressInfo);
     }
+
+    RETINA_NODISCARD RETINA_INLINE auto GetBufferQueueFamilyIndices(
+      const CDevice& device,
+      const SBufferCreateInfo& createInfo
+    ) noexcept -> std::vector<uint32> {
+      RETINA_PROFILE_SCOPED();
+      if (createInfo.IsCrossDomain) {
+        auto families = std::vector<uint32> {
+          device.GetGraphicsQueue().GetFamilyIndex(),
+          device.GetComputeQueue().GetFamilyIndex(),
+          device.GetTransferQueue().GetFamilyIndex()
+        };
+        std::sort(families.begin(), families.end());
+        families.erase(std::unique(families.begin(), families.end()), families.end());
+        return families;
+      }
+      switch (createInfo.Domain) {
+        case EQueueDomain::E_GRAPHICS:
+          return { device.GetGraphicsQueue().GetFamilyIndex() };
+        case EQueueDomain::E_COMPUTE:
+          return { device.GetComputeQueue().GetFamilyIndex() };
+        case EQueueDomain::E_TRANSFER:
+          return { device.GetTransferQueue().GetFamilyIndex() };
+      }
+      std::unreachable();
+    }
+
+    // "queueFamilyIndices" is referenced by the returned info and has to outlive it
+    RETINA_NODISCARD RETINA_INLINE auto MakeNativeBufferCreateInfo(
+      const SBufferCreateInfo& createInfo,
+      const std::vector<uint32>& queueFamilyIndices
+    ) noexcept -> VkBufferCreateInfo {
+      RETINA_PROFILE_SCOPED();
+      auto bufferCreateInfo = VkBufferCreateInfo(VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO);
+      bufferCreateInfo.flags = AsEnumCounterpart(createInfo.Flags);
+      bufferCreateInfo.size = createInfo.Capacity;
+      // Every buffer hands out its device address
+      bufferCreateInfo.usage = AsEnumCounterpart(createInfo.Usage | EBufferUsageFlag::E_SHADER_DEVICE_ADDRESS);
+      bufferCreateInfo.sharingMode = queueFamilyIndices.size() > 1
+        ? VK_SHARING_MODE_CONCURRENT
+        : VK_SHARING_MODE_EXCLUSIVE;
+      bufferCreateInfo.queueFamilyIndexCount = queueFamilyIndices.size();
+      bufferCreateInfo.pQueueFamilyIndices = queueFamilyIndices.data();
+      return bufferCreateInfo;
+    }
   }
 
   CBuffer::CBuffer(const CDevice& device) noexcept
@@ -48,7 +78,11 @@ namespace Retina::Graphics {
     RETINA_PROFILE_SCOPED();
     const auto isSparse = Core::IsFlagEnabled(_createInfo.Flags, EBufferCreateFlag::E_SPARSE_BINDING);
     if (_handle) {
-      if (_allocation) {
+      if (_isAliased) {
+        // The memory belongs to whoever aliased it
+        vkDestroyBuffer(_device->GetHandle(), _handle, nullptr);
+        RETINA_GRAPHICS_INFO("Buffer ({}) destroyed", GetDebugName());
+      } else if (_allocation) {
         vmaDestroyBuffer(_device->GetAllocator(), _handle, _allocation);
         RETINA_GRAPHICS_INFO("Buffer ({}) destroyed", GetDebugName());
       } else if (isSparse) {
@@ -81,6 +115,60 @@ namespace Retina::Graphics {
     return buffers;
   }
 
+  auto CBuffer::MakeAliased(
+    const CDevice& device,
+    const SBufferCreateInfo& createInfo,
+    VmaAllocation allocation,
+    uint64 offset
+  ) noexcept -> Core::CArcPtr<CBuffer> {
+    RETINA_PROFILE_SCOPED();
+    RETINA_ASSERT_WITH(createInfo.Heap == EHeapType::E_DEVICE_ONLY, "Only device local buffers can be aliased");
+    auto self = Core::CArcPtr(new CBuffer(device));
+    const auto queueFamilyIndices = Details::GetBufferQueueFamilyIndices(device, createInfo);
+    const auto bufferCreateInfo = Details::MakeNativeBufferCreateInfo(createInfo, queueFamilyIndices);
+
+    auto bufferHandle = VkBuffer();
+    RETINA_GRAPHICS_VULKAN_CHECK(vkCreateBuffer(device.GetHandle(), &bufferCreateInfo, nullptr, &bufferHandle));
+    RETINA_GRAPHICS_VULKAN_CHECK(vmaBindBufferMemory2(device.GetAllocator(), allocation, offset, bufferHandle, nullptr));
+
+    auto allocationInfo = VmaAllocationInfo();
+    vmaGetAllocationInfo(device.GetAllocator(), allocation, &allocationInfo);
+    auto memoryRequirements = VkMemoryRequirements();
+    vkGetBufferMemoryRequirements(device.GetHandle(), bufferHandle, &memoryRequirements);
+
+    const auto address = Details::GetBufferDeviceAddress(device, bufferHandle);
+    RETINA_GRAPHICS_INFO("Buffer ({}) initialized", createInfo.Name);
+    RETINA_GRAPHICS_INFO(" - Capacity: {}", createInfo.Capacity);
+    RETINA_GRAPHICS_INFO(" - Aliased at offset: {}", offset);
+    RETINA_GRAPHICS_INFO(" - Address: {}", address);
+
+    self->_handle = bufferHandle;
+    self->_allocation = allocation;
+    self->_allocationInfo = allocationInfo;
+    self->_isAliased = true;
+    self->_aliasOffset = offset;
+    self->_memoryRequirements = memoryRequirements;
+    self->_size = createInfo.Capacity;
+    self->_address = address;
+    self->_createInfo = createInfo;
+    self->SetDebugName(createInfo.Name);
+    return self;
+  }
+
+  auto CBuffer::QueryMemoryRequirements(
+    const CDevice& device,
+    const SBufferCreateInfo& createInfo
+  ) noexcept -> VkMemoryRequirements {
+    RETINA_PROFILE_SCOPED();
+    const auto queueFamilyIndices = Details::GetBufferQueueFamilyIndices(device, createInfo);
+    const auto bufferCreateInfo = Details::MakeNativeBufferCreateInfo(createInfo, queueFamilyIndices);
+    auto requirementsInfo = VkDeviceBufferMemoryRequirements(VK_STRUCTURE_TYPE_DEVICE_BUFFER_MEMORY_REQUIREMENTS);
+    requirementsInfo.pCreateInfo = &bufferCreateInfo;
+    auto requirements = VkMemoryRequirements2(VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2);
+    vkGetDeviceBufferMemoryRequirements(device.GetHandle(), &requirementsInfo, &requirements);
+    return requirements.memoryRequirements;
+  }
+
   auto CBuffer::GetHandle() const noexcept -> VkBuffer {
     RETINA_PROFILE_SCOPED();
     return _handle;
@@ -96,6 +184,21 @@ namespace Retina::Graphics {
     return _allocationInfo;
   }
 
+  auto CBuffer::IsAliased() const noexcept -> bool {
+    RETINA_PROFILE_SCOPED();
+    return _isAliased;
+  }
+
+  auto CBuffer::GetAliasOffset() const noexcept -> uint64 {
+    RETINA_PROFILE_SCOPED();
+    return _aliasOffset;
+  }
+
+  auto CBuffer::GetMemoryRequirements() const noexcept -> const VkMemoryRequirements& {
+    RETINA_PROFILE_SCOPED();
+    return _memoryRequirements;
+  }
+
   auto CBuffer::GetSizeBytes() const noexcept -> usize {
     RETINA_PROFILE_SCOPED();
     return _size;
@@ -181,23 +284,8 @@ namespace Retina::Graphics {
 
   auto CBuffer::Make(const CDevice& device, const SBufferCreateInfo& createInfo, CBuffer* self) noexcept -> void {
     RETINA_PROFILE_SCOPED();
-    auto queueFamilyIndices = std::vector {
-      device.GetGraphicsQueue().GetFamilyIndex(),
-      device.GetTransferQueue().GetFamilyIndex(),
-      device.GetComputeQueue().GetFamilyIndex(),
-    };
-    std::sort(queueFamilyIndices.begin(), queueFamilyIndices.end());
-    queueFamilyIndices.erase(std::unique(queueFamilyIndices.begin(), queueFamilyIndices.end()), queueFamilyIndices.end());
-
-    auto bufferCreateInfo = VkBufferCreateInfo(VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO);
-    bufferCreateInfo.flags = AsEnumCounterpart(createInfo.Flags);
-    bufferCreateInfo.size = createInfo.Capacity;
-    bufferCreateInfo.usage = Details::DEFAULT_BUFFER_USAGE_FLAGS;
-    bufferCreateInfo.sharingMode = queueFamilyIndices.size() > 1
-      ? VK_SHARING_MODE_CONCURRENT
-      : VK_SHARING_MODE_EXCLUSIVE;
-    bufferCreateInfo.queueFamilyIndexCount = queueFamilyIndices.size();
-    bufferCreateInfo.pQueueFamilyIndices = queueFamilyIndices.data();
+    const auto queueFamilyIndices = Details::GetBufferQueueFamilyIndices(device, createInfo);
+    const auto bufferCreateInfo = Details::MakeNativeBufferCreateInfo(createInfo, queueFamilyIndices);
 
     const auto allocationFlags = [&] -> VmaAllocationCreateFlags {
       switch (createInfo.Heap) {
@@ -4,17 +4,75 @@
 #include <Retina/Graphics/CommandPool.hpp>
 #include <Retina/Graphics/DescriptorSet.hpp>
 #include <Retina/Graphics/Device.hpp>
+#include <Retina/Graphics/GraphicsPipeline.hpp>
 #include <Retina/Graphics/Image.hpp>
 #include <Retina/Graphics/ImageView.hpp>
 #include <Retina/Graphics/Logger.hpp>
 #include <Retina/Graphics/Macros.hpp>
+#include <Retina/Graphics/MeshShadingPipeline.hpp>
 #include <Retina/Graphics/Pipeline.hpp>
 #include <Retina/Graphics/Queue.hpp>
 
 #include <volk.h>
 
+#include <algorithm>
+
 namespace Retina::Graphics {
   namespace Details {
+    RETINA_NODISCARD RETINA_INLINE auto GetBindPointIndex(EPipelineBindPoint bindPoint) noexcept -> uint32 {
+      RETINA_PROFILE_SCOPED();
+      switch (bindPoint) {
+        case EPipelineBindPoint::E_GRAPHICS:
+          return 0;
+        case EPipelineBindPoint::E_COMPUTE:
+          return 1;
+        default:
+          return -1_u32;
+      }
+    }
+
+    // Bindings made through one layout stay valid through another when both share the push constant range
+    // and the set layouts of every set up to "setCount"
+    RETINA_NODISCARD RETINA_INLINE auto IsPipelineLayoutCompatible(
+      const IPipeline& left,
+      const IPipeline& right,
+      uint32 setCount
+    ) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      const auto& leftLayout = left.GetLayout();
+      const auto& rightLayout = right.GetLayout();
+      if (leftLayout.Handle == rightLayout.Handle) {
+        return true;
+      }
+      if (leftLayout.PushConstant != rightLayout.PushConstant) {
+        return false;
+      }
+      if (leftLayout.DescriptorLayouts.size() < setCount || rightLayout.DescriptorLayouts.size() < setCount) {
+        return false;
+      }
+      return std::ranges::equal(
+        std::span(leftLayout.DescriptorLayouts).first(setCount),
+        std::span(rightLayout.DescriptorLayouts).first(setCount)
+      );
+    }
+
+    // Binding a pipeline overwrites every piece of dynamic state it was not created with
+    RETINA_NODISCARD RETINA_INLINE auto IsDynamicStateEnabled(const IPipeline& pipeline, EDynamicState state) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      auto dynamicStates = std::span<const EDynamicState>();
+      switch (pipeline.GetType()) {
+        case EPipelineType::E_GRAPHICS:
+          dynamicStates = static_cast<const CGraphicsPipeline&>(pipeline).GetCreateInfo().DynamicState.DynamicStates;
+          break;
+        case EPipelineType::E_MESH_SHADING:
+          dynamicStates = static_cast<const CMeshShadingPipeline&>(pipeline).GetCreateInfo().DynamicState.DynamicStates;
+          break;
+        default:
+          break;
+      }
+      return std::ranges::find(dynamicStates, state) != dynamicStates.end();
+    }
+
     RETINA_NODISCARD RETINA_INLINE auto MakeNativeRenderingAttachmentInfo(
       const SAttachmentInfo& attachmentInfo,
       EImageLayout layout
@@ -51,9 +109,8 @@ namespace Retina::Graphics {
       info.srcAccessMask = AsEnumCounterpart(barrier.SourceAccess);
       info.dstStageMask = AsEnumCounterpart(barrier.DestStage);
       info.dstAccessMask = AsEnumCounterpart(barrier.DestAccess);
-      // TODO: Handle queue family ownership transfers
-      info.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-      info.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      info.srcQueueFamilyIndex = barrier.SourceQueueFamily;
+      info.dstQueueFamilyIndex = barrier.DestQueueFamily;
       info.buffer = buffer.GetHandle();
       info.offset = barrier.MemoryRange.Offset;
       info.size = barrier.MemoryRange.Size;
@@ -70,14 +127,23 @@ namespace Retina::Graphics {
       info.dstAccessMask = AsEnumCounterpart(barrier.DestAccess);
       info.oldLayout = AsEnumCounterpart(barrier.OldLayout);
       info.newLayout = AsEnumCounterpart(barrier.NewLayout);
-      // TODO: Handle queue family ownership transfers
-      info.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-      info.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      info.srcQueueFamilyIndex = barrier.SourceQueueFamily;
+      info.dstQueueFamilyIndex = barrier.DestQueueFamily;
       info.image = image.GetHandle();
       info.subresourceRange = MakeNativeImageSubresourceRange(image.GetView().GetAspectMask(), barrier.SubresourceRange);
       return info;
     }
 
+    // Concurrently shared resources and queues of the same family have no ownership to hand over
+    RETINA_NODISCARD RETINA_INLINE auto IsOwnershipTransferRequired(
+      const CQueue& sourceQueue,
+      const CQueue& destQueue,
+      bool isCrossDomain
+    ) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      return !isCrossDomain && sourceQueue.GetFamilyIndex() != destQueue.GetFamilyIndex();
+    }
+
     RETINA_INLINE auto IssueFullBarrier(VkCommandBuffer commandBuffer) noexcept -> void {
       RETINA_PROFILE_SCOPED();
       auto barrier = VkMemoryBarrier2(VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
@@ -91,6 +157,115 @@ namespace Retina::Graphics {
       dependencyInfo.pMemoryBarriers = &barrier;
       vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
     }
+
+    // "WHOLE_SIZE" and the "REMAINING" counts saturate to the end of the resource
+    RETINA_NODISCARD RETINA_INLINE constexpr auto IsRangeOverlapping(
+      uint64 leftOffset,
+      uint64 leftSize,
+      uint64 rightOffset,
+      uint64 rightSize
+    ) noexcept -> bool {
+      const auto leftEnd = leftOffset + std::min(leftSize, -1_u64 - leftOffset);
+      const auto rightEnd = rightOffset + std::min(rightSize, -1_u64 - rightOffset);
+      return leftOffset < rightEnd && rightOffset < leftEnd;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto IsBufferMemoryBarrierOverlapping(
+      const VkBufferMemoryBarrier2& left,
+      const VkBufferMemoryBarrier2& right
+    ) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      return left.buffer == right.buffer && IsRangeOverlapping(left.offset, left.size, right.offset, right.size);
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto IsImageMemoryBarrierOverlapping(
+      const VkImageMemoryBarrier2& left,
+      const VkImageMemoryBarrier2& right
+    ) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      const auto& leftRange = left.subresourceRange;
+      const auto& rightRange = right.subresourceRange;
+      return
+        left.image == right.image &&
+        (leftRange.aspectMask & rightRange.aspectMask) &&
+        IsRangeOverlapping(leftRange.baseMipLevel, leftRange.levelCount, rightRange.baseMipLevel, rightRange.levelCount) &&
+        IsRangeOverlapping(leftRange.baseArrayLayer, leftRange.layerCount, rightRange.baseArrayLayer, rightRange.layerCount);
+    }
+
+    // A global barrier overlaps every resource, recording it in the same dependency as a resource barrier drops the
+    // ordering between them whenever the later one's first scope picks up the earlier one's second scope. Stages that
+    // stand for several others are taken as all of them
+    template <typename L, typename R>
+    RETINA_NODISCARD RETINA_INLINE auto IsBarrierChaining(const L& earlier, const R& later) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      constexpr auto expandingStages =
+        VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT |
+        VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT |
+        VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT |
+        VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+      if ((earlier.dstStageMask | later.srcStageMask) & expandingStages) {
+        return true;
+      }
+      return earlier.dstStageMask & later.srcStageMask;
+    }
+
+    // Both barriers are recorded back to back, so the union of their scopes keeps every dependency either of them
+    // had. Ownership transfers are never merged, release and acquire have to stay a matching pair
+    template <typename T>
+    RETINA_INLINE auto MergeBarrierScopes(T& pending, const T& barrier) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      pending.srcStageMask |= barrier.srcStageMask;
+      pending.srcAccessMask |= barrier.srcAccessMask;
+      pending.dstStageMask |= barrier.dstStageMask;
+      pending.dstAccessMask |= barrier.dstAccessMask;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto TryMergeBufferMemoryBarrier(
+      VkBufferMemoryBarrier2& pending,
+      const VkBufferMemoryBarrier2& barrier
+    ) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      if (
+        pending.buffer != barrier.buffer ||
+        pending.offset != barrier.offset ||
+        pending.size != barrier.size ||
+        pending.srcQueueFamilyIndex != pending.dstQueueFamilyIndex ||
+        barrier.srcQueueFamilyIndex != barrier.dstQueueFamilyIndex
+      ) {
+        return false;
+      }
+      MergeBarrierScopes(pending, barrier);
+      return true;
+    }
+
+    // Merges a barrier that repeats the transition of "pending", or continues it from the layout it left the image in
+    RETINA_NODISCARD RETINA_INLINE auto TryMergeImageMemoryBarrier(
+      VkImageMemoryBarrier2& pending,
+      const VkImageMemoryBarrier2& barrier
+    ) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      const auto& pendingRange = pending.subresourceRange;
+      const auto& range = barrier.subresourceRange;
+      if (
+        pending.image != barrier.image ||
+        pendingRange.aspectMask != range.aspectMask ||
+        pendingRange.baseMipLevel != range.baseMipLevel ||
+        pendingRange.levelCount != range.levelCount ||
+        pendingRange.baseArrayLayer != range.baseArrayLayer ||
+        pendingRange.layerCount != range.layerCount ||
+        pending.srcQueueFamilyIndex != pending.dstQueueFamilyIndex ||
+        barrier.srcQueueFamilyIndex != barrier.dstQueueFamilyIndex
+      ) {
+        return false;
+      }
+      const auto isRepeated = pending.oldLayout == barrier.oldLayout && pending.newLayout == barrier.newLayout;
+      if (!isRepeated && pending.newLayout != barrier.oldLayout) {
+        return false;
+      }
+      MergeBarrierScopes(pending, barrier);
+      pending.newLayout = barrier.newLayout;
+      return true;
+    }
   }
 
   CCommandBuffer::~CCommandBuffer() noexcept {
@@ -220,6 +395,11 @@ namespace Retina::Graphics {
     return *_queue;
   }
 
+  auto CCommandBuffer::GetStatistics() const noexcept -> const SCommandBufferStatistics& {
+    RETINA_PROFILE_SCOPED();
+    return _statistics;
+  }
+
   auto CCommandBuffer::GetDebugName() const noexcept -> std::string_view {
     RETINA_PROFILE_SCOPED();
     return _createInfo.Name;
@@ -235,17 +415,26 @@ namespace Retina::Graphics {
     RETINA_PROFILE_SCOPED();
     auto commandBufferBeginInfo = VkCommandBufferBeginInfo(VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO);
     RETINA_GRAPHICS_VULKAN_CHECK(vkBeginCommandBuffer(_handle, &commandBufferBeginInfo));
+    _currentState.RenderingInfo = std::nullopt;
+    _currentState.Pipeline = nullptr;
+    InvalidateState();
+    _pendingBarriers.MemoryBarriers.clear();
+    _pendingBarriers.BufferMemoryBarriers.clear();
+    _pendingBarriers.ImageMemoryBarriers.clear();
+    _statistics = {};
     return *this;
   }
 
   auto CCommandBuffer::End() noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    FlushBarriers();
     RETINA_GRAPHICS_VULKAN_CHECK(vkEndCommandBuffer(_handle));
     return *this;
   }
 
   auto CCommandBuffer::BeginRendering(SRenderingInfo renderingInfo) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    FlushBarriers();
     auto regionName = renderingInfo.Name;
     if (regionName.empty()) {
       regionName = "GenericRenderingRegion";
@@ -364,6 +553,10 @@ namespace Retina::Graphics {
 
   auto CCommandBuffer::SetViewport(const SViewport& viewport) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    if (_currentState.Viewport == viewport) {
+      _statistics.SkippedCommandCount++;
+      return *this;
+    }
     const auto nativeViewport = VkViewport(
       viewport.X,
       viewport.Y,
@@ -373,13 +566,21 @@ namespace Retina::Graphics {
       1.0f
     );
     vkCmdSetViewport(_handle, 0, 1, &nativeViewport);
+    _currentState.Viewport = viewport;
+    _statistics.EmittedCommandCount++;
     return *this;
   }
 
   auto CCommandBuffer::SetScissor(const SScissor& scissor) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    if (_currentState.Scissor == scissor) {
+      _statistics.SkippedCommandCount++;
+      return *this;
+    }
     const auto nativeScissor = std::bit_cast<VkRect2D>(scissor);
     vkCmdSetScissor(_handle, 0, 1, &nativeScissor);
+    _currentState.Scissor = scissor;
+    _statistics.EmittedCommandCount++;
     return *this;
   }
 
@@ -393,8 +594,30 @@ namespace Retina::Graphics {
 
   auto CCommandBuffer::BindPipeline(const IPipeline& pipeline) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
-    vkCmdBindPipeline(_handle, AsEnumCounterpart(pipeline.GetBindPoint()), pipeline.GetHandle());
     _currentState.Pipeline = &pipeline;
+    const auto bindPointIndex = Details::GetBindPointIndex(pipeline.GetBindPoint());
+    if (bindPointIndex == -1_u32) {
+      vkCmdBindPipeline(_handle, AsEnumCounterpart(pipeline.GetBindPoint()), pipeline.GetHandle());
+      _statistics.EmittedCommandCount++;
+      return *this;
+    }
+    // Compared by handle, a graphics pipeline changes its handle once the optimized variant replaces the linked one
+    auto& bindPointState = _currentState.BindPoints[bindPointIndex];
+    if (bindPointState.Pipeline == pipeline.GetHandle()) {
+      _statistics.SkippedCommandCount++;
+      return *this;
+    }
+    vkCmdBindPipeline(_handle, AsEnumCounterpart(pipeline.GetBindPoint()), pipeline.GetHandle());
+    bindPointState.Pipeline = pipeline.GetHandle();
+    _statistics.EmittedCommandCount++;
+    if (pipeline.GetBindPoint() == EPipelineBindPoint::E_GRAPHICS) {
+      if (!Details::IsDynamicStateEnabled(pipeline, EDynamicState::E_VIEWPORT)) {
+        _currentState.Viewport = std::nullopt;
+      }
+      if (!Details::IsDynamicStateEnabled(pipeline, EDynamicState::E_SCISSOR)) {
+        _currentState.Scissor = std::nullopt;
+      }
+    }
     return *this;
   }
 
@@ -404,20 +627,97 @@ namespace Retina::Graphics {
     const auto& layout = currentPipeline.GetLayout();
     const auto bindPoint = AsEnumCounterpart(currentPipeline.GetBindPoint());
     const auto setHandle = descriptorSet.GetHandle();
+    const auto bindPointIndex = Details::GetBindPointIndex(currentPipeline.GetBindPoint());
+    if (bindPointIndex != -1_u32) {
+      auto& bindPointState = _currentState.BindPoints[bindPointIndex];
+      if (
+        bindPointState.DescriptorPipeline &&
+        bindPointState.DescriptorSet == setHandle &&
+        bindPointState.FirstSet == firstSet &&
+        Details::IsPipelineLayoutCompatible(*bindPointState.DescriptorPipeline, currentPipeline, firstSet + 1)
+      ) {
+        _statistics.SkippedCommandCount++;
+        return *this;
+      }
+      bindPointState.DescriptorPipeline = &currentPipeline;
+      bindPointState.FirstSet = firstSet;
+      bindPointState.DescriptorSet = setHandle;
+      bindPointState.HasDescriptorBufferOffsets = false;
+    }
     vkCmdBindDescriptorSets(_handle, bindPoint, layout.Handle, firstSet, 1, &setHandle, 0, nullptr);
+    _statistics.EmittedCommandCount++;
     return *this;
   }
 
   auto CCommandBuffer::BindShaderResourceTable(const CShaderResourceTable& shaderResourceTable) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
-    return BindDescriptorSet(shaderResourceTable.GetDescriptorSet());
+    if (!shaderResourceTable.HasDescriptorBuffer()) {
+      return BindDescriptorSet(shaderResourceTable.GetDescriptorSet());
+    }
+    // The buffer is bound once per command buffer, every later bind only points the pipeline layout at it
+    const auto& descriptorBuffer = shaderResourceTable.GetDescriptorBuffer();
+    if (_currentState.DescriptorBuffer != descriptorBuffer.GetHandle()) {
+      auto descriptorBufferBindingInfo = VkDescriptorBufferBindingInfoEXT(VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT);
+      descriptorBufferBindingInfo.address = descriptorBuffer.GetAddress();
+      descriptorBufferBindingInfo.usage = AsEnumCounterpart(descriptorBuffer.GetCreateInfo().Usage | EBufferUsageFlag::E_SHADER_DEVICE_ADDRESS);
+      vkCmdBindDescriptorBuffersEXT(_handle, 1, &descriptorBufferBindingInfo);
+      _currentState.DescriptorBuffer = descriptorBuffer.GetHandle();
+      for (auto& bindPointState : _currentState.BindPoints) {
+        bindPointState.HasDescriptorBufferOffsets = false;
+      }
+    }
+
+    const auto& currentPipeline = *_currentState.Pipeline;
+    const auto bindPointIndex = Details::GetBindPointIndex(currentPipeline.GetBindPoint());
+    if (bindPointIndex != -1_u32) {
+      auto& bindPointState = _currentState.BindPoints[bindPointIndex];
+      if (
+        bindPointState.HasDescriptorBufferOffsets &&
+        Details::IsPipelineLayoutCompatible(*bindPointState.DescriptorPipeline, currentPipeline, 1)
+      ) {
+        _statistics.SkippedCommandCount++;
+        return *this;
+      }
+      bindPointState.DescriptorPipeline = &currentPipeline;
+      bindPointState.FirstSet = 0;
+      bindPointState.DescriptorSet = {};
+      bindPointState.HasDescriptorBufferOffsets = true;
+    }
+    const auto bufferIndex = 0_u32;
+    const auto bufferOffset = VkDeviceSize();
+    vkCmdSetDescriptorBufferOffsetsEXT(
+      _handle,
+      AsEnumCounterpart(currentPipeline.GetBindPoint()),
+      currentPipeline.GetLayoutHandle(),
+      0,
+      1,
+      &bufferIndex,
+      &bufferOffset
+    );
+    _statistics.EmittedCommandCount++;
+    return *this;
   }
 
   auto CCommandBuffer::PushConstants(uint32 offset, std::span<const uint8> values) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
     const auto& currentPipeline = *_currentState.Pipeline;
     const auto& layout = currentPipeline.GetLayout();
+    // Only an identical push over the last one is elided, partial overlaps are always emitted
+    auto& pushConstantState = _currentState.PushConstants;
+    if (
+      pushConstantState.Pipeline &&
+      pushConstantState.Offset == offset &&
+      std::ranges::equal(pushConstantState.Values, values) &&
+      Details::IsPipelineLayoutCompatible(*pushConstantState.Pipeline, currentPipeline, 0)
+    ) {
+      _statistics.SkippedCommandCount++;
+      return *this;
+    }
     vkCmdPushConstants(_handle, layout.Handle, AsEnumCounterpart(layout.PushConstant.Stages), offset, values.size_bytes(), values.data());
+    pushConstantState.Pipeline = &currentPipeline;
+    pushConstantState.Offset = offset;
+    pushConstantState.Values.assign(values.begin(), values.end());
+    _statistics.EmittedCommandCount++;
     return *this;
   }
 
@@ -435,6 +735,7 @@ namespace Retina::Graphics {
     uint32 firstInstance
   ) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    FlushBarriers();
     vkCmdDrawIndexed(_handle, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
     return *this;
   }
@@ -446,42 +747,93 @@ namespace Retina::Graphics {
     uint32 firstInstance
   ) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    FlushBarriers();
     vkCmdDraw(_handle, vertexCount, instanceCount, firstVertex, firstInstance);
     return *this;
   }
 
+  auto CCommandBuffer::DrawIndexedIndirectCount(
+    const CBuffer& buffer,
+    usize offset,
+    const CBuffer& countBuffer,
+    usize countOffset,
+    uint32 maxDrawCount
+  ) noexcept -> CCommandBuffer& {
+    RETINA_PROFILE_SCOPED();
+    FlushBarriers();
+    vkCmdDrawIndexedIndirectCount(
+      _handle,
+      buffer.GetHandle(),
+      offset,
+      countBuffer.GetHandle(),
+      countOffset,
+      maxDrawCount,
+      sizeof(SDrawIndexedIndirectCommand)
+    );
+    return *this;
+  }
+
   auto CCommandBuffer::DrawMeshTasks(uint32 x, uint32 y, uint32 z) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    FlushBarriers();
     vkCmdDrawMeshTasksEXT(_handle, x, y, z);
     return *this;
   }
 
   auto CCommandBuffer::Dispatch(uint32 x, uint32 y, uint32 z) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    FlushBarriers();
     vkCmdDispatch(_handle, x, y, z);
     return *this;
   }
 
+  auto CCommandBuffer::DispatchIndirect(const CBuffer& buffer, usize offset) noexcept -> CCommandBuffer& {
+    RETINA_PROFILE_SCOPED();
+    FlushBarriers();
+    vkCmdDispatchIndirect(_handle, buffer.GetHandle(), offset);
+    return *this;
+  }
+
   auto CCommandBuffer::Barrier(const SMemoryBarrierInfo& barrierInfo) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
-    auto memoryBarriers = std::vector<VkMemoryBarrier2>();
-    memoryBarriers.reserve(barrierInfo.MemoryBarriers.size());
     for (const auto& barrier : barrierInfo.MemoryBarriers) {
-      memoryBarriers.emplace_back(Details::MakeNativeMemoryBarrier(barrier));
+      EnqueueMemoryBarrier(Details::MakeNativeMemoryBarrier(barrier));
     }
-
-    auto bufferMemoryBarriers = std::vector<VkBufferMemoryBarrier2>();
-    bufferMemoryBarriers.reserve(barrierInfo.BufferMemoryBarriers.size());
     for (const auto& barrier : barrierInfo.BufferMemoryBarriers) {
-      bufferMemoryBarriers.emplace_back(Details::MakeNativeBufferMemoryBarrier(barrier));
+      EnqueueBufferMemoryBarrier(Details::MakeNativeBufferMemoryBarrier(barrier));
     }
-
-    auto imageMemoryBarriers = std::vector<VkImageMemoryBarrier2>();
-    imageMemoryBarriers.reserve(barrierInfo.ImageMemoryBarriers.size());
     for (const auto& barrier : barrierInfo.ImageMemoryBarriers) {
-      imageMemoryBarriers.emplace_back(Details::MakeNativeImageMemoryBarrier(barrier));
+      EnqueueImageMemoryBarrier(Details::MakeNativeImageMemoryBarrier(barrier));
     }
+    return *this;
+  }
 
+  auto CCommandBuffer::MemoryBarrier(const SMemoryBarrier& barrier) noexcept -> CCommandBuffer& {
+    RETINA_PROFILE_SCOPED();
+    EnqueueMemoryBarrier(Details::MakeNativeMemoryBarrier(barrier));
+    return *this;
+  }
+
+  auto CCommandBuffer::BufferMemoryBarrier(const SBufferMemoryBarrier& barrier) noexcept -> CCommandBuffer& {
+    RETINA_PROFILE_SCOPED();
+    EnqueueBufferMemoryBarrier(Details::MakeNativeBufferMemoryBarrier(barrier));
+    return *this;
+  }
+
+  auto CCommandBuffer::ImageMemoryBarrier(const SImageMemoryBarrier& barrier) noexcept -> CCommandBuffer& {
+    RETINA_PROFILE_SCOPED();
+    EnqueueImageMemoryBarrier(Details::MakeNativeImageMemoryBarrier(barrier));
+    return *this;
+  }
+
+  auto CCommandBuffer::FlushBarriers() noexcept -> CCommandBuffer& {
+    RETINA_PROFILE_SCOPED();
+    auto& memoryBarriers = _pendingBarriers.MemoryBarriers;
+    auto& bufferMemoryBarriers = _pendingBarriers.BufferMemoryBarriers;
+    auto& imageMemoryBarriers = _pendingBarriers.ImageMemoryBarriers;
+    if (memoryBarriers.empty() && bufferMemoryBarriers.empty() && imageMemoryBarriers.empty()) {
+      return *this;
+    }
     auto dependencyInfo = VkDependencyInfo(VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
     dependencyInfo.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
     dependencyInfo.memoryBarrierCount = memoryBarriers.size();
@@ -491,50 +843,79 @@ namespace Retina::Graphics {
     dependencyInfo.imageMemoryBarrierCount = imageMemoryBarriers.size();
     dependencyInfo.pImageMemoryBarriers = imageMemoryBarriers.data();
     vkCmdPipelineBarrier2(_handle, &dependencyInfo);
+    _statistics.PipelineBarrierCount++;
+
+    memoryBarriers.clear();
+    bufferMemoryBarriers.clear();
+    imageMemoryBarriers.clear();
     return *this;
   }
 
-  auto CCommandBuffer::MemoryBarrier(const SMemoryBarrier& barrier) noexcept -> CCommandBuffer& {
+  auto CCommandBuffer::InvalidateState() noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
-    auto memoryBarrier = Details::MakeNativeMemoryBarrier(barrier);
-    auto dependencyInfo = VkDependencyInfo(VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
-    dependencyInfo.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
-    dependencyInfo.memoryBarrierCount = 1;
-    dependencyInfo.pMemoryBarriers = &memoryBarrier;
-    vkCmdPipelineBarrier2(_handle, &dependencyInfo);
+    _currentState.DescriptorBuffer = {};
+    _currentState.BindPoints = {};
+    // Keeps the push constant storage around
+    _currentState.PushConstants.Pipeline = nullptr;
+    _currentState.PushConstants.Values.clear();
+    _currentState.Viewport = std::nullopt;
+    _currentState.Scissor = std::nullopt;
     return *this;
   }
 
-  auto CCommandBuffer::BufferMemoryBarrier(const SBufferMemoryBarrier& barrier) noexcept -> CCommandBuffer& {
+  auto CCommandBuffer::ReleaseOwnership(const CQueue& destQueue, SBufferMemoryBarrier barrier) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
-    auto bufferBarrier = Details::MakeNativeBufferMemoryBarrier(barrier);
-    auto dependencyInfo = VkDependencyInfo(VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
-    dependencyInfo.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
-    dependencyInfo.bufferMemoryBarrierCount = 1;
-    dependencyInfo.pBufferMemoryBarriers = &bufferBarrier;
-    vkCmdPipelineBarrier2(_handle, &dependencyInfo);
-    return *this;
+    if (!Details::IsOwnershipTransferRequired(GetQueue(), destQueue, barrier.Buffer->GetCreateInfo().IsCrossDomain)) {
+      return *this;
+    }
+    barrier.DestAccess = EResourceAccessFlag::E_NONE;
+    barrier.SourceQueueFamily = GetQueue().GetFamilyIndex();
+    barrier.DestQueueFamily = destQueue.GetFamilyIndex();
+    return BufferMemoryBarrier(barrier);
   }
 
-  auto CCommandBuffer::ImageMemoryBarrier(const SImageMemoryBarrier& barrier) noexcept -> CCommandBuffer& {
+  auto CCommandBuffer::ReleaseOwnership(const CQueue& destQueue, SImageMemoryBarrier barrier) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
-    auto imageBarrier = Details::MakeNativeImageMemoryBarrier(barrier);
-    auto dependencyInfo = VkDependencyInfo(VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
-    dependencyInfo.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
-    dependencyInfo.imageMemoryBarrierCount = 1;
-    dependencyInfo.pImageMemoryBarriers = &imageBarrier;
-    vkCmdPipelineBarrier2(_handle, &dependencyInfo);
-    return *this;
+    // Without a transfer the layout transition is left to the acquire
+    if (!Details::IsOwnershipTransferRequired(GetQueue(), destQueue, barrier.Image->GetCreateInfo().IsCrossDomain)) {
+      return *this;
+    }
+    barrier.DestAccess = EResourceAccessFlag::E_NONE;
+    barrier.SourceQueueFamily = GetQueue().GetFamilyIndex();
+    barrier.DestQueueFamily = destQueue.GetFamilyIndex();
+    return ImageMemoryBarrier(barrier);
+  }
+
+  auto CCommandBuffer::AcquireOwnership(const CQueue& sourceQueue, SBufferMemoryBarrier barrier) noexcept -> CCommandBuffer& {
+    RETINA_PROFILE_SCOPED();
+    barrier.SourceAccess = EResourceAccessFlag::E_NONE;
+    if (Details::IsOwnershipTransferRequired(sourceQueue, GetQueue(), barrier.Buffer->GetCreateInfo().IsCrossDomain)) {
+      barrier.SourceQueueFamily = sourceQueue.GetFamilyIndex();
+      barrier.DestQueueFamily = GetQueue().GetFamilyIndex();
+    }
+    return BufferMemoryBarrier(barrier);
+  }
+
+  auto CCommandBuffer::AcquireOwnership(const CQueue& sourceQueue, SImageMemoryBarrier barrier) noexcept -> CCommandBuffer& {
+    RETINA_PROFILE_SCOPED();
+    barrier.SourceAccess = EResourceAccessFlag::E_NONE;
+    if (Details::IsOwnershipTransferRequired(sourceQueue, GetQueue(), barrier.Image->GetCreateInfo().IsCrossDomain)) {
+      barrier.SourceQueueFamily = sourceQueue.GetFamilyIndex();
+      barrier.DestQueueFamily = GetQueue().GetFamilyIndex();
+    }
+    return ImageMemoryBarrier(barrier);
   }
 
   auto CCommandBuffer::ClearBuffer(const CBuffer& buffer, uint32 value, const SBufferMemoryRange& range) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    FlushBarriers();
     vkCmdFillBuffer(_handle, buffer.GetHandle(), range.Offset, range.Size, value);
     return *this;
   }
 
   auto CCommandBuffer::CopyBuffer(const CBuffer& source, const CBuffer& dest, const SBufferCopyRegion& copyRegion) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    FlushBarriers();
     auto region = VkBufferCopy2(VK_STRUCTURE_TYPE_BUFFER_COPY_2);
     region.srcOffset = copyRegion.SourceOffset;
     region.dstOffset = copyRegion.DestOffset;
@@ -552,8 +933,41 @@ namespace Retina::Graphics {
     return *this;
   }
 
+  auto CCommandBuffer::CopyBufferRegions(
+    const CBuffer& source,
+    const CBuffer& dest,
+    std::span<const SBufferCopyRegion> copyRegions
+  ) noexcept -> CCommandBuffer& {
+    RETINA_PROFILE_SCOPED();
+    if (copyRegions.empty()) {
+      return *this;
+    }
+    FlushBarriers();
+    auto regions = std::vector<VkBufferCopy2>();
+    regions.reserve(copyRegions.size());
+    for (const auto& copyRegion : copyRegions) {
+      auto region = VkBufferCopy2(VK_STRUCTURE_TYPE_BUFFER_COPY_2);
+      region.srcOffset = copyRegion.SourceOffset;
+      region.dstOffset = copyRegion.DestOffset;
+      region.size = copyRegion.Size;
+      if (region.size == WHOLE_SIZE) {
+        region.size = source.GetSizeBytes() - region.srcOffset;
+      }
+      regions.emplace_back(region);
+    }
+
+    auto copy = VkCopyBufferInfo2(VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2);
+    copy.srcBuffer = source.GetHandle();
+    copy.dstBuffer = dest.GetHandle();
+    copy.regionCount = static_cast<uint32>(regions.size());
+    copy.pRegions = regions.data();
+    vkCmdCopyBuffer2(_handle, &copy);
+    return *this;
+  }
+
   auto CCommandBuffer::CopyBufferToImage(const CBuffer& source, const CImage& dest, const SBufferImageCopyRegion& copyRegion) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    FlushBarriers();
     const auto subresourceLayers = MakeNativeImageSubresourceLayers(dest, copyRegion.SubresourceRange);
     auto region = VkBufferImageCopy2(VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2);
     region.bufferOffset = copyRegion.Offset;
@@ -582,6 +996,7 @@ namespace Retina::Graphics {
 
   auto CCommandBuffer::ClearImage(const CImageView& imageView, const SClearValue& clearValue) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    FlushBarriers();
     auto aspectMask = imageView.GetAspectMask();
     const auto isColor = Core::IsFlagEnabled(aspectMask, EImageAspectFlag::E_COLOR);
     const auto isDepth = Core::IsFlagEnabled(aspectMask, EImageAspectFlag::E_DEPTH);
@@ -618,6 +1033,7 @@ namespace Retina::Graphics {
 
   auto CCommandBuffer::CopyImage(const CImage& source, const CImage& dest, const SImageCopyRegion& copyRegion) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    FlushBarriers();
     const auto sourceSubresource = MakeNativeImageSubresourceLayers(source, copyRegion.SourceSubresource);
     const auto destSubresource = MakeNativeImageSubresourceLayers(dest, copyRegion.DestSubresource);
     const auto sourceOffset = std::bit_cast<VkOffset3D>(copyRegion.SourceOffset);
@@ -649,6 +1065,7 @@ namespace Retina::Graphics {
 
   auto CCommandBuffer::BlitImage(const CImage& source, const CImage& dest, const SImageBlitRegion& blitRegion) noexcept -> CCommandBuffer& {
     RETINA_PROFILE_SCOPED();
+    FlushBarriers();
     const auto sourceSubresource = MakeNativeImageSubresourceLayers(source, blitRegion.SourceSubresource);
     const auto destSubresource = MakeNativeImageSubresourceLayers(dest, blitRegion.DestSubresource);
     const auto sourceOffsets = std::bit_cast<std::array<VkOffset3D, 2>>(blitRegion.SourceOffsets);
@@ -701,4 +1118,64 @@ namespace Retina::Graphics {
     vkCmdEndDebugUtilsLabelEXT(_handle);
     return *this;
   }
+
+  auto CCommandBuffer::EnqueueMemoryBarrier(const VkMemoryBarrier2& barrier) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto isChaining =
+      std::ranges::any_of(_pendingBarriers.BufferMemoryBarriers, [&](const auto& pending) noexcept {
+        return Details::IsBarrierChaining(pending, barrier);
+      }) ||
+      std::ranges::any_of(_pendingBarriers.ImageMemoryBarriers, [&](const auto& pending) noexcept {
+        return Details::IsBarrierChaining(pending, barrier);
+      });
+    if (isChaining) {
+      FlushBarriers();
+    }
+    // Global barriers cover every resource anyway, a single one carries all of them
+    auto& memoryBarriers = _pendingBarriers.MemoryBarriers;
+    if (!memoryBarriers.empty()) {
+      Details::MergeBarrierScopes(memoryBarriers.front(), barrier);
+      _statistics.MergedBarrierCount++;
+      return;
+    }
+    memoryBarriers.emplace_back(barrier);
+  }
+
+  auto CCommandBuffer::EnqueueBufferMemoryBarrier(const VkBufferMemoryBarrier2& barrier) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    // The pending global barrier overlaps this resource too
+    if (!_pendingBarriers.MemoryBarriers.empty() && Details::IsBarrierChaining(_pendingBarriers.MemoryBarriers.front(), barrier)) {
+      FlushBarriers();
+    }
+    for (auto& pending : _pendingBarriers.BufferMemoryBarriers) {
+      if (Details::TryMergeBufferMemoryBarrier(pending, barrier)) {
+        _statistics.MergedBarrierCount++;
+        return;
+      }
+      if (Details::IsBufferMemoryBarrierOverlapping(pending, barrier)) {
+        FlushBarriers();
+        break;
+      }
+    }
+    _pendingBarriers.BufferMemoryBarriers.emplace_back(barrier);
+  }
+
+  auto CCommandBuffer::EnqueueImageMemoryBarrier(const VkImageMemoryBarrier2& barrier) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (!_pendingBarriers.MemoryBarriers.empty() && Details::IsBarrierChaining(_pendingBarriers.MemoryBarriers.front(), barrier)) {
+      FlushBarriers();
+    }
+    for (auto& pending : _pendingBarriers.ImageMemoryBarriers) {
+      if (Details::TryMergeImageMemoryBarrier(pending, barrier)) {
+        _statistics.MergedBarrierCount++;
+        return;
+      }
+      // Barriers inside one dependency are unordered, an overlapping one that cannot be merged has to come after
+      if (Details::IsImageMemoryBarrierOverlapping(pending, barrier)) {
+        FlushBarriers();
+        break;
+      }
+    }
+    _pendingBarriers.ImageMemoryBarriers.emplace_back(barrier);
+  }
 }
@@ -0,0 +1,79 @@
+#include <Retina/Graphics/CommandBuffer.hpp>
+#include <Retina/Graphics/CommandPool.hpp>
+#include <Retina/Graphics/CommandPoolAllocator.hpp>
+#include <Retina/Graphics/Logger.hpp>
+#include <Retina/Graphics/Macros.hpp>
+#include <Retina/Graphics/Queue.hpp>
+
+#include <format>
+
+namespace Retina::Graphics {
+  CCommandPoolAllocator::CCommandPoolAllocator(const CQueue& queue) noexcept
+    : _queue(queue)
+  {
+    RETINA_PROFILE_SCOPED();
+  }
+
+  auto CCommandPoolAllocator::Make(const CQueue& queue, uint32 frameCount) noexcept -> Core::CUniquePtr<CCommandPoolAllocator> {
+    RETINA_PROFILE_SCOPED();
+    RETINA_ASSERT_WITH(frameCount > 0, "Command pool allocator needs at least one frame");
+    auto self = Core::MakeUnique<CCommandPoolAllocator>(queue);
+    self->_frames.resize(frameCount);
+    return self;
+  }
+
+  auto CCommandPoolAllocator::GetFrameCount() const noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    return _frames.size();
+  }
+
+  auto CCommandPoolAllocator::GetQueue() const noexcept -> const CQueue& {
+    RETINA_PROFILE_SCOPED();
+    return *_queue;
+  }
+
+  auto CCommandPoolAllocator::BeginFrame(uint32 frameIndex) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    RETINA_ASSERT_WITH(frameIndex < _frames.size(), "Frame index out of range");
+    const auto lock = std::lock_guard(_mutex);
+    for (auto& threadCommandPool : _frames[frameIndex]) {
+      if (threadCommandPool->AllocatedCount > 0) {
+        threadCommandPool->CommandPool->Reset();
+        threadCommandPool->AllocatedCount = 0;
+      }
+    }
+    _frameIndex = frameIndex;
+  }
+
+  auto CCommandPoolAllocator::Allocate() noexcept -> CCommandBuffer& {
+    RETINA_PROFILE_SCOPED();
+    auto& threadCommandPool = GetThreadCommandPool();
+    const auto index = threadCommandPool.AllocatedCount++;
+    if (index == threadCommandPool.CommandBuffers.size()) {
+      threadCommandPool.CommandBuffers.emplace_back(CCommandBuffer::MakeWith(*threadCommandPool.CommandPool, {
+        .Name = std::format("{}_CommandBuffer{}", threadCommandPool.CommandPool->GetDebugName(), index),
+      }));
+    }
+    return *threadCommandPool.CommandBuffers[index];
+  }
+
+  auto CCommandPoolAllocator::GetThreadCommandPool() noexcept -> SThreadCommandPool& {
+    RETINA_PROFILE_SCOPED();
+    const auto threadId = std::this_thread::get_id();
+    const auto lock = std::lock_guard(_mutex);
+    auto& threadCommandPools = _frames[_frameIndex];
+    for (auto& threadCommandPool : threadCommandPools) {
+      if (threadCommandPool->ThreadId == threadId) {
+        return *threadCommandPool;
+      }
+    }
+    // Pools live as long as the allocator, a thread that stops recording leaves its pools idle
+    auto& threadCommandPool = threadCommandPools.emplace_back(Core::MakeUnique<SThreadCommandPool>());
+    threadCommandPool->ThreadId = threadId;
+    threadCommandPool->CommandPool = CCommandPool::Make(*_queue, {
+      .Name = std::format("Frame{}Thread{}CommandPool", _frameIndex, threadCommandPools.size() - 1),
+      .Flags = ECommandPoolCreateFlag::E_TRANSIENT,
+    });
+    return *threadCommandPool;
+  }
+}
@@ -3,8 +3,7 @@
 #include <Retina/Graphics/Device.hpp>
 #include <Retina/Graphics/Logger.hpp>
 #include <Retina/Graphics/Macros.hpp>
-
-#include <spirv_glsl.hpp>
+#include <Retina/Graphics/PipelineCache.hpp>
 
 #include <volk.h>
 
@@ -32,21 +31,23 @@ namespace Retina::Graphics {
   ) noexcept -> Core::CArcPtr<CComputePipeline> {
     RETINA_PROFILE_SCOPED();
     auto self = Core::CArcPtr(new CComputePipeline());
+    const auto specializationData = Details::MakeSpecializationData(createInfo.SpecializationConstants);
+    const auto specializationInfo = Details::MakeNativeSpecializationInfo(specializationData);
 
-    const auto computeShaderBinary = Details::CompileShaderFromSource(
+    const auto computeShader = Details::LoadShader(
       createInfo.ComputeShader,
       createInfo.IncludeDirectories,
       EShaderStageFlag::E_COMPUTE
     );
-    const auto computeShaderCompiler = std::make_shared<spirv_cross::CompilerGLSL>(computeShaderBinary);
     auto computeShaderStage = VkPipelineShaderStageCreateInfo(VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
     computeShaderStage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-    computeShaderStage.module = Details::MakeShaderModule(device, computeShaderBinary);
+    computeShaderStage.module = Details::MakeShaderModule(device, computeShader.Spirv);
     computeShaderStage.pName = "main";
+    computeShaderStage.pSpecializationInfo = &specializationInfo;
 
     const auto descriptorLayoutHandles = Details::MakeDescriptorLayoutHandles(createInfo.DescriptorLayouts);
-    const auto pushConstantRange = Details::ReflectPushConstantRange(std::to_array({
-      computeShaderCompiler.get(),
+    const auto pushConstantRange = Details::ReflectPushConstantRange(std::to_array<const Details::SShaderBinary*>({
+      &computeShader,
     }));
     const auto nativePushConstantInfo = std::bit_cast<VkPushConstantRange>(pushConstantRange);
 
@@ -69,6 +70,7 @@ namespace Retina::Graphics {
     );
 
     auto pipelineCreateInfo = VkComputePipelineCreateInfo(VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO);
+    pipelineCreateInfo.flags = Details::MakeDescriptorLayoutPipelineFlags(createInfo.DescriptorLayouts);
     pipelineCreateInfo.stage = computeShaderStage;
     pipelineCreateInfo.layout = pipelineLayoutHandle;
     pipelineCreateInfo.basePipelineIndex = -1;
@@ -77,7 +79,7 @@ namespace Retina::Graphics {
     RETINA_GRAPHICS_VULKAN_CHECK(
       vkCreateComputePipelines(
         device.GetHandle(),
-        VK_NULL_HANDLE,
+        device.GetPipelineCache().GetHandle(),
         1,
         &pipelineCreateInfo,
         nullptr,
@@ -92,6 +94,7 @@ namespace Retina::Graphics {
     self->_layout = {
       .Handle = pipelineLayoutHandle,
       .PushConstant = pushConstantRange,
+      .DescriptorLayouts = descriptorLayoutHandles,
     };
     self->_createInfo = createInfo;
     self->_device = device.ToArcPtr();
@@ -17,29 +17,65 @@ namespace Retina::Graphics {
   auto CDeletionQueue::Enqueue(std::move_only_function<void()>&& packet) noexcept -> void {
     RETINA_PROFILE_SCOPED();
     const auto& mainTimeline = _device->GetMainTimeline();
-    _packets.emplace_back(mainTimeline.GetHostTimelineValue(), std::move(packet));
+    const auto lock = std::lock_guard(_mutex);
+    const auto timelineValue = mainTimeline.GetHostTimelineValue();
+    if (_buckets.empty() || _buckets.back().TimelineValue != timelineValue) {
+      auto& bucket = _buckets.emplace_back(timelineValue);
+      if (!_freeDeletions.empty()) {
+        bucket.Deletions = std::move(_freeDeletions.back());
+        _freeDeletions.pop_back();
+      }
+    }
+    _buckets.back().Deletions.emplace_back(std::move(packet));
   }
 
   auto CDeletionQueue::Tick() noexcept -> void {
     RETINA_PROFILE_SCOPED();
     const auto& mainTimeline = _device->GetMainTimeline();
     const auto currentTimelineValue = mainTimeline.GetDeviceTimelineValue();
-    for (auto it = _packets.begin(); it != _packets.end();) {
-      auto& [timelineValue, deletion] = *it;
-      if (timelineValue < currentTimelineValue) {
-        deletion();
-        it = _packets.erase(it);
-      } else {
-        ++it;
+    auto retiredBuckets = std::vector<SDeletionQueueBucket>();
+    {
+      const auto lock = std::lock_guard(_mutex);
+      while (!_buckets.empty() && _buckets.front().TimelineValue < currentTimelineValue) {
+        retiredBuckets.emplace_back(std::move(_buckets.front()));
+        _buckets.pop_front();
       }
     }
+    Retire(retiredBuckets);
   }
 
   auto CDeletionQueue::Flush() noexcept -> void {
     RETINA_PROFILE_SCOPED();
-    for (auto& packet : _packets) {
-      packet.Deletion();
+    // Deletions may enqueue further deletions, keep going until nothing is left
+    while (true) {
+      auto retiredBuckets = std::vector<SDeletionQueueBucket>();
+      {
+        const auto lock = std::lock_guard(_mutex);
+        if (_buckets.empty()) {
+          return;
+        }
+        retiredBuckets.assign(std::make_move_iterator(_buckets.begin()), std::make_move_iterator(_buckets.end()));
+        _buckets.clear();
+      }
+      Retire(retiredBuckets);
+    }
+  }
+
+  auto CDeletionQueue::Retire(std::vector<SDeletionQueueBucket>& buckets) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (buckets.empty()) {
+      return;
+    }
+    // Run without the lock held, a deletion is free to enqueue another one
+    for (auto& bucket : buckets) {
+      for (auto& deletion : bucket.Deletions) {
+        deletion();
+      }
+      bucket.Deletions.clear();
+    }
+    const auto lock = std::lock_guard(_mutex);
+    for (auto& bucket : buckets) {
+      _freeDeletions.emplace_back(std::move(bucket.Deletions));
     }
-    _packets.clear();
   }
 }
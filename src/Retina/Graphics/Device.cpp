@@ -5,6 +5,8 @@
 #include <Retina/Graphics/DescriptorSet.hpp>
 #include <Retina/Graphics/Device.hpp>
 #include <Retina/Graphics/HostDeviceTimeline.hpp>
+#include <Retina/Graphics/PipelineCache.hpp>
+#include <Retina/Graphics/PipelineLibraryCache.hpp>
 #include <Retina/Graphics/Instance.hpp>
 #include <Retina/Graphics/Image.hpp>
 #include <Retina/Graphics/ImageView.hpp>
@@ -15,6 +17,7 @@
 
 #include <volk.h>
 
+#include <array>
 #include <compare>
 #include <cstring>
 #include <span>
@@ -40,6 +43,8 @@ namespace Retina::Graphics {
       VkPhysicalDeviceRayTracingPositionFetchFeaturesKHR RayTracingPositionFetchFeatures = {};
       VkPhysicalDeviceAccelerationStructureFeaturesKHR AccelerationStructureFeatures = {};
       VkPhysicalDeviceMemoryPriorityFeaturesEXT MemoryPriorityFeatures = {};
+      VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT GraphicsPipelineLibraryFeatures = {};
+      VkPhysicalDeviceDescriptorBufferFeaturesEXT DescriptorBufferFeatures = {};
     };
 
     struct SQueueFamilyInfo {
@@ -149,6 +154,8 @@ namespace Retina::Graphics {
       auto rayTracingPositionFetchFeatures = VkPhysicalDeviceRayTracingPositionFetchFeaturesKHR(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_POSITION_FETCH_FEATURES_KHR);
       auto accelerationStructureFeatures = VkPhysicalDeviceAccelerationStructureFeaturesKHR(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR);
       auto memoryPriorityFeatures = VkPhysicalDeviceMemoryPriorityFeaturesEXT(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT);
+      auto graphicsPipelineLibraryFeatures = VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT);
+      auto descriptorBufferFeatures = VkPhysicalDeviceDescriptorBufferFeaturesEXT(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT);
 
       features.pNext = &features11;
       features11.pNext = &features12;
@@ -158,6 +165,8 @@ namespace Retina::Graphics {
       rayTracingPipelineFeatures.pNext = &rayTracingPositionFetchFeatures;
       rayTracingPositionFetchFeatures.pNext = &accelerationStructureFeatures;
       accelerationStructureFeatures.pNext = &memoryPriorityFeatures;
+      memoryPriorityFeatures.pNext = &graphicsPipelineLibraryFeatures;
+      graphicsPipelineLibraryFeatures.pNext = &descriptorBufferFeatures;
       vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
 
       RETINA_GRAPHICS_INFO("Acquired physical device features");
@@ -171,6 +180,8 @@ namespace Retina::Graphics {
         rayTracingPositionFetchFeatures,
         accelerationStructureFeatures,
         memoryPriorityFeatures,
+        graphicsPipelineLibraryFeatures,
+        descriptorBufferFeatures,
       };
     }
 
@@ -202,6 +213,89 @@ namespace Retina::Graphics {
       };
     }
 
+    RETINA_NODISCARD RETINA_INLINE auto IsDeviceFeatureSupported(
+      bool SDeviceFeature::* feature,
+      const SPhysicalDeviceFeatures& availableFeatures,
+      std::span<const VkExtensionProperties> extensions
+    ) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      if (feature == &SDeviceFeature::Swapchain) {
+        return IsExtensionAvailable(extensions, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+      }
+      if (feature == &SDeviceFeature::MeshShader) {
+        return
+          IsExtensionAvailable(extensions, VK_EXT_MESH_SHADER_EXTENSION_NAME) &&
+          availableFeatures.MeshShaderFeatures.taskShader &&
+          availableFeatures.MeshShaderFeatures.meshShader;
+      }
+      if (feature == &SDeviceFeature::RayTracingPipeline) {
+        return
+          IsExtensionAvailable(extensions, VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME) &&
+          IsExtensionAvailable(extensions, VK_KHR_RAY_TRACING_POSITION_FETCH_EXTENSION_NAME) &&
+          availableFeatures.RayTracingPipelineFeatures.rayTracingPipeline &&
+          availableFeatures.RayTracingPipelineFeatures.rayTracingPipelineTraceRaysIndirect &&
+          availableFeatures.RayTracingPipelineFeatures.rayTraversalPrimitiveCulling &&
+          availableFeatures.RayTracingPositionFetchFeatures.rayTracingPositionFetch;
+      }
+      if (feature == &SDeviceFeature::AccelerationStructure) {
+        return
+          IsExtensionAvailable(extensions, VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME) &&
+          IsExtensionAvailable(extensions, VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME) &&
+          availableFeatures.AccelerationStructureFeatures.accelerationStructure &&
+          availableFeatures.AccelerationStructureFeatures.accelerationStructureCaptureReplay &&
+          availableFeatures.AccelerationStructureFeatures.descriptorBindingAccelerationStructureUpdateAfterBind;
+      }
+      if (feature == &SDeviceFeature::MemoryBudget) {
+        return IsExtensionAvailable(extensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+      }
+      if (feature == &SDeviceFeature::MemoryPriority) {
+        return
+          IsExtensionAvailable(extensions, VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME) &&
+          availableFeatures.MemoryPriorityFeatures.memoryPriority;
+      }
+      if (feature == &SDeviceFeature::GraphicsPipelineLibrary) {
+        return
+          IsExtensionAvailable(extensions, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+          IsExtensionAvailable(extensions, VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+          availableFeatures.GraphicsPipelineLibraryFeatures.graphicsPipelineLibrary;
+      }
+      if (feature == &SDeviceFeature::DescriptorBuffer) {
+        return
+          IsExtensionAvailable(extensions, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) &&
+          availableFeatures.DescriptorBufferFeatures.descriptorBuffer;
+      }
+      return false;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto ResolveDeviceFeatures(
+      const SDeviceCreateInfo& createInfo,
+      const SPhysicalDeviceFeatures& availableFeatures,
+      std::span<const VkExtensionProperties> extensions
+    ) noexcept -> SDeviceFeature {
+      RETINA_PROFILE_SCOPED();
+      constexpr static auto features = std::to_array({
+        std::make_pair(&SDeviceFeature::Swapchain, "Swapchain"),
+        std::make_pair(&SDeviceFeature::MeshShader, "MeshShader"),
+        std::make_pair(&SDeviceFeature::RayTracingPipeline, "RayTracingPipeline"),
+        std::make_pair(&SDeviceFeature::AccelerationStructure, "AccelerationStructure"),
+        std::make_pair(&SDeviceFeature::MemoryBudget, "MemoryBudget"),
+        std::make_pair(&SDeviceFeature::MemoryPriority, "MemoryPriority"),
+        std::make_pair(&SDeviceFeature::GraphicsPipelineLibrary, "GraphicsPipelineLibrary"),
+        std::make_pair(&SDeviceFeature::DescriptorBuffer, "DescriptorBuffer"),
+      });
+      auto resolvedFeatures = createInfo.Features;
+      for (const auto& [feature, name] : features) {
+        if (resolvedFeatures.*feature || !(createInfo.OptionalFeatures.*feature)) {
+          continue;
+        }
+        resolvedFeatures.*feature = IsDeviceFeatureSupported(feature, availableFeatures, extensions);
+        if (!(resolvedFeatures.*feature)) {
+          RETINA_GRAPHICS_WARN("Optional device feature \"{}\" not supported, disabling", name);
+        }
+      }
+      return resolvedFeatures;
+    }
+
     RETINA_NODISCARD auto GetEnabledDeviceExtensions(
       const CInstance& instance,
       VkPhysicalDevice physicalDevice,
@@ -238,6 +332,13 @@ namespace Retina::Graphics {
       if (features.MemoryPriority) {
         RETINA_ENABLE_EXTENSION_OR_PANIC(VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME);
       }
+      if (features.GraphicsPipelineLibrary) {
+        RETINA_ENABLE_EXTENSION_OR_PANIC(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+        RETINA_ENABLE_EXTENSION_OR_PANIC(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+      }
+      if (features.DescriptorBuffer) {
+        RETINA_ENABLE_EXTENSION_OR_PANIC(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+      }
 
       if (instance.IsFeatureEnabled(&SInstanceFeature::DLSS)) {
         const auto dlssExtensions = GetNvidiaDlssDeviceExtensions(instance.GetHandle(), physicalDevice);
@@ -268,7 +369,9 @@ namespace Retina::Graphics {
         VkPhysicalDeviceRayTracingPipelineFeaturesKHR(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_FEATURES_KHR),
         VkPhysicalDeviceRayTracingPositionFetchFeaturesKHR(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_POSITION_FETCH_FEATURES_KHR),
         VkPhysicalDeviceAccelerationStructureFeaturesKHR(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR),
-        VkPhysicalDeviceMemoryPriorityFeaturesEXT(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT)
+        VkPhysicalDeviceMemoryPriorityFeaturesEXT(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT),
+        VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT),
+        VkPhysicalDeviceDescriptorBufferFeaturesEXT(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT)
       );
       enabledFeatures.Features.pNext = &enabledFeatures.Features11;
       enabledFeatures.Features11.pNext = &enabledFeatures.Features12;
@@ -278,6 +381,8 @@ namespace Retina::Graphics {
       enabledFeatures.RayTracingPipelineFeatures.pNext = &enabledFeatures.RayTracingPositionFetchFeatures;
       enabledFeatures.RayTracingPositionFetchFeatures.pNext = &enabledFeatures.AccelerationStructureFeatures;
       enabledFeatures.AccelerationStructureFeatures.pNext = &enabledFeatures.MemoryPriorityFeatures;
+      enabledFeatures.MemoryPriorityFeatures.pNext = &enabledFeatures.GraphicsPipelineLibraryFeatures;
+      enabledFeatures.GraphicsPipelineLibraryFeatures.pNext = &enabledFeatures.DescriptorBufferFeatures;
 
 #define RETINA_ENABLE_FEATURE_OR_PANIC(x)                                         \
   do {                                                                            \
@@ -295,6 +400,7 @@ namespace Retina::Graphics {
       RETINA_ENABLE_FEATURE_OR_PANIC(Features.features.geometryShader);
       RETINA_ENABLE_FEATURE_OR_PANIC(Features.features.sampleRateShading);
       RETINA_ENABLE_FEATURE_OR_PANIC(Features.features.multiDrawIndirect);
+      RETINA_ENABLE_FEATURE_OR_PANIC(Features.features.drawIndirectFirstInstance);
       RETINA_ENABLE_FEATURE_OR_PANIC(Features.features.depthClamp);
       RETINA_ENABLE_FEATURE_OR_PANIC(Features.features.depthBiasClamp);
       RETINA_ENABLE_FEATURE_OR_PANIC(Features.features.depthBounds);
@@ -386,6 +492,14 @@ namespace Retina::Graphics {
         RETINA_ENABLE_FEATURE_OR_PANIC(MemoryPriorityFeatures.memoryPriority);
       }
 
+      if (requestedFeatures.GraphicsPipelineLibrary) {
+        RETINA_ENABLE_FEATURE_OR_PANIC(GraphicsPipelineLibraryFeatures.graphicsPipelineLibrary);
+      }
+
+      if (requestedFeatures.DescriptorBuffer) {
+        RETINA_ENABLE_FEATURE_OR_PANIC(DescriptorBufferFeatures.descriptorBuffer);
+      }
+
       RETINA_GRAPHICS_INFO("Enabled device features");
 #undef RETINA_ENABLE_FEATURE_OR_PANIC
       return enabledFeatures;
@@ -480,9 +594,18 @@ namespace Retina::Graphics {
   CDevice::~CDevice() noexcept {
     RETINA_PROFILE_SCOPED();
     if (_handle) {
+      // Joined first, queued pipeline work still uses the device
+      _workerPool.Reset();
+      // Pending shader resource table destructions still point into the table
+      _deletionQueue->Flush();
       _shaderResourceTable.Reset();
       _deletionQueue->Flush();
+      _pipelineLibraryCache.Reset();
+      _pipelineCache.Reset();
       _mainTimeline.Reset();
+      _transferQueue->ReleaseImmediateContexts();
+      _computeQueue->ReleaseImmediateContexts();
+      _graphicsQueue->ReleaseImmediateContexts();
       _transferQueue.Reset();
       _computeQueue.Reset();
       _graphicsQueue.Reset();
@@ -503,8 +626,9 @@ namespace Retina::Graphics {
     const auto physicalDeviceFeatures = Details::GetPhysicalDeviceFeatures(physicalDevice);
     const auto physicalDeviceQueues = Details::GetPhysicalDeviceQueueProperties(physicalDevice);
     const auto availableDeviceExtensions = Details::EnumeratePhysicalDeviceExtensions(physicalDevice);
-    const auto enabledDeviceExtensions = Details::GetEnabledDeviceExtensions(instance, physicalDevice, createInfo.Features, availableDeviceExtensions);
-    const auto enabledDeviceFeatures = Details::GetEnabledDeviceFeatures(createInfo.Features, physicalDeviceFeatures);
+    const auto resolvedFeatures = Details::ResolveDeviceFeatures(createInfo, physicalDeviceFeatures, availableDeviceExtensions);
+    const auto enabledDeviceExtensions = Details::GetEnabledDeviceExtensions(instance, physicalDevice, resolvedFeatures, availableDeviceExtensions);
+    const auto enabledDeviceFeatures = Details::GetEnabledDeviceFeatures(resolvedFeatures, physicalDeviceFeatures);
     const auto deviceRayTracingProperties = Details::MakeDeviceRayTracingProperties(physicalDeviceProperties);
     const auto deviceQueueInfos = Details::MakeDeviceQueueInfos(physicalDeviceQueues);
     const auto [
@@ -543,6 +667,7 @@ namespace Retina::Graphics {
     self->_allocator = allocator;
     self->_rayTracingProperties = deviceRayTracingProperties;
     self->_createInfo = createInfo;
+    self->_createInfo.Features = resolvedFeatures;
     self->_instance = instance.ToArcPtr();
 
     self->_graphicsQueue = CQueue::Make(*self, {
@@ -571,7 +696,13 @@ namespace Retina::Graphics {
     }
     self->_mainTimeline = CHostDeviceTimeline::Make(*self, -1);
     self->_deletionQueue = CDeletionQueue::Make(*self);
+    self->_pipelineCache = CPipelineCache::Make(*self, {
+      .Name = "MainPipelineCache",
+      .Path = createInfo.PipelineCachePath,
+    });
+    self->_pipelineLibraryCache = CPipelineLibraryCache::Make(*self);
     self->_shaderResourceTable = CShaderResourceTable::Make(*self);
+    self->_workerPool = Core::CWorkerPool::Make();
 
     {
       const auto& memoryProperties = physicalDeviceProperties.MemoryProperties.memoryProperties;
@@ -636,11 +767,26 @@ namespace Retina::Graphics {
     return *_deletionQueue;
   }
 
+  auto CDevice::GetPipelineCache() const noexcept -> const CPipelineCache& {
+    RETINA_PROFILE_SCOPED();
+    return *_pipelineCache;
+  }
+
+  auto CDevice::GetPipelineLibraryCache() const noexcept -> CPipelineLibraryCache& {
+    RETINA_PROFILE_SCOPED();
+    return *_pipelineLibraryCache;
+  }
+
   auto CDevice::GetShaderResourceTable() const noexcept -> CShaderResourceTable& {
     RETINA_PROFILE_SCOPED();
     return *_shaderResourceTable;
   }
 
+  auto CDevice::GetWorkerPool() const noexcept -> Core::CWorkerPool& {
+    RETINA_PROFILE_SCOPED();
+    return *_workerPool;
+  }
+
   auto CDevice::GetCreateInfo() const noexcept -> const SDeviceCreateInfo& {
     RETINA_PROFILE_SCOPED();
     return _createInfo;
@@ -704,5 +850,7 @@ namespace Retina::Graphics {
   auto CDevice::Tick() noexcept -> void {
     RETINA_PROFILE_SCOPED();
     _deletionQueue->Tick();
+    _pipelineCache->Tick();
+    _pipelineLibraryCache->Tick();
   }
 }
@@ -1,17 +1,325 @@
+#include <Retina/Graphics/DeletionQueue.hpp>
 #include <Retina/Graphics/DescriptorLayout.hpp>
 #include <Retina/Graphics/Device.hpp>
 #include <Retina/Graphics/Logger.hpp>
 #include <Retina/Graphics/Macros.hpp>
 #include <Retina/Graphics/GraphicsPipeline.hpp>
-
-#include <spirv_glsl.hpp>
+#include <Retina/Graphics/PipelineCache.hpp>
+#include <Retina/Graphics/PipelineLibraryCache.hpp>
 
 #include <volk.h>
 
+#include <chrono>
+#include <future>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
 #include <vector>
 #include <array>
 
 namespace Retina::Graphics {
+  namespace Details {
+    // Keys are built field by field, copying whole structures would take their padding bytes along
+    template <typename T>
+      requires (std::is_scalar_v<T>)
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, T value) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const VkViewport& viewport) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, viewport.x);
+      AppendPipelineLibraryKey(key, viewport.y);
+      AppendPipelineLibraryKey(key, viewport.width);
+      AppendPipelineLibraryKey(key, viewport.height);
+      AppendPipelineLibraryKey(key, viewport.minDepth);
+      AppendPipelineLibraryKey(key, viewport.maxDepth);
+    }
+
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const VkRect2D& scissor) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, scissor.offset.x);
+      AppendPipelineLibraryKey(key, scissor.offset.y);
+      AppendPipelineLibraryKey(key, scissor.extent.width);
+      AppendPipelineLibraryKey(key, scissor.extent.height);
+    }
+
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const VkSpecializationMapEntry& entry) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, entry.constantID);
+      AppendPipelineLibraryKey(key, entry.offset);
+      AppendPipelineLibraryKey(key, entry.size);
+    }
+
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const VkPushConstantRange& range) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, range.stageFlags);
+      AppendPipelineLibraryKey(key, range.offset);
+      AppendPipelineLibraryKey(key, range.size);
+    }
+
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const SDescriptorLayoutBinding& binding) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, binding.Count);
+      AppendPipelineLibraryKey(key, binding.Flags);
+      AppendPipelineLibraryKey(key, binding.Stages);
+      AppendPipelineLibraryKey(key, binding.Type);
+    }
+
+    // Layouts are keyed by their description, a destroyed layout's handle value may be reused by an unrelated one
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const CDescriptorLayout& layout) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      const auto& createInfo = layout.GetCreateInfo();
+      AppendPipelineLibraryKey(key, createInfo.Flags);
+      AppendPipelineLibraryKey(key, createInfo.Bindings.size());
+      for (const auto& binding : createInfo.Bindings) {
+        AppendPipelineLibraryKey(key, binding);
+      }
+    }
+
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const VkPipelineColorBlendAttachmentState& attachment) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, attachment.blendEnable);
+      AppendPipelineLibraryKey(key, attachment.srcColorBlendFactor);
+      AppendPipelineLibraryKey(key, attachment.dstColorBlendFactor);
+      AppendPipelineLibraryKey(key, attachment.colorBlendOp);
+      AppendPipelineLibraryKey(key, attachment.srcAlphaBlendFactor);
+      AppendPipelineLibraryKey(key, attachment.dstAlphaBlendFactor);
+      AppendPipelineLibraryKey(key, attachment.alphaBlendOp);
+      AppendPipelineLibraryKey(key, attachment.colorWriteMask);
+    }
+
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const VkStencilOpState& state) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, state.failOp);
+      AppendPipelineLibraryKey(key, state.passOp);
+      AppendPipelineLibraryKey(key, state.depthFailOp);
+      AppendPipelineLibraryKey(key, state.compareOp);
+      AppendPipelineLibraryKey(key, state.compareMask);
+      AppendPipelineLibraryKey(key, state.writeMask);
+      AppendPipelineLibraryKey(key, state.reference);
+    }
+
+    // State structures are keyed by everything past the "sType" and "pNext" header, chained state is not supported
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const VkPipelineInputAssemblyStateCreateInfo& state) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, state.flags);
+      AppendPipelineLibraryKey(key, state.topology);
+      AppendPipelineLibraryKey(key, state.primitiveRestartEnable);
+    }
+
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const VkPipelineTessellationStateCreateInfo& state) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, state.flags);
+      AppendPipelineLibraryKey(key, state.patchControlPoints);
+    }
+
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const VkPipelineRasterizationStateCreateInfo& state) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, state.flags);
+      AppendPipelineLibraryKey(key, state.depthClampEnable);
+      AppendPipelineLibraryKey(key, state.rasterizerDiscardEnable);
+      AppendPipelineLibraryKey(key, state.polygonMode);
+      AppendPipelineLibraryKey(key, state.cullMode);
+      AppendPipelineLibraryKey(key, state.frontFace);
+      AppendPipelineLibraryKey(key, state.depthBiasEnable);
+      AppendPipelineLibraryKey(key, state.depthBiasConstantFactor);
+      AppendPipelineLibraryKey(key, state.depthBiasClamp);
+      AppendPipelineLibraryKey(key, state.depthBiasSlopeFactor);
+      AppendPipelineLibraryKey(key, state.lineWidth);
+    }
+
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const VkPipelineMultisampleStateCreateInfo& state) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, state.flags);
+      AppendPipelineLibraryKey(key, state.rasterizationSamples);
+      AppendPipelineLibraryKey(key, state.sampleShadingEnable);
+      AppendPipelineLibraryKey(key, state.minSampleShading);
+      // One mask word per 32 samples, the pointer itself says nothing about the state
+      AppendPipelineLibraryKey(key, state.pSampleMask != nullptr);
+      if (state.pSampleMask) {
+        const auto maskWordCount = (static_cast<uint32>(state.rasterizationSamples) + 31) / 32;
+        for (auto i = 0_u32; i < maskWordCount; ++i) {
+          AppendPipelineLibraryKey(key, state.pSampleMask[i]);
+        }
+      }
+      AppendPipelineLibraryKey(key, state.alphaToCoverageEnable);
+      AppendPipelineLibraryKey(key, state.alphaToOneEnable);
+    }
+
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, const VkPipelineDepthStencilStateCreateInfo& state) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, state.flags);
+      AppendPipelineLibraryKey(key, state.depthTestEnable);
+      AppendPipelineLibraryKey(key, state.depthWriteEnable);
+      AppendPipelineLibraryKey(key, state.depthCompareOp);
+      AppendPipelineLibraryKey(key, state.depthBoundsTestEnable);
+      AppendPipelineLibraryKey(key, state.stencilTestEnable);
+      AppendPipelineLibraryKey(key, state.front);
+      AppendPipelineLibraryKey(key, state.back);
+      AppendPipelineLibraryKey(key, state.minDepthBounds);
+      AppendPipelineLibraryKey(key, state.maxDepthBounds);
+    }
+
+    // Prefixed with the element count, so neighbouring ranges cannot be confused with each other
+    template <typename T>
+    RETINA_INLINE auto AppendPipelineLibraryKey(std::string& key, std::span<const T> values) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      AppendPipelineLibraryKey(key, values.size());
+      if constexpr (std::is_scalar_v<T>) {
+        key.append(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+      } else {
+        for (const auto& value : values) {
+          AppendPipelineLibraryKey(key, value);
+        }
+      }
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto AcquireGraphicsPipelineLibrary(
+      const CDevice& device,
+      VkGraphicsPipelineCreateInfo pipelineCreateInfo,
+      VkGraphicsPipelineLibraryFlagsEXT flags,
+      std::span<const VkPipelineShaderStageCreateInfo> stages,
+      std::string_view key
+    ) noexcept -> VkPipeline {
+      RETINA_PROFILE_SCOPED();
+      auto libraryCreateInfo = VkGraphicsPipelineLibraryCreateInfoEXT(VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT);
+      libraryCreateInfo.pNext = pipelineCreateInfo.pNext;
+      libraryCreateInfo.flags = flags;
+
+      pipelineCreateInfo.pNext = &libraryCreateInfo;
+      pipelineCreateInfo.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+      pipelineCreateInfo.stageCount = stages.size();
+      pipelineCreateInfo.pStages = stages.data();
+
+      auto libraryKey = std::string();
+      AppendPipelineLibraryKey(libraryKey, flags);
+      libraryKey += key;
+      return device.GetPipelineLibraryCache().Acquire(std::move(libraryKey), pipelineCreateInfo);
+    }
+
+    // Vertex input, pre-rasterization, fragment shader and fragment output libraries, each keyed by the state it is built from.
+    // State a library does not use is ignored by the driver, so every library is created from the complete pipeline state
+    RETINA_NODISCARD RETINA_INLINE auto AcquireGraphicsPipelineLibraries(
+      const CDevice& device,
+      const VkGraphicsPipelineCreateInfo& pipelineCreateInfo,
+      const SShaderBinary& vertexShader,
+      const SShaderBinary* fragmentShader,
+      const SSpecializationData& specializationData,
+      std::span<const Core::CReferenceWrapper<const CDescriptorLayout>> descriptorLayouts,
+      const VkPushConstantRange& pushConstantRange
+    ) noexcept -> std::array<VkPipeline, 4> {
+      RETINA_PROFILE_SCOPED();
+      const auto& renderingCreateInfo = *static_cast<const VkPipelineRenderingCreateInfo*>(pipelineCreateInfo.pNext);
+      const auto& viewportStateCreateInfo = *pipelineCreateInfo.pViewportState;
+      const auto& colorBlendStateCreateInfo = *pipelineCreateInfo.pColorBlendState;
+      const auto& dynamicStateCreateInfo = *pipelineCreateInfo.pDynamicState;
+      const auto stages = std::span(pipelineCreateInfo.pStages, pipelineCreateInfo.stageCount);
+
+      auto commonKey = std::string();
+      AppendPipelineLibraryKey(commonKey, std::span(dynamicStateCreateInfo.pDynamicStates, dynamicStateCreateInfo.dynamicStateCount));
+      AppendPipelineLibraryKey(commonKey, renderingCreateInfo.viewMask);
+
+      auto layoutKey = std::string();
+      AppendPipelineLibraryKey(layoutKey, descriptorLayouts);
+      AppendPipelineLibraryKey(layoutKey, pushConstantRange);
+      AppendPipelineLibraryKey(layoutKey, std::span<const VkSpecializationMapEntry>(specializationData.MapEntries));
+      AppendPipelineLibraryKey(layoutKey, std::span<const uint32>(specializationData.Data));
+
+      // Vertex input is always empty, geometry is pulled from buffers by the shaders
+      auto vertexInputKey = commonKey;
+      AppendPipelineLibraryKey(vertexInputKey, *pipelineCreateInfo.pInputAssemblyState);
+
+      auto preRasterizationKey = commonKey + layoutKey;
+      AppendPipelineLibraryKey(preRasterizationKey, std::span<const uint32>(vertexShader.Spirv));
+      AppendPipelineLibraryKey(preRasterizationKey, std::span(viewportStateCreateInfo.pViewports, viewportStateCreateInfo.viewportCount));
+      AppendPipelineLibraryKey(preRasterizationKey, std::span(viewportStateCreateInfo.pScissors, viewportStateCreateInfo.scissorCount));
+      AppendPipelineLibraryKey(preRasterizationKey, *pipelineCreateInfo.pTessellationState);
+      AppendPipelineLibraryKey(preRasterizationKey, *pipelineCreateInfo.pRasterizationState);
+
+      auto fragmentShaderKey = commonKey + layoutKey;
+      if (fragmentShader) {
+        AppendPipelineLibraryKey(fragmentShaderKey, std::span<const uint32>(fragmentShader->Spirv));
+      }
+      AppendPipelineLibraryKey(fragmentShaderKey, *pipelineCreateInfo.pMultisampleState);
+      AppendPipelineLibraryKey(fragmentShaderKey, *pipelineCreateInfo.pDepthStencilState);
+
+      auto fragmentOutputKey = commonKey;
+      AppendPipelineLibraryKey(fragmentOutputKey, std::span(renderingCreateInfo.pColorAttachmentFormats, renderingCreateInfo.colorAttachmentCount));
+      AppendPipelineLibraryKey(fragmentOutputKey, renderingCreateInfo.depthAttachmentFormat);
+      AppendPipelineLibraryKey(fragmentOutputKey, renderingCreateInfo.stencilAttachmentFormat);
+      AppendPipelineLibraryKey(fragmentOutputKey, std::span(colorBlendStateCreateInfo.pAttachments, colorBlendStateCreateInfo.attachmentCount));
+      AppendPipelineLibraryKey(fragmentOutputKey, colorBlendStateCreateInfo.logicOpEnable);
+      AppendPipelineLibraryKey(fragmentOutputKey, colorBlendStateCreateInfo.logicOp);
+      AppendPipelineLibraryKey(fragmentOutputKey, std::span<const float32>(colorBlendStateCreateInfo.blendConstants));
+      AppendPipelineLibraryKey(fragmentOutputKey, *pipelineCreateInfo.pMultisampleState);
+
+      return {
+        AcquireGraphicsPipelineLibrary(
+          device,
+          pipelineCreateInfo,
+          VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+          {},
+          vertexInputKey
+        ),
+        AcquireGraphicsPipelineLibrary(
+          device,
+          pipelineCreateInfo,
+          VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+          stages.first(1),
+          preRasterizationKey
+        ),
+        AcquireGraphicsPipelineLibrary(
+          device,
+          pipelineCreateInfo,
+          VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+          stages.subspan(1),
+          fragmentShaderKey
+        ),
+        AcquireGraphicsPipelineLibrary(
+          device,
+          pipelineCreateInfo,
+          VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT,
+          {},
+          fragmentOutputKey
+        ),
+      };
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto LinkGraphicsPipelineLibraries(
+      const CDevice& device,
+      std::span<const VkPipeline> libraries,
+      VkPipelineLayout layout,
+      VkPipelineCreateFlags flags
+    ) noexcept -> VkPipeline {
+      RETINA_PROFILE_SCOPED();
+      auto libraryCreateInfo = VkPipelineLibraryCreateInfoKHR(VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR);
+      libraryCreateInfo.libraryCount = libraries.size();
+      libraryCreateInfo.pLibraries = libraries.data();
+
+      auto pipelineCreateInfo = VkGraphicsPipelineCreateInfo(VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO);
+      pipelineCreateInfo.pNext = &libraryCreateInfo;
+      pipelineCreateInfo.flags = flags;
+      pipelineCreateInfo.layout = layout;
+      pipelineCreateInfo.basePipelineIndex = -1;
+
+      auto pipelineHandle = VkPipeline();
+      RETINA_GRAPHICS_VULKAN_CHECK(
+        vkCreateGraphicsPipelines(
+          device.GetHandle(),
+          device.GetPipelineCache().GetHandle(),
+          1,
+          &pipelineCreateInfo,
+          nullptr,
+          &pipelineHandle
+        )
+      );
+      return pipelineHandle;
+    }
+  }
+
   CGraphicsPipeline::CGraphicsPipeline() noexcept
     : IPipeline(EPipelineType::E_GRAPHICS)
   {
@@ -20,6 +328,10 @@ namespace Retina::Graphics {
 
   CGraphicsPipeline::~CGraphicsPipeline() noexcept {
     RETINA_PROFILE_SCOPED();
+    if (_optimizedHandle.valid()) {
+      _device->GetPipelineLibraryCache().Unregister(*this);
+      vkDestroyPipeline(_device->GetHandle(), _optimizedHandle.get(), nullptr);
+    }
     if (_handle) {
       RETINA_GRAPHICS_INFO("Graphics pipeline ({}) destroyed", GetDebugName());
     }
@@ -31,35 +343,37 @@ namespace Retina::Graphics {
   ) noexcept -> Core::CArcPtr<CGraphicsPipeline> {
     RETINA_PROFILE_SCOPED();
     auto self = Core::CArcPtr(new CGraphicsPipeline());
+    const auto specializationData = Details::MakeSpecializationData(createInfo.SpecializationConstants);
+    const auto specializationInfo = Details::MakeNativeSpecializationInfo(specializationData);
     auto shaderStages = std::vector<VkPipelineShaderStageCreateInfo>();
 
-    const auto vertexShaderBinary = Details::CompileShaderFromSource(
+    const auto vertexShader = Details::LoadShader(
       createInfo.VertexShader,
       createInfo.IncludeDirectories,
       EShaderStageFlag::E_VERTEX
     );
-    const auto vertexShaderCompiler = Core::MakeUnique<spirv_cross::CompilerGLSL>(vertexShaderBinary);
     {
       auto stage = VkPipelineShaderStageCreateInfo(VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
       stage.stage = VK_SHADER_STAGE_VERTEX_BIT;
-      stage.module = Details::MakeShaderModule(device, vertexShaderBinary);
+      stage.module = Details::MakeShaderModule(device, vertexShader.Spirv);
       stage.pName = "main";
+      stage.pSpecializationInfo = &specializationInfo;
       shaderStages.emplace_back(stage);
     }
 
-    auto fragmentShaderCompiler = Core::CUniquePtr<spirv_cross::CompilerGLSL>();
+    auto fragmentShader = std::optional<Details::SShaderBinary>();
     if (createInfo.FragmentShader) {
-      const auto fragmentShaderBinary = Details::CompileShaderFromSource(
+      fragmentShader = Details::LoadShader(
         createInfo.FragmentShader.value(),
         createInfo.IncludeDirectories,
         EShaderStageFlag::E_FRAGMENT
       );
-      fragmentShaderCompiler = Core::MakeUnique<spirv_cross::CompilerGLSL>(fragmentShaderBinary);
       {
         auto stage = VkPipelineShaderStageCreateInfo(VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
         stage.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-        stage.module = Details::MakeShaderModule(device, fragmentShaderBinary);
+        stage.module = Details::MakeShaderModule(device, fragmentShader->Spirv);
         stage.pName = "main";
+        stage.pSpecializationInfo = &specializationInfo;
         shaderStages.emplace_back(stage);
       }
     }
@@ -154,26 +468,8 @@ namespace Retina::Graphics {
     depthStencilStateCreateInfo.maxDepthBounds = createInfo.DepthStencilState.MaxDepthBounds;
 
     auto colorBlendAttachments = createInfo.ColorBlendState.Attachments;
-    if (fragmentShaderCompiler && colorBlendAttachments.empty()) {
-      const auto& resources = fragmentShaderCompiler->get_shader_resources();
-      for (const auto& stageOutput : resources.stage_outputs) {
-        const auto& type = fragmentShaderCompiler->get_type(stageOutput.base_type_id);
-        const auto colorWriteMask = [&] {
-          auto mask = EColorComponentFlag();
-          switch (type.vecsize) {
-            case 4: mask |= EColorComponentFlag::E_A; RETINA_FALLTHROUGH;
-            case 3: mask |= EColorComponentFlag::E_B; RETINA_FALLTHROUGH;
-            case 2: mask |= EColorComponentFlag::E_G; RETINA_FALLTHROUGH;
-            case 1: mask |= EColorComponentFlag::E_R; break;
-            default: std::unreachable();
-          }
-          return mask;
-        }();
-
-        auto colorBlendAttachmentInfo = SPipelineColorBlendAttachmentInfo();
-        colorBlendAttachmentInfo.ColorWriteMask = colorWriteMask;
-        colorBlendAttachments.emplace_back(colorBlendAttachmentInfo);
-      }
+    if (fragmentShader && colorBlendAttachments.empty()) {
+      colorBlendAttachments = Details::ReflectColorBlendAttachments(*fragmentShader);
     }
     auto colorBlendAttachmentStates = std::vector<VkPipelineColorBlendAttachmentState>();
     colorBlendAttachmentStates.reserve(colorBlendAttachments.size());
@@ -229,9 +525,9 @@ namespace Retina::Graphics {
     }
 
     const auto descriptorLayoutHandles = Details::MakeDescriptorLayoutHandles(createInfo.DescriptorLayouts);
-    const auto pushConstantRange = Details::ReflectPushConstantRange(std::to_array({
-      vertexShaderCompiler.Get(),
-      fragmentShaderCompiler.Get()
+    const auto pushConstantRange = Details::ReflectPushConstantRange(std::to_array<const Details::SShaderBinary*>({
+      &vertexShader,
+      fragmentShader ? &*fragmentShader : nullptr
     }));
     const auto nativePushConstantInfo = std::bit_cast<VkPushConstantRange>(pushConstantRange);
 
@@ -255,6 +551,7 @@ namespace Retina::Graphics {
 
     auto pipelineCreateInfo = VkGraphicsPipelineCreateInfo(VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO);
     pipelineCreateInfo.pNext = &pipelineRenderingCreateInfo;
+    pipelineCreateInfo.flags = Details::MakeDescriptorLayoutPipelineFlags(createInfo.DescriptorLayouts);
     pipelineCreateInfo.stageCount = shaderStages.size();
     pipelineCreateInfo.pStages = shaderStages.data();
     pipelineCreateInfo.pVertexInputState = &vertexInputStateCreateInfo;
@@ -270,16 +567,39 @@ namespace Retina::Graphics {
     pipelineCreateInfo.basePipelineIndex = -1;
 
     auto pipelineHandle = VkPipeline();
-    RETINA_GRAPHICS_VULKAN_CHECK(
-      vkCreateGraphicsPipelines(
-        device.GetHandle(),
-        VK_NULL_HANDLE,
-        1,
-        &pipelineCreateInfo,
-        nullptr,
-        &pipelineHandle
-      )
-    );
+    if (device.IsFeatureEnabled(&SDeviceFeature::GraphicsPipelineLibrary)) {
+      // Fast linking only stitches the libraries together, the optimized link replaces it once it is compiled
+      const auto libraries = Details::AcquireGraphicsPipelineLibraries(
+        device,
+        pipelineCreateInfo,
+        vertexShader,
+        fragmentShader ? &*fragmentShader : nullptr,
+        specializationData,
+        createInfo.DescriptorLayouts,
+        nativePushConstantInfo
+      );
+      const auto flags = pipelineCreateInfo.flags;
+      pipelineHandle = Details::LinkGraphicsPipelineLibraries(device, libraries, pipelineLayoutHandle, flags);
+      self->_optimizedHandle = device.GetWorkerPool().Submit([&device, libraries, pipelineLayoutHandle, flags] noexcept {
+        return Details::LinkGraphicsPipelineLibraries(
+          device,
+          libraries,
+          pipelineLayoutHandle,
+          flags | VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT
+        );
+      });
+    } else {
+      RETINA_GRAPHICS_VULKAN_CHECK(
+        vkCreateGraphicsPipelines(
+          device.GetHandle(),
+          device.GetPipelineCache().GetHandle(),
+          1,
+          &pipelineCreateInfo,
+          nullptr,
+          &pipelineHandle
+        )
+      );
+    }
     RETINA_GRAPHICS_INFO("Graphics pipeline ({}) initialized", createInfo.Name);
 
     for (const auto& stage : shaderStages) {
@@ -290,10 +610,14 @@ namespace Retina::Graphics {
     self->_layout = {
       .Handle = pipelineLayoutHandle,
       .PushConstant = pushConstantRange,
+      .DescriptorLayouts = descriptorLayoutHandles,
     };
     self->_createInfo = createInfo;
     self->_device = device.ToArcPtr();
     self->SetDebugName(createInfo.Name);
+    if (self->_optimizedHandle.valid()) {
+      device.GetPipelineLibraryCache().Register(*self);
+    }
     return self;
   }
 
@@ -312,4 +636,22 @@ namespace Retina::Graphics {
     RETINA_GRAPHICS_SET_DEBUG_NAME(_device->GetHandle(), _handle, VK_OBJECT_TYPE_PIPELINE, name);
     _createInfo.Name = name;
   }
+
+  auto CGraphicsPipeline::TryPromoteOptimizedHandle() noexcept -> bool {
+    RETINA_PROFILE_SCOPED();
+    if (!_optimizedHandle.valid()) {
+      return true;
+    }
+    if (_optimizedHandle.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return false;
+    }
+    // Frames in flight may still be recorded with the fast linked handle
+    _device->GetDeletionQueue().Enqueue([device = _device->GetHandle(), handle = _handle] noexcept {
+      vkDestroyPipeline(device, handle, nullptr);
+    });
+    _handle = _optimizedHandle.get();
+    RETINA_GRAPHICS_SET_DEBUG_NAME(_device->GetHandle(), _handle, VK_OBJECT_TYPE_PIPELINE, GetDebugName());
+    RETINA_GRAPHICS_INFO("Graphics pipeline ({}) promoted to its optimized link", GetDebugName());
+    return true;
+  }
 }
\ No newline at end of file
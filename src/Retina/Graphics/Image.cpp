@@ -35,6 +35,76 @@ namespace Retina::Graphics {
       return requirements;
     }
 
+    RETINA_NODISCARD RETINA_INLINE auto GetImageQueueFamilyIndices(
+      const CDevice& device,
+      const SImageCreateInfo& createInfo
+    ) noexcept -> std::vector<uint32> {
+      RETINA_PROFILE_SCOPED();
+      if (createInfo.IsCrossDomain) {
+        auto families = std::vector<uint32> {
+          device.GetGraphicsQueue().GetFamilyIndex(),
+          device.GetComputeQueue().GetFamilyIndex(),
+          device.GetTransferQueue().GetFamilyIndex()
+        };
+        std::sort(families.begin(), families.end());
+        families.erase(std::unique(families.begin(), families.end()), families.end());
+        return families;
+      }
+      switch (createInfo.Domain) {
+        case EQueueDomain::E_GRAPHICS:
+          return { device.GetGraphicsQueue().GetFamilyIndex() };
+        case EQueueDomain::E_COMPUTE:
+          return { device.GetComputeQueue().GetFamilyIndex() };
+        case EQueueDomain::E_TRANSFER:
+          return { device.GetTransferQueue().GetFamilyIndex() };
+      }
+      std::unreachable();
+    }
+
+    // "queueFamilies" is referenced by the returned info and has to outlive it
+    RETINA_NODISCARD RETINA_INLINE auto MakeNativeImageCreateInfo(
+      const SImageCreateInfo& createInfo,
+      const std::vector<uint32>& queueFamilies
+    ) noexcept -> VkImageCreateInfo {
+      RETINA_PROFILE_SCOPED();
+      auto imageCreateInfo = VkImageCreateInfo(VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO);
+      imageCreateInfo.flags = AsEnumCounterpart(createInfo.Flags);
+      imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+      imageCreateInfo.format = AsEnumCounterpart(createInfo.Format);
+      imageCreateInfo.extent = {
+        .width = createInfo.Width,
+        .height = createInfo.Height,
+        .depth = 1
+      };
+      imageCreateInfo.mipLevels = createInfo.Levels;
+      imageCreateInfo.arrayLayers = createInfo.Layers;
+      imageCreateInfo.samples = AsEnumCounterpart(createInfo.Samples);
+      imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+      imageCreateInfo.usage = AsEnumCounterpart(createInfo.Usage);
+      imageCreateInfo.sharingMode = createInfo.IsCrossDomain
+        ? VK_SHARING_MODE_CONCURRENT
+        : VK_SHARING_MODE_EXCLUSIVE;
+      imageCreateInfo.queueFamilyIndexCount = queueFamilies.size();
+      imageCreateInfo.pQueueFamilyIndices = queueFamilies.data();
+      imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+      return imageCreateInfo;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto MakeDefaultImageView(
+      const CImage& image,
+      const SImageCreateInfo& createInfo
+    ) noexcept -> Core::CArcPtr<CImageView> {
+      RETINA_PROFILE_SCOPED();
+      if (!createInfo.ViewInfo) {
+        return {};
+      }
+      auto viewInfo = *createInfo.ViewInfo;
+      if (viewInfo.Name.empty()) {
+        viewInfo.Name = std::format("{}View", createInfo.Name);
+      }
+      return CImageView::Make(image, viewInfo);
+    }
+
     RETINA_NODISCARD RETINA_INLINE auto GetSwapchainImages(
       const CDevice& device,
       const CSwapchain& swapchain
@@ -58,7 +128,11 @@ namespace Retina::Graphics {
     RETINA_PROFILE_SCOPED();
     _view.Reset();
     const auto isSparse = Core::IsFlagEnabled(_createInfo.Flags, EImageCreateFlag::E_SPARSE_BINDING);
-    if (_allocation) {
+    if (_isAliased) {
+      // The memory belongs to whoever aliased it
+      vkDestroyImage(_device->GetHandle(), _handle, nullptr);
+      RETINA_GRAPHICS_INFO("Image ({}) destroyed", GetDebugName());
+    } else if (_allocation) {
       vmaDestroyImage(_device->GetAllocator(), _handle, _allocation);
       RETINA_GRAPHICS_INFO("Image ({}) destroyed", GetDebugName());
     } else if (_handle && isSparse) {
@@ -70,50 +144,9 @@ namespace Retina::Graphics {
   auto CImage::Make(const CDevice& device, const SImageCreateInfo& createInfo) noexcept -> Core::CArcPtr<CImage> {
     RETINA_PROFILE_SCOPED();
     auto self = Core::CArcPtr(new CImage(device));
-    const auto sharingMode = createInfo.IsCrossDomain
-      ? VK_SHARING_MODE_CONCURRENT
-      : VK_SHARING_MODE_EXCLUSIVE;
-    const auto queueFamilies = [&] noexcept -> std::vector<uint32> {
-      if (createInfo.IsCrossDomain) {
-        auto families = std::vector<uint32> {
-          device.GetGraphicsQueue().GetFamilyIndex(),
-          device.GetComputeQueue().GetFamilyIndex(),
-          device.GetTransferQueue().GetFamilyIndex()
-        };
-        std::sort(families.begin(), families.end());
-        families.erase(std::unique(families.begin(), families.end()), families.end());
-        return families;
-      }
-      switch (createInfo.Domain) {
-        case EQueueDomain::E_GRAPHICS:
-          return { device.GetGraphicsQueue().GetFamilyIndex() };
-        case EQueueDomain::E_COMPUTE:
-          return { device.GetComputeQueue().GetFamilyIndex() };
-        case EQueueDomain::E_TRANSFER:
-          return { device.GetTransferQueue().GetFamilyIndex() };
-      }
-      std::unreachable();
-    }();
-
+    const auto queueFamilies = Details::GetImageQueueFamilyIndices(device, createInfo);
     const auto aspectMask = ImageAspectMaskFrom(createInfo.Format);
-    auto imageCreateInfo = VkImageCreateInfo(VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO);
-    imageCreateInfo.flags = AsEnumCounterpart(createInfo.Flags);
-    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageCreateInfo.format = AsEnumCounterpart(createInfo.Format);
-    imageCreateInfo.extent = {
-      .width = createInfo.Width,
-      .height = createInfo.Height,
-      .depth = 1
-    };
-    imageCreateInfo.mipLevels = createInfo.Levels;
-    imageCreateInfo.arrayLayers = createInfo.Layers;
-    imageCreateInfo.samples = AsEnumCounterpart(createInfo.Samples);
-    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageCreateInfo.usage = AsEnumCounterpart(createInfo.Usage);
-    imageCreateInfo.sharingMode = sharingMode;
-    imageCreateInfo.queueFamilyIndexCount = queueFamilies.size();
-    imageCreateInfo.pQueueFamilyIndices = queueFamilies.data();
-    imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    const auto imageCreateInfo = Details::MakeNativeImageCreateInfo(createInfo, queueFamilies);
 
     const auto isAttachment =
       Core::IsFlagEnabled(createInfo.Usage, EImageUsageFlag::E_COLOR_ATTACHMENT) ||
@@ -149,7 +182,12 @@ namespace Retina::Graphics {
         allocationCreateInfo.priority = 1.0f;
       }
 
-      vmaCreateImage(
+      // Transient attachments never leave tile memory on devices that expose lazily allocated memory
+      const auto isTransient = Core::IsFlagEnabled(createInfo.Usage, EImageUsageFlag::E_TRANSIENT_ATTACHMENT);
+      if (isTransient) {
+        allocationCreateInfo.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+      }
+      auto result = vmaCreateImage(
         device.GetAllocator(),
         &imageCreateInfo,
         &allocationCreateInfo,
@@ -157,6 +195,18 @@ namespace Retina::Graphics {
         &allocationHandle,
         &allocationInfo
       );
+      if (isTransient && result == VK_ERROR_FEATURE_NOT_PRESENT) {
+        allocationCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        result = vmaCreateImage(
+          device.GetAllocator(),
+          &imageCreateInfo,
+          &allocationCreateInfo,
+          &imageHandle,
+          &allocationHandle,
+          &allocationInfo
+        );
+      }
+      RETINA_GRAPHICS_VULKAN_CHECK(result);
       memoryRequirements = Details::GetImageMemoryRequirements(device, imageHandle);
     }
 
@@ -167,16 +217,46 @@ namespace Retina::Graphics {
     self->_sparseMemoryRequirements = sparseMemoryRequirement;
     self->_createInfo = createInfo;
     self->SetDebugName(createInfo.Name);
+    self->_view = Details::MakeDefaultImageView(*self, createInfo);
 
-    if (createInfo.ViewInfo) {
-      auto viewInfo = *createInfo.ViewInfo;
-      if (viewInfo.Name.empty()) {
-        viewInfo.Name = std::format("{}View", createInfo.Name);
-      }
-      self->_view = CImageView::Make(*self, viewInfo);
-    }
+    RETINA_GRAPHICS_INFO("Image ({}) initialized", createInfo.Name);
+    return self;
+  }
+
+  auto CImage::MakeAliased(
+    const CDevice& device,
+    const SImageCreateInfo& createInfo,
+    VmaAllocation allocation,
+    uint64 offset
+  ) noexcept -> Core::CArcPtr<CImage> {
+    RETINA_PROFILE_SCOPED();
+    RETINA_ASSERT_WITH(
+      !Core::IsFlagEnabled(createInfo.Flags, EImageCreateFlag::E_SPARSE_BINDING),
+      "Sparse images cannot be aliased"
+    );
+    auto self = Core::CArcPtr(new CImage(device));
+    const auto queueFamilies = Details::GetImageQueueFamilyIndices(device, createInfo);
+    const auto imageCreateInfo = Details::MakeNativeImageCreateInfo(createInfo, queueFamilies);
+
+    auto imageHandle = VkImage();
+    RETINA_GRAPHICS_VULKAN_CHECK(vkCreateImage(device.GetHandle(), &imageCreateInfo, nullptr, &imageHandle));
+    RETINA_GRAPHICS_VULKAN_CHECK(vmaBindImageMemory2(device.GetAllocator(), allocation, offset, imageHandle, nullptr));
+
+    auto allocationInfo = VmaAllocationInfo();
+    vmaGetAllocationInfo(device.GetAllocator(), allocation, &allocationInfo);
+
+    self->_handle = imageHandle;
+    self->_allocation = allocation;
+    self->_allocationInfo = allocationInfo;
+    self->_isAliased = true;
+    self->_aliasOffset = offset;
+    self->_memoryRequirements = Details::GetImageMemoryRequirements(device, imageHandle);
+    self->_createInfo = createInfo;
+    self->SetDebugName(createInfo.Name);
+    self->_view = Details::MakeDefaultImageView(*self, createInfo);
 
     RETINA_GRAPHICS_INFO("Image ({}) initialized", createInfo.Name);
+    RETINA_GRAPHICS_INFO(" - Aliased at offset: {}", offset);
     return self;
   }
 
@@ -210,6 +290,20 @@ namespace Retina::Graphics {
     return images;
   }
 
+  auto CImage::QueryMemoryRequirements(
+    const CDevice& device,
+    const SImageCreateInfo& createInfo
+  ) noexcept -> VkMemoryRequirements {
+    RETINA_PROFILE_SCOPED();
+    const auto queueFamilies = Details::GetImageQueueFamilyIndices(device, createInfo);
+    const auto imageCreateInfo = Details::MakeNativeImageCreateInfo(createInfo, queueFamilies);
+    auto requirementsInfo = VkDeviceImageMemoryRequirements(VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS);
+    requirementsInfo.pCreateInfo = &imageCreateInfo;
+    auto requirements = VkMemoryRequirements2(VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2);
+    vkGetDeviceImageMemoryRequirements(device.GetHandle(), &requirementsInfo, &requirements);
+    return requirements.memoryRequirements;
+  }
+
   auto CImage::GetHandle() const noexcept -> VkImage {
     RETINA_PROFILE_SCOPED();
     return _handle;
@@ -225,6 +319,16 @@ namespace Retina::Graphics {
     return _allocationInfo;
   }
 
+  auto CImage::IsAliased() const noexcept -> bool {
+    RETINA_PROFILE_SCOPED();
+    return _isAliased;
+  }
+
+  auto CImage::GetAliasOffset() const noexcept -> uint64 {
+    RETINA_PROFILE_SCOPED();
+    return _aliasOffset;
+  }
+
   auto CImage::GetMemoryRequirements() const noexcept -> const VkMemoryRequirements& {
     RETINA_PROFILE_SCOPED();
     return _memoryRequirements;
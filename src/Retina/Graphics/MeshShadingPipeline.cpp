@@ -3,11 +3,11 @@
 #include <Retina/Graphics/Logger.hpp>
 #include <Retina/Graphics/Macros.hpp>
 #include <Retina/Graphics/MeshShadingPipeline.hpp>
-
-#include <spirv_glsl.hpp>
+#include <Retina/Graphics/PipelineCache.hpp>
 
 #include <volk.h>
 
+#include <optional>
 #include <vector>
 #include <array>
 
@@ -31,52 +31,54 @@ namespace Retina::Graphics {
   ) noexcept -> Core::CArcPtr<CMeshShadingPipeline> {
     RETINA_PROFILE_SCOPED();
     auto self = Core::CArcPtr(new CMeshShadingPipeline());
+    const auto specializationData = Details::MakeSpecializationData(createInfo.SpecializationConstants);
+    const auto specializationInfo = Details::MakeNativeSpecializationInfo(specializationData);
     auto shaderStages = std::vector<VkPipelineShaderStageCreateInfo>();
 
-    const auto meshShaderBinary = Details::CompileShaderFromSource(
+    const auto meshShader = Details::LoadShader(
       createInfo.MeshShader,
       createInfo.IncludeDirectories,
       EShaderStageFlag::E_MESH_EXT
     );
-    const auto meshShaderCompiler = Core::MakeUnique<spirv_cross::CompilerGLSL>(meshShaderBinary);
     {
       auto stage = VkPipelineShaderStageCreateInfo(VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
       stage.stage = VK_SHADER_STAGE_MESH_BIT_EXT;
-      stage.module = Details::MakeShaderModule(device, meshShaderBinary);
+      stage.module = Details::MakeShaderModule(device, meshShader.Spirv);
       stage.pName = "main";
+      stage.pSpecializationInfo = &specializationInfo;
       shaderStages.emplace_back(stage);
     }
 
-    auto taskShaderCompiler = Core::CUniquePtr<spirv_cross::CompilerGLSL>();
+    auto taskShader = std::optional<Details::SShaderBinary>();
     if (createInfo.TaskShader) {
-      const auto taskShaderBinary = Details::CompileShaderFromSource(
+      taskShader = Details::LoadShader(
         createInfo.TaskShader.value(),
         createInfo.IncludeDirectories,
         EShaderStageFlag::E_TASK_EXT
       );
-      taskShaderCompiler = Core::MakeUnique<spirv_cross::CompilerGLSL>(taskShaderBinary);
       {
         auto stage = VkPipelineShaderStageCreateInfo(VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
         stage.stage = VK_SHADER_STAGE_TASK_BIT_EXT;
-        stage.module = Details::MakeShaderModule(device, taskShaderBinary);
+        stage.module = Details::MakeShaderModule(device, taskShader->Spirv);
         stage.pName = "main";
+        stage.pSpecializationInfo = &specializationInfo;
         shaderStages.emplace_back(stage);
       }
     }
 
-    auto fragmentShaderCompiler = Core::CUniquePtr<spirv_cross::CompilerGLSL>();
+    auto fragmentShader = std::optional<Details::SShaderBinary>();
     if (createInfo.FragmentShader) {
-      const auto fragmentShaderBinary = Details::CompileShaderFromSource(
+      fragmentShader = Details::LoadShader(
         createInfo.FragmentShader.value(),
         createInfo.IncludeDirectories,
         EShaderStageFlag::E_FRAGMENT
       );
-      fragmentShaderCompiler = Core::MakeUnique<spirv_cross::CompilerGLSL>(fragmentShaderBinary);
       {
         auto stage = VkPipelineShaderStageCreateInfo(VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
         stage.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-        stage.module = Details::MakeShaderModule(device, fragmentShaderBinary);
+        stage.module = Details::MakeShaderModule(device, fragmentShader->Spirv);
         stage.pName = "main";
+        stage.pSpecializationInfo = &specializationInfo;
         shaderStages.emplace_back(stage);
       }
     }
@@ -164,26 +166,8 @@ namespace Retina::Graphics {
     depthStencilStateCreateInfo.maxDepthBounds = createInfo.DepthStencilState.MaxDepthBounds;
 
     auto colorBlendAttachments = createInfo.ColorBlendState.Attachments;
-    if (fragmentShaderCompiler && colorBlendAttachments.empty()) {
-      const auto& resources = fragmentShaderCompiler->get_shader_resources();
-      for (const auto& stageOutput : resources.stage_outputs) {
-        const auto& type = fragmentShaderCompiler->get_type(stageOutput.base_type_id);
-        const auto colorWriteMask = [&] {
-          auto mask = EColorComponentFlag();
-          switch (type.vecsize) {
-            case 4: mask |= EColorComponentFlag::E_A; RETINA_FALLTHROUGH;
-            case 3: mask |= EColorComponentFlag::E_B; RETINA_FALLTHROUGH;
-            case 2: mask |= EColorComponentFlag::E_G; RETINA_FALLTHROUGH;
-            case 1: mask |= EColorComponentFlag::E_R; break;
-            default: std::unreachable();
-          }
-          return mask;
-        }();
-
-        auto colorBlendAttachmentInfo = SPipelineColorBlendAttachmentInfo();
-        colorBlendAttachmentInfo.ColorWriteMask = colorWriteMask;
-        colorBlendAttachments.emplace_back(colorBlendAttachmentInfo);
-      }
+    if (fragmentShader && colorBlendAttachments.empty()) {
+      colorBlendAttachments = Details::ReflectColorBlendAttachments(*fragmentShader);
     }
     auto colorBlendAttachmentStates = std::vector<VkPipelineColorBlendAttachmentState>();
     colorBlendAttachmentStates.reserve(colorBlendAttachments.size());
@@ -239,10 +223,10 @@ namespace Retina::Graphics {
     }
 
     const auto descriptorLayoutHandles = Details::MakeDescriptorLayoutHandles(createInfo.DescriptorLayouts);
-    const auto pushConstantRange = Details::ReflectPushConstantRange(std::to_array({
-      meshShaderCompiler.Get(),
-      taskShaderCompiler.Get(),
-      fragmentShaderCompiler.Get()
+    const auto pushConstantRange = Details::ReflectPushConstantRange(std::to_array<const Details::SShaderBinary*>({
+      &meshShader,
+      taskShader ? &*taskShader : nullptr,
+      fragmentShader ? &*fragmentShader : nullptr
     }));
     const auto nativePushConstantInfo = std::bit_cast<VkPushConstantRange>(pushConstantRange);
 
@@ -266,6 +250,7 @@ namespace Retina::Graphics {
 
     auto pipelineCreateInfo = VkGraphicsPipelineCreateInfo(VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO);
     pipelineCreateInfo.pNext = &pipelineRenderingCreateInfo;
+    pipelineCreateInfo.flags = Details::MakeDescriptorLayoutPipelineFlags(createInfo.DescriptorLayouts);
     pipelineCreateInfo.stageCount = shaderStages.size();
     pipelineCreateInfo.pStages = shaderStages.data();
     pipelineCreateInfo.pVertexInputState = nullptr;
@@ -284,7 +269,7 @@ namespace Retina::Graphics {
     RETINA_GRAPHICS_VULKAN_CHECK(
       vkCreateGraphicsPipelines(
         device.GetHandle(),
-        VK_NULL_HANDLE,
+        device.GetPipelineCache().GetHandle(),
         1,
         &pipelineCreateInfo,
         nullptr,
@@ -301,6 +286,7 @@ namespace Retina::Graphics {
     self->_layout = {
       .Handle = pipelineLayoutHandle,
       .PushConstant = pushConstantRange,
+      .DescriptorLayouts = descriptorLayoutHandles,
     };
     self->_createInfo = createInfo;
     self->_device = device.ToArcPtr();
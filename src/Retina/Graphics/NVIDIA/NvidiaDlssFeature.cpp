@@ -225,6 +225,8 @@ namespace Retina::Graphics {
     dlssEvaluateParameters.InMVScaleX = evaluateInfo.MotionVectorScale.x;
     dlssEvaluateParameters.InMVScaleY = evaluateInfo.MotionVectorScale.y;
 
+    // NGX records straight into the handle, the barriers guarding its inputs have to be in there first
+    commands.FlushBarriers();
     RETINA_NVIDIA_CHECK(
       NGX_VULKAN_EVALUATE_DLSS_EXT(
         commands.GetHandle(),
@@ -233,6 +235,8 @@ namespace Retina::Graphics {
         &dlssEvaluateParameters
       )
     );
+    // NGX binds its own pipelines and descriptors behind the tracked state
+    commands.InvalidateState();
   }
 
   auto GetNvidiaDlssIstanceExtensions() noexcept -> std::vector<const char*> {
@@ -6,32 +6,111 @@
 
 #include <volk.h>
 
+#if defined(RETINA_ENABLE_RUNTIME_SHADER_COMPILER)
 #include <shaderc/shaderc.hpp>
+#endif
 
 #include <spirv_glsl.hpp>
 
 #include <mio/mmap.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <utility>
+#include <variant>
 #include <vector>
 #include <ranges>
 #include <span>
 
 namespace Retina::Graphics {
   namespace Details {
+#if defined(RETINA_ENABLE_RUNTIME_SHADER_COMPILER)
+    // Bumped whenever the cache layout or the way shaders are compiled changes
+    constexpr static auto SHADER_CACHE_MAGIC = 0x48535452_u32;
+    constexpr static auto SHADER_CACHE_VERSION = 1_u32;
+    constexpr static auto SHADER_COMPILE_OPTIONS = std::string_view("debug;O0;vulkan1.3;spirv1.6;glsl460core;preserve-bindings");
+
+    struct SShaderCacheHeader {
+      uint32 Magic = 0;
+      uint32 Version = 0;
+      uint64 Key = 0;
+      EShaderStageFlag Stage = {};
+      uint32 PushConstantSize = 0;
+      uint32 OutputCount = 0;
+      uint32 SpirvSize = 0;
+    };
+
+    // Sources are only shared between the pipelines of an open batch, a later batch reads edited files again
+    struct SShaderSourceCache {
+      std::mutex Mutex;
+      uint32 BatchCount = 0;
+      Core::FlatHashMap<std::string, std::shared_ptr<const std::string>> Sources;
+    };
+
+    RETINA_NODISCARD RETINA_INLINE auto GetShaderSourceCache() noexcept -> SShaderSourceCache& {
+      RETINA_PROFILE_SCOPED();
+      static auto cache = SShaderSourceCache();
+      return cache;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto ReadShaderSource(const std::filesystem::path& path) noexcept -> std::shared_ptr<const std::string> {
+      RETINA_PROFILE_SCOPED();
+      auto& cache = GetShaderSourceCache();
+      const auto key = path.generic_string();
+      {
+        const auto lock = std::lock_guard(cache.Mutex);
+        if (const auto it = cache.Sources.find(key); it != cache.Sources.end()) {
+          return it->second;
+        }
+      }
+      auto error = std::error_code();
+      const auto file = mio::make_mmap_source(key, error);
+      auto source = error
+        ? std::make_shared<const std::string>()
+        : std::make_shared<const std::string>(file.begin(), file.end());
+      const auto lock = std::lock_guard(cache.Mutex);
+      if (cache.BatchCount == 0) {
+        return source;
+      }
+      return cache.Sources.try_emplace(key, std::move(source)).first->second;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto ResolveShaderInclude(
+      std::string_view requestedSource,
+      std::span<const std::filesystem::path> includeDirectories
+    ) noexcept -> std::filesystem::path {
+      RETINA_PROFILE_SCOPED();
+      auto includePath = std::filesystem::path(requestedSource);
+      for (const auto& includeDirectory : includeDirectories) {
+        auto path = (includeDirectory / includePath).make_preferred();
+        if (std::filesystem::exists(path)) {
+          return path;
+        }
+      }
+      if (includePath.is_absolute() && std::filesystem::exists(includePath)) {
+        return includePath;
+      }
+      return {};
+    }
+
     class CShaderIncludeResult : public shaderc_include_result {
     public:
       using ShadercIncludeResult = shaderc_include_result;
 
-      CShaderIncludeResult(std::filesystem::path path) noexcept
+      CShaderIncludeResult(const std::filesystem::path& path) noexcept
         : ShadercIncludeResult(),
-          _path(std::move(path)),
-          _filename(_path.filename().generic_string()),
-          _file(_path.generic_string())
+          _filename(path.filename().generic_string()),
+          _source(ReadShaderSource(path))
       {
         RETINA_PROFILE_SCOPED();
-        ShadercIncludeResult::content = _file.data();
-        ShadercIncludeResult::content_length = _file.size();
+        ShadercIncludeResult::content = _source->data();
+        ShadercIncludeResult::content_length = _source->size();
         ShadercIncludeResult::source_name = _filename.c_str();
         ShadercIncludeResult::source_name_length = _filename.size();
       }
@@ -39,9 +118,8 @@ namespace Retina::Graphics {
       ~CShaderIncludeResult() noexcept = default;
 
     private:
-      std::filesystem::path _path;
       std::string _filename;
-      mio::mmap_source _file;
+      std::shared_ptr<const std::string> _source;
     };
 
     class CShaderIncludeResolver : public shaderc::CompileOptions::IncluderInterface {
@@ -64,20 +142,11 @@ namespace Retina::Graphics {
         size_t
       ) noexcept -> shaderc_include_result* override {
         RETINA_PROFILE_SCOPED();
-        auto includePath = std::filesystem::path(requestedSource);
-        for (const auto& includeDirectory : _includeDirectories) {
-          auto path = (includeDirectory / includePath).make_preferred();
-          if (std::filesystem::exists(path)) {
-            return new CShaderIncludeResult(path);
-          }
-        }
-        if (includePath.is_absolute()) {
-          if (std::filesystem::exists(includePath)) {
-            return new CShaderIncludeResult(includePath);
-          }
+        const auto path = ResolveShaderInclude(requestedSource, _includeDirectories);
+        if (path.empty()) {
+          RETINA_GRAPHICS_PANIC_WITH("Failed to find include '{}'", requestedSource);
         }
-        RETINA_GRAPHICS_PANIC_WITH("Failed to find include '{}'", requestedSource);
-        return nullptr;
+        return new CShaderIncludeResult(path);
       }
 
       void ReleaseInclude(shaderc_include_result* data) override {
@@ -89,6 +158,133 @@ namespace Retina::Graphics {
       std::vector<std::filesystem::path> _includeDirectories;
     };
 
+    // Appends every file "source" transitively includes to the key material. Includes behind preprocessor
+    // conditions are hashed as well, which at worst invalidates the cache more often than needed
+    auto AppendShaderIncludes(
+      std::string_view source,
+      std::span<const std::filesystem::path> includeDirectories,
+      Core::FlatHashSet<std::string>& visited,
+      std::string& keyMaterial
+    ) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      const auto trim = [](std::string_view value) noexcept {
+        const auto offset = value.find_first_not_of(" \t");
+        return offset == std::string_view::npos ? std::string_view() : value.substr(offset);
+      };
+      while (!source.empty()) {
+        const auto lineEnd = std::min(source.find('\n'), source.size());
+        auto line = trim(source.substr(0, lineEnd));
+        source.remove_prefix(std::min(lineEnd + 1, source.size()));
+        if (!line.starts_with('#')) {
+          continue;
+        }
+        line = trim(line.substr(1));
+        if (!line.starts_with("include")) {
+          continue;
+        }
+        line = trim(line.substr(7));
+        if (line.empty() || (line.front() != '"' && line.front() != '<')) {
+          continue;
+        }
+        const auto nameEnd = line.find(line.front() == '"' ? '"' : '>', 1);
+        if (nameEnd == std::string_view::npos) {
+          continue;
+        }
+        // Unresolved includes are left for shaderc to report
+        const auto path = ResolveShaderInclude(line.substr(1, nameEnd - 1), includeDirectories);
+        if (path.empty() || !visited.emplace(path.generic_string()).second) {
+          continue;
+        }
+        const auto include = ReadShaderSource(path);
+        keyMaterial += path.generic_string();
+        keyMaterial += '\0';
+        keyMaterial += *include;
+        keyMaterial += '\0';
+        AppendShaderIncludes(*include, includeDirectories, visited, keyMaterial);
+      }
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto MakeShaderCacheKey(
+      const std::filesystem::path& path,
+      std::string_view source,
+      std::span<const std::filesystem::path> includeDirectories,
+      EShaderStageFlag stage
+    ) noexcept -> uint64 {
+      RETINA_PROFILE_SCOPED();
+      auto keyMaterial = std::string(SHADER_COMPILE_OPTIONS);
+      keyMaterial += '\0';
+      keyMaterial += std::to_string(std::to_underlying(stage));
+      keyMaterial += '\0';
+      keyMaterial += path.generic_string();
+      keyMaterial += '\0';
+      keyMaterial += source;
+      keyMaterial += '\0';
+      auto visited = Core::FlatHashSet<std::string>();
+      AppendShaderIncludes(source, includeDirectories, visited, keyMaterial);
+      return ankerl::unordered_dense::hash<std::string_view>()(keyMaterial);
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto GetShaderCachePath(uint64 key) noexcept -> std::filesystem::path {
+      RETINA_PROFILE_SCOPED();
+      return std::filesystem::path(RETINA_SHADER_CACHE_DIRECTORY) / std::format("{:016x}.spv", key);
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto LoadCachedShader(const std::filesystem::path& path, uint64 key) noexcept -> std::optional<SShaderBinary> {
+      RETINA_PROFILE_SCOPED();
+      auto file = std::ifstream(path, std::ios::binary);
+      auto header = SShaderCacheHeader();
+      if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return std::nullopt;
+      }
+      if (header.Magic != SHADER_CACHE_MAGIC || header.Version != SHADER_CACHE_VERSION || header.Key != key) {
+        return std::nullopt;
+      }
+      auto shader = SShaderBinary();
+      shader.Spirv.resize(header.SpirvSize);
+      shader.Stage = header.Stage;
+      shader.PushConstantSize = header.PushConstantSize;
+      shader.OutputComponentCounts.resize(header.OutputCount);
+      file.read(reinterpret_cast<char*>(shader.OutputComponentCounts.data()), header.OutputCount * sizeof(uint32));
+      file.read(reinterpret_cast<char*>(shader.Spirv.data()), header.SpirvSize * sizeof(uint32));
+      if (!file) {
+        return std::nullopt;
+      }
+      return shader;
+    }
+
+    RETINA_INLINE auto StoreCachedShader(const std::filesystem::path& path, uint64 key, const SShaderBinary& shader) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      const auto header = SShaderCacheHeader {
+        .Magic = SHADER_CACHE_MAGIC,
+        .Version = SHADER_CACHE_VERSION,
+        .Key = key,
+        .Stage = shader.Stage,
+        .PushConstantSize = shader.PushConstantSize,
+        .OutputCount = static_cast<uint32>(shader.OutputComponentCounts.size()),
+        .SpirvSize = static_cast<uint32>(shader.Spirv.size()),
+      };
+      auto error = std::error_code();
+      std::filesystem::create_directories(path.parent_path(), error);
+      // Unique per thread, pipelines compiled concurrently may race on the same shader
+      auto temporaryPath = path;
+      temporaryPath += std::format(".{}.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+      {
+        auto file = std::ofstream(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(shader.OutputComponentCounts.data()), shader.OutputComponentCounts.size() * sizeof(uint32));
+        file.write(reinterpret_cast<const char*>(shader.Spirv.data()), shader.Spirv.size() * sizeof(uint32));
+        if (!file.flush()) {
+          RETINA_GRAPHICS_WARN("Failed to write shader cache '{}'", temporaryPath.generic_string());
+          std::filesystem::remove(temporaryPath, error);
+          return;
+        }
+      }
+      std::filesystem::rename(temporaryPath, path, error);
+      if (error) {
+        std::filesystem::remove(temporaryPath, error);
+      }
+    }
+
     RETINA_NODISCARD RETINA_INLINE auto GetShaderKindFrom(EShaderStageFlag stage) noexcept -> shaderc_shader_kind {
       RETINA_PROFILE_SCOPED();
       switch (stage) {
@@ -114,7 +310,7 @@ namespace Retina::Graphics {
       const std::filesystem::path& path,
       std::span<const std::filesystem::path> includeDirectories,
       EShaderStageFlag stage
-    ) noexcept -> std::vector<uint32> {
+    ) noexcept -> SShaderBinary {
       RETINA_PROFILE_SCOPED();
       const auto root = std::filesystem::path(RETINA_MAIN_SHADER_DIRECTORY);
       auto includeDirectoriesWithRoot = std::vector(
@@ -125,7 +321,13 @@ namespace Retina::Graphics {
       if (!std::filesystem::exists(path)) {
         RETINA_GRAPHICS_PANIC_WITH("Shader '{}' does not exist", path.generic_string());
       }
-      const auto shaderSource = mio::mmap_source(path.generic_string());
+      const auto shaderSource = ReadShaderSource(path);
+      const auto cacheKey = MakeShaderCacheKey(path, *shaderSource, includeDirectoriesWithRoot, stage);
+      const auto cachePath = GetShaderCachePath(cacheKey);
+      if (auto shader = LoadCachedShader(cachePath, cacheKey)) {
+        return std::move(*shader);
+      }
+
       auto compiler = shaderc::Compiler();
       auto compilerOptions = shaderc::CompileOptions();
       compilerOptions.SetGenerateDebugInfo();
@@ -138,8 +340,8 @@ namespace Retina::Graphics {
       compilerOptions.SetPreserveBindings(true);
 
       auto spirv = compiler.CompileGlslToSpv(
-        shaderSource.data(),
-        shaderSource.size(),
+        shaderSource->data(),
+        shaderSource->size(),
         GetShaderKindFrom(stage),
         path.generic_string().c_str(),
         compilerOptions
@@ -151,7 +353,100 @@ namespace Retina::Graphics {
           spirv.GetErrorMessage()
         );
       }
-      return { spirv.cbegin(), spirv.cend() };
+      const auto shader = ReflectShaderBinary({ spirv.cbegin(), spirv.cend() });
+      StoreCachedShader(cachePath, cacheKey, shader);
+      return shader;
+    }
+#else
+    auto LoadCompiledShader(const std::filesystem::path& path, EShaderStageFlag stage) noexcept -> SShaderBinary {
+      RETINA_PROFILE_SCOPED();
+      const auto relativePath = std::filesystem::relative(path, RETINA_ROOT_SOURCE_DIRECTORY);
+      auto compiledPath = std::filesystem::path(RETINA_COMPILED_SHADER_DIRECTORY) / relativePath;
+      compiledPath += ".spv";
+      auto error = std::error_code();
+      const auto file = mio::make_mmap_source(compiledPath.generic_string(), error);
+      if (error || file.size() % sizeof(uint32) != 0) {
+        RETINA_GRAPHICS_PANIC_WITH("Compiled shader '{}' does not exist or is corrupt", compiledPath.generic_string());
+      }
+      auto spirv = std::vector<uint32>(file.size() / sizeof(uint32));
+      std::memcpy(spirv.data(), file.data(), file.size());
+      auto shader = ReflectShaderBinary(std::move(spirv));
+      RETINA_ASSERT_WITH(shader.Stage == stage, "Compiled shader stage does not match the requested stage");
+      return shader;
+    }
+#endif
+
+    auto BeginShaderSourceBatch() noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+#if defined(RETINA_ENABLE_RUNTIME_SHADER_COMPILER)
+      auto& cache = GetShaderSourceCache();
+      const auto lock = std::lock_guard(cache.Mutex);
+      ++cache.BatchCount;
+#endif
+    }
+
+    auto EndShaderSourceBatch() noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+#if defined(RETINA_ENABLE_RUNTIME_SHADER_COMPILER)
+      auto& cache = GetShaderSourceCache();
+      const auto lock = std::lock_guard(cache.Mutex);
+      RETINA_ASSERT_WITH(cache.BatchCount > 0, "Shader source batch ended more often than it began");
+      if (--cache.BatchCount == 0) {
+        cache.Sources.clear();
+      }
+#endif
+    }
+
+    auto LoadShader(
+      const std::filesystem::path& path,
+      std::span<const std::filesystem::path> includeDirectories,
+      EShaderStageFlag stage
+    ) noexcept -> SShaderBinary {
+      RETINA_PROFILE_SCOPED();
+#if defined(RETINA_ENABLE_RUNTIME_SHADER_COMPILER)
+      return CompileShaderFromSource(path, includeDirectories, stage);
+#else
+      RETINA_UNUSED(includeDirectories);
+      return LoadCompiledShader(path, stage);
+#endif
+    }
+
+    auto MakeSpecializationData(
+      std::span<const SPipelineSpecializationConstant> constants
+    ) noexcept -> SSpecializationData {
+      RETINA_PROFILE_SCOPED();
+      auto data = SSpecializationData();
+      data.MapEntries.reserve(constants.size());
+      data.Data.reserve(constants.size());
+      for (const auto& constant : constants) {
+        RETINA_ASSERT_WITH(
+          std::ranges::none_of(data.MapEntries, [&](const auto& entry) noexcept { return entry.constantID == constant.Id; }),
+          "Specialization constant specified more than once"
+        );
+        data.MapEntries.push_back({
+          .constantID = constant.Id,
+          .offset = static_cast<uint32>(data.Data.size() * sizeof(uint32)),
+          .size = sizeof(uint32),
+        });
+        data.Data.emplace_back(std::visit([](const auto value) noexcept -> uint32 {
+          if constexpr (std::is_same_v<decltype(value), const bool>) {
+            return value ? VK_TRUE : VK_FALSE;
+          } else {
+            return std::bit_cast<uint32>(value);
+          }
+        }, constant.Value));
+      }
+      return data;
+    }
+
+    auto MakeNativeSpecializationInfo(const SSpecializationData& data) noexcept -> VkSpecializationInfo {
+      RETINA_PROFILE_SCOPED();
+      auto specializationInfo = VkSpecializationInfo();
+      specializationInfo.mapEntryCount = data.MapEntries.size();
+      specializationInfo.pMapEntries = data.MapEntries.data();
+      specializationInfo.dataSize = data.Data.size() * sizeof(uint32);
+      specializationInfo.pData = data.Data.data();
+      return specializationInfo;
     }
 
     auto MakeShaderModule(const CDevice& device, std::span<const uint32> spirv) noexcept -> VkShaderModule {
@@ -195,34 +490,67 @@ namespace Retina::Graphics {
       }
     }
 
+    auto ReflectShaderBinary(std::vector<uint32> spirv) noexcept -> SShaderBinary {
+      RETINA_PROFILE_SCOPED();
+      const auto compiler = spirv_cross::CompilerGLSL(spirv);
+      const auto resources = compiler.get_shader_resources();
+      auto shader = SShaderBinary();
+      shader.Stage = ExecutionModelToShaderStage(compiler);
+      if (!resources.push_constant_buffers.empty()) {
+        const auto& pushConstantBuffer = resources.push_constant_buffers.back();
+        const auto& pushConstantType = compiler.get_type(pushConstantBuffer.type_id);
+        shader.PushConstantSize = compiler.get_declared_struct_size(pushConstantType);
+      }
+      if (shader.Stage == EShaderStageFlag::E_FRAGMENT) {
+        shader.OutputComponentCounts.reserve(resources.stage_outputs.size());
+        for (const auto& stageOutput : resources.stage_outputs) {
+          shader.OutputComponentCounts.emplace_back(compiler.get_type(stageOutput.base_type_id).vecsize);
+        }
+      }
+      shader.Spirv = std::move(spirv);
+      return shader;
+    }
+
     auto ReflectPushConstantRange(
-      std::span<const spirv_cross::CompilerGLSL* const> compilers
+      std::span<const SShaderBinary* const> shaders
     ) noexcept -> SPipelinePushConstantInfo {
       RETINA_PROFILE_SCOPED();
       auto pushConstantInfo = SPipelinePushConstantInfo();
-      for (const auto* compiler : compilers) {
-        if (!compiler) {
-          continue;
-        }
-        const auto resources = compiler->get_shader_resources();
-        if (resources.push_constant_buffers.empty()) {
+      for (const auto* shader : shaders) {
+        if (!shader || shader->PushConstantSize == 0) {
           continue;
         }
-        const auto& pushConstantBuffer = resources.push_constant_buffers.back();
-        const auto& pushConstantType = compiler->get_type(pushConstantBuffer.type_id);
-        const auto pushConstantSize = compiler->get_declared_struct_size(pushConstantType);
-        const auto stage = ExecutionModelToShaderStage(*compiler);
         if (pushConstantInfo.Size == 0) {
-          pushConstantInfo.Stages = stage;
-          pushConstantInfo.Size = pushConstantSize;
+          pushConstantInfo.Stages = shader->Stage;
+          pushConstantInfo.Size = shader->PushConstantSize;
         } else {
-          RETINA_ASSERT_WITH(pushConstantInfo.Size == pushConstantSize, "Push constant size mismatch");
-          pushConstantInfo.Stages |= stage;
+          RETINA_ASSERT_WITH(pushConstantInfo.Size == shader->PushConstantSize, "Push constant size mismatch");
+          pushConstantInfo.Stages |= shader->Stage;
         }
       }
       return pushConstantInfo;
     }
 
+    auto ReflectColorBlendAttachments(const SShaderBinary& fragmentShader) noexcept -> std::vector<SPipelineColorBlendAttachmentInfo> {
+      RETINA_PROFILE_SCOPED();
+      auto colorBlendAttachments = std::vector<SPipelineColorBlendAttachmentInfo>();
+      colorBlendAttachments.reserve(fragmentShader.OutputComponentCounts.size());
+      for (const auto componentCount : fragmentShader.OutputComponentCounts) {
+        auto colorWriteMask = EColorComponentFlag();
+        switch (componentCount) {
+          case 4: colorWriteMask |= EColorComponentFlag::E_A; RETINA_FALLTHROUGH;
+          case 3: colorWriteMask |= EColorComponentFlag::E_B; RETINA_FALLTHROUGH;
+          case 2: colorWriteMask |= EColorComponentFlag::E_G; RETINA_FALLTHROUGH;
+          case 1: colorWriteMask |= EColorComponentFlag::E_R; break;
+          default: std::unreachable();
+        }
+        auto colorBlendAttachmentInfo = SPipelineColorBlendAttachmentInfo();
+        colorBlendAttachmentInfo.ColorWriteMask = colorWriteMask;
+        colorBlendAttachments.emplace_back(colorBlendAttachmentInfo);
+      }
+      return colorBlendAttachments;
+    }
+
     auto MakeDescriptorLayoutHandles(
       std::span<const Core::CReferenceWrapper<const CDescriptorLayout>> layouts
     ) noexcept -> std::vector<VkDescriptorSetLayout> {
@@ -234,6 +562,18 @@ namespace Retina::Graphics {
       }
       return descriptorLayoutHandles;
     }
+
+    auto MakeDescriptorLayoutPipelineFlags(
+      std::span<const Core::CReferenceWrapper<const CDescriptorLayout>> layouts
+    ) noexcept -> VkPipelineCreateFlags {
+      RETINA_PROFILE_SCOPED();
+      for (const auto& layout : layouts) {
+        if (Core::IsFlagEnabled(layout->GetCreateInfo().Flags, EDescriptorLayoutCreateFlag::E_DESCRIPTOR_BUFFER_EXT)) {
+          return VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+      }
+      return 0;
+    }
   }
 
   IPipeline::~IPipeline() noexcept {
@@ -0,0 +1,145 @@
+#include <Retina/Graphics/ComputePipeline.hpp>
+#include <Retina/Graphics/Device.hpp>
+#include <Retina/Graphics/GraphicsPipeline.hpp>
+#include <Retina/Graphics/Logger.hpp>
+#include <Retina/Graphics/Macros.hpp>
+#include <Retina/Graphics/MeshShadingPipeline.hpp>
+#include <Retina/Graphics/Pipeline.hpp>
+#include <Retina/Graphics/PipelineBuilder.hpp>
+
+namespace Retina::Graphics {
+  namespace Details {
+    template <typename T, typename C>
+    RETINA_NODISCARD RETINA_INLINE auto BuildPipelineAsync(
+      const CDevice& device,
+      const C& createInfo
+    ) noexcept -> std::shared_future<Core::CArcPtr<T>> {
+      RETINA_PROFILE_SCOPED();
+      // The create info is copied, callers are free to let theirs go out of scope
+      return device.GetWorkerPool().Submit([&device, createInfo] {
+        RETINA_PROFILE_SCOPED();
+        return T::Make(device, createInfo);
+      }).share();
+    }
+
+    template <typename T>
+    RETINA_NODISCARD RETINA_INLINE auto WaitPipelineAsync(
+      std::shared_future<Core::CArcPtr<T>> future
+    ) noexcept -> std::shared_future<void> {
+      RETINA_PROFILE_SCOPED();
+      return std::async(std::launch::deferred, [future = std::move(future)] {
+        future.wait();
+      }).share();
+    }
+
+    template <typename T>
+    RETINA_NODISCARD RETINA_INLINE auto AssignPipelineAsync(
+      std::shared_future<Core::CArcPtr<T>> future,
+      Core::CArcPtr<T>& pipeline
+    ) noexcept -> std::shared_future<void> {
+      RETINA_PROFILE_SCOPED();
+      return std::async(std::launch::deferred, [future = std::move(future), &pipeline] {
+        pipeline = future.get();
+      }).share();
+    }
+  }
+
+  CPipelineBuilder::CPipelineBuilder(const CDevice& device) noexcept
+    : _device(device)
+  {
+    RETINA_PROFILE_SCOPED();
+  }
+
+  CPipelineBuilder::~CPipelineBuilder() noexcept {
+    RETINA_PROFILE_SCOPED();
+    Wait();
+  }
+
+  auto CPipelineBuilder::Make(const CDevice& device) noexcept -> Core::CUniquePtr<CPipelineBuilder> {
+    RETINA_PROFILE_SCOPED();
+    return Core::MakeUnique<CPipelineBuilder>(device);
+  }
+
+  auto CPipelineBuilder::GetDevice() const noexcept -> const CDevice& {
+    RETINA_PROFILE_SCOPED();
+    return *_device;
+  }
+
+  auto CPipelineBuilder::Build(
+    const SComputePipelineCreateInfo& createInfo
+  ) noexcept -> std::shared_future<Core::CArcPtr<CComputePipeline>> {
+    RETINA_PROFILE_SCOPED();
+    BeginBatch();
+    auto future = Details::BuildPipelineAsync<CComputePipeline>(*_device, createInfo);
+    _pending.emplace_back(Details::WaitPipelineAsync(future));
+    return future;
+  }
+
+  auto CPipelineBuilder::Build(
+    const SGraphicsPipelineCreateInfo& createInfo
+  ) noexcept -> std::shared_future<Core::CArcPtr<CGraphicsPipeline>> {
+    RETINA_PROFILE_SCOPED();
+    BeginBatch();
+    auto future = Details::BuildPipelineAsync<CGraphicsPipeline>(*_device, createInfo);
+    _pending.emplace_back(Details::WaitPipelineAsync(future));
+    return future;
+  }
+
+  auto CPipelineBuilder::Build(
+    const SMeshShadingPipelineCreateInfo& createInfo
+  ) noexcept -> std::shared_future<Core::CArcPtr<CMeshShadingPipeline>> {
+    RETINA_PROFILE_SCOPED();
+    BeginBatch();
+    auto future = Details::BuildPipelineAsync<CMeshShadingPipeline>(*_device, createInfo);
+    _pending.emplace_back(Details::WaitPipelineAsync(future));
+    return future;
+  }
+
+  auto CPipelineBuilder::Build(
+    const SComputePipelineCreateInfo& createInfo,
+    Core::CArcPtr<CComputePipeline>& pipeline
+  ) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    BeginBatch();
+    _pending.emplace_back(Details::AssignPipelineAsync(Details::BuildPipelineAsync<CComputePipeline>(*_device, createInfo), pipeline));
+  }
+
+  auto CPipelineBuilder::Build(
+    const SGraphicsPipelineCreateInfo& createInfo,
+    Core::CArcPtr<CGraphicsPipeline>& pipeline
+  ) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    BeginBatch();
+    _pending.emplace_back(Details::AssignPipelineAsync(Details::BuildPipelineAsync<CGraphicsPipeline>(*_device, createInfo), pipeline));
+  }
+
+  auto CPipelineBuilder::Build(
+    const SMeshShadingPipelineCreateInfo& createInfo,
+    Core::CArcPtr<CMeshShadingPipeline>& pipeline
+  ) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    BeginBatch();
+    _pending.emplace_back(Details::AssignPipelineAsync(Details::BuildPipelineAsync<CMeshShadingPipeline>(*_device, createInfo), pipeline));
+  }
+
+  auto CPipelineBuilder::Wait() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (_pending.empty()) {
+      return;
+    }
+    for (const auto& pending : _pending) {
+      pending.get();
+    }
+    RETINA_GRAPHICS_INFO("Built {} pipelines", _pending.size());
+    _pending.clear();
+    Details::EndShaderSourceBatch();
+  }
+
+  auto CPipelineBuilder::BeginBatch() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    // A batch spans from the first build after a "Wait" to the next "Wait"
+    if (_pending.empty()) {
+      Details::BeginShaderSourceBatch();
+    }
+  }
+}
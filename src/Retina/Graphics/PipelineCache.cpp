@@ -0,0 +1,197 @@
+#include <Retina/Graphics/Device.hpp>
+#include <Retina/Graphics/Logger.hpp>
+#include <Retina/Graphics/Macros.hpp>
+#include <Retina/Graphics/PipelineCache.hpp>
+
+#include <volk.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <vector>
+
+namespace Retina::Graphics {
+  namespace Details {
+    // A cache written by another driver or device is at best ignored, some drivers crash on it instead
+    RETINA_NODISCARD RETINA_INLINE auto IsPipelineCacheCompatible(
+      const CDevice& device,
+      std::span<const uint8> data
+    ) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      auto header = VkPipelineCacheHeaderVersionOne();
+      if (data.size() < sizeof(header)) {
+        return false;
+      }
+      std::memcpy(&header, data.data(), sizeof(header));
+
+      auto properties = VkPhysicalDeviceProperties();
+      vkGetPhysicalDeviceProperties(device.GetPhysicalDevice(), &properties);
+      // A truncated file must not pass for a valid one
+      return
+        header.headerSize >= sizeof(header) &&
+        header.headerSize <= data.size() &&
+        header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+        header.vendorID == properties.vendorID &&
+        header.deviceID == properties.deviceID &&
+        std::ranges::equal(header.pipelineCacheUUID, properties.pipelineCacheUUID);
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto HashPipelineCacheData(std::span<const uint8> data) noexcept -> uint64 {
+      RETINA_PROFILE_SCOPED();
+      return ankerl::unordered_dense::detail::wyhash::hash(data.data(), data.size());
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto ReadPipelineCacheData(const std::filesystem::path& path) noexcept -> std::vector<uint8> {
+      RETINA_PROFILE_SCOPED();
+      auto error = std::error_code();
+      const auto size = std::filesystem::file_size(path, error);
+      if (error) {
+        return {};
+      }
+      auto file = std::ifstream(path, std::ios::binary);
+      auto data = std::vector<uint8>(size);
+      if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size))) {
+        return {};
+      }
+      return data;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto GetPipelineCacheData(const CDevice& device, VkPipelineCache pipelineCache) noexcept -> std::vector<uint8> {
+      RETINA_PROFILE_SCOPED();
+      auto size = 0_usize;
+      RETINA_GRAPHICS_VULKAN_CHECK(vkGetPipelineCacheData(device.GetHandle(), pipelineCache, &size, nullptr));
+      auto data = std::vector<uint8>(size);
+      RETINA_GRAPHICS_VULKAN_CHECK(vkGetPipelineCacheData(device.GetHandle(), pipelineCache, &size, data.data()));
+      data.resize(size);
+      return data;
+    }
+  }
+
+  CPipelineCache::CPipelineCache(const CDevice& device) noexcept
+    : _device(device)
+  {
+    RETINA_PROFILE_SCOPED();
+  }
+
+  CPipelineCache::~CPipelineCache() noexcept {
+    RETINA_PROFILE_SCOPED();
+    if (_handle) {
+      Save();
+      vkDestroyPipelineCache(_device->GetHandle(), _handle, nullptr);
+      RETINA_GRAPHICS_INFO("Pipeline cache ({}) destroyed", GetDebugName());
+    }
+  }
+
+  auto CPipelineCache::Make(
+    const CDevice& device,
+    const SPipelineCacheCreateInfo& createInfo
+  ) noexcept -> Core::CUniquePtr<CPipelineCache> {
+    RETINA_PROFILE_SCOPED();
+    auto self = Core::MakeUnique<CPipelineCache>(device);
+    auto initialData = std::vector<uint8>();
+    if (!createInfo.Path.empty()) {
+      initialData = Details::ReadPipelineCacheData(createInfo.Path);
+      if (!initialData.empty() && !Details::IsPipelineCacheCompatible(device, initialData)) {
+        RETINA_GRAPHICS_WARN("Pipeline cache '{}' does not match the device, starting empty", createInfo.Path.generic_string());
+        initialData.clear();
+      }
+    }
+
+    auto pipelineCacheCreateInfo = VkPipelineCacheCreateInfo(VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO);
+    pipelineCacheCreateInfo.initialDataSize = initialData.size();
+    pipelineCacheCreateInfo.pInitialData = initialData.data();
+
+    auto pipelineCacheHandle = VkPipelineCache();
+    RETINA_GRAPHICS_VULKAN_CHECK(
+      vkCreatePipelineCache(
+        device.GetHandle(),
+        &pipelineCacheCreateInfo,
+        nullptr,
+        &pipelineCacheHandle
+      )
+    );
+
+    self->_handle = pipelineCacheHandle;
+    self->_savedHash = Details::HashPipelineCacheData(initialData);
+    self->_lastSaveTime = std::chrono::steady_clock::now();
+    self->_createInfo = createInfo;
+    self->SetDebugName(createInfo.Name);
+
+    RETINA_GRAPHICS_INFO("Pipeline cache ({}) initialized", createInfo.Name);
+    RETINA_GRAPHICS_INFO(" - Path: {}", createInfo.Path.generic_string());
+    RETINA_GRAPHICS_INFO(" - Loaded bytes: {}", initialData.size());
+    return self;
+  }
+
+  auto CPipelineCache::GetHandle() const noexcept -> VkPipelineCache {
+    RETINA_PROFILE_SCOPED();
+    return _handle;
+  }
+
+  auto CPipelineCache::GetCreateInfo() const noexcept -> const SPipelineCacheCreateInfo& {
+    RETINA_PROFILE_SCOPED();
+    return _createInfo;
+  }
+
+  auto CPipelineCache::GetDevice() const noexcept -> const CDevice& {
+    RETINA_PROFILE_SCOPED();
+    return *_device;
+  }
+
+  auto CPipelineCache::GetDebugName() const noexcept -> std::string_view {
+    RETINA_PROFILE_SCOPED();
+    return _createInfo.Name;
+  }
+
+  auto CPipelineCache::SetDebugName(std::string_view name) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    RETINA_GRAPHICS_SET_DEBUG_NAME(_device->GetHandle(), _handle, VK_OBJECT_TYPE_PIPELINE_CACHE, name);
+    _createInfo.Name = name;
+  }
+
+  auto CPipelineCache::Save() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    _lastSaveTime = std::chrono::steady_clock::now();
+    if (_createInfo.Path.empty()) {
+      return;
+    }
+    const auto data = Details::GetPipelineCacheData(*_device, _handle);
+    const auto dataHash = Details::HashPipelineCacheData(data);
+    if (dataHash == _savedHash) {
+      return;
+    }
+
+    auto error = std::error_code();
+    const auto& path = _createInfo.Path;
+    if (path.has_parent_path()) {
+      std::filesystem::create_directories(path.parent_path(), error);
+    }
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+      auto file = std::ofstream(temporaryPath, std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+      if (!file.flush()) {
+        RETINA_GRAPHICS_WARN("Failed to write pipeline cache '{}'", temporaryPath.generic_string());
+        std::filesystem::remove(temporaryPath, error);
+        return;
+      }
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+      RETINA_GRAPHICS_WARN("Failed to replace pipeline cache '{}': {}", path.generic_string(), error.message());
+      std::filesystem::remove(temporaryPath, error);
+      return;
+    }
+    _savedHash = dataHash;
+    RETINA_GRAPHICS_INFO("Pipeline cache ({}) saved, {} bytes", GetDebugName(), data.size());
+  }
+
+  auto CPipelineCache::Tick() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (std::chrono::steady_clock::now() - _lastSaveTime >= _createInfo.SaveInterval) {
+      Save();
+    }
+  }
+}
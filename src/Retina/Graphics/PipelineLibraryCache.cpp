@@ -0,0 +1,94 @@
+#include <Retina/Graphics/Device.hpp>
+#include <Retina/Graphics/GraphicsPipeline.hpp>
+#include <Retina/Graphics/Logger.hpp>
+#include <Retina/Graphics/Macros.hpp>
+#include <Retina/Graphics/PipelineCache.hpp>
+#include <Retina/Graphics/PipelineLibraryCache.hpp>
+
+#include <volk.h>
+
+#include <algorithm>
+
+namespace Retina::Graphics {
+  CPipelineLibraryCache::CPipelineLibraryCache(const CDevice& device) noexcept
+    : _device(device)
+  {
+    RETINA_PROFILE_SCOPED();
+  }
+
+  CPipelineLibraryCache::~CPipelineLibraryCache() noexcept {
+    RETINA_PROFILE_SCOPED();
+    RETINA_ASSERT_WITH(_pending.empty(), "Pipeline library cache destroyed while pipelines are still linking");
+    for (const auto& [key, library] : _libraries) {
+      vkDestroyPipeline(_device->GetHandle(), library, nullptr);
+    }
+    RETINA_GRAPHICS_INFO("Pipeline library cache destroyed, {} libraries", _libraries.size());
+  }
+
+  auto CPipelineLibraryCache::Make(const CDevice& device) noexcept -> Core::CUniquePtr<CPipelineLibraryCache> {
+    RETINA_PROFILE_SCOPED();
+    return Core::MakeUnique<CPipelineLibraryCache>(device);
+  }
+
+  auto CPipelineLibraryCache::GetLibraryCount() const noexcept -> usize {
+    RETINA_PROFILE_SCOPED();
+    const auto lock = std::lock_guard(_mutex);
+    return _libraries.size();
+  }
+
+  auto CPipelineLibraryCache::GetDevice() const noexcept -> const CDevice& {
+    RETINA_PROFILE_SCOPED();
+    return *_device;
+  }
+
+  auto CPipelineLibraryCache::Acquire(std::string key, const VkGraphicsPipelineCreateInfo& createInfo) noexcept -> VkPipeline {
+    RETINA_PROFILE_SCOPED();
+    {
+      const auto lock = std::lock_guard(_mutex);
+      if (const auto it = _libraries.find(key); it != _libraries.end()) {
+        return it->second;
+      }
+    }
+
+    // Compiled outside the lock, so builder threads that miss on different libraries do not wait on each other
+    auto library = VkPipeline();
+    RETINA_GRAPHICS_VULKAN_CHECK(
+      vkCreateGraphicsPipelines(
+        _device->GetHandle(),
+        _device->GetPipelineCache().GetHandle(),
+        1,
+        &createInfo,
+        nullptr,
+        &library
+      )
+    );
+
+    const auto lock = std::lock_guard(_mutex);
+    const auto [it, isInserted] = _libraries.try_emplace(std::move(key), library);
+    if (!isInserted) {
+      // Another thread created the same library in the meantime
+      vkDestroyPipeline(_device->GetHandle(), library, nullptr);
+    }
+    return it->second;
+  }
+
+  auto CPipelineLibraryCache::Register(CGraphicsPipeline& pipeline) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto lock = std::lock_guard(_mutex);
+    _pending.emplace_back(&pipeline);
+  }
+
+  auto CPipelineLibraryCache::Unregister(const CGraphicsPipeline& pipeline) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto lock = std::lock_guard(_mutex);
+    std::erase(_pending, &pipeline);
+  }
+
+  auto CPipelineLibraryCache::Tick() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto lock = std::lock_guard(_mutex);
+    std::erase_if(_pending, [](CGraphicsPipeline* pipeline) noexcept {
+      return pipeline->TryPromoteOptimizedHandle();
+    });
+  }
+}
@@ -1,5 +1,7 @@
+#include <Retina/Graphics/Resources/ShaderResourceTable.hpp>
 #include <Retina/Graphics/BinarySemaphore.hpp>
 #include <Retina/Graphics/CommandBuffer.hpp>
+#include <Retina/Graphics/CommandPool.hpp>
 #include <Retina/Graphics/Device.hpp>
 #include <Retina/Graphics/Fence.hpp>
 #include <Retina/Graphics/HostDeviceTimeline.hpp>
@@ -10,7 +12,25 @@
 
 #include <volk.h>
 
+#include <format>
+
 namespace Retina::Graphics {
+  namespace Details {
+    // Every signal list ends with the queue timeline
+    constexpr static auto MAX_QUEUE_SUBMIT_SEMAPHORE_INFOS =
+      MAX_QUEUE_SUBMIT_BATCH_SIZE * (MAX_QUEUE_SUBMIT_SEMAPHORES + MAX_QUEUE_SUBMIT_TIMELINES + 1);
+    constexpr static auto MAX_QUEUE_SUBMIT_COMMAND_BUFFER_INFOS = MAX_QUEUE_SUBMIT_BATCH_SIZE * MAX_QUEUE_SUBMIT_COMMAND_BUFFERS;
+
+    RETINA_NODISCARD RETINA_INLINE auto MakeSemaphoreSubmitInfo(const SQueueSemaphoreSubmitInfo& info) noexcept -> VkSemaphoreSubmitInfo {
+      RETINA_PROFILE_SCOPED();
+      auto semaphoreSubmitInfo = VkSemaphoreSubmitInfo(VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO);
+      semaphoreSubmitInfo.semaphore = info.Semaphore->GetHandle();
+      semaphoreSubmitInfo.stageMask = AsEnumCounterpart(info.Stage);
+      semaphoreSubmitInfo.value = info.Value;
+      return semaphoreSubmitInfo;
+    }
+  }
+
   CQueue::CQueue(const CDevice& device) noexcept
     : _device(device)
   {
@@ -38,6 +58,9 @@ namespace Retina::Graphics {
     );
 
     self->_handle = queueHandle;
+    self->_timeline = CTimelineSemaphore::Make(device, {
+      .Name = std::format("{}Timeline", createInfo.Name),
+    });
     self->_createInfo = createInfo;
     self->SetDebugName(createInfo.Name);
     return self;
@@ -73,6 +96,16 @@ namespace Retina::Graphics {
     return _createInfo.QueueIndex;
   }
 
+  auto CQueue::GetTimeline() const noexcept -> const CTimelineSemaphore& {
+    RETINA_PROFILE_SCOPED();
+    return *_timeline;
+  }
+
+  auto CQueue::GetTimelineValue() const noexcept -> uint64 {
+    RETINA_PROFILE_SCOPED();
+    return _timelineValue.load(std::memory_order_acquire);
+  }
+
   auto CQueue::GetDebugName() const noexcept -> std::string_view {
     RETINA_PROFILE_SCOPED();
     return _createInfo.Name;
@@ -84,74 +117,104 @@ namespace Retina::Graphics {
     _createInfo.Name = name;
   }
 
-  auto CQueue::Submit(const SQueueSubmitInfo& submitInfo, const CFence* fence) noexcept -> void {
+  auto CQueue::Submit(const SQueueSubmitInfo& submitInfo, const CFence* fence) noexcept -> uint64 {
     RETINA_PROFILE_SCOPED();
-    auto waitSemaphoreInfos = std::vector<VkSemaphoreSubmitInfo>();
-    waitSemaphoreInfos.reserve(submitInfo.WaitSemaphores.size());
-    for (const auto& [semaphore, stage, value] : submitInfo.WaitSemaphores) {
-      auto semaphoreSubmitInfo = VkSemaphoreSubmitInfo(VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO);
-      semaphoreSubmitInfo.semaphore = semaphore->GetHandle();
-      semaphoreSubmitInfo.stageMask = AsEnumCounterpart(stage);
-      semaphoreSubmitInfo.value = value;
-      waitSemaphoreInfos.emplace_back(semaphoreSubmitInfo);
-    }
+    return Submit(std::span(&submitInfo, 1), fence);
+  }
 
-    auto signalSemaphoreInfos = std::vector<VkSemaphoreSubmitInfo>();
-    signalSemaphoreInfos.reserve(submitInfo.SignalSemaphores.size());
-    for (const auto& [semaphore, stage, value] : submitInfo.SignalSemaphores) {
-      auto semaphoreSubmitInfo = VkSemaphoreSubmitInfo(VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO);
-      semaphoreSubmitInfo.semaphore = semaphore->GetHandle();
-      semaphoreSubmitInfo.stageMask = AsEnumCounterpart(stage);
-      semaphoreSubmitInfo.value = value;
-      signalSemaphoreInfos.emplace_back(semaphoreSubmitInfo);
-    }
+  auto CQueue::Submit(std::span<const SQueueSubmitInfo> submitInfos, const CFence* fence) noexcept -> uint64 {
+    RETINA_PROFILE_SCOPED();
+    RETINA_ASSERT_WITH(!submitInfos.empty(), "Submission batch is empty");
+    RETINA_ASSERT_WITH(submitInfos.size() <= MAX_QUEUE_SUBMIT_BATCH_SIZE, "Submission batch is too large");
+    // Descriptors written since the last submission have to be in the table before the device can read it
+    _device->GetShaderResourceTable().Flush();
 
-    for (auto& timeline : submitInfo.Timelines) {
-      auto semaphoreInfo = VkSemaphoreSubmitInfo(VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO);
-      semaphoreInfo.semaphore = timeline->GetDeviceTimeline().GetHandle();
-      // TODO: maybe make this a parameter?
-      semaphoreInfo.stageMask = VK_PIPELINE_STAGE_2_NONE;
-      semaphoreInfo.value = timeline->GetNextHostTimelineValue();
-      signalSemaphoreInfos.emplace_back(semaphoreInfo);
-    }
+    // Every submission in the batch points into these, they never reallocate and never touch the heap
+    auto waitSemaphoreInfos = Core::CFixedVector<VkSemaphoreSubmitInfo, Details::MAX_QUEUE_SUBMIT_SEMAPHORE_INFOS>();
+    auto signalSemaphoreInfos = Core::CFixedVector<VkSemaphoreSubmitInfo, Details::MAX_QUEUE_SUBMIT_SEMAPHORE_INFOS>();
+    auto commandBufferInfos = Core::CFixedVector<VkCommandBufferSubmitInfo, Details::MAX_QUEUE_SUBMIT_COMMAND_BUFFER_INFOS>();
+    auto queueSubmitInfos = Core::CFixedVector<VkSubmitInfo2, MAX_QUEUE_SUBMIT_BATCH_SIZE>();
+    auto timelineSemaphoreIndices = Core::CFixedVector<usize, MAX_QUEUE_SUBMIT_BATCH_SIZE>();
+    for (const auto& submitInfo : submitInfos) {
+      auto& queueSubmitInfo = queueSubmitInfos.EmplaceBack(VK_STRUCTURE_TYPE_SUBMIT_INFO_2);
+
+      const auto waitSemaphoreOffset = waitSemaphoreInfos.GetSize();
+      for (auto i = 0_usize; i < submitInfo.WaitSemaphores.GetSize(); ++i) {
+        waitSemaphoreInfos.PushBack(Details::MakeSemaphoreSubmitInfo(submitInfo.WaitSemaphores[i]));
+      }
+      queueSubmitInfo.waitSemaphoreInfoCount = waitSemaphoreInfos.GetSize() - waitSemaphoreOffset;
+      queueSubmitInfo.pWaitSemaphoreInfos = waitSemaphoreInfos.GetData() + waitSemaphoreOffset;
+
+      const auto commandBufferOffset = commandBufferInfos.GetSize();
+      for (auto i = 0_usize; i < submitInfo.CommandBuffers.GetSize(); ++i) {
+        auto& commandBufferInfo = commandBufferInfos.EmplaceBack(VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO);
+        commandBufferInfo.commandBuffer = submitInfo.CommandBuffers[i]->GetHandle();
+      }
+      queueSubmitInfo.commandBufferInfoCount = commandBufferInfos.GetSize() - commandBufferOffset;
+      queueSubmitInfo.pCommandBufferInfos = commandBufferInfos.GetData() + commandBufferOffset;
 
-    auto commandBufferInfos = std::vector<VkCommandBufferSubmitInfo>();
-    commandBufferInfos.reserve(submitInfo.CommandBuffers.size());
-    for (const auto& commandBuffer : submitInfo.CommandBuffers) {
-      auto commandBufferInfo = VkCommandBufferSubmitInfo(VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO);
-      commandBufferInfo.commandBuffer = commandBuffer->GetHandle();
-      commandBufferInfos.emplace_back(commandBufferInfo);
+      // The queue timeline is signaled last, its value is only known once the lock is held
+      const auto signalSemaphoreOffset = signalSemaphoreInfos.GetSize();
+      for (auto i = 0_usize; i < submitInfo.SignalSemaphores.GetSize(); ++i) {
+        signalSemaphoreInfos.PushBack(Details::MakeSemaphoreSubmitInfo(submitInfo.SignalSemaphores[i]));
+      }
+      for (auto i = 0_usize; i < submitInfo.Timelines.GetSize(); ++i) {
+        const auto& timeline = submitInfo.Timelines[i];
+        auto& semaphoreInfo = signalSemaphoreInfos.EmplaceBack(VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO);
+        semaphoreInfo.semaphore = timeline->GetDeviceTimeline().GetHandle();
+        // TODO: maybe make this a parameter?
+        semaphoreInfo.stageMask = VK_PIPELINE_STAGE_2_NONE;
+        semaphoreInfo.value = timeline->GetNextHostTimelineValue();
+      }
+      timelineSemaphoreIndices.PushBack(signalSemaphoreInfos.GetSize());
+      auto& timelineSemaphoreInfo = signalSemaphoreInfos.EmplaceBack(VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO);
+      timelineSemaphoreInfo.semaphore = _timeline->GetHandle();
+      timelineSemaphoreInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+      queueSubmitInfo.signalSemaphoreInfoCount = signalSemaphoreInfos.GetSize() - signalSemaphoreOffset;
+      queueSubmitInfo.pSignalSemaphoreInfos = signalSemaphoreInfos.GetData() + signalSemaphoreOffset;
     }
 
     const auto fenceHandle = fence ? fence->GetHandle() : VkFence();
-
-    auto queueSubmitInfo = VkSubmitInfo2(VK_STRUCTURE_TYPE_SUBMIT_INFO_2);
-    queueSubmitInfo.waitSemaphoreInfoCount = waitSemaphoreInfos.size();
-    queueSubmitInfo.pWaitSemaphoreInfos = waitSemaphoreInfos.data();
-    queueSubmitInfo.commandBufferInfoCount = commandBufferInfos.size();
-    queueSubmitInfo.pCommandBufferInfos = commandBufferInfos.data();
-    queueSubmitInfo.signalSemaphoreInfoCount = signalSemaphoreInfos.size();
-    queueSubmitInfo.pSignalSemaphoreInfos = signalSemaphoreInfos.data();
     auto guard = std::lock_guard(_mutex);
-    RETINA_GRAPHICS_VULKAN_CHECK(vkQueueSubmit2(_handle, 1, &queueSubmitInfo, fenceHandle));
+    // Values are handed out under the lock, so they reach the device in increasing order
+    auto timelineValue = _timelineValue.load(std::memory_order_relaxed);
+    for (auto i = 0_usize; i < timelineSemaphoreIndices.GetSize(); ++i) {
+      signalSemaphoreInfos[timelineSemaphoreIndices[i]].value = ++timelineValue;
+    }
+    RETINA_GRAPHICS_VULKAN_CHECK(vkQueueSubmit2(_handle, queueSubmitInfos.GetSize(), queueSubmitInfos.GetData(), fenceHandle));
+    _timelineValue.store(timelineValue, std::memory_order_release);
+    return timelineValue;
   }
 
-  auto CQueue::Submit(std::move_only_function<void(CCommandBuffer&)>&& submission) noexcept -> void {
+  auto CQueue::SubmitAsync(std::move_only_function<void(CCommandBuffer&)>&& submission) noexcept -> uint64 {
     RETINA_PROFILE_SCOPED();
-    auto commandBuffer = CCommandBuffer::Make(*this, {
-      .Name = "TransientCommandBuffer",
-      .PoolInfo = { {
-        .Flags = ECommandPoolCreateFlag::E_TRANSIENT,
-      } },
-    });
-
+    auto commandBuffer = AcquireImmediateContext();
     commandBuffer->Begin();
     submission(*commandBuffer);
     commandBuffer->End();
 
-    auto fence = CFence::Make(GetDevice(), { .Name = "ImmediateSubmissionFence" });
-    Submit({ .CommandBuffers = { *commandBuffer } }, fence.Get());
-    fence->Wait();
+    const auto timelineValue = Submit({ .CommandBuffers = { *commandBuffer } });
+    const auto lock = std::lock_guard(_immediateContextMutex);
+    _immediateContexts.push_back({
+      .CommandBuffer = std::move(commandBuffer),
+      .Value = timelineValue,
+    });
+    return timelineValue;
+  }
+
+  auto CQueue::Submit(std::move_only_function<void(CCommandBuffer&)>&& submission) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    _timeline->Wait(SubmitAsync(std::move(submission)));
+  }
+
+  auto CQueue::ReleaseImmediateContexts() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto lock = std::lock_guard(_immediateContextMutex);
+    if (_immediateContexts.empty()) {
+      return;
+    }
+    _timeline->Wait(GetTimelineValue());
+    _immediateContexts.clear();
   }
 
   auto CQueue::WaitIdle() const noexcept -> void {
@@ -168,5 +231,33 @@ namespace Retina::Graphics {
     RETINA_PROFILE_SCOPED();
     _mutex.unlock();
   }
-}
 
+  auto CQueue::AcquireImmediateContext() noexcept -> Core::CArcPtr<CCommandBuffer> {
+    RETINA_PROFILE_SCOPED();
+    auto commandBuffer = Core::CArcPtr<CCommandBuffer>();
+    {
+      const auto lock = std::lock_guard(_immediateContextMutex);
+      if (!_immediateContexts.empty()) {
+        const auto completedValue = _timeline->GetCounter();
+        for (auto i = 0_usize; i < _immediateContexts.size(); ++i) {
+          if (_immediateContexts[i].Value <= completedValue) {
+            std::swap(_immediateContexts[i], _immediateContexts.back());
+            commandBuffer = std::move(_immediateContexts.back().CommandBuffer);
+            _immediateContexts.pop_back();
+            break;
+          }
+        }
+      }
+    }
+    if (commandBuffer) {
+      commandBuffer->GetCommandPool().Reset();
+      return commandBuffer;
+    }
+    return CCommandBuffer::Make(*this, {
+      .Name = "ImmediateCommandBuffer",
+      .PoolInfo = { {
+        .Flags = ECommandPoolCreateFlag::E_TRANSIENT,
+      } },
+    });
+  }
+}
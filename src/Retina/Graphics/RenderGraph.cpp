@@ -0,0 +1,927 @@
+#include <Retina/Graphics/Buffer.hpp>
+#include <Retina/Graphics/CommandBuffer.hpp>
+#include <Retina/Graphics/CommandPoolAllocator.hpp>
+#include <Retina/Graphics/Device.hpp>
+#include <Retina/Graphics/Image.hpp>
+#include <Retina/Graphics/Queue.hpp>
+#include <Retina/Graphics/RenderGraph.hpp>
+#include <Retina/Graphics/TimelineSemaphore.hpp>
+
+#include <algorithm>
+#include <future>
+#include <tuple>
+#include <utility>
+
+namespace Retina::Graphics {
+  namespace Details {
+    RETINA_NODISCARD RETINA_INLINE auto IsSameBarrierScope(const SImageMemoryBarrier& left, const SImageMemoryBarrier& right) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      return
+        &left.Image.Get() == &right.Image.Get() &&
+        left.SourceStage == right.SourceStage &&
+        left.DestStage == right.DestStage &&
+        left.SourceAccess == right.SourceAccess &&
+        left.DestAccess == right.DestAccess &&
+        left.OldLayout == right.OldLayout &&
+        left.NewLayout == right.NewLayout;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto IsImageLayoutChanging(
+      EImageLayout currentLayout,
+      const SRenderGraphAccessInfo& accessInfo
+    ) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      return accessInfo.Layout != EImageLayout::E_UNDEFINED && accessInfo.Layout != currentLayout;
+    }
+
+    // Stages the async compute queue supports, anything else has to run on the graphics queue
+    RETINA_NODISCARD RETINA_INLINE auto IsComputeQueueStage(EPipelineStageFlag stage) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      constexpr auto computeStages =
+        EPipelineStageFlag::E_DRAW_INDIRECT |
+        EPipelineStageFlag::E_COMPUTE_SHADER |
+        EPipelineStageFlag::E_TRANSFER |
+        EPipelineStageFlag::E_ALL_COMMANDS;
+      return (stage & ~computeStages) == EPipelineStageFlag::E_NONE;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto GetOtherQueueDomain(EQueueDomain domain) noexcept -> EQueueDomain {
+      RETINA_PROFILE_SCOPED();
+      return domain == EQueueDomain::E_GRAPHICS ? EQueueDomain::E_COMPUTE : EQueueDomain::E_GRAPHICS;
+    }
+
+    struct SAliasedMemoryRange {
+      VmaAllocation Allocation = {};
+      uint64 Begin = 0;
+      uint64 End = 0;
+    };
+  }
+
+  CRenderGraph::CRenderGraph(const CDevice& device) noexcept
+    : _device(device)
+  {
+    RETINA_PROFILE_SCOPED();
+  }
+
+  auto CRenderGraph::Make(const CDevice& device, uint32 frameCount) noexcept -> Core::CUniquePtr<CRenderGraph> {
+    RETINA_PROFILE_SCOPED();
+    auto self = Core::MakeUnique<CRenderGraph>(device);
+    self->_commandPools = {
+      CCommandPoolAllocator::Make(device.GetGraphicsQueue(), frameCount),
+      CCommandPoolAllocator::Make(device.GetComputeQueue(), frameCount),
+    };
+    return self;
+  }
+
+  auto CRenderGraph::GetStatistics() const noexcept -> const SRenderGraphStatistics& {
+    RETINA_PROFILE_SCOPED();
+    return _statistics;
+  }
+
+  auto CRenderGraph::GetDevice() const noexcept -> const CDevice& {
+    RETINA_PROFILE_SCOPED();
+    return *_device;
+  }
+
+  auto CRenderGraph::ImportImage(const CImage& image, const SRenderGraphImportInfo& importInfo) noexcept -> SRenderGraphImage {
+    RETINA_PROFILE_SCOPED();
+    const auto it = std::ranges::find(_images, &image, &SImageResource::Image);
+    if (it != _images.end()) {
+      return { static_cast<uint32>(std::distance(_images.begin(), it)) };
+    }
+    RETINA_ASSERT_WITH(
+      !image.IsAliased() || importInfo.InitialAccess == ERenderGraphAccess::E_NONE,
+      "Aliased images do not keep their contents between frames"
+    );
+    _images.push_back({
+      .Image = &image,
+      .ImportInfo = importInfo,
+      .LevelCount = image.GetLevelCount(),
+      .LayerCount = image.GetLayerCount(),
+    });
+    return { static_cast<uint32>(_images.size() - 1) };
+  }
+
+  auto CRenderGraph::ImportBuffer(const CBuffer& buffer, const SRenderGraphImportInfo& importInfo) noexcept -> SRenderGraphBuffer {
+    RETINA_PROFILE_SCOPED();
+    const auto it = std::ranges::find(_buffers, &buffer, &SBufferResource::Buffer);
+    if (it != _buffers.end()) {
+      return { static_cast<uint32>(std::distance(_buffers.begin(), it)) };
+    }
+    RETINA_ASSERT_WITH(
+      !buffer.IsAliased() || importInfo.InitialAccess == ERenderGraphAccess::E_NONE,
+      "Aliased buffers do not keep their contents between frames"
+    );
+    _buffers.push_back({
+      .Buffer = &buffer,
+      .ImportInfo = importInfo,
+    });
+    return { static_cast<uint32>(_buffers.size() - 1) };
+  }
+
+  auto CRenderGraph::AddPass(SRenderGraphPassInfo&& passInfo) noexcept -> CRenderGraph& {
+    RETINA_PROFILE_SCOPED();
+    RETINA_ASSERT_WITH(passInfo.Queue != EQueueDomain::E_TRANSFER, "Render graph passes run on the graphics or the compute queue");
+    if (passInfo.Queue == EQueueDomain::E_COMPUTE) {
+      for (const auto& usage : passInfo.Images) {
+        RETINA_ASSERT_WITH(Details::IsComputeQueueStage(GetRenderGraphAccessInfo(usage.Access).Stage), "Async compute pass uses a graphics stage");
+      }
+      for (const auto& usage : passInfo.Buffers) {
+        RETINA_ASSERT_WITH(Details::IsComputeQueueStage(GetRenderGraphAccessInfo(usage.Access).Stage), "Async compute pass uses a graphics stage");
+      }
+    }
+    _passes.emplace_back(std::move(passInfo));
+    return *this;
+  }
+
+  auto CRenderGraph::Submit(const SRenderGraphSubmitInfo& submitInfo) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    _isAsyncCompute = &_device->GetComputeQueue() != &_device->GetGraphicsQueue();
+    if (!_isAsyncCompute) {
+      for (auto& pass : _passes) {
+        pass.Queue = EQueueDomain::E_GRAPHICS;
+      }
+    }
+    FindAliases();
+    const auto isPassAlive = CullPasses();
+    const auto levels = SchedulePasses(isPassAlive);
+    _statistics = {
+      .PassCount = static_cast<uint32>(_passes.size()),
+      .CulledPassCount = static_cast<uint32>(std::ranges::count(isPassAlive, false)),
+      .LevelCount = static_cast<uint32>(levels.size()),
+    };
+    for (auto i = 0_u32; i < _passes.size(); ++i) {
+      if (isPassAlive[i] && _passes[i].Queue == EQueueDomain::E_COMPUTE) {
+        _statistics.AsyncComputePassCount++;
+      }
+    }
+
+    // Whatever the device already finished needs no wait
+    for (const auto domain : { EQueueDomain::E_GRAPHICS, EQueueDomain::E_COMPUTE }) {
+      const auto slot = std::to_underlying(domain);
+      const auto completedValue = GetQueue(domain).GetTimeline().GetCounter();
+      std::erase_if(_queueAccessValues[slot], [&](const auto& entry) noexcept {
+        return entry.second <= completedValue;
+      });
+    }
+
+    const auto makeInitialState = [](ERenderGraphAccess access) noexcept {
+      const auto accessInfo = GetRenderGraphAccessInfo(access);
+      auto state = SResourceState();
+      state.Layout = accessInfo.Layout;
+      if (accessInfo.IsWrite) {
+        state.WriteStage = accessInfo.Stage;
+        state.WriteAccess = accessInfo.Access;
+      } else {
+        state.ReadStage = accessInfo.Stage;
+        state.ReadAccess = accessInfo.Access;
+      }
+      return state;
+    };
+    for (auto& image : _images) {
+      image.States.assign(image.LevelCount * image.LayerCount, makeInitialState(image.ImportInfo.InitialAccess));
+    }
+    for (auto& buffer : _buffers) {
+      buffer.State = makeInitialState(buffer.ImportInfo.InitialAccess);
+    }
+
+    for (auto& commandPools : _commandPools) {
+      commandPools->BeginFrame(submitInfo.FrameIndex);
+    }
+    // The calling thread records the first chunk of every submission, the workers record the others
+    const auto workerCount = std::max(submitInfo.RecordingThreadCount, 1_u32) - 1;
+    if (workerCount == 0) {
+      _workerPool.Reset();
+    } else if (!_workerPool || _workerPool->GetWorkerCount() != workerCount) {
+      _workerPool = Core::CWorkerPool::Make(workerCount);
+    }
+
+    // The first graphics submission carries the caller's commands, async compute work must not start before them
+    _submissions.clear();
+    _batchSubmissions.clear();
+    _openSubmissions = { -1_u32, -1_u32 };
+    _currentQueue = EQueueDomain::E_GRAPHICS;
+    MakeSubmission(EQueueDomain::E_GRAPHICS);
+    _submissions.front().IsClosed = _statistics.AsyncComputePassCount > 0;
+
+    // Every barrier is resolved before recording starts so the statistics are complete while passes execute.
+    // Each level records its graphics passes first, then its compute passes
+    auto batch = SBarrierBatch();
+    for (const auto& level : levels) {
+      for (const auto domain : { EQueueDomain::E_GRAPHICS, EQueueDomain::E_COMPUTE }) {
+        auto passes = std::vector<uint32>();
+        for (const auto passIndex : level) {
+          if (_passes[passIndex].Queue == domain) {
+            passes.emplace_back(passIndex);
+          }
+        }
+        if (passes.empty()) {
+          continue;
+        }
+        _currentQueue = domain;
+        for (const auto passIndex : passes) {
+          const auto& pass = _passes[passIndex];
+          for (const auto& usage : pass.Images) {
+            AccessImage(batch, usage.Image.Index, usage.SubresourceRange, usage.Access);
+          }
+          for (const auto& usage : pass.Buffers) {
+            AccessBuffer(batch, usage.Buffer.Index, usage.Access);
+          }
+        }
+        CommitBatch(batch, std::move(passes));
+      }
+    }
+
+    // Exported resources are left on the graphics queue, in the state the next consumer outside the graph expects
+    _currentQueue = EQueueDomain::E_GRAPHICS;
+    for (auto i = 0_u32; i < _images.size(); ++i) {
+      const auto finalAccess = _images[i].ImportInfo.FinalAccess;
+      if (finalAccess != ERenderGraphAccess::E_NONE) {
+        AccessImage(batch, i, {}, finalAccess);
+      }
+    }
+    for (auto i = 0_u32; i < _buffers.size(); ++i) {
+      const auto finalAccess = _buffers[i].ImportInfo.FinalAccess;
+      if (finalAccess != ERenderGraphAccess::E_NONE) {
+        AccessBuffer(batch, i, finalAccess);
+      }
+    }
+    CommitBatch(batch, {});
+
+    // The caller's timelines mark the whole frame as done. When compute work exists they are signaled from the
+    // compute queue after it caught up with graphics, which keeps the next frame's graphics work from waiting on it
+    const auto lastGraphicsSubmission = _openSubmissions[std::to_underlying(EQueueDomain::E_GRAPHICS)];
+    auto timelineSubmission = lastGraphicsSubmission;
+    if (_openSubmissions[std::to_underlying(EQueueDomain::E_COMPUTE)] != -1_u32) {
+      _currentQueue = EQueueDomain::E_COMPUTE;
+      timelineSubmission = MakeSubmission(EQueueDomain::E_COMPUTE);
+      _submissions[timelineSubmission].WaitSubmission = lastGraphicsSubmission;
+      _submissions[timelineSubmission].WaitStage = EPipelineStageFlag::E_ALL_COMMANDS;
+    }
+    _statistics.SubmissionCount = static_cast<uint32>(_submissions.size());
+
+    // Submissions only wait on earlier ones, so the values they wait on are known by the time they are submitted
+    for (auto i = 0_u32; i < _submissions.size(); ++i) {
+      auto& submission = _submissions[i];
+      auto queueSubmitInfo = SQueueSubmitInfo();
+      if (i == 0) {
+        queueSubmitInfo.CommandBuffers = submitInfo.CommandBuffers;
+        queueSubmitInfo.WaitSemaphores = submitInfo.WaitSemaphores;
+      }
+      const auto slot = std::to_underlying(submission.Queue);
+      if (!submission.Steps.empty()) {
+        // Contiguous runs of steps holding about the same number of passes, each recorded into its own
+        // command buffer. Submitted in order, so barriers keep covering everything recorded after them
+        auto passCount = 0_u32;
+        for (const auto& step : submission.Steps) {
+          passCount += step.Passes.size();
+        }
+        // Every chunk takes one of the submission's command buffer slots, the caller's command buffers come first
+        const auto freeCommandBufferCount = static_cast<uint32>(MAX_QUEUE_SUBMIT_COMMAND_BUFFERS - queueSubmitInfo.CommandBuffers.GetSize());
+        const auto chunkCount = std::clamp(submitInfo.RecordingThreadCount, 1_u32, std::max(std::min(passCount, freeCommandBufferCount), 1_u32));
+        auto chunks = std::vector<std::pair<uint32, uint32>>();
+        for (auto stepIndex = 0_u32, firstStep = 0_u32, recordedCount = 0_u32; stepIndex < submission.Steps.size(); ++stepIndex) {
+          recordedCount += submission.Steps[stepIndex].Passes.size();
+          const auto isLastStep = stepIndex + 1 == submission.Steps.size();
+          if (isLastStep || (chunks.size() + 1 < chunkCount && recordedCount * chunkCount >= (chunks.size() + 1) * passCount)) {
+            chunks.emplace_back(firstStep, stepIndex + 1);
+            firstStep = stepIndex + 1;
+          }
+        }
+        // Allocated by the recording thread, each thread owns the pools it allocates from
+        auto commandBuffers = std::vector<CCommandBuffer*>(chunks.size());
+        const auto record = [&](usize chunk) noexcept {
+          RETINA_PROFILE_SCOPED();
+          auto& commands = _commandPools[slot]->Allocate();
+          commandBuffers[chunk] = &commands;
+          commands.Begin();
+          for (auto stepIndex = chunks[chunk].first; stepIndex < chunks[chunk].second; ++stepIndex) {
+            auto& step = submission.Steps[stepIndex];
+            if (!step.Barrier.MemoryBarriers.empty() || !step.Barrier.ImageMemoryBarriers.empty()) {
+              commands.Barrier(step.Barrier);
+            }
+            for (const auto passIndex : step.Passes) {
+              auto& pass = _passes[passIndex];
+              commands.BeginNamedRegion(pass.Name);
+              if (pass.Execute) {
+                pass.Execute(commands);
+              }
+              commands.EndNamedRegion();
+            }
+          }
+          commands.End();
+        };
+        auto recordings = std::vector<std::future<void>>();
+        for (auto chunk = 1_usize; chunk < chunks.size(); ++chunk) {
+          recordings.emplace_back(_workerPool->Submit([&record, chunk] noexcept {
+            record(chunk);
+          }));
+        }
+        record(0);
+        for (auto& recording : recordings) {
+          recording.get();
+        }
+        for (const auto* commands : commandBuffers) {
+          queueSubmitInfo.CommandBuffers.EmplaceBack(*commands);
+        }
+      }
+
+      if (submission.WaitSubmission != -1_u32 || submission.WaitValue != 0) {
+        auto waitValue = submission.WaitValue;
+        if (submission.WaitSubmission != -1_u32) {
+          waitValue = std::max(waitValue, _submissions[submission.WaitSubmission].SignalValue);
+        }
+        queueSubmitInfo.WaitSemaphores.PushBack({
+          GetQueue(Details::GetOtherQueueDomain(submission.Queue)).GetTimeline(),
+          submission.WaitStage,
+          waitValue,
+        });
+      }
+      if (i == lastGraphicsSubmission) {
+        queueSubmitInfo.SignalSemaphores = submitInfo.SignalSemaphores;
+      }
+      if (i == timelineSubmission) {
+        queueSubmitInfo.Timelines = submitInfo.Timelines;
+      }
+      submission.SignalValue = GetQueue(submission.Queue).Submit(queueSubmitInfo);
+    }
+
+    // Remembered for the next frames, whose first access on the other queue has to wait on these values
+    if (_isAsyncCompute) {
+      const auto recordAccess = [&](const void* key, uint32 batchIndex) noexcept {
+        if (batchIndex == -1_u32) {
+          return;
+        }
+        const auto& submission = _submissions[_batchSubmissions[batchIndex]];
+        auto& value = _queueAccessValues[std::to_underlying(submission.Queue)][key];
+        value = std::max(value, submission.SignalValue);
+      };
+      for (const auto& image : _images) {
+        for (const auto& state : image.States) {
+          recordAccess(image.Image, state.Batch);
+          if (image.Alias.IsAliased) {
+            recordAccess(image.Image->GetAllocation(), state.Batch);
+          }
+        }
+      }
+      for (const auto& buffer : _buffers) {
+        recordAccess(buffer.Buffer, buffer.State.Batch);
+        if (buffer.Alias.IsAliased) {
+          recordAccess(buffer.Buffer->GetAllocation(), buffer.State.Batch);
+        }
+      }
+    }
+
+    _images.clear();
+    _buffers.clear();
+    _passes.clear();
+  }
+
+  auto CRenderGraph::FindAliases() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto resourceCount = static_cast<uint32>(_images.size() + _buffers.size());
+    auto ranges = std::vector<Details::SAliasedMemoryRange>(resourceCount);
+    for (auto i = 0_u32; i < _images.size(); ++i) {
+      const auto& image = *_images[i].Image;
+      if (image.IsAliased()) {
+        ranges[i] = {
+          .Allocation = image.GetAllocation(),
+          .Begin = image.GetAliasOffset(),
+          .End = image.GetAliasOffset() + image.GetMemoryRequirements().size,
+        };
+      }
+    }
+    for (auto i = 0_u32; i < _buffers.size(); ++i) {
+      const auto& buffer = *_buffers[i].Buffer;
+      if (buffer.IsAliased()) {
+        ranges[_images.size() + i] = {
+          .Allocation = buffer.GetAllocation(),
+          .Begin = buffer.GetAliasOffset(),
+          .End = buffer.GetAliasOffset() + buffer.GetMemoryRequirements().size,
+        };
+      }
+    }
+
+    for (auto i = 0_u32; i < resourceCount; ++i) {
+      if (!ranges[i].Allocation) {
+        continue;
+      }
+      GetAliasState(i).IsAliased = true;
+      for (auto j = i + 1; j < resourceCount; ++j) {
+        const auto isOverlapping =
+          ranges[i].Allocation == ranges[j].Allocation &&
+          ranges[i].Begin < ranges[j].End &&
+          ranges[j].Begin < ranges[i].End;
+        if (isOverlapping) {
+          GetAliasState(i).Aliases.emplace_back(j);
+          GetAliasState(j).Aliases.emplace_back(i);
+        }
+      }
+    }
+  }
+
+  auto CRenderGraph::GetAliasState(uint32 resourceIndex) noexcept -> SAliasState& {
+    RETINA_PROFILE_SCOPED();
+    if (resourceIndex < _images.size()) {
+      return _images[resourceIndex].Alias;
+    }
+    return _buffers[resourceIndex - _images.size()].Alias;
+  }
+
+  auto CRenderGraph::GetResourceStates(uint32 resourceIndex) noexcept -> std::span<SResourceState> {
+    RETINA_PROFILE_SCOPED();
+    if (resourceIndex < _images.size()) {
+      return _images[resourceIndex].States;
+    }
+    return { &_buffers[resourceIndex - _images.size()].State, 1 };
+  }
+
+  auto CRenderGraph::CullPasses() const noexcept -> std::vector<bool> {
+    RETINA_PROFILE_SCOPED();
+    auto isImageNeeded = std::vector<bool>(_images.size());
+    auto isBufferNeeded = std::vector<bool>(_buffers.size());
+    for (auto i = 0_u32; i < _images.size(); ++i) {
+      isImageNeeded[i] = _images[i].ImportInfo.FinalAccess != ERenderGraphAccess::E_NONE;
+    }
+    for (auto i = 0_u32; i < _buffers.size(); ++i) {
+      isBufferNeeded[i] = _buffers[i].ImportInfo.FinalAccess != ERenderGraphAccess::E_NONE;
+    }
+
+    // Walks backwards from the exported resources, a pass survives if something later consumes one of its writes.
+    // Writes are not assumed to overwrite the whole resource, so they never end the lifetime of earlier contents
+    auto isPassAlive = std::vector<bool>(_passes.size());
+    for (auto i = static_cast<int32>(_passes.size()) - 1; i >= 0; --i) {
+      const auto& pass = _passes[i];
+      auto isAlive = pass.HasSideEffects;
+      for (const auto& usage : pass.Images) {
+        isAlive |= GetRenderGraphAccessInfo(usage.Access).IsWrite && isImageNeeded[usage.Image.Index];
+      }
+      for (const auto& usage : pass.Buffers) {
+        isAlive |= GetRenderGraphAccessInfo(usage.Access).IsWrite && isBufferNeeded[usage.Buffer.Index];
+      }
+      if (!isAlive) {
+        continue;
+      }
+      isPassAlive[i] = true;
+      for (const auto& usage : pass.Images) {
+        isImageNeeded[usage.Image.Index] = true;
+      }
+      for (const auto& usage : pass.Buffers) {
+        isBufferNeeded[usage.Buffer.Index] = true;
+      }
+    }
+    return isPassAlive;
+  }
+
+  auto CRenderGraph::SchedulePasses(const std::vector<bool>& isPassAlive) const noexcept -> std::vector<std::vector<uint32>> {
+    RETINA_PROFILE_SCOPED();
+    struct SHazardState {
+      EImageLayout Layout = EImageLayout::E_UNDEFINED;
+      uint32 LastWriter = -1_u32;
+      std::vector<uint32> Readers;
+      // Highest level touching the resource, an alias taking over its memory goes after it
+      uint32 LastLevel = 0;
+      bool IsAccessed = false;
+    };
+    auto imageHazards = std::vector<SHazardState>(_images.size());
+    auto bufferHazards = std::vector<SHazardState>(_buffers.size());
+    for (auto i = 0_u32; i < _images.size(); ++i) {
+      imageHazards[i].Layout = GetRenderGraphAccessInfo(_images[i].ImportInfo.InitialAccess).Layout;
+    }
+
+    // A layout transition rewrites the image, so a read in a different layout orders like a write
+    const auto isHazardWrite = [](const SHazardState& hazard, const SRenderGraphAccessInfo& accessInfo) noexcept {
+      return accessInfo.IsWrite || Details::IsImageLayoutChanging(hazard.Layout, accessInfo);
+    };
+    const auto getHazard = [&](uint32 resourceIndex) noexcept -> const SHazardState& {
+      if (resourceIndex < _images.size()) {
+        return imageHazards[resourceIndex];
+      }
+      return bufferHazards[resourceIndex - _images.size()];
+    };
+    const auto getAliases = [&](uint32 resourceIndex) noexcept -> const std::vector<uint32>& {
+      if (resourceIndex < _images.size()) {
+        return _images[resourceIndex].Alias.Aliases;
+      }
+      return _buffers[resourceIndex - _images.size()].Alias.Aliases;
+    };
+
+    auto passLevels = std::vector<uint32>(_passes.size());
+    const auto getLevelAfter = [&](uint32 resourceIndex, const SHazardState& hazard, const SRenderGraphAccessInfo& accessInfo) noexcept {
+      auto level = 0_u32;
+      if (!hazard.IsAccessed) {
+        for (const auto alias : getAliases(resourceIndex)) {
+          const auto& aliasHazard = getHazard(alias);
+          if (aliasHazard.IsAccessed) {
+            level = std::max(level, aliasHazard.LastLevel + 1);
+          }
+        }
+      }
+      if (hazard.LastWriter != -1_u32) {
+        level = std::max(level, passLevels[hazard.LastWriter] + 1);
+      }
+      if (isHazardWrite(hazard, accessInfo)) {
+        for (const auto reader : hazard.Readers) {
+          level = std::max(level, passLevels[reader] + 1);
+        }
+      }
+      return level;
+    };
+    const auto updateHazard = [&](SHazardState& hazard, const SRenderGraphAccessInfo& accessInfo, uint32 passIndex) noexcept {
+      hazard.LastLevel = std::max(hazard.LastLevel, passLevels[passIndex]);
+      hazard.IsAccessed = true;
+      if (isHazardWrite(hazard, accessInfo)) {
+        hazard.LastWriter = passIndex;
+        hazard.Readers.clear();
+      } else {
+        hazard.Readers.emplace_back(passIndex);
+      }
+      if (accessInfo.Layout != EImageLayout::E_UNDEFINED) {
+        hazard.Layout = accessInfo.Layout;
+      }
+    };
+
+    auto levelCount = 0_u32;
+    for (auto i = 0_u32; i < _passes.size(); ++i) {
+      if (!isPassAlive[i]) {
+        continue;
+      }
+      const auto& pass = _passes[i];
+      auto level = 0_u32;
+      for (const auto& usage : pass.Images) {
+        const auto resourceIndex = usage.Image.Index;
+        level = std::max(level, getLevelAfter(resourceIndex, imageHazards[resourceIndex], GetRenderGraphAccessInfo(usage.Access)));
+      }
+      for (const auto& usage : pass.Buffers) {
+        auto accessInfo = GetRenderGraphAccessInfo(usage.Access);
+        accessInfo.Layout = EImageLayout::E_UNDEFINED;
+        const auto resourceIndex = static_cast<uint32>(_images.size()) + usage.Buffer.Index;
+        level = std::max(level, getLevelAfter(resourceIndex, bufferHazards[usage.Buffer.Index], accessInfo));
+      }
+      passLevels[i] = level;
+      levelCount = std::max(levelCount, level + 1);
+
+      for (const auto& usage : pass.Images) {
+        updateHazard(imageHazards[usage.Image.Index], GetRenderGraphAccessInfo(usage.Access), i);
+      }
+      for (const auto& usage : pass.Buffers) {
+        auto accessInfo = GetRenderGraphAccessInfo(usage.Access);
+        accessInfo.Layout = EImageLayout::E_UNDEFINED;
+        updateHazard(bufferHazards[usage.Buffer.Index], accessInfo, i);
+      }
+    }
+
+    // Passes inside a level keep their declaration order
+    auto levels = std::vector<std::vector<uint32>>(levelCount);
+    for (auto i = 0_u32; i < _passes.size(); ++i) {
+      if (isPassAlive[i]) {
+        levels[passLevels[i]].emplace_back(i);
+      }
+    }
+    return levels;
+  }
+
+  auto CRenderGraph::GetQueue(EQueueDomain domain) const noexcept -> CQueue& {
+    RETINA_PROFILE_SCOPED();
+    if (domain == EQueueDomain::E_COMPUTE) {
+      return _device->GetComputeQueue();
+    }
+    return _device->GetGraphicsQueue();
+  }
+
+  auto CRenderGraph::MakeSubmission(EQueueDomain domain) noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    const auto slot = std::to_underlying(domain);
+    auto submission = SSubmission();
+    submission.Queue = domain;
+    // The first compute submission starts once the caller's graphics commands are done
+    if (domain == EQueueDomain::E_COMPUTE && _openSubmissions[slot] == -1_u32) {
+      submission.WaitSubmission = 0;
+      submission.WaitStage = EPipelineStageFlag::E_ALL_COMMANDS;
+      _submissions.front().IsClosed = true;
+    }
+    _submissions.emplace_back(std::move(submission));
+    _openSubmissions[slot] = static_cast<uint32>(_submissions.size() - 1);
+    return _openSubmissions[slot];
+  }
+
+  auto CRenderGraph::GetOpenSubmission(EQueueDomain domain) noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    const auto submissionIndex = _openSubmissions[std::to_underlying(domain)];
+    if (submissionIndex == -1_u32 || _submissions[submissionIndex].IsClosed) {
+      return MakeSubmission(domain);
+    }
+    return submissionIndex;
+  }
+
+  auto CRenderGraph::GetWaitingSubmission() noexcept -> SSubmission& {
+    RETINA_PROFILE_SCOPED();
+    // Waits happen before everything in a submission, recorded work must not be held back by them
+    auto submissionIndex = GetOpenSubmission(_currentQueue);
+    if (!_submissions[submissionIndex].Steps.empty()) {
+      submissionIndex = MakeSubmission(_currentQueue);
+    }
+    return _submissions[submissionIndex];
+  }
+
+  auto CRenderGraph::WaitForSubmission(uint32 submissionIndex, EPipelineStageFlag stage) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    auto& submission = GetWaitingSubmission();
+    if (submission.WaitSubmission == -1_u32 || submission.WaitSubmission < submissionIndex) {
+      submission.WaitSubmission = submissionIndex;
+    }
+    submission.WaitStage |= stage;
+    _submissions[submissionIndex].IsClosed = true;
+  }
+
+  auto CRenderGraph::WaitForValue(uint64 value, EPipelineStageFlag stage) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    auto& submission = GetWaitingSubmission();
+    submission.WaitValue = std::max(submission.WaitValue, value);
+    submission.WaitStage |= stage;
+  }
+
+  auto CRenderGraph::AcquireQueue(SResourceState& state, uint32 resourceIndex, const SRenderGraphAccessInfo& accessInfo) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto currentBatch = static_cast<uint32>(_batchSubmissions.size());
+    const auto previousBatch = std::exchange(state.Batch, currentBatch);
+    if (!_isAsyncCompute || previousBatch == currentBatch) {
+      return;
+    }
+    if (previousBatch != -1_u32) {
+      const auto submissionIndex = _batchSubmissions[previousBatch];
+      if (_submissions[submissionIndex].Queue == _currentQueue) {
+        return;
+      }
+      WaitForSubmission(submissionIndex, accessInfo.Stage);
+    } else {
+      // First access in this graph, an earlier one may still be using the resource on the other queue.
+      // Stages the compute queue does not know about can only come from graphics work
+      const auto isImage = resourceIndex < _images.size();
+      const auto* key = isImage
+        ? static_cast<const void*>(_images[resourceIndex].Image)
+        : static_cast<const void*>(_buffers[resourceIndex - _images.size()].Buffer);
+      const auto& otherValues = _queueAccessValues[std::to_underlying(Details::GetOtherQueueDomain(_currentQueue))];
+      const auto it = otherValues.find(key);
+      if (it != otherValues.end()) {
+        WaitForValue(it->second, accessInfo.Stage);
+      } else if (_currentQueue == EQueueDomain::E_COMPUTE && !Details::IsComputeQueueStage(state.WriteStage | state.ReadStage)) {
+        WaitForValue(_device->GetGraphicsQueue().GetTimelineValue(), accessInfo.Stage);
+      } else {
+        return;
+      }
+    }
+
+    const auto isImage = resourceIndex < _images.size();
+    const auto isCrossDomain = isImage
+      ? _images[resourceIndex].Image->GetCreateInfo().IsCrossDomain
+      : _buffers[resourceIndex - _images.size()].Buffer->GetCreateInfo().IsCrossDomain;
+    RETINA_ASSERT_WITH(
+      isCrossDomain || _device->GetComputeQueue().GetFamilyIndex() == _device->GetGraphicsQueue().GetFamilyIndex(),
+      "Resources used on both queues must be created cross domain"
+    );
+    // The semaphore wait makes everything visible to the accessing stage. A layout transition still
+    // has to chain after the wait, so it keeps the stage as its source
+    const auto isLayoutChanging = isImage && Details::IsImageLayoutChanging(state.Layout, accessInfo);
+    const auto isVisible = !accessInfo.IsWrite && !isLayoutChanging;
+    state.WriteStage = isLayoutChanging ? accessInfo.Stage : EPipelineStageFlag::E_NONE;
+    state.WriteAccess = EResourceAccessFlag::E_NONE;
+    state.ReadStage = isVisible ? accessInfo.Stage : EPipelineStageFlag::E_NONE;
+    state.ReadAccess = isVisible ? accessInfo.Access : EResourceAccessFlag::E_NONE;
+  }
+
+  auto CRenderGraph::AcquireAliasedMemory(uint32 resourceIndex, const SRenderGraphAccessInfo& accessInfo) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    auto& alias = GetAliasState(resourceIndex);
+    if (!alias.IsAliased || alias.IsAccessed) {
+      return;
+    }
+    alias.IsAccessed = true;
+
+    // The previous occupant's accesses become pending writes of this resource, so its first barrier
+    // (and layout transition) waits on them. Scheduling already placed those accesses in earlier levels.
+    // Occupants on the other queue are waited on through the semaphore instead
+    const auto currentBatch = static_cast<uint32>(_batchSubmissions.size());
+    auto sourceStage = EPipelineStageFlag::E_NONE;
+    auto sourceAccess = EResourceAccessFlag::E_NONE;
+    auto hasPredecessor = false;
+    for (const auto other : alias.Aliases) {
+      if (!GetAliasState(other).IsAccessed) {
+        continue;
+      }
+      hasPredecessor = true;
+      for (const auto& state : GetResourceStates(other)) {
+        if (state.Batch == -1_u32) {
+          continue;
+        }
+        if (state.Batch != currentBatch && _submissions[_batchSubmissions[state.Batch]].Queue != _currentQueue) {
+          WaitForSubmission(_batchSubmissions[state.Batch], accessInfo.Stage);
+          sourceStage |= accessInfo.Stage;
+          continue;
+        }
+        sourceStage |= state.WriteStage | state.ReadStage;
+        sourceAccess |= state.WriteAccess;
+      }
+    }
+    if (!hasPredecessor) {
+      sourceStage = EPipelineStageFlag::E_ALL_COMMANDS;
+      sourceAccess = EResourceAccessFlag::E_MEMORY_WRITE;
+      if (_isAsyncCompute) {
+        const auto* key = resourceIndex < _images.size()
+          ? static_cast<const void*>(_images[resourceIndex].Image->GetAllocation())
+          : static_cast<const void*>(_buffers[resourceIndex - _images.size()].Buffer->GetAllocation());
+        const auto& otherValues = _queueAccessValues[std::to_underlying(Details::GetOtherQueueDomain(_currentQueue))];
+        if (const auto it = otherValues.find(key); it != otherValues.end()) {
+          WaitForValue(it->second, accessInfo.Stage);
+        }
+      }
+    }
+    for (auto& state : GetResourceStates(resourceIndex)) {
+      state.WriteStage |= sourceStage;
+      state.WriteAccess |= sourceAccess;
+      state.Batch = currentBatch;
+    }
+  }
+
+  auto CRenderGraph::AccessImage(
+    SBarrierBatch& batch,
+    uint32 imageIndex,
+    const SImageSubresourceRange& range,
+    ERenderGraphAccess access
+  ) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto accessInfo = GetRenderGraphAccessInfo(access);
+    AcquireAliasedMemory(imageIndex, accessInfo);
+    auto& image = _images[imageIndex];
+    const auto baseLevel = range.BaseLevel == SUBRESOURCE_LEVEL_IGNORED ? 0_u32 : range.BaseLevel;
+    const auto baseLayer = range.BaseLayer == SUBRESOURCE_LAYER_IGNORED ? 0_u32 : range.BaseLayer;
+    const auto levelCount = range.LevelCount == SUBRESOURCE_REMAINING_LEVELS ? image.LevelCount - baseLevel : range.LevelCount;
+    const auto layerCount = range.LayerCount == SUBRESOURCE_REMAINING_LAYERS ? image.LayerCount - baseLayer : range.LayerCount;
+    for (auto level = baseLevel; level < baseLevel + levelCount; ++level) {
+      for (auto layer = baseLayer; layer < baseLayer + layerCount; ++layer) {
+        auto& state = image.States[level * image.LayerCount + layer];
+        AcquireQueue(state, imageIndex, accessInfo);
+        if (!Details::IsImageLayoutChanging(state.Layout, accessInfo)) {
+          AccessResource(batch, state, accessInfo);
+          continue;
+        }
+        RETINA_ASSERT_WITH(state.BatchBarrierIndex == -1_u32, "Subresource changes layout twice in the same barrier batch");
+        state.BatchBarrierIndex = static_cast<uint32>(batch.ImageBarriers.size());
+        batch.ImageBarriers.push_back({
+          .Image = imageIndex,
+          .Level = level,
+          .Layer = layer,
+          .SourceStage = state.WriteStage | state.ReadStage,
+          .DestStage = accessInfo.Stage,
+          .SourceAccess = state.WriteAccess,
+          .DestAccess = accessInfo.Access,
+          .OldLayout = state.Layout,
+          .NewLayout = accessInfo.Layout,
+        });
+        // The transition itself is a write that later accesses have to wait on
+        state.Layout = accessInfo.Layout;
+        state.WriteStage = accessInfo.Stage;
+        state.WriteAccess = accessInfo.IsWrite ? accessInfo.Access : EResourceAccessFlag::E_NONE;
+        state.ReadStage = accessInfo.IsWrite ? EPipelineStageFlag::E_NONE : accessInfo.Stage;
+        state.ReadAccess = accessInfo.IsWrite ? EResourceAccessFlag::E_NONE : accessInfo.Access;
+      }
+    }
+  }
+
+  auto CRenderGraph::AccessBuffer(SBarrierBatch& batch, uint32 bufferIndex, ERenderGraphAccess access) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto resourceIndex = static_cast<uint32>(_images.size()) + bufferIndex;
+    const auto accessInfo = GetRenderGraphAccessInfo(access);
+    AcquireAliasedMemory(resourceIndex, accessInfo);
+    auto& state = _buffers[bufferIndex].State;
+    AcquireQueue(state, resourceIndex, accessInfo);
+    AccessResource(batch, state, accessInfo);
+  }
+
+  auto CRenderGraph::AccessResource(
+    SBarrierBatch& batch,
+    SResourceState& state,
+    const SRenderGraphAccessInfo& accessInfo
+  ) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    auto sourceStage = EPipelineStageFlag::E_NONE;
+    auto sourceAccess = EResourceAccessFlag::E_NONE;
+    if (accessInfo.IsWrite) {
+      // Write after write needs the previous write available, write after read only needs the execution dependency
+      sourceStage = state.WriteStage | state.ReadStage;
+      sourceAccess = state.WriteAccess;
+      state.WriteStage = accessInfo.Stage;
+      state.WriteAccess = accessInfo.Access;
+      state.ReadStage = EPipelineStageFlag::E_NONE;
+      state.ReadAccess = EResourceAccessFlag::E_NONE;
+    } else {
+      const auto isVisible =
+        Core::IsFlagEnabled(state.ReadStage, accessInfo.Stage) &&
+        Core::IsFlagEnabled(state.ReadAccess, accessInfo.Access);
+      if (!isVisible) {
+        sourceStage = state.WriteStage;
+        sourceAccess = state.WriteAccess;
+      }
+      state.ReadStage |= accessInfo.Stage;
+      state.ReadAccess |= accessInfo.Access;
+    }
+    if (sourceStage == EPipelineStageFlag::E_NONE) {
+      return;
+    }
+
+    // Barriers in one batch are unordered, a subresource that was already transitioned in this batch
+    // widens that transition instead of depending on it
+    if (state.BatchBarrierIndex != -1_u32) {
+      auto& barrier = batch.ImageBarriers[state.BatchBarrierIndex];
+      barrier.DestStage |= accessInfo.Stage;
+      barrier.DestAccess |= accessInfo.Access;
+      return;
+    }
+    batch.MemoryBarrier.SourceStage |= sourceStage;
+    batch.MemoryBarrier.DestStage |= accessInfo.Stage;
+    batch.MemoryBarrier.SourceAccess |= sourceAccess;
+    batch.MemoryBarrier.DestAccess |= accessInfo.Access;
+  }
+
+  auto CRenderGraph::ResolveBatch(SBarrierBatch& batch) noexcept -> SMemoryBarrierInfo {
+    RETINA_PROFILE_SCOPED();
+    for (const auto& pending : batch.ImageBarriers) {
+      auto& image = _images[pending.Image];
+      image.States[pending.Level * image.LayerCount + pending.Layer].BatchBarrierIndex = -1_u32;
+    }
+    const auto hasMemoryBarrier = batch.MemoryBarrier.SourceStage != EPipelineStageFlag::E_NONE;
+    if (!hasMemoryBarrier && batch.ImageBarriers.empty()) {
+      return {};
+    }
+
+    std::ranges::sort(batch.ImageBarriers, {}, [](const SPendingImageBarrier& pending) noexcept {
+      return std::tie(pending.Image, pending.Level, pending.Layer);
+    });
+
+    // Adjacent layers of a level collapse first, then adjacent levels that cover the same layers
+    auto layerBarriers = std::vector<SImageMemoryBarrier>();
+    layerBarriers.reserve(batch.ImageBarriers.size());
+    for (const auto& pending : batch.ImageBarriers) {
+      auto barrier = SImageMemoryBarrier {
+        .Image = *_images[pending.Image].Image,
+        .SourceStage = pending.SourceStage,
+        .DestStage = pending.DestStage,
+        .SourceAccess = pending.SourceAccess,
+        .DestAccess = pending.DestAccess,
+        .OldLayout = pending.OldLayout,
+        .NewLayout = pending.NewLayout,
+        .SubresourceRange = {
+          .BaseLevel = pending.Level,
+          .LevelCount = 1,
+          .BaseLayer = pending.Layer,
+          .LayerCount = 1,
+        },
+      };
+      if (!layerBarriers.empty()) {
+        auto& last = layerBarriers.back();
+        const auto isAdjacent =
+          last.SubresourceRange.BaseLevel == pending.Level &&
+          last.SubresourceRange.BaseLayer + last.SubresourceRange.LayerCount == pending.Layer;
+        if (isAdjacent && Details::IsSameBarrierScope(last, barrier)) {
+          last.SubresourceRange.LayerCount++;
+          continue;
+        }
+      }
+      layerBarriers.emplace_back(barrier);
+    }
+
+    auto barrierInfo = SMemoryBarrierInfo();
+    barrierInfo.ImageMemoryBarriers.reserve(layerBarriers.size());
+    for (const auto& barrier : layerBarriers) {
+      if (!barrierInfo.ImageMemoryBarriers.empty()) {
+        auto& last = barrierInfo.ImageMemoryBarriers.back();
+        const auto isAdjacent =
+          last.SubresourceRange.BaseLayer == barrier.SubresourceRange.BaseLayer &&
+          last.SubresourceRange.LayerCount == barrier.SubresourceRange.LayerCount &&
+          last.SubresourceRange.BaseLevel + last.SubresourceRange.LevelCount == barrier.SubresourceRange.BaseLevel;
+        if (isAdjacent && Details::IsSameBarrierScope(last, barrier)) {
+          last.SubresourceRange.LevelCount += barrier.SubresourceRange.LevelCount;
+          continue;
+        }
+      }
+      barrierInfo.ImageMemoryBarriers.emplace_back(barrier);
+    }
+    if (hasMemoryBarrier) {
+      barrierInfo.MemoryBarriers.emplace_back(batch.MemoryBarrier);
+    }
+    _statistics.BarrierBatchCount++;
+    _statistics.ImageBarrierCount += static_cast<uint32>(barrierInfo.ImageMemoryBarriers.size());
+    batch = SBarrierBatch();
+    return barrierInfo;
+  }
+
+  auto CRenderGraph::CommitBatch(SBarrierBatch& batch, std::vector<uint32>&& passes) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto submissionIndex = GetOpenSubmission(_currentQueue);
+    _submissions[submissionIndex].Steps.push_back({
+      .Barrier = ResolveBatch(batch),
+      .Passes = std::move(passes),
+    });
+    _batchSubmissions.emplace_back(submissionIndex);
+  }
+}
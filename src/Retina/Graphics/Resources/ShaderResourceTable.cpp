@@ -1,5 +1,6 @@
 #include <Retina/Graphics/Resources/ShaderResourceTable.hpp>
 #include <Retina/Graphics/Buffer.hpp>
+#include <Retina/Graphics/DeletionQueue.hpp>
 #include <Retina/Graphics/DescriptorLayout.hpp>
 #include <Retina/Graphics/DescriptorPool.hpp>
 #include <Retina/Graphics/DescriptorSet.hpp>
@@ -10,13 +11,98 @@
 #include <Retina/Graphics/Macros.hpp>
 #include <Retina/Graphics/Sampler.hpp>
 
+#include <volk.h>
+
+#include <algorithm>
+#include <utility>
+#include <variant>
+
 namespace Retina::Graphics {
+  namespace Details {
+    RETINA_NODISCARD RETINA_INLINE auto GetDescriptorBufferProperties(
+      const CDevice& device
+    ) noexcept -> VkPhysicalDeviceDescriptorBufferPropertiesEXT {
+      RETINA_PROFILE_SCOPED();
+      auto descriptorBufferProperties = VkPhysicalDeviceDescriptorBufferPropertiesEXT(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT);
+      auto properties = VkPhysicalDeviceProperties2(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2);
+      properties.pNext = &descriptorBufferProperties;
+      vkGetPhysicalDeviceProperties2(device.GetPhysicalDevice(), &properties);
+      return descriptorBufferProperties;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto GetDescriptorSize(
+      const VkPhysicalDeviceDescriptorBufferPropertiesEXT& properties,
+      EDescriptorType type
+    ) noexcept -> usize {
+      RETINA_PROFILE_SCOPED();
+      switch (type) {
+        case EDescriptorType::E_SAMPLER:
+          return properties.samplerDescriptorSize;
+        case EDescriptorType::E_SAMPLED_IMAGE:
+          return properties.sampledImageDescriptorSize;
+        case EDescriptorType::E_STORAGE_IMAGE:
+          return properties.storageImageDescriptorSize;
+        case EDescriptorType::E_STORAGE_BUFFER:
+          return properties.storageBufferDescriptorSize;
+        default:
+          RETINA_GRAPHICS_PANIC_WITH("Unsupported descriptor type");
+      }
+    }
+
+    RETINA_INLINE auto GetNativeDescriptor(
+      const CDevice& device,
+      EDescriptorType type,
+      const SImageDescriptor& descriptor,
+      usize size,
+      uint8* data
+    ) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      const auto imageInfo = VkDescriptorImageInfo {
+        .sampler = descriptor.Sampler,
+        .imageView = descriptor.View,
+        .imageLayout = AsEnumCounterpart(descriptor.Layout),
+      };
+      auto descriptorGetInfo = VkDescriptorGetInfoEXT(VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT);
+      descriptorGetInfo.type = AsEnumCounterpart(type);
+      switch (type) {
+        case EDescriptorType::E_SAMPLER:
+          descriptorGetInfo.data.pSampler = &descriptor.Sampler;
+          break;
+        case EDescriptorType::E_SAMPLED_IMAGE:
+          descriptorGetInfo.data.pSampledImage = &imageInfo;
+          break;
+        case EDescriptorType::E_STORAGE_IMAGE:
+          descriptorGetInfo.data.pStorageImage = &imageInfo;
+          break;
+        default:
+          RETINA_GRAPHICS_PANIC_WITH("Unsupported descriptor type");
+      }
+      vkGetDescriptorEXT(device.GetHandle(), &descriptorGetInfo, size, data);
+    }
+
+    RETINA_INLINE auto GetNativeDescriptor(
+      const CDevice& device,
+      EDescriptorType type,
+      const SBufferDescriptor& descriptor,
+      usize size,
+      uint8* data
+    ) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      RETINA_ASSERT_WITH(type == EDescriptorType::E_STORAGE_BUFFER, "Unsupported descriptor type");
+      RETINA_ASSERT_WITH(descriptor.Size != WHOLE_SIZE, "Descriptor buffers need an explicit buffer range");
+      auto addressInfo = VkDescriptorAddressInfoEXT(VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT);
+      addressInfo.address = descriptor.Address + descriptor.Offset;
+      addressInfo.range = descriptor.Size;
+
+      auto descriptorGetInfo = VkDescriptorGetInfoEXT(VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT);
+      descriptorGetInfo.type = AsEnumCounterpart(type);
+      descriptorGetInfo.data.pStorageBuffer = &addressInfo;
+      vkGetDescriptorEXT(device.GetHandle(), &descriptorGetInfo, size, data);
+    }
+  }
+
   CShaderResourceTable::CShaderResourceTable(const CDevice& device) noexcept
-    : _device(device),
-      _samplerStorage({}),
-      _bufferStorage({}),
-      _imageStorage({}),
-      _imageViewStorage({})
+    : _device(device)
   {
     RETINA_PROFILE_SCOPED();
   }
@@ -24,49 +110,57 @@ namespace Retina::Graphics {
   auto CShaderResourceTable::Make(const CDevice& device) noexcept -> Core::CUniquePtr<CShaderResourceTable> {
     RETINA_PROFILE_SCOPED();
     auto self = Core::MakeUnique<CShaderResourceTable>(device);
-    const auto descriptorPoolSizes = std::vector<SDescriptorPoolSize> {
-      { EDescriptorType::E_SAMPLER, MAX_SAMPLER_RESOURCE_SLOTS },
-      { EDescriptorType::E_SAMPLED_IMAGE, MAX_IMAGE_RESOURCE_SLOTS },
-      { EDescriptorType::E_STORAGE_IMAGE, MAX_IMAGE_RESOURCE_SLOTS },
-      { EDescriptorType::E_STORAGE_BUFFER, 1 },
-    };
+    const auto hasDescriptorBuffer = device.IsFeatureEnabled(&SDeviceFeature::DescriptorBuffer);
+    // A descriptor buffer layout still needs a pool to be made from, no set is ever allocated from it
+    const auto descriptorPoolSizes = hasDescriptorBuffer
+      ? std::vector<SDescriptorPoolSize> {
+        { EDescriptorType::E_STORAGE_BUFFER, 1 },
+      }
+      : std::vector<SDescriptorPoolSize> {
+        { EDescriptorType::E_SAMPLER, MAX_SAMPLER_RESOURCE_SLOTS },
+        { EDescriptorType::E_SAMPLED_IMAGE, MAX_IMAGE_RESOURCE_SLOTS },
+        { EDescriptorType::E_STORAGE_IMAGE, MAX_IMAGE_RESOURCE_SLOTS },
+        { EDescriptorType::E_STORAGE_BUFFER, 1 },
+      };
     auto descriptorPool = CDescriptorPool::Make(device, SDescriptorPoolCreateInfo {
       .Name = "ShaderResourceTable_DescriptorPool",
-      .Flags = EDescriptorPoolCreateFlag::E_UPDATE_AFTER_BIND,
+      .Flags = hasDescriptorBuffer
+        ? EDescriptorPoolCreateFlag()
+        : EDescriptorPoolCreateFlag::E_UPDATE_AFTER_BIND,
       .MaxSets = 1,
       .PoolSizes = descriptorPoolSizes,
     });
 
+    // Descriptor buffer memory is never in use by the driver, updates while pending need no opt-in. The set is
+    // bound while recording and only written by the flush at submission, which is an update after bind
+    const auto bindingFlags = hasDescriptorBuffer
+      ? EDescriptorBindingFlag::E_PARTIALLY_BOUND
+      : EDescriptorBindingFlag::E_UPDATE_AFTER_BIND |
+        EDescriptorBindingFlag::E_UPDATE_UNUSED_WHILE_PENDING |
+        EDescriptorBindingFlag::E_PARTIALLY_BOUND;
+
     auto descriptorLayoutBindings = std::vector<SDescriptorLayoutBinding> {
       {
         .Count = MAX_SAMPLER_RESOURCE_SLOTS,
-        .Flags =
-          EDescriptorBindingFlag::E_UPDATE_UNUSED_WHILE_PENDING |
-          EDescriptorBindingFlag::E_PARTIALLY_BOUND,
+        .Flags = bindingFlags,
         .Stages = EShaderStageFlag::E_ALL,
         .Type = EDescriptorType::E_SAMPLER,
       },
       {
         .Count = MAX_IMAGE_RESOURCE_SLOTS,
-        .Flags =
-          EDescriptorBindingFlag::E_UPDATE_UNUSED_WHILE_PENDING |
-          EDescriptorBindingFlag::E_PARTIALLY_BOUND,
+        .Flags = bindingFlags,
         .Stages = EShaderStageFlag::E_ALL,
         .Type = EDescriptorType::E_SAMPLED_IMAGE,
       },
       {
         .Count = MAX_IMAGE_RESOURCE_SLOTS,
-        .Flags =
-          EDescriptorBindingFlag::E_UPDATE_UNUSED_WHILE_PENDING |
-          EDescriptorBindingFlag::E_PARTIALLY_BOUND,
+        .Flags = bindingFlags,
         .Stages = EShaderStageFlag::E_ALL,
         .Type = EDescriptorType::E_STORAGE_IMAGE,
       },
       {
         .Count = 1,
-        .Flags =
-          EDescriptorBindingFlag::E_UPDATE_UNUSED_WHILE_PENDING |
-          EDescriptorBindingFlag::E_PARTIALLY_BOUND,
+        .Flags = bindingFlags,
         .Stages = EShaderStageFlag::E_ALL,
         .Type = EDescriptorType::E_STORAGE_BUFFER,
       },
@@ -74,38 +168,72 @@ namespace Retina::Graphics {
 
     auto descriptorLayout = CDescriptorLayout::Make(*descriptorPool, SDescriptorLayoutCreateInfo {
       .Name = "ShaderResourceTable_DescriptorLayout",
+      .Flags = hasDescriptorBuffer
+        ? EDescriptorLayoutCreateFlag::E_DESCRIPTOR_BUFFER_EXT
+        : EDescriptorLayoutCreateFlag::E_UPDATE_AFTER_BIND_POOL,
       .Bindings = descriptorLayoutBindings,
     });
 
-    auto descriptorSet = CDescriptorSet::Make(*descriptorLayout, {
-      .Name = "ShaderResourceTable_DescriptorSet",
-    });
+    if (hasDescriptorBuffer) {
+      const auto descriptorBufferProperties = Details::GetDescriptorBufferProperties(device);
+      auto descriptorLayoutSize = VkDeviceSize();
+      vkGetDescriptorSetLayoutSizeEXT(device.GetHandle(), descriptorLayout->GetHandle(), &descriptorLayoutSize);
+
+      self->_descriptorBufferBindings.reserve(descriptorLayoutBindings.size());
+      for (auto i = 0_u32; i < descriptorLayoutBindings.size(); ++i) {
+        auto offset = VkDeviceSize();
+        vkGetDescriptorSetLayoutBindingOffsetEXT(device.GetHandle(), descriptorLayout->GetHandle(), i, &offset);
+        self->_descriptorBufferBindings.push_back({
+          .Offset = offset,
+          .Stride = Details::GetDescriptorSize(descriptorBufferProperties, descriptorLayoutBindings[i].Type),
+        });
+      }
+
+      self->_descriptorBuffer = CBuffer::Make(device, {
+        .Name = "ShaderResourceTable_DescriptorBuffer",
+        .Heap = EHeapType::E_DEVICE_MAPPABLE,
+        .Capacity = descriptorLayoutSize,
+        .Usage =
+          EBufferUsageFlag::E_SAMPLER_DESCRIPTOR_BUFFER_EXT |
+          EBufferUsageFlag::E_RESOURCE_DESCRIPTOR_BUFFER_EXT,
+        .IsCrossDomain = true,
+      });
+    } else {
+      self->_descriptorSet = CDescriptorSet::Make(*descriptorLayout, {
+        .Name = "ShaderResourceTable_DescriptorSet",
+      });
+    }
+    self->_descriptorLayout = std::move(descriptorLayout);
 
     auto addressBuffer = CTypedBuffer<uint64>::Make(device, {
       .Name = "ShaderResourceTable_AddressBuffer",
       .Heap = EHeapType::E_DEVICE_MAPPABLE,
       .Capacity = MAX_BUFFER_RESOURCE_SLOTS,
+      .IsCrossDomain = true,
     });
 
-    descriptorSet->Write(std::to_array({
+    self->Write(std::to_array({
       SDescriptorWriteInfo {
         .Slot = 0,
         .Type = EDescriptorType::E_STORAGE_BUFFER,
         .Descriptors = std::vector {
-          addressBuffer->GetDescriptor(),
+          addressBuffer->GetDescriptor(0, MAX_BUFFER_RESOURCE_SLOTS),
         }
       }
     }));
 
+    self->Flush();
+
     RETINA_GRAPHICS_INFO("Main shader resource table initialized");
+    RETINA_GRAPHICS_INFO(" - Descriptor buffer: {}", hasDescriptorBuffer);
 
-    self->_descriptorSet = std::move(descriptorSet);
     self->_addressBuffer = std::move(addressBuffer);
     return self;
   }
 
   auto CShaderResourceTable::GetDescriptorSet() const noexcept -> const CDescriptorSet& {
     RETINA_PROFILE_SCOPED();
+    RETINA_ASSERT_WITH(_descriptorSet, "Shader resource table is backed by a descriptor buffer");
     return *_descriptorSet;
   }
 
@@ -116,17 +244,32 @@ namespace Retina::Graphics {
 
   auto CShaderResourceTable::GetDescriptorLayout() const noexcept -> const CDescriptorLayout& {
     RETINA_PROFILE_SCOPED();
-    return _descriptorSet->GetLayout();
+    return *_descriptorLayout;
+  }
+
+  auto CShaderResourceTable::HasDescriptorBuffer() const noexcept -> bool {
+    RETINA_PROFILE_SCOPED();
+    return _descriptorBuffer;
+  }
+
+  auto CShaderResourceTable::GetDescriptorBuffer() const noexcept -> const CBuffer& {
+    RETINA_PROFILE_SCOPED();
+    RETINA_ASSERT_WITH(_descriptorBuffer, "Shader resource table is backed by a descriptor set");
+    return *_descriptorBuffer;
   }
 
   auto CShaderResourceTable::MakeSampler(const SSamplerCreateInfo& createInfo) noexcept -> CShaderResource<CSampler> {
     RETINA_PROFILE_SCOPED();
     auto sampler = CSampler::Make(_device, createInfo);
     const auto descriptor = sampler->GetDescriptor();
-    const auto slot = _samplerSlots.Allocate();
-    _samplerStorage[slot] = sampler;
+    auto slot = -1_u64;
+    {
+      const auto lock = std::lock_guard(_slotMutex);
+      slot = _samplerSlots.Allocate();
+      _samplerStorage[slot] = sampler;
+    }
 
-    _descriptorSet->Write(
+    Write(
       std::to_array<SDescriptorWriteInfo>({
         {
           .Slot = static_cast<uint32>(slot),
@@ -144,11 +287,22 @@ namespace Retina::Graphics {
     EImageLayout layout
   ) noexcept -> CShaderResource<CImage> {
     RETINA_PROFILE_SCOPED();
-    auto image = CImage::Make(_device, createInfo);
+    return RegisterImage(CImage::Make(_device, createInfo), layout);
+  }
+
+  auto CShaderResourceTable::RegisterImage(
+    Core::CArcPtr<CImage> image,
+    EImageLayout layout
+  ) noexcept -> CShaderResource<CImage> {
+    RETINA_PROFILE_SCOPED();
     const auto descriptor = image->GetDescriptor(layout);
     const auto usage = image->GetUsage();
-    const auto slot = _imageSlots.Allocate();
-    _imageStorage[slot] = image;
+    auto slot = -1_u64;
+    {
+      const auto lock = std::lock_guard(_slotMutex);
+      slot = _imageSlots.Allocate();
+      _imageStorage[slot] = image;
+    }
 
     auto descriptorWriteInfos = std::vector<SDescriptorWriteInfo>();
     descriptorWriteInfos.reserve(2);
@@ -166,7 +320,7 @@ namespace Retina::Graphics {
       info.Descriptors = std::vector { descriptor };
       descriptorWriteInfos.emplace_back(info);
     }
-    _descriptorSet->Write(descriptorWriteInfos);
+    Write(descriptorWriteInfos);
 
     return CShaderResource<CImage>::Make(*image, slot);
   }
@@ -180,8 +334,12 @@ namespace Retina::Graphics {
     auto imageView = CImageView::Make(image, createInfo);
     const auto descriptor = imageView->GetDescriptor(layout);
     const auto usage = imageView->GetImage().GetUsage();
-    const auto slot = _imageSlots.Allocate();
-    _imageViewStorage[slot] = imageView;
+    auto slot = -1_u64;
+    {
+      const auto lock = std::lock_guard(_slotMutex);
+      slot = _imageSlots.Allocate();
+      _imageViewStorage[slot] = imageView;
+    }
 
     auto descriptorWriteInfos = std::vector<SDescriptorWriteInfo>();
     descriptorWriteInfos.reserve(2);
@@ -199,62 +357,186 @@ namespace Retina::Graphics {
       info.Descriptors = std::vector { descriptor };
       descriptorWriteInfos.emplace_back(info);
     }
-    _descriptorSet->Write(descriptorWriteInfos);
+    Write(descriptorWriteInfos);
 
     return CShaderResource<CImageView>::Make(*imageView, slot);
   }
 
   auto CShaderResourceTable::IsAllocated(CShaderResource<CSampler> handle) const noexcept -> bool {
     RETINA_PROFILE_SCOPED();
-    return handle.IsValid() && _samplerStorage[handle.GetHandle()];
+    if (!handle.IsValid()) {
+      return false;
+    }
+    const auto lock = std::lock_guard(_slotMutex);
+    return _samplerStorage[handle.GetHandle()];
   }
 
   auto CShaderResourceTable::IsAllocated(CShaderResource<CImage> handle) const noexcept -> bool {
     RETINA_PROFILE_SCOPED();
-    return handle.IsValid() && _imageStorage[handle.GetHandle()];
+    if (!handle.IsValid()) {
+      return false;
+    }
+    const auto lock = std::lock_guard(_slotMutex);
+    return _imageStorage[handle.GetHandle()];
   }
 
   auto CShaderResourceTable::IsAllocated(CShaderResource<CImageView> handle) const noexcept -> bool {
     RETINA_PROFILE_SCOPED();
-    return handle.IsValid() && _imageViewStorage[handle.GetHandle()];
+    if (!handle.IsValid()) {
+      return false;
+    }
+    const auto lock = std::lock_guard(_slotMutex);
+    return _imageViewStorage[handle.GetHandle()];
   }
 
   auto CShaderResourceTable::GetSamplerResourceFromHandle(uint32 handle) const noexcept -> CShaderResource<CSampler> {
     RETINA_PROFILE_SCOPED();
+    const auto lock = std::lock_guard(_slotMutex);
     return CShaderResource<CSampler>::Make(*_samplerStorage[handle], handle);
   }
 
   auto CShaderResourceTable::GetImageResourceFromHandle(uint32 handle) const noexcept -> CShaderResource<CImage> {
     RETINA_PROFILE_SCOPED();
+    const auto lock = std::lock_guard(_slotMutex);
     return CShaderResource<CImage>::Make(*_imageStorage[handle], handle);
   }
 
   auto CShaderResourceTable::GetImageViewResourceFromHandle(uint32 handle) const noexcept -> CShaderResource<CImageView> {
     RETINA_PROFILE_SCOPED();
+    const auto lock = std::lock_guard(_slotMutex);
     return CShaderResource<CImageView>::Make(*_imageViewStorage[handle], handle);
   }
 
   auto CShaderResourceTable::Destroy(CShaderResource<CSampler> handle) noexcept -> void {
     RETINA_PROFILE_SCOPED();
-    if (handle.IsValid()) {
-      _samplerSlots.Free(handle.GetHandle());
-      _samplerStorage[handle.GetHandle()] = {};
+    if (!handle.IsValid()) {
+      return;
     }
+    _device->GetDeletionQueue().Enqueue([this, slot = handle.GetHandle()] noexcept {
+      // Moved out, so the resource is released after the lock is
+      auto sampler = Core::CArcPtr<CSampler>();
+      {
+        const auto lock = std::lock_guard(_slotMutex);
+        _samplerSlots.Free(slot);
+        sampler = std::move(_samplerStorage[slot]);
+      }
+    });
   }
 
   auto CShaderResourceTable::Destroy(CShaderResource<CImage> handle) noexcept -> void {
     RETINA_PROFILE_SCOPED();
-    if (handle.IsValid()) {
-      _imageSlots.Free(handle.GetHandle());
-      _imageStorage[handle.GetHandle()] = {};
+    if (!handle.IsValid()) {
+      return;
     }
+    _device->GetDeletionQueue().Enqueue([this, slot = handle.GetHandle()] noexcept {
+      auto image = Core::CArcPtr<CImage>();
+      {
+        const auto lock = std::lock_guard(_slotMutex);
+        _imageSlots.Free(slot);
+        image = std::move(_imageStorage[slot]);
+      }
+    });
   }
 
   auto CShaderResourceTable::Destroy(CShaderResource<CImageView> handle) noexcept -> void {
     RETINA_PROFILE_SCOPED();
-    if (handle.IsValid()) {
-      _imageSlots.Free(handle.GetHandle());
-      _imageViewStorage[handle.GetHandle()] = {};
+    if (!handle.IsValid()) {
+      return;
+    }
+    _device->GetDeletionQueue().Enqueue([this, slot = handle.GetHandle()] noexcept {
+      auto imageView = Core::CArcPtr<CImageView>();
+      {
+        const auto lock = std::lock_guard(_slotMutex);
+        _imageSlots.Free(slot);
+        imageView = std::move(_imageViewStorage[slot]);
+      }
+    });
+  }
+
+  auto CShaderResourceTable::DestroyBuffer(uint32 slot) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    _device->GetDeletionQueue().Enqueue([this, slot] noexcept {
+      auto buffer = Core::CArcPtr<CBuffer>();
+      {
+        const auto lock = std::lock_guard(_slotMutex);
+        _bufferSlots.Free(slot);
+        buffer = std::move(_bufferStorage[slot]);
+      }
+    });
+  }
+
+  auto CShaderResourceTable::Write(std::span<const SDescriptorWriteInfo> writes) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (!_descriptorBuffer) {
+      const auto lock = std::lock_guard(_pendingWriteMutex);
+      for (const auto& write : writes) {
+        RETINA_ASSERT_WITH(write.Binding == -1_u32, "Shader resource table bindings are resolved from the descriptor type");
+        std::visit([&](const auto& descriptors) noexcept {
+          for (auto i = 0_u32; i < descriptors.size(); ++i) {
+            _pendingWrites.push_back({
+              .Type = write.Type,
+              .Slot = write.Slot + i,
+              .Descriptor = descriptors[i],
+            });
+          }
+        }, write.Descriptors);
+      }
+      return;
+    }
+    for (const auto& write : writes) {
+      const auto binding = write.Binding == -1_u32
+        ? *_descriptorLayout->FindBindingIndexFrom(write.Type)
+        : write.Binding;
+      const auto& [offset, stride] = _descriptorBufferBindings[binding];
+      auto* data = _descriptorBuffer->GetData() + offset + write.Slot * stride;
+      std::visit([&](const auto& descriptors) noexcept {
+        for (const auto& descriptor : descriptors) {
+          Details::GetNativeDescriptor(*_device, write.Type, descriptor, stride, data);
+          data += stride;
+        }
+      }, write.Descriptors);
+    }
+  }
+
+  auto CShaderResourceTable::Flush() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    // Held for the whole update, the descriptor set must not be written from two threads at once
+    const auto lock = std::lock_guard(_pendingWriteMutex);
+    if (_pendingWrites.empty()) {
+      return;
+    }
+    // Stable, so the last write to a slot stays last and wins over the ones before it
+    std::ranges::stable_sort(_pendingWrites, {}, [](const SPendingDescriptorWrite& write) noexcept {
+      return std::make_pair(write.Type, write.Slot);
+    });
+
+    auto writes = std::vector<SDescriptorWriteInfo>();
+    for (auto i = 0_usize; i < _pendingWrites.size(); ++i) {
+      const auto& pendingWrite = _pendingWrites[i];
+      if (i + 1 < _pendingWrites.size()) {
+        const auto& nextWrite = _pendingWrites[i + 1];
+        if (nextWrite.Type == pendingWrite.Type && nextWrite.Slot == pendingWrite.Slot) {
+          continue;
+        }
+      }
+      // Consecutive slots of the same type become one write covering the whole range
+      std::visit([&]<typename T>(const T& descriptor) noexcept {
+        if (!writes.empty()) {
+          auto& lastWrite = writes.back();
+          auto* descriptors = std::get_if<std::vector<T>>(&lastWrite.Descriptors);
+          if (lastWrite.Type == pendingWrite.Type && descriptors && lastWrite.Slot + descriptors->size() == pendingWrite.Slot) {
+            descriptors->emplace_back(descriptor);
+            return;
+          }
+        }
+        writes.push_back({
+          .Slot = pendingWrite.Slot,
+          .Type = pendingWrite.Type,
+          .Descriptors = std::vector { descriptor },
+        });
+      }, pendingWrite.Descriptor);
     }
+    _pendingWrites.clear();
+    _descriptorSet->Write(writes);
   }
 }
@@ -0,0 +1,279 @@
+#include <Retina/Graphics/Buffer.hpp>
+#include <Retina/Graphics/DeletionQueue.hpp>
+#include <Retina/Graphics/Device.hpp>
+#include <Retina/Graphics/Image.hpp>
+#include <Retina/Graphics/Logger.hpp>
+#include <Retina/Graphics/Macros.hpp>
+#include <Retina/Graphics/TransientResourcePool.hpp>
+
+#include <volk.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace Retina::Graphics {
+  namespace Details {
+    struct STransientPlacement {
+      VkMemoryRequirements Requirements = {};
+      uint32 FirstUse = 0;
+      uint32 LastUse = 0;
+      bool IsImage = false;
+      uint32 Index = 0;
+      uint32 Block = 0;
+      uint64 Offset = 0;
+    };
+
+    struct STransientBlock {
+      bool IsImage = false;
+      uint32 MemoryTypeBits = 0;
+      uint64 Alignment = 1;
+      uint64 Size = 0;
+      std::vector<uint32> Placements;
+    };
+
+    RETINA_NODISCARD RETINA_INLINE constexpr auto AlignUp(uint64 value, uint64 alignment) noexcept -> uint64 {
+      return (value + alignment - 1) / alignment * alignment;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto IsLifetimeOverlapping(
+      const STransientPlacement& left,
+      const STransientPlacement& right
+    ) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      return left.FirstUse <= right.LastUse && right.FirstUse <= left.LastUse;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto HasLazilyAllocatedMemory(const CDevice& device) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      const VkPhysicalDeviceMemoryProperties* properties = nullptr;
+      vmaGetMemoryProperties(device.GetAllocator(), &properties);
+      for (auto i = 0_u32; i < properties->memoryTypeCount; ++i) {
+        if (properties->memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto IsAttachmentOnly(EImageUsageFlag usage) noexcept -> bool {
+      RETINA_PROFILE_SCOPED();
+      constexpr auto attachmentUsage =
+        EImageUsageFlag::E_COLOR_ATTACHMENT |
+        EImageUsageFlag::E_DEPTH_STENCIL_ATTACHMENT |
+        EImageUsageFlag::E_INPUT_ATTACHMENT |
+        EImageUsageFlag::E_TRANSIENT_ATTACHMENT;
+      return (usage & ~attachmentUsage) == EImageUsageFlag();
+    }
+
+    // Lowest offset in "block" where "placement" does not overlap any placement alive at the same time
+    RETINA_NODISCARD RETINA_INLINE auto FindPlacementOffset(
+      std::span<const STransientPlacement> placements,
+      const STransientBlock& block,
+      const STransientPlacement& placement
+    ) noexcept -> uint64 {
+      RETINA_PROFILE_SCOPED();
+      auto occupied = std::vector<const STransientPlacement*>();
+      for (const auto index : block.Placements) {
+        if (IsLifetimeOverlapping(placements[index], placement)) {
+          occupied.emplace_back(&placements[index]);
+        }
+      }
+      std::ranges::sort(occupied, {}, [](const STransientPlacement* current) noexcept {
+        return current->Offset;
+      });
+
+      auto offset = 0_u64;
+      for (const auto* current : occupied) {
+        const auto candidate = AlignUp(offset, placement.Requirements.alignment);
+        if (candidate + placement.Requirements.size <= current->Offset) {
+          break;
+        }
+        offset = std::max(offset, current->Offset + current->Requirements.size);
+      }
+      return AlignUp(offset, placement.Requirements.alignment);
+    }
+  }
+
+  CTransientResourcePool::CTransientResourcePool(const CDevice& device) noexcept
+    : _device(device)
+  {
+    RETINA_PROFILE_SCOPED();
+  }
+
+  CTransientResourcePool::~CTransientResourcePool() noexcept {
+    RETINA_PROFILE_SCOPED();
+    Release();
+  }
+
+  auto CTransientResourcePool::Make(const CDevice& device) noexcept -> Core::CUniquePtr<CTransientResourcePool> {
+    RETINA_PROFILE_SCOPED();
+    return Core::MakeUnique<CTransientResourcePool>(device);
+  }
+
+  auto CTransientResourcePool::GetImages() const noexcept -> std::span<const Core::CArcPtr<CImage>> {
+    RETINA_PROFILE_SCOPED();
+    return _images;
+  }
+
+  auto CTransientResourcePool::GetBuffers() const noexcept -> std::span<const Core::CArcPtr<CBuffer>> {
+    RETINA_PROFILE_SCOPED();
+    return _buffers;
+  }
+
+  auto CTransientResourcePool::GetStatistics() const noexcept -> const STransientResourcePoolStatistics& {
+    RETINA_PROFILE_SCOPED();
+    return _statistics;
+  }
+
+  auto CTransientResourcePool::GetDevice() const noexcept -> const CDevice& {
+    RETINA_PROFILE_SCOPED();
+    return *_device;
+  }
+
+  auto CTransientResourcePool::Allocate(
+    std::span<const STransientImageInfo> images,
+    std::span<const STransientBufferInfo> buffers
+  ) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    Release();
+    _images.resize(images.size());
+    _buffers.resize(buffers.size());
+    _statistics = {};
+
+    const auto hasLazyMemory = Details::HasLazilyAllocatedMemory(*_device);
+    auto placements = std::vector<Details::STransientPlacement>();
+    placements.reserve(images.size() + buffers.size());
+    for (auto i = 0_u32; i < images.size(); ++i) {
+      const auto& image = images[i];
+      RETINA_ASSERT_WITH(image.FirstUse <= image.LastUse, "Transient image is last used before it is first used");
+      // Lazily allocated memory is only committed while the attachment is rendered to, there is nothing to alias
+      if (hasLazyMemory && Details::IsAttachmentOnly(image.CreateInfo.Usage)) {
+        auto createInfo = image.CreateInfo;
+        createInfo.Usage |= EImageUsageFlag::E_TRANSIENT_ATTACHMENT;
+        _images[i] = CImage::Make(*_device, createInfo);
+        _statistics.LazyImageCount++;
+        continue;
+      }
+      placements.push_back({
+        .Requirements = CImage::QueryMemoryRequirements(*_device, image.CreateInfo),
+        .FirstUse = image.FirstUse,
+        .LastUse = image.LastUse,
+        .IsImage = true,
+        .Index = i,
+      });
+    }
+    for (auto i = 0_u32; i < buffers.size(); ++i) {
+      const auto& buffer = buffers[i];
+      RETINA_ASSERT_WITH(buffer.FirstUse <= buffer.LastUse, "Transient buffer is last used before it is first used");
+      placements.push_back({
+        .Requirements = CBuffer::QueryMemoryRequirements(*_device, buffer.CreateInfo),
+        .FirstUse = buffer.FirstUse,
+        .LastUse = buffer.LastUse,
+        .IsImage = false,
+        .Index = i,
+      });
+    }
+
+    // Largest first, so small resources fill the holes left between the large ones. Images and buffers
+    // never share a block, which keeps linear and optimal resources clear of "bufferImageGranularity"
+    auto order = std::vector<uint32>(placements.size());
+    for (auto i = 0_u32; i < order.size(); ++i) {
+      order[i] = i;
+    }
+    std::ranges::stable_sort(order, std::greater(), [&](uint32 index) noexcept {
+      return placements[index].Requirements.size;
+    });
+    auto blocks = std::vector<Details::STransientBlock>();
+    for (const auto index : order) {
+      auto& placement = placements[index];
+      auto blockIndex = -1_u32;
+      for (auto i = 0_u32; i < blocks.size(); ++i) {
+        if (blocks[i].IsImage == placement.IsImage && (blocks[i].MemoryTypeBits & placement.Requirements.memoryTypeBits)) {
+          blockIndex = i;
+          break;
+        }
+      }
+      if (blockIndex == -1_u32) {
+        blockIndex = static_cast<uint32>(blocks.size());
+        blocks.push_back({
+          .IsImage = placement.IsImage,
+          .MemoryTypeBits = placement.Requirements.memoryTypeBits,
+        });
+      }
+      auto& block = blocks[blockIndex];
+      placement.Block = blockIndex;
+      placement.Offset = Details::FindPlacementOffset(placements, block, placement);
+      block.MemoryTypeBits &= placement.Requirements.memoryTypeBits;
+      block.Alignment = std::max(block.Alignment, placement.Requirements.alignment);
+      block.Size = std::max(block.Size, placement.Offset + placement.Requirements.size);
+      block.Placements.emplace_back(index);
+      _statistics.RequestedBytes += placement.Requirements.size;
+    }
+
+    _blocks.reserve(blocks.size());
+    for (const auto& block : blocks) {
+      const auto memoryRequirements = VkMemoryRequirements {
+        .size = block.Size,
+        .alignment = block.Alignment,
+        .memoryTypeBits = block.MemoryTypeBits,
+      };
+      auto allocationCreateInfo = VmaAllocationCreateInfo();
+      allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+      allocationCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+      allocationCreateInfo.priority = 1.0f;
+
+      auto allocation = VmaAllocation();
+      RETINA_GRAPHICS_VULKAN_CHECK(
+        vmaAllocateMemory(
+          _device->GetAllocator(),
+          &memoryRequirements,
+          &allocationCreateInfo,
+          &allocation,
+          nullptr
+        )
+      );
+      _blocks.emplace_back(allocation);
+      _statistics.AllocatedBytes += block.Size;
+    }
+
+    for (const auto& placement : placements) {
+      const auto allocation = _blocks[placement.Block];
+      if (placement.IsImage) {
+        _images[placement.Index] = CImage::MakeAliased(*_device, images[placement.Index].CreateInfo, allocation, placement.Offset);
+      } else {
+        _buffers[placement.Index] = CBuffer::MakeAliased(*_device, buffers[placement.Index].CreateInfo, allocation, placement.Offset);
+      }
+    }
+    _statistics.BlockCount = static_cast<uint32>(_blocks.size());
+    _statistics.AliasedResourceCount = static_cast<uint32>(placements.size());
+
+    RETINA_GRAPHICS_INFO("Transient resources allocated");
+    RETINA_GRAPHICS_INFO(" - Blocks: {}", _statistics.BlockCount);
+    RETINA_GRAPHICS_INFO(" - Lazily allocated images: {}", _statistics.LazyImageCount);
+    RETINA_GRAPHICS_INFO(" - Requested bytes: {}", _statistics.RequestedBytes);
+    RETINA_GRAPHICS_INFO(" - Allocated bytes: {}", _statistics.AllocatedBytes);
+  }
+
+  auto CTransientResourcePool::Release() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (_blocks.empty() && _images.empty() && _buffers.empty()) {
+      return;
+    }
+    // Frames in flight may still use the resources, the memory goes away once the device caught up
+    _device->GetDeletionQueue().Enqueue([
+      allocator = _device->GetAllocator(),
+      blocks = std::move(_blocks),
+      images = std::move(_images),
+      buffers = std::move(_buffers)
+    ] mutable noexcept {
+      images.clear();
+      buffers.clear();
+      for (const auto block : blocks) {
+        vmaFreeMemory(allocator, block);
+      }
+    });
+    _blocks.clear();
+    _images.clear();
+    _buffers.clear();
+  }
+}
@@ -0,0 +1,69 @@
+#include <Retina/Sandbox/Bounds.hpp>
+
+namespace Retina::Sandbox {
+  auto IsAabbValid(const SAabb& aabb) noexcept -> bool {
+    RETINA_PROFILE_SCOPED();
+    return glm::all(glm::lessThanEqual(aabb.Min, aabb.Max));
+  }
+
+  auto MakeAabbUnion(const SAabb& left, const SAabb& right) noexcept -> SAabb {
+    RETINA_PROFILE_SCOPED();
+    return {
+      glm::min(left.Min, right.Min),
+      glm::max(left.Max, right.Max),
+    };
+  }
+
+  auto GetAabbCenter(const SAabb& aabb) noexcept -> glm::vec3 {
+    RETINA_PROFILE_SCOPED();
+    return (aabb.Min + aabb.Max) * 0.5f;
+  }
+
+  auto GetAabbSurfaceArea(const SAabb& aabb) noexcept -> float32 {
+    RETINA_PROFILE_SCOPED();
+    if (!IsAabbValid(aabb)) {
+      return 0.0f;
+    }
+    const auto extent = aabb.Max - aabb.Min;
+    return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+  }
+
+  auto TransformAabb(const SAabb& aabb, const glm::mat4& transform) noexcept -> SAabb {
+    RETINA_PROFILE_SCOPED();
+    if (!IsAabbValid(aabb)) {
+      return aabb;
+    }
+    // Projects the extent onto every axis instead of transforming all eight corners
+    const auto center = glm::vec3(transform * glm::vec4(GetAabbCenter(aabb), 1.0f));
+    const auto extent = (aabb.Max - aabb.Min) * 0.5f;
+    const auto absolute = glm::mat3(
+      glm::abs(glm::vec3(transform[0])),
+      glm::abs(glm::vec3(transform[1])),
+      glm::abs(glm::vec3(transform[2]))
+    );
+    const auto worldExtent = absolute * extent;
+    return {
+      center - worldExtent,
+      center + worldExtent,
+    };
+  }
+
+  auto MakeFrustum(const glm::mat4& projView) noexcept -> SFrustum {
+    RETINA_PROFILE_SCOPED();
+    const auto transposed = glm::transpose(projView);
+    auto frustum = SFrustum();
+    frustum.Planes[0] = transposed[3] + transposed[0];
+    frustum.Planes[1] = transposed[3] - transposed[0];
+    frustum.Planes[2] = transposed[3] + transposed[1];
+    frustum.Planes[3] = transposed[3] - transposed[1];
+    frustum.Planes[4] = transposed[2];
+    frustum.Planes[5] = transposed[3] - transposed[2];
+    for (auto& plane : frustum.Planes) {
+      const auto length = glm::length(glm::vec3(plane));
+      if (length > 0.0f) {
+        plane /= length;
+      }
+    }
+    return frustum;
+  }
+}
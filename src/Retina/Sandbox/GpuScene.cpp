@@ -0,0 +1,510 @@
+#include <Retina/Sandbox/GpuScene.hpp>
+
+#include <algorithm>
+#include <array>
+#include <execution>
+#include <functional>
+
+namespace Retina::Sandbox {
+  namespace Details {
+    // Calls "function" with every run of consecutive indices in a sorted, unique list
+    template <typename F>
+    RETINA_INLINE auto ForEachConsecutiveRun(std::span<const uint32> indices, F&& function) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      auto begin = 0_u32;
+      for (auto i = 1_u32; i <= indices.size(); ++i) {
+        if (i == indices.size() || indices[i] != indices[i - 1] + 1) {
+          function(indices[begin], i - begin);
+          begin = i;
+        }
+      }
+    }
+
+    RETINA_INLINE auto SortUnique(std::vector<uint32>& values) noexcept -> void {
+      RETINA_PROFILE_SCOPED();
+      std::sort(values.begin(), values.end());
+      values.erase(std::unique(values.begin(), values.end()), values.end());
+    }
+
+    template <typename T>
+    RETINA_NODISCARD RETINA_INLINE auto AllocateSlot(std::vector<std::optional<T>>& slots, std::vector<uint32>& freeSlots) noexcept -> uint32 {
+      RETINA_PROFILE_SCOPED();
+      if (freeSlots.empty()) {
+        slots.emplace_back();
+        return static_cast<uint32>(slots.size() - 1);
+      }
+      const auto slot = freeSlots.back();
+      freeSlots.pop_back();
+      return slot;
+    }
+  }
+
+  CGpuScene::CGpuScene(const Graphics::CDevice& device) noexcept
+    : _device(device)
+  {
+    RETINA_PROFILE_SCOPED();
+  }
+
+  auto CGpuScene::Make(
+    const Graphics::CDevice& device,
+    const SGpuSceneCreateInfo& createInfo
+  ) noexcept -> Core::CUniquePtr<CGpuScene> {
+    RETINA_PROFILE_SCOPED();
+    auto self = Core::MakeUnique<CGpuScene>(device);
+    const auto framesInFlight = createInfo.FramesInFlight;
+    // Written on the graphics queue, read by the material passes on the async compute queue
+    self->_meshletBuffer = CGpuSceneBuffer<SMeshlet>::Make(device, { .Name = "SceneMeshletBuffer", .IsCrossDomain = true }, framesInFlight);
+    self->_meshletInstanceBuffer = CGpuSceneBuffer<SMeshletInstance>::Make(device, { .Name = "SceneMeshletInstanceBuffer", .IsCrossDomain = true }, framesInFlight);
+    self->_materialBuffer = CGpuSceneBuffer<SMaterial>::Make(device, { .Name = "SceneMaterialBuffer", .IsCrossDomain = true }, framesInFlight);
+    self->_transformBuffer = CGpuSceneBuffer<STransformRecord>::Make(device, { .Name = "SceneTransformBuffer", .IsCrossDomain = true }, framesInFlight);
+    self->_positionBuffer = CGpuSceneBuffer<glm::vec3>::Make(device, { .Name = "ScenePositionBuffer", .IsCrossDomain = true }, framesInFlight);
+    self->_vertexBuffer = CGpuSceneBuffer<SMeshletVertex>::Make(device, { .Name = "SceneVertexBuffer", .IsCrossDomain = true }, framesInFlight);
+    self->_indexBuffer = CGpuSceneBuffer<uint32>::Make(device, { .Name = "SceneIndexBuffer", .IsCrossDomain = true }, framesInFlight);
+    self->_primitiveBuffer = CGpuSceneBuffer<uint8>::Make(device, { .Name = "ScenePrimitiveBuffer", .IsCrossDomain = true }, framesInFlight);
+    self->_createInfo = createInfo;
+    return self;
+  }
+
+  auto CGpuScene::GetMeshletBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<SMeshlet>>& {
+    RETINA_PROFILE_SCOPED();
+    return _meshletBuffer.GetResource();
+  }
+
+  auto CGpuScene::GetMeshletInstanceBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<SMeshletInstance>>& {
+    RETINA_PROFILE_SCOPED();
+    return _meshletInstanceBuffer.GetResource();
+  }
+
+  auto CGpuScene::GetMaterialBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<SMaterial>>& {
+    RETINA_PROFILE_SCOPED();
+    return _materialBuffer.GetResource();
+  }
+
+  auto CGpuScene::GetTransformBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<STransformRecord>>& {
+    RETINA_PROFILE_SCOPED();
+    return _transformBuffer.GetResource();
+  }
+
+  auto CGpuScene::GetPositionBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<glm::vec3>>& {
+    RETINA_PROFILE_SCOPED();
+    return _positionBuffer.GetResource();
+  }
+
+  auto CGpuScene::GetVertexBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<SMeshletVertex>>& {
+    RETINA_PROFILE_SCOPED();
+    return _vertexBuffer.GetResource();
+  }
+
+  auto CGpuScene::GetIndexBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<uint32>>& {
+    RETINA_PROFILE_SCOPED();
+    return _indexBuffer.GetResource();
+  }
+
+  auto CGpuScene::GetPrimitiveBuffer() const noexcept -> const Graphics::CShaderResource<Graphics::CTypedBuffer<uint8>>& {
+    RETINA_PROFILE_SCOPED();
+    return _primitiveBuffer.GetResource();
+  }
+
+  auto CGpuScene::GetMeshletInstanceCount() const noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    return static_cast<uint32>(_meshletInstanceOwners.size());
+  }
+
+  auto CGpuScene::GetMeshletInstancePrimitiveCount() const noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    return _meshletInstancePrimitiveCount;
+  }
+
+  auto CGpuScene::GetTransformSystem() noexcept -> CTransformSystem& {
+    RETINA_PROFILE_SCOPED();
+    return _transformSystem;
+  }
+
+  auto CGpuScene::GetTransformSystem() const noexcept -> const CTransformSystem& {
+    RETINA_PROFILE_SCOPED();
+    return _transformSystem;
+  }
+
+  auto CGpuScene::GetInstanceRootNode(uint32 instance) const noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    return _instances[instance]->RootNode;
+  }
+
+  auto CGpuScene::GetBvh() const noexcept -> const CSceneBvh& {
+    RETINA_PROFILE_SCOPED();
+    return _bvh;
+  }
+
+  auto CGpuScene::AddModel(const CMeshletModel& model, std::span<const SMaterial> materials) noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    const auto meshlets = model.GetMeshlets();
+    const auto meshletInstances = model.GetMeshletInstances();
+    const auto positions = model.GetPositions();
+    const auto indices = model.GetIndices();
+    const auto primitives = model.GetPrimitives();
+
+    auto sceneModel = SModel();
+    sceneModel.Meshlets = AllocateRange(_meshletAllocator, static_cast<uint32>(meshlets.size()));
+    sceneModel.Vertices = AllocateRange(_vertexAllocator, static_cast<uint32>(positions.size()));
+    sceneModel.Indices = AllocateRange(_indexAllocator, static_cast<uint32>(indices.size()));
+    sceneModel.Primitives = AllocateRange(_primitiveAllocator, static_cast<uint32>(primitives.size()));
+    sceneModel.Materials = AllocateRange(_materialAllocator, static_cast<uint32>(materials.size()));
+    sceneModel.LocalMeshlets.assign(meshlets.begin(), meshlets.end());
+    sceneModel.LocalMeshletInstances.assign(meshletInstances.begin(), meshletInstances.end());
+    const auto nodes = model.GetNodes();
+    sceneModel.Nodes.assign(nodes.begin(), nodes.end());
+    const auto meshBounds = model.GetMeshBounds();
+    sceneModel.MeshBounds.assign(meshBounds.begin(), meshBounds.end());
+    for (const auto& meshletInstance : meshletInstances) {
+      sceneModel.PrimitiveCount += meshlets[meshletInstance.MeshletIndex].PrimitiveCount;
+    }
+
+    _meshletBuffer.Reserve(_meshletAllocator.GetCapacity());
+    _positionBuffer.Reserve(_vertexAllocator.GetCapacity());
+    _vertexBuffer.Reserve(_vertexAllocator.GetCapacity());
+    _indexBuffer.Reserve(_indexAllocator.GetCapacity());
+    _primitiveBuffer.Reserve(_primitiveAllocator.GetCapacity());
+    _materialBuffer.Reserve(_materialAllocator.GetCapacity());
+
+    _positionBuffer.Write(sceneModel.Vertices.Offset, positions);
+    _vertexBuffer.Write(sceneModel.Vertices.Offset, model.GetVertices());
+    _indexBuffer.Write(sceneModel.Indices.Offset, indices);
+    _primitiveBuffer.Write(sceneModel.Primitives.Offset, primitives);
+    _materialBuffer.Write(sceneModel.Materials.Offset, materials);
+
+    const auto modelIndex = Details::AllocateSlot(_models, _freeModels);
+    _models[modelIndex] = std::move(sceneModel);
+    _dirtyModels.emplace_back(modelIndex);
+    return modelIndex;
+  }
+
+  auto CGpuScene::RemoveModel(uint32 model) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    while (!_models[model]->Instances.empty()) {
+      RemoveInstance(_models[model]->Instances.back());
+    }
+    const auto& sceneModel = *_models[model];
+    _meshletAllocator.Free(sceneModel.Meshlets.Offset, sceneModel.Meshlets.Size);
+    _vertexAllocator.Free(sceneModel.Vertices.Offset, sceneModel.Vertices.Size);
+    _indexAllocator.Free(sceneModel.Indices.Offset, sceneModel.Indices.Size);
+    _primitiveAllocator.Free(sceneModel.Primitives.Offset, sceneModel.Primitives.Size);
+    _materialAllocator.Free(sceneModel.Materials.Offset, sceneModel.Materials.Size);
+    _positionBuffer.Discard(sceneModel.Vertices.Offset, sceneModel.Vertices.Size);
+    _vertexBuffer.Discard(sceneModel.Vertices.Offset, sceneModel.Vertices.Size);
+    _indexBuffer.Discard(sceneModel.Indices.Offset, sceneModel.Indices.Size);
+    _primitiveBuffer.Discard(sceneModel.Primitives.Offset, sceneModel.Primitives.Size);
+    _materialBuffer.Discard(sceneModel.Materials.Offset, sceneModel.Materials.Size);
+    _models[model].reset();
+    _freeModels.emplace_back(model);
+  }
+
+  auto CGpuScene::AddInstance(uint32 model, const glm::mat4& transform) noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    auto& sceneModel = *_models[model];
+    const auto instanceIndex = Details::AllocateSlot(_instances, _freeInstances);
+
+    // Every instance gets its own root node so the whole instance can be moved with a single transform
+    auto instance = SInstance();
+    instance.Model = model;
+    instance.RootNode = _transformSystem.AddNodes(std::to_array({ SNode { .LocalTransform = transform } }));
+    instance.FirstNode = _transformSystem.AddNodes(sceneModel.Nodes, instance.RootNode);
+    _transformBuffer.Reserve(_transformSystem.GetCapacity());
+
+    _nodeLocalBounds.resize(_transformSystem.GetCapacity());
+    for (auto i = 0_u32; i < sceneModel.Nodes.size(); ++i) {
+      const auto mesh = sceneModel.Nodes[i].Mesh;
+      if (mesh != -1_u32) {
+        _nodeLocalBounds[instance.FirstNode + i] = sceneModel.MeshBounds[mesh];
+      }
+    }
+    _isBvhDirty = true;
+
+    const auto meshletInstanceCount = static_cast<uint32>(sceneModel.LocalMeshletInstances.size());
+    const auto firstSlot = static_cast<uint32>(_meshletInstanceOwners.size());
+    instance.MeshletInstanceSlots.reserve(meshletInstanceCount);
+    for (auto i = 0_u32; i < meshletInstanceCount; ++i) {
+      instance.MeshletInstanceSlots.emplace_back(firstSlot + i);
+      _meshletInstanceOwners.push_back({ instanceIndex, i });
+      _dirtyMeshletInstances.emplace_back(firstSlot + i);
+    }
+    _meshletInstanceBuffer.Reserve(_meshletInstanceOwners.size());
+    _meshletInstancePrimitiveCount += sceneModel.PrimitiveCount;
+
+    sceneModel.Instances.emplace_back(instanceIndex);
+    _instances[instanceIndex] = std::move(instance);
+    return instanceIndex;
+  }
+
+  auto CGpuScene::RemoveInstance(uint32 instance) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    auto sceneInstance = std::move(*_instances[instance]);
+    _instances[instance].reset();
+    _freeInstances.emplace_back(instance);
+
+    // Removing the highest slots first guarantees the last meshlet instance is never one that is still to be removed
+    auto slots = std::move(sceneInstance.MeshletInstanceSlots);
+    std::sort(slots.begin(), slots.end(), std::greater());
+    for (const auto slot : slots) {
+      const auto lastSlot = static_cast<uint32>(_meshletInstanceOwners.size() - 1);
+      if (slot != lastSlot) {
+        const auto owner = _meshletInstanceOwners[lastSlot];
+        _meshletInstanceOwners[slot] = owner;
+        _instances[owner.Instance]->MeshletInstanceSlots[owner.Index] = slot;
+        _dirtyMeshletInstances.emplace_back(slot);
+      }
+      _meshletInstanceOwners.pop_back();
+    }
+
+    auto& sceneModel = *_models[sceneInstance.Model];
+    _meshletInstancePrimitiveCount -= sceneModel.PrimitiveCount;
+    std::erase(sceneModel.Instances, instance);
+    _transformSystem.RemoveNodes(sceneInstance.RootNode, 1);
+    _isBvhDirty = true;
+    if (!sceneModel.Nodes.empty()) {
+      std::fill_n(_nodeLocalBounds.begin() + sceneInstance.FirstNode, sceneModel.Nodes.size(), SAabb());
+      _transformSystem.RemoveNodes(sceneInstance.FirstNode, static_cast<uint32>(sceneModel.Nodes.size()));
+    }
+  }
+
+  auto CGpuScene::Update() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    CompactGeometry();
+    _transformSystem.Update();
+    UpdateBvh();
+    WriteDirtyModels();
+    WriteDirtyMeshletInstances();
+    WriteDirtyTransforms();
+  }
+
+  auto CGpuScene::Flush(Graphics::CCommandBuffer& commands, uint32 frameIndex) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    auto hasPendingWork = false;
+    ForEachBuffer([&](const auto& buffer) noexcept {
+      hasPendingWork |= buffer.HasPendingWork();
+    });
+    if (!hasPendingWork) {
+      ForEachBuffer([&](auto& buffer) noexcept {
+        buffer.FlushGrowth(commands, frameIndex);
+      });
+      return;
+    }
+
+    constexpr static auto transferToTransferBarrier = Graphics::SMemoryBarrier {
+      .SourceStage = Graphics::EPipelineStageFlag::E_TRANSFER,
+      .DestStage = Graphics::EPipelineStageFlag::E_TRANSFER,
+      .SourceAccess = Graphics::EResourceAccessFlag::E_TRANSFER_WRITE,
+      .DestAccess =
+        Graphics::EResourceAccessFlag::E_TRANSFER_READ |
+        Graphics::EResourceAccessFlag::E_TRANSFER_WRITE,
+    };
+    commands.MemoryBarrier({
+      .SourceStage =
+        Graphics::EPipelineStageFlag::E_ALL_GRAPHICS |
+        Graphics::EPipelineStageFlag::E_COMPUTE_SHADER,
+      .DestStage = Graphics::EPipelineStageFlag::E_TRANSFER,
+      .SourceAccess = Graphics::EResourceAccessFlag::E_NONE,
+      .DestAccess =
+        Graphics::EResourceAccessFlag::E_TRANSFER_READ |
+        Graphics::EResourceAccessFlag::E_TRANSFER_WRITE,
+    });
+    ForEachBuffer([&](auto& buffer) noexcept {
+      buffer.FlushGrowth(commands, frameIndex);
+    });
+    commands.MemoryBarrier(transferToTransferBarrier);
+    ForEachBuffer([&](auto& buffer) noexcept {
+      buffer.FlushMoves(commands);
+    });
+    commands.MemoryBarrier(transferToTransferBarrier);
+    ForEachBuffer([&](auto& buffer) noexcept {
+      buffer.FlushWrites(commands, frameIndex);
+    });
+    commands.MemoryBarrier({
+      .SourceStage = Graphics::EPipelineStageFlag::E_TRANSFER,
+      .DestStage =
+        Graphics::EPipelineStageFlag::E_ALL_GRAPHICS |
+        Graphics::EPipelineStageFlag::E_COMPUTE_SHADER,
+      .SourceAccess = Graphics::EResourceAccessFlag::E_TRANSFER_WRITE,
+      .DestAccess = Graphics::EResourceAccessFlag::E_SHADER_STORAGE_READ,
+    });
+  }
+
+  auto CGpuScene::AllocateRange(CRangeAllocator& allocator, uint32 size) noexcept -> SGpuSceneRange {
+    RETINA_PROFILE_SCOPED();
+    if (size == 0) {
+      return {};
+    }
+    auto offset = allocator.Allocate(size);
+    if (!offset) {
+      allocator.Grow(std::max(allocator.GetCapacity() * 2, allocator.GetCapacity() + size));
+      offset = allocator.Allocate(size);
+    }
+    RETINA_ASSERT_WITH(offset, "Failed to allocate scene range");
+    return { *offset, size };
+  }
+
+  auto CGpuScene::MakeMeshlet(const SModel& model, uint32 meshlet) const noexcept -> SMeshlet {
+    RETINA_PROFILE_SCOPED();
+    auto result = model.LocalMeshlets[meshlet];
+    result.VertexOffset += model.Vertices.Offset;
+    result.IndexOffset += model.Indices.Offset;
+    result.PrimitiveOffset += model.Primitives.Offset;
+    return result;
+  }
+
+  auto CGpuScene::MakeMeshletInstance(const SInstance& instance, uint32 meshletInstance) const noexcept -> SMeshletInstance {
+    RETINA_PROFILE_SCOPED();
+    const auto& model = *_models[instance.Model];
+    auto result = model.LocalMeshletInstances[meshletInstance];
+    result.MeshletIndex += model.Meshlets.Offset;
+    result.TransformIndex += instance.FirstNode;
+    if (result.MaterialIndex != -1_u32) {
+      result.MaterialIndex += model.Materials.Offset;
+    }
+    return result;
+  }
+
+  auto CGpuScene::WriteDirtyModels() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    Details::SortUnique(_dirtyModels);
+    auto meshlets = std::vector<SMeshlet>();
+    for (const auto modelIndex : _dirtyModels) {
+      if (!_models[modelIndex]) {
+        continue;
+      }
+      const auto& model = *_models[modelIndex];
+      meshlets.clear();
+      meshlets.reserve(model.LocalMeshlets.size());
+      for (auto i = 0_u32; i < model.LocalMeshlets.size(); ++i) {
+        meshlets.emplace_back(MakeMeshlet(model, i));
+      }
+      _meshletBuffer.Write(model.Meshlets.Offset, std::span<const SMeshlet>(meshlets));
+    }
+    _dirtyModels.clear();
+  }
+
+  auto CGpuScene::WriteDirtyMeshletInstances() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    const auto meshletInstanceCount = GetMeshletInstanceCount();
+    Details::SortUnique(_dirtyMeshletInstances);
+    std::erase_if(_dirtyMeshletInstances, [&](uint32 slot) noexcept {
+      return slot >= meshletInstanceCount;
+    });
+    auto meshletInstances = std::vector<SMeshletInstance>();
+    Details::ForEachConsecutiveRun(_dirtyMeshletInstances, [&](uint32 firstSlot, uint32 count) noexcept {
+      meshletInstances.clear();
+      for (auto slot = firstSlot; slot < firstSlot + count; ++slot) {
+        const auto [instance, index] = _meshletInstanceOwners[slot];
+        meshletInstances.emplace_back(MakeMeshletInstance(*_instances[instance], index));
+      }
+      _meshletInstanceBuffer.Write(firstSlot, std::span<const SMeshletInstance>(meshletInstances));
+    });
+    _dirtyMeshletInstances.clear();
+  }
+
+  auto CGpuScene::WriteDirtyTransforms() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    auto records = std::vector<STransformRecord>();
+    Details::ForEachConsecutiveRun(_transformSystem.GetDirtyRecords(), [&](uint32 firstNode, uint32 count) noexcept {
+      records.clear();
+      for (auto node = firstNode; node < firstNode + count; ++node) {
+        records.emplace_back(_transformSystem.MakeRecord(node));
+      }
+      _transformBuffer.Write(firstNode, std::span<const STransformRecord>(records));
+    });
+  }
+
+  auto CGpuScene::UpdateBvh() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    _nodeWorldBounds.resize(_nodeLocalBounds.size());
+    if (_isBvhDirty) {
+      _bvhItems.clear();
+      for (auto node = 0_u32; node < _nodeLocalBounds.size(); ++node) {
+        if (IsAabbValid(_nodeLocalBounds[node])) {
+          _bvhItems.emplace_back(node);
+        }
+      }
+      std::for_each(std::execution::par, _bvhItems.begin(), _bvhItems.end(), [this](uint32 node) noexcept {
+        _nodeWorldBounds[node] = TransformAabb(_nodeLocalBounds[node], _transformSystem.GetWorldTransform(node));
+      });
+      _bvh = CSceneBvh::Make(_bvhItems, _nodeWorldBounds);
+      _isBvhDirty = false;
+      return;
+    }
+
+    const auto dirtyNodes = _transformSystem.GetDirtyRecords();
+    if (dirtyNodes.empty()) {
+      return;
+    }
+    for (const auto node : dirtyNodes) {
+      if (node < _nodeLocalBounds.size() && IsAabbValid(_nodeLocalBounds[node])) {
+        _nodeWorldBounds[node] = TransformAabb(_nodeLocalBounds[node], _transformSystem.GetWorldTransform(node));
+      }
+    }
+    _bvh.Refit(_nodeWorldBounds, dirtyNodes);
+  }
+
+  auto CGpuScene::CompactGeometry() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    // Holes only exist if there is more than the free tail, relocate a single model per frame to bound the copy cost
+    const auto isFragmented = [](const CRangeAllocator& allocator) noexcept {
+      return allocator.GetFreeBlockCount() > 1;
+    };
+    if (
+      !isFragmented(_meshletAllocator) &&
+      !isFragmented(_vertexAllocator) &&
+      !isFragmented(_indexAllocator) &&
+      !isFragmented(_primitiveAllocator)
+    ) {
+      return;
+    }
+    if (_models.size() == _freeModels.size()) {
+      return;
+    }
+    auto modelIndex = 0_u32;
+    do {
+      modelIndex = _compactionCursor++ % _models.size();
+    } while (!_models[modelIndex]);
+
+    auto& model = *_models[modelIndex];
+    auto isGeometryMoved = false;
+    if (const auto source = RelocateRange(_vertexAllocator, model.Vertices)) {
+      _positionBuffer.Move(*source, model.Vertices.Offset, model.Vertices.Size);
+      _vertexBuffer.Move(*source, model.Vertices.Offset, model.Vertices.Size);
+      isGeometryMoved = true;
+    }
+    if (const auto source = RelocateRange(_indexAllocator, model.Indices)) {
+      _indexBuffer.Move(*source, model.Indices.Offset, model.Indices.Size);
+      isGeometryMoved = true;
+    }
+    if (const auto source = RelocateRange(_primitiveAllocator, model.Primitives)) {
+      _primitiveBuffer.Move(*source, model.Primitives.Offset, model.Primitives.Size);
+      isGeometryMoved = true;
+    }
+    // Meshlets are rewritten from the host copy anyway, so they never need a GPU side move
+    const auto isMeshletMoved = RelocateRange(_meshletAllocator, model.Meshlets).has_value();
+    if (isGeometryMoved || isMeshletMoved) {
+      _dirtyModels.emplace_back(modelIndex);
+    }
+    if (isMeshletMoved) {
+      for (const auto instance : model.Instances) {
+        const auto& slots = _instances[instance]->MeshletInstanceSlots;
+        _dirtyMeshletInstances.insert(_dirtyMeshletInstances.end(), slots.begin(), slots.end());
+      }
+    }
+  }
+
+  auto CGpuScene::RelocateRange(CRangeAllocator& allocator, SGpuSceneRange& range) noexcept -> std::optional<uint32> {
+    RETINA_PROFILE_SCOPED();
+    if (range.Size == 0) {
+      return std::nullopt;
+    }
+    const auto offset = allocator.AllocateBelow(range.Size, range.Offset);
+    if (!offset) {
+      return std::nullopt;
+    }
+    const auto source = range.Offset;
+    allocator.Free(source, range.Size);
+    range.Offset = *offset;
+    return source;
+  }
+}
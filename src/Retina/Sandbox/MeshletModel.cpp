@@ -300,27 +300,45 @@ namespace Retina::Sandbox {
       meshletPrimitiveMapping.emplace_back(currentMeshletOffset, currentMeshletOffset + meshlets.size());
     }
 
+    auto modelMeshBounds = std::vector<SAabb>();
+    {
+      const auto meshes = model.GetMeshes();
+      modelMeshBounds.reserve(meshes.size());
+      for (const auto& mesh : meshes) {
+        auto bounds = SAabb();
+        for (const auto primitiveIndex : mesh.Primitives) {
+          for (const auto& position : modelMeshPrimitives[primitiveIndex].Positions) {
+            bounds.Min = glm::min(bounds.Min, position);
+            bounds.Max = glm::max(bounds.Max, position);
+          }
+        }
+        modelMeshBounds.emplace_back(bounds);
+      }
+    }
+
     auto modelMeshletInstances = std::vector<SMeshletInstance>();
-    auto modelTransforms = std::vector<glm::mat4>();
     {
       const auto meshes = model.GetMeshes();
-      for (const auto& [meshIndex, transform] : model.GetNodes()) {
-        const auto& mesh = meshes[meshIndex];
-        const auto transformIndex = static_cast<uint32>(modelTransforms.size());
-        for (const auto& primitiveIndex : mesh.Primitives) {
+      const auto nodes = model.GetNodes();
+      for (auto nodeIndex = 0_u32; nodeIndex < nodes.size(); ++nodeIndex) {
+        const auto meshIndex = nodes[nodeIndex].Mesh;
+        if (meshIndex == -1_u32) {
+          continue;
+        }
+        // Transforms are owned by the transform system, which keeps one record per model node
+        for (const auto& primitiveIndex : meshes[meshIndex].Primitives) {
           const auto& meshPrimitive = modelMeshPrimitives[primitiveIndex];
           const auto [begin, end] = meshletPrimitiveMapping[primitiveIndex];
           for (auto i = begin; i < end; ++i) {
-            modelMeshletInstances.emplace_back(i, transformIndex, meshPrimitive.MaterialIndex);
+            modelMeshletInstances.emplace_back(i, nodeIndex, meshPrimitive.MaterialIndex);
           }
         }
-        modelTransforms.emplace_back(transform);
       }
     }
 
     self._meshlets = std::move(modelMeshlets);
     self._meshletInstances = std::move(modelMeshletInstances);
-    self._transforms = std::move(modelTransforms);
+    self._meshBounds = std::move(modelMeshBounds);
     self._positions = std::move(modelPositions);
     self._vertices = std::move(modelVertices);
     self._indices = std::move(modelIndices);
@@ -339,9 +357,14 @@ namespace Retina::Sandbox {
     return _meshletInstances;
   }
 
-  auto CMeshletModel::GetTransforms() const noexcept -> std::span<const glm::mat4> {
+  auto CMeshletModel::GetNodes() const noexcept -> std::span<const SNode> {
+    RETINA_PROFILE_SCOPED();
+    return _model.GetNodes();
+  }
+
+  auto CMeshletModel::GetMeshBounds() const noexcept -> std::span<const SAabb> {
     RETINA_PROFILE_SCOPED();
-    return _transforms;
+    return _meshBounds;
   }
 
   auto CMeshletModel::GetPositions() const noexcept -> std::span<const glm::vec3> {
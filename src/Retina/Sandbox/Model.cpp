@@ -262,16 +262,16 @@ namespace Retina::Sandbox {
 
       for (auto i = 0_u32; i < gltf->nodes_count; ++i) {
         const auto& currentNode = gltf->nodes[i];
-        if (!currentNode.mesh) {
-          RETINA_SANDBOX_WARN("Node has no mesh, skipping");
-          continue;
-        }
-        const auto meshIndex = cgltf_mesh_index(gltf, currentNode.mesh);
         auto transform = glm::mat4(1.0f);
-        cgltf_node_transform_world(&currentNode, glm::value_ptr(transform));
+        cgltf_node_transform_local(&currentNode, glm::value_ptr(transform));
         auto node = SNode();
-        node.Mesh = meshIndex;
-        node.Transform = transform;
+        if (currentNode.parent) {
+          node.Parent = cgltf_node_index(gltf, currentNode.parent);
+        }
+        if (currentNode.mesh) {
+          node.Mesh = cgltf_mesh_index(gltf, currentNode.mesh);
+        }
+        node.LocalTransform = transform;
         nodes.emplace_back(node);
       }
 
@@ -0,0 +1,97 @@
+#include <Retina/Sandbox/RangeAllocator.hpp>
+
+#include <iterator>
+
+namespace Retina::Sandbox {
+  auto CRangeAllocator::Make(uint32 capacity) noexcept -> CRangeAllocator {
+    RETINA_PROFILE_SCOPED();
+    auto self = CRangeAllocator();
+    self.Grow(capacity);
+    return self;
+  }
+
+  auto CRangeAllocator::GetCapacity() const noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    return _capacity;
+  }
+
+  auto CRangeAllocator::GetUsedSize() const noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    return _usedSize;
+  }
+
+  auto CRangeAllocator::GetFreeSize() const noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    return _capacity - _usedSize;
+  }
+
+  auto CRangeAllocator::GetFreeBlockCount() const noexcept -> usize {
+    RETINA_PROFILE_SCOPED();
+    return _freeBlocks.size();
+  }
+
+  auto CRangeAllocator::Allocate(uint32 size) noexcept -> std::optional<uint32> {
+    RETINA_PROFILE_SCOPED();
+    return AllocateBelow(size, _capacity);
+  }
+
+  auto CRangeAllocator::AllocateBelow(uint32 size, uint32 limit) noexcept -> std::optional<uint32> {
+    RETINA_PROFILE_SCOPED();
+    if (size == 0) {
+      return std::nullopt;
+    }
+    for (auto block = _freeBlocks.begin(); block != _freeBlocks.end() && block->first + size <= limit; ++block) {
+      if (block->second >= size) {
+        return AllocateFromBlock(block, size);
+      }
+    }
+    return std::nullopt;
+  }
+
+  auto CRangeAllocator::Free(uint32 offset, uint32 size) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (size == 0) {
+      return;
+    }
+    RETINA_ASSERT_WITH(offset + size <= _capacity, "Range is out of bounds");
+    _usedSize -= size;
+    auto [block, _] = _freeBlocks.emplace(offset, size);
+    if (block != _freeBlocks.begin()) {
+      const auto previous = std::prev(block);
+      if (previous->first + previous->second == block->first) {
+        previous->second += block->second;
+        block = _freeBlocks.erase(block);
+        block = std::prev(block);
+      }
+    }
+    const auto next = std::next(block);
+    if (next != _freeBlocks.end() && block->first + block->second == next->first) {
+      block->second += next->second;
+      _freeBlocks.erase(next);
+    }
+  }
+
+  auto CRangeAllocator::Grow(uint32 capacity) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (capacity <= _capacity) {
+      return;
+    }
+    const auto offset = _capacity;
+    const auto size = capacity - _capacity;
+    _capacity = capacity;
+    // The new tail counts as used until it is released, so it can be coalesced like any other block
+    _usedSize += size;
+    Free(offset, size);
+  }
+
+  auto CRangeAllocator::AllocateFromBlock(std::map<uint32, uint32>::iterator block, uint32 size) noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    const auto [offset, blockSize] = *block;
+    _freeBlocks.erase(block);
+    if (blockSize > size) {
+      _freeBlocks.emplace(offset + size, blockSize - size);
+    }
+    _usedSize += size;
+    return offset;
+  }
+}
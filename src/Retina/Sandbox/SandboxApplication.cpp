@@ -13,6 +13,16 @@ namespace Retina {
 
 namespace Retina::Sandbox {
   namespace Details {
+    // Order of the passes touching render targets in "OnRender", transient render target lifetimes are expressed in it
+    constexpr static auto RENDER_TARGET_PASS_VISBUFFER_RASTER = 0_u32;
+    constexpr static auto RENDER_TARGET_PASS_MATERIAL_CLASSIFY = 1_u32;
+    constexpr static auto RENDER_TARGET_PASS_MATERIAL_SHADE = 2_u32;
+    constexpr static auto RENDER_TARGET_PASS_GBUFFER_RESOLVE = 3_u32;
+    constexpr static auto RENDER_TARGET_PASS_DLSS = 4_u32;
+    constexpr static auto RENDER_TARGET_PASS_TONEMAP = 5_u32;
+    constexpr static auto RENDER_TARGET_PASS_IMGUI = 6_u32;
+    constexpr static auto RENDER_TARGET_PASS_SWAPCHAIN_COPY = 7_u32;
+
     RETINA_NODISCARD RETINA_INLINE auto WithShaderPath(const std::filesystem::path& path) noexcept -> std::filesystem::path {
       RETINA_PROFILE_SCOPED();
       return std::filesystem::path(RETINA_SHADER_DIRECTORY) / path;
@@ -23,6 +33,11 @@ namespace Retina::Sandbox {
       return std::filesystem::path(RETINA_ASSET_DIRECTORY) / path;
     }
 
+    RETINA_NODISCARD RETINA_INLINE auto WithCachePath(const std::filesystem::path& path) noexcept -> std::filesystem::path {
+      RETINA_PROFILE_SCOPED();
+      return std::filesystem::path(RETINA_CACHE_DIRECTORY) / path;
+    }
+
     template <typename T>
     RETINA_NODISCARD RETINA_INLINE constexpr auto PreviousPowerTwo(T value) noexcept -> T {
       return 1 << (sizeof(T) * CHAR_BIT - std::countl_zero(value - 1) - 1);
@@ -196,6 +211,8 @@ namespace Retina::Sandbox {
         .Name = "StagingBuffer",
         .Heap = Graphics::EHeapType::E_HOST_ONLY_COHERENT,
         .Capacity = data.size(),
+        .Usage = Graphics::EBufferUsageFlag::E_TRANSFER_SRC,
+        .Domain = Graphics::EQueueDomain::E_TRANSFER,
       });
       buffer->Write(data);
       auto resource = device
@@ -205,8 +222,21 @@ namespace Retina::Sandbox {
           .Heap = Graphics::EHeapType::E_DEVICE_ONLY,
           .Capacity = data.size(),
         });
+      // The copy runs on the transfer queue, the graphics queue owns the buffer from then on
+      const auto ownershipBarrier = Graphics::SBufferMemoryBarrier {
+        .Buffer = *resource,
+        .SourceStage = Graphics::EPipelineStageFlag::E_TRANSFER,
+        .DestStage = Graphics::EPipelineStageFlag::E_ALL_COMMANDS,
+        .SourceAccess = Graphics::EResourceAccessFlag::E_TRANSFER_WRITE,
+        .DestAccess = Graphics::EResourceAccessFlag::E_SHADER_READ,
+      };
       device.GetTransferQueue().Submit([&](Graphics::CCommandBuffer& commands) noexcept {
-        commands.CopyBuffer(*buffer, *resource, {});
+        commands
+          .CopyBuffer(*buffer, *resource, {})
+          .ReleaseOwnership(device.GetGraphicsQueue(), ownershipBarrier);
+      });
+      device.GetGraphicsQueue().Submit([&](Graphics::CCommandBuffer& commands) noexcept {
+        commands.AcquireOwnership(device.GetTransferQueue(), ownershipBarrier);
       });
       return resource;
     }
@@ -236,6 +266,7 @@ namespace Retina::Sandbox {
         .Name = "StagingBuffer",
         .Heap = Graphics::EHeapType::E_HOST_ONLY_CACHED,
         .Capacity = textureHandle->dataSize,
+        .Usage = Graphics::EBufferUsageFlag::E_TRANSFER_SRC,
       });
       staging->Write(std::span(textureHandle->pData, textureHandle->dataSize));
 
@@ -325,10 +356,15 @@ namespace Retina::Sandbox {
       .Name = "MainDevice",
       .Features = {
         .Swapchain = true,
-        .MeshShader = true,
         .MemoryBudget = true,
         .MemoryPriority = true,
       },
+      .OptionalFeatures = {
+        .MeshShader = true,
+        .GraphicsPipelineLibrary = true,
+        .DescriptorBuffer = true,
+      },
+      .PipelineCachePath = Details::WithCachePath("PipelineCache.bin"),
     });
 
     _swapchain = Graphics::CSwapchain::Make(*_device, *_window, {
@@ -337,10 +373,9 @@ namespace Retina::Sandbox {
       .MakeSurface = WSI::MakeSurface,
     });
 
-    _commandBuffers = Graphics::CCommandBuffer::Make(_device->GetGraphicsQueue(), FRAMES_IN_FLIGHT, {
-      .Name = "MainCommandBuffer",
-      .PoolInfo = Graphics::DEFAULT_COMMAND_POOL_CREATE_INFO,
-    });
+    _commandPools = Graphics::CCommandPoolAllocator::Make(_device->GetGraphicsQueue(), FRAMES_IN_FLIGHT);
+    _renderGraph = Graphics::CRenderGraph::Make(*_device, FRAMES_IN_FLIGHT);
+    _transientPool = Graphics::CTransientResourcePool::Make(*_device);
 
     _imageAvailableSemaphores = Graphics::CBinarySemaphore::Make(*_device, FRAMES_IN_FLIGHT, {
       .Name = "ImageAvailableSemaphore",
@@ -351,6 +386,7 @@ namespace Retina::Sandbox {
     });
 
     _frameTimeline = Graphics::CHostDeviceTimeline::Make(*_device, FRAMES_IN_FLIGHT);
+    _pipelineBuilder = Graphics::CPipelineBuilder::Make(*_device);
 
     _dlssInstance = Graphics::CNvidiaDlssFeature::Make(*_device);
 
@@ -369,40 +405,35 @@ namespace Retina::Sandbox {
       .BorderColor = Graphics::EBorderColor::E_INT_OPAQUE_BLACK,
     });
 
-    _model = std::move(
-      CMeshletModel::Make(Details::WithAssetPath("Models/Bistro/Bistro.gltf"))
-        .or_else([](const auto& error) -> std::expected<CMeshletModel, CModel::EError> {
-          RETINA_SANDBOX_ERROR("Failed to load model");
-          return std::unexpected(error);
-        })
-        .value()
-    );
+    const auto model = CMeshletModel::Make(Details::WithAssetPath("Models/Bistro/Bistro.gltf"))
+      .or_else([](const auto& error) -> std::expected<CMeshletModel, CModel::EError> {
+        RETINA_SANDBOX_ERROR("Failed to load model");
+        return std::unexpected(error);
+      })
+      .value();
+    _scene = CGpuScene::Make(*_device, {
+      .FramesInFlight = FRAMES_IN_FLIGHT,
+    });
 
     _viewBuffer = _device->GetShaderResourceTable().MakeBuffer<SViewInfo>(FRAMES_IN_FLIGHT, {
       .Name = "ViewBuffer",
       .Heap = Graphics::EHeapType::E_DEVICE_MAPPABLE,
       .Capacity = 1,
+      .IsCrossDomain = true,
     });
 
     UpdateDLSSResolution();
     InitializeGUI();
+    InitializeRenderTargets();
     InitializeVisbufferPass();
     InitializeVisbufferResolvePass();
     InitializeGBufferPass();
     InitializeTonemapPass();
     InitializeDLSSPass();
 
-    _meshletBuffer = Details::UploadBufferAsResource(*_device, _model.GetMeshlets(), "MeshletBuffer");
-    _meshletInstanceBuffer = Details::UploadBufferAsResource(*_device, _model.GetMeshletInstances(), "MeshletInstanceBuffer");
-    _transformBuffer = Details::UploadBufferAsResource(*_device, _model.GetTransforms(), "TransformBuffer");
-    _positionBuffer = Details::UploadBufferAsResource(*_device, _model.GetPositions(), "PositionBuffer");
-    _vertexBuffer = Details::UploadBufferAsResource(*_device, _model.GetVertices(), "VertexBuffer");
-    _indexBuffer = Details::UploadBufferAsResource(*_device, _model.GetIndices(), "IndexBuffer");
-    _primitiveBuffer = Details::UploadBufferAsResource(*_device, _model.GetPrimitives(), "PrimitiveBuffer");
-
     {
-      const auto modelMaterials = _model.GetMaterials();
-      const auto modelTextures = _model.GetTextures();
+      const auto modelMaterials = model.GetMaterials();
+      const auto modelTextures = model.GetTextures();
 
       auto materials = std::vector<SMaterial>();
       materials.reserve(modelMaterials.size());
@@ -425,8 +456,10 @@ namespace Retina::Sandbox {
         materials.emplace_back(material);
       }
 
-      _materialBuffer = Details::UploadBufferAsResource(*_device, std::span<const SMaterial>(materials), "MaterialBuffer");
+      _scene->AddInstance(_scene->AddModel(model, materials));
     }
+    // Pipelines were compiling in the background while the textures uploaded
+    _pipelineBuilder->Wait();
 
     _window->GetEventDispatcher().Attach(this, &CSandboxApplication::OnWindowResize);
     _window->GetEventDispatcher().Attach(this, &CSandboxApplication::OnWindowClose);
@@ -461,11 +494,13 @@ namespace Retina::Sandbox {
 
     UpdateDLSSResolution();
 
+    InitializeRenderTargets();
     InitializeVisbufferPass();
     InitializeVisbufferResolvePass();
     InitializeGBufferPass();
     InitializeTonemapPass();
     InitializeDLSSPass();
+    _pipelineBuilder->Wait();
 
     OnUpdate();
     OnRender();
@@ -497,11 +532,13 @@ namespace Retina::Sandbox {
     if (_dlss.ShouldResize) {
       _device->WaitIdle();
       UpdateDLSSResolution();
+      InitializeRenderTargets();
       InitializeVisbufferPass();
       InitializeVisbufferResolvePass();
       InitializeGBufferPass();
       InitializeTonemapPass();
       InitializeDLSSPass();
+      _pipelineBuilder->Wait();
     }
 
     auto& viewBuffer = _viewBuffer[frameIndex];
@@ -541,6 +578,10 @@ namespace Retina::Sandbox {
       viewBuffer->Write(mainView);
       _camera->Update(_timer.GetDeltaTime());
     }
+
+    _scene->Update();
+    _visibleNodeRanges.clear();
+    _scene->GetBvh().QueryFrustum(MakeFrustum(mainView.ProjView), _visibleNodeRanges);
   }
 
   auto CSandboxApplication::OnRender() noexcept -> void {
@@ -554,497 +595,553 @@ namespace Retina::Sandbox {
 
     const auto& viewBuffer = _viewBuffer[frameIndex];
 
-    auto& commandBuffer = *_commandBuffers[frameIndex];
-    commandBuffer.GetCommandPool().Reset();
-    commandBuffer
-      .Begin()
-      .Barrier({
-        .ImageMemoryBarriers = {
-          {
-            .Image = *_visbuffer.MainImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_NONE,
-            .DestStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_NONE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .OldLayout = Graphics::EImageLayout::E_UNDEFINED,
-            .NewLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
+    _commandPools->BeginFrame(frameIndex);
+    auto& commandBuffer = _commandPools->Allocate();
+    commandBuffer.Begin();
+
+    _scene->Flush(commandBuffer, frameIndex);
+
+    const auto hasMeshShader = _device->IsFeatureEnabled(&Graphics::SDeviceFeature::MeshShader);
+    const auto meshletInstanceCount = _scene->GetMeshletInstanceCount();
+    if (!hasMeshShader) {
+      // Scratch buffers follow the scene, growth copies the old contents. Grown ahead of the graph, so passes recorded
+      // concurrently never see the buffers swapped. The copy waits on the previous frame, the graph orders what follows it
+      _visbuffer.DrawCommandBuffer.Reserve(meshletInstanceCount);
+      _visbuffer.ExpandedIndexBuffer.Reserve(_scene->GetMeshletInstancePrimitiveCount() * 3);
+      commandBuffer.MemoryBarrier({
+        .SourceStage =
+          Graphics::EPipelineStageFlag::E_DRAW_INDIRECT |
+          Graphics::EPipelineStageFlag::E_INDEX_INPUT |
+          Graphics::EPipelineStageFlag::E_COMPUTE_SHADER,
+        .DestStage = Graphics::EPipelineStageFlag::E_TRANSFER,
+        .SourceAccess = Graphics::EResourceAccessFlag::E_SHADER_STORAGE_WRITE,
+        .DestAccess = Graphics::EResourceAccessFlag::E_TRANSFER_READ,
+      });
+      // Retired buffers of older frames are released here even when nothing grows
+      _visbuffer.DrawCommandBuffer.FlushGrowth(commandBuffer, frameIndex);
+      _visbuffer.ExpandedIndexBuffer.FlushGrowth(commandBuffer, frameIndex);
+    }
+    // Changed by the settings window, which is recorded alongside the passes that read them
+    const auto tonemapWhitePoint = _tonemap.WhitePoint;
+    const auto isTonemapPassthrough = _tonemap.IsPassthrough;
+
+    auto& renderGraph = *_renderGraph;
+    const auto visbufferMainImage = renderGraph.ImportImage(*_visbuffer.MainImage);
+    const auto visbufferVelocityImage = renderGraph.ImportImage(*_visbuffer.VelocityImage);
+    const auto visbufferDepthImage = renderGraph.ImportImage(*_visbuffer.DepthImage);
+    const auto albedoImage = renderGraph.ImportImage(*_visbufferResolve.AlbedoImage);
+    const auto normalImage = renderGraph.ImportImage(*_visbufferResolve.NormalImage);
+    const auto shaderMaterialIdImage = renderGraph.ImportImage(*_visbufferResolve.ShaderMaterialIdImage);
+    const auto gbufferMainImage = renderGraph.ImportImage(*_gbufferPass.MainImage);
+    const auto dlssMainImage = renderGraph.ImportImage(*_dlss.MainImage);
+    const auto tonemapMainImage = renderGraph.ImportImage(*_tonemap.MainImage);
+    const auto swapchainImage = renderGraph.ImportImage(_swapchain->GetCurrentImage(), {
+      .FinalAccess = Graphics::ERenderGraphAccess::E_PRESENT,
+    });
+    // The previous frame consumed the tile buffers last, the graph has to wait on it before they are reset
+    const auto tileDispatchBuffer = renderGraph.ImportBuffer(*_visbufferResolve.TileDispatchBuffer, {
+      .InitialAccess = Graphics::ERenderGraphAccess::E_INDIRECT_COMMAND_READ,
+    });
+    const auto tileBuffer = renderGraph.ImportBuffer(*_visbufferResolve.TileBuffer, {
+      .InitialAccess = Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_READ,
+    });
+
+    auto visbufferRasterBuffers = std::vector<Graphics::SRenderGraphBufferUsage>();
+    if (!hasMeshShader) {
+      const auto drawCommandBuffer = renderGraph.ImportBuffer(*_visbuffer.DrawCommandBuffer.GetResource(), {
+        .InitialAccess = Graphics::ERenderGraphAccess::E_TRANSFER_WRITE,
+      });
+      const auto drawCountBuffer = renderGraph.ImportBuffer(*_visbuffer.DrawCountBuffer, {
+        .InitialAccess = Graphics::ERenderGraphAccess::E_INDIRECT_COMMAND_READ,
+      });
+      const auto expandedIndexBuffer = renderGraph.ImportBuffer(*_visbuffer.ExpandedIndexBuffer.GetResource(), {
+        .InitialAccess = Graphics::ERenderGraphAccess::E_TRANSFER_WRITE,
+      });
+      renderGraph
+        .AddPass({
+          .Name = "VisbufferDrawCountClear",
+          .Buffers = {
+            { drawCountBuffer, Graphics::ERenderGraphAccess::E_TRANSFER_WRITE },
           },
-          {
-            .Image = *_visbuffer.VelocityImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_NONE,
-            .DestStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_NONE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .OldLayout = Graphics::EImageLayout::E_UNDEFINED,
-            .NewLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
+          .Execute = [&](Graphics::CCommandBuffer& commands) noexcept {
+            commands.ClearBuffer(*_visbuffer.DrawCountBuffer);
           },
-          {
-            .Image = *_visbuffer.DepthImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_NONE,
-            .DestStage = Graphics::EPipelineStageFlag::E_EARLY_FRAGMENT_TESTS,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_NONE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_DEPTH_STENCIL_ATTACHMENT_WRITE,
-            .OldLayout = Graphics::EImageLayout::E_UNDEFINED,
-            .NewLayout = Graphics::EImageLayout::E_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-          }
-        }
-      })
-      .BeginRendering({
-        .Name = "VisbufferMainRaster",
-        .ColorAttachments = {
-          {
-            .ImageView = _visbuffer.MainImage->GetView(),
-            .LoadOperator = Graphics::EAttachmentLoadOperator::E_CLEAR,
-            .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
-            .ClearValue = Graphics::MakeColorClearValue(-1_u32),
+        })
+        .AddPass({
+          .Name = "MeshletExpand",
+          .Buffers = {
+            { drawCommandBuffer, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_WRITE },
+            { drawCountBuffer, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_READ_WRITE },
+            { expandedIndexBuffer, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_WRITE },
           },
-          {
-            .ImageView = _visbuffer.VelocityImage->GetView(),
-            .LoadOperator = Graphics::EAttachmentLoadOperator::E_CLEAR,
-            .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
-            .ClearValue = Graphics::MakeColorClearValue(0.0f),
+          .Execute = [&](Graphics::CCommandBuffer& commands) noexcept {
+            commands
+              .BindPipeline(*_visbuffer.ExpandPipeline)
+              .BindShaderResourceTable(_device->GetShaderResourceTable())
+              .PushConstants(
+                _scene->GetMeshletBuffer().GetHandle(),
+                _scene->GetMeshletInstanceBuffer().GetHandle(),
+                _scene->GetTransformBuffer().GetHandle(),
+                _scene->GetPositionBuffer().GetHandle(),
+                _scene->GetIndexBuffer().GetHandle(),
+                _scene->GetPrimitiveBuffer().GetHandle(),
+                viewBuffer.GetHandle(),
+                _visbuffer.DrawCommandBuffer.GetHandle(),
+                _visbuffer.DrawCountBuffer.GetHandle(),
+                _visbuffer.ExpandedIndexBuffer.GetHandle(),
+                meshletInstanceCount
+              )
+              .Dispatch(meshletInstanceCount);
           },
+        });
+      visbufferRasterBuffers = {
+        { drawCommandBuffer, Graphics::ERenderGraphAccess::E_INDIRECT_COMMAND_READ },
+        { drawCountBuffer, Graphics::ERenderGraphAccess::E_INDIRECT_COMMAND_READ },
+        { expandedIndexBuffer, Graphics::ERenderGraphAccess::E_INDEX_READ },
+      };
+    }
+
+    renderGraph
+      .AddPass({
+        .Name = "VisbufferMainRaster",
+        .Images = {
+          { visbufferMainImage, Graphics::ERenderGraphAccess::E_COLOR_ATTACHMENT_WRITE },
+          { visbufferVelocityImage, Graphics::ERenderGraphAccess::E_COLOR_ATTACHMENT_WRITE },
+          { visbufferDepthImage, Graphics::ERenderGraphAccess::E_DEPTH_STENCIL_ATTACHMENT_WRITE },
+        },
+        .Buffers = std::move(visbufferRasterBuffers),
+        .Execute = [&](Graphics::CCommandBuffer& commands) noexcept {
+          commands
+            .BeginRendering({
+              .Name = "VisbufferMainRaster",
+              .ColorAttachments = {
+                {
+                  .ImageView = _visbuffer.MainImage->GetView(),
+                  .LoadOperator = Graphics::EAttachmentLoadOperator::E_CLEAR,
+                  .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
+                  .ClearValue = Graphics::MakeColorClearValue(-1_u32),
+                },
+                {
+                  .ImageView = _visbuffer.VelocityImage->GetView(),
+                  .LoadOperator = Graphics::EAttachmentLoadOperator::E_CLEAR,
+                  .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
+                  .ClearValue = Graphics::MakeColorClearValue(0.0f),
+                },
+              },
+              .DepthAttachment = { {
+                .ImageView = _visbuffer.DepthImage->GetView(),
+                .LoadOperator = Graphics::EAttachmentLoadOperator::E_CLEAR,
+                .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
+                .ClearValue = Graphics::MakeDepthStencilClearValue(0.0f, 0),
+              } },
+            })
+            .SetViewport()
+            .SetScissor();
+          if (hasMeshShader) {
+            commands.BindPipeline(*_visbuffer.MainPipeline);
+          } else {
+            commands
+              .BindPipeline(*_visbuffer.FallbackPipeline)
+              .BindIndexBuffer(*_visbuffer.ExpandedIndexBuffer.GetResource());
+          }
+          commands
+            .BindShaderResourceTable(_device->GetShaderResourceTable())
+            .PushConstants(
+              _scene->GetMeshletBuffer().GetHandle(),
+              _scene->GetMeshletInstanceBuffer().GetHandle(),
+              _scene->GetTransformBuffer().GetHandle(),
+              _scene->GetPositionBuffer().GetHandle(),
+              _scene->GetIndexBuffer().GetHandle(),
+              _scene->GetPrimitiveBuffer().GetHandle(),
+              viewBuffer.GetHandle()
+            );
+          if (hasMeshShader) {
+            commands.DrawMeshTasks(meshletInstanceCount);
+          } else {
+            commands.DrawIndexedIndirectCount(
+              *_visbuffer.DrawCommandBuffer.GetResource(),
+              0,
+              *_visbuffer.DrawCountBuffer,
+              0,
+              meshletInstanceCount
+            );
+          }
+          commands.EndRendering();
         },
-        .DepthAttachment = { {
-          .ImageView = _visbuffer.DepthImage->GetView(),
-          .LoadOperator = Graphics::EAttachmentLoadOperator::E_CLEAR,
-          .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
-          .ClearValue = Graphics::MakeDepthStencilClearValue(0.0f, 0),
-        } },
       })
-      .SetViewport()
-      .SetScissor()
-      .BindPipeline(*_visbuffer.MainPipeline)
-      .BindShaderResourceTable(_device->GetShaderResourceTable())
-      .PushConstants(
-        _meshletBuffer.GetHandle(),
-        _meshletInstanceBuffer.GetHandle(),
-        _transformBuffer.GetHandle(),
-        _positionBuffer.GetHandle(),
-        _indexBuffer.GetHandle(),
-        _primitiveBuffer.GetHandle(),
-        viewBuffer.GetHandle()
-      )
-      .DrawMeshTasks(_meshletInstanceBuffer->GetSize())
-      .EndRendering()
-      .Barrier({
-        .ImageMemoryBarriers = {
-          {
-            .Image = *_visbuffer.MainImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .DestStage = Graphics::EPipelineStageFlag::E_FRAGMENT_SHADER,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_SHADER_SAMPLED_READ,
-            .OldLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-            .NewLayout = Graphics::EImageLayout::E_SHADER_READ_ONLY_OPTIMAL,
-          },
-          {
-            .Image = *_visbuffer.VelocityImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .DestStage = Graphics::EPipelineStageFlag::E_FRAGMENT_SHADER,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_SHADER_SAMPLED_READ,
-            .OldLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-            .NewLayout = Graphics::EImageLayout::E_SHADER_READ_ONLY_OPTIMAL,
-          },
-          {
-            .Image = *_visbuffer.DepthImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_LATE_FRAGMENT_TESTS,
-            .DestStage = Graphics::EPipelineStageFlag::E_FRAGMENT_SHADER,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_DEPTH_STENCIL_ATTACHMENT_WRITE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_SHADER_SAMPLED_READ,
-            .OldLayout = Graphics::EImageLayout::E_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-            .NewLayout = Graphics::EImageLayout::E_SHADER_READ_ONLY_OPTIMAL,
-          },
-          {
-            .Image = *_visbufferResolve.AlbedoImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_NONE,
-            .DestStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_NONE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .OldLayout = Graphics::EImageLayout::E_UNDEFINED,
-            .NewLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-          },
-          {
-            .Image = *_visbufferResolve.NormalImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_NONE,
-            .DestStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_NONE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .OldLayout = Graphics::EImageLayout::E_UNDEFINED,
-            .NewLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-          },
-          {
-            .Image = *_visbufferResolve.ShaderMaterialIdImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_NONE,
-            .DestStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_NONE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .OldLayout = Graphics::EImageLayout::E_UNDEFINED,
-            .NewLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-          },
+      .AddPass({
+        .Name = "MaterialTileReset",
+        .Buffers = {
+          { tileDispatchBuffer, Graphics::ERenderGraphAccess::E_TRANSFER_WRITE },
+        },
+        .Queue = Graphics::EQueueDomain::E_COMPUTE,
+        .Execute = [&](Graphics::CCommandBuffer& commands) noexcept {
+          commands.CopyBuffer(*_visbufferResolve.TileDispatchResetBuffer, *_visbufferResolve.TileDispatchBuffer, {});
         },
       })
-      .BeginRendering({
-        .Name = "VisbufferResolve",
-        .ColorAttachments = {
-          {
-            .ImageView = _visbufferResolve.AlbedoImage->GetView(),
-            .LoadOperator = Graphics::EAttachmentLoadOperator::E_DONT_CARE,
-            .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
-          },
-          {
-            .ImageView = _visbufferResolve.NormalImage->GetView(),
-            .LoadOperator = Graphics::EAttachmentLoadOperator::E_DONT_CARE,
-            .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
-          },
-          {
-            .ImageView = _visbufferResolve.ShaderMaterialIdImage->GetView(),
-            .LoadOperator = Graphics::EAttachmentLoadOperator::E_DONT_CARE,
-            .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
-          },
+      .AddPass({
+        .Name = "MaterialClassify",
+        .Images = {
+          { visbufferMainImage, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_SAMPLED_READ },
+          { albedoImage, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_WRITE },
+          { normalImage, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_WRITE },
+          { shaderMaterialIdImage, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_WRITE },
+        },
+        .Buffers = {
+          { tileDispatchBuffer, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_READ_WRITE },
+          { tileBuffer, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_WRITE },
+        },
+        .Queue = Graphics::EQueueDomain::E_COMPUTE,
+        .Execute = [&](Graphics::CCommandBuffer& commands) noexcept {
+          commands
+            .BindPipeline(*_visbufferResolve.ClassifyPipeline)
+            .BindShaderResourceTable(_device->GetShaderResourceTable())
+            .PushConstants(
+              _visbuffer.MainImage.GetHandle(),
+              _scene->GetMeshletInstanceBuffer().GetHandle(),
+              _scene->GetMaterialBuffer().GetHandle(),
+              _visbufferResolve.AlbedoImage.GetHandle(),
+              _visbufferResolve.NormalImage.GetHandle(),
+              _visbufferResolve.ShaderMaterialIdImage.GetHandle(),
+              _visbufferResolve.TileDispatchBuffer.GetHandle(),
+              _visbufferResolve.TileBuffer.GetHandle(),
+              _visbufferResolve.TileCapacity
+            )
+            .Dispatch(
+              Details::DivideRoundUp<uint32>(_visbuffer.MainImage->GetWidth(), MATERIAL_TILE_SIZE),
+              Details::DivideRoundUp<uint32>(_visbuffer.MainImage->GetHeight(), MATERIAL_TILE_SIZE)
+            );
         },
       })
-      .SetViewport()
-      .SetScissor()
-      .BindPipeline(*_visbufferResolve.MainPipeline)
-      .BindShaderResourceTable(_device->GetShaderResourceTable())
-      .PushConstants(
-        _visbuffer.MainImage.GetHandle(),
-        _meshletBuffer.GetHandle(),
-        _meshletInstanceBuffer.GetHandle(),
-        _transformBuffer.GetHandle(),
-        _vertexBuffer.GetHandle(),
-        _positionBuffer.GetHandle(),
-        _indexBuffer.GetHandle(),
-        _primitiveBuffer.GetHandle(),
-        _materialBuffer.GetHandle(),
-        _linearSampler.GetHandle(),
-        viewBuffer.GetHandle()
-      )
-      .Draw(3)
-      .EndRendering()
-      .Barrier({
-        .ImageMemoryBarriers = {
-          {
-            .Image = *_visbufferResolve.AlbedoImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .DestStage = Graphics::EPipelineStageFlag::E_FRAGMENT_SHADER,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_SHADER_SAMPLED_READ,
-            .OldLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-            .NewLayout = Graphics::EImageLayout::E_SHADER_READ_ONLY_OPTIMAL,
-          },
-          {
-            .Image = *_visbufferResolve.NormalImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .DestStage = Graphics::EPipelineStageFlag::E_FRAGMENT_SHADER,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_SHADER_SAMPLED_READ,
-            .OldLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-            .NewLayout = Graphics::EImageLayout::E_SHADER_READ_ONLY_OPTIMAL,
-          },
-          {
-            .Image = *_visbufferResolve.ShaderMaterialIdImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .DestStage = Graphics::EPipelineStageFlag::E_FRAGMENT_SHADER,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_SHADER_SAMPLED_READ,
-            .OldLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-            .NewLayout = Graphics::EImageLayout::E_SHADER_READ_ONLY_OPTIMAL,
-          },
-          {
-            .Image = *_tonemap.MainImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_NONE,
-            .DestStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_NONE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .OldLayout = Graphics::EImageLayout::E_UNDEFINED,
-            .NewLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-          },
-          {
-            .Image = *_dlss.MainImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_NONE,
-            .DestStage =
-              Graphics::EPipelineStageFlag::E_TRANSFER |
-              Graphics::EPipelineStageFlag::E_COMPUTE_SHADER,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_NONE,
-            .DestAccess =
-              Graphics::EResourceAccessFlag::E_SHADER_READ |
-              Graphics::EResourceAccessFlag::E_SHADER_WRITE |
-              Graphics::EResourceAccessFlag::E_TRANSFER_WRITE,
-            .OldLayout = Graphics::EImageLayout::E_UNDEFINED,
-            .NewLayout = Graphics::EImageLayout::E_GENERAL,
-          },
-          {
-            .Image = *_gbufferPass.MainImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_NONE,
-            .DestStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_NONE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .OldLayout = Graphics::EImageLayout::E_UNDEFINED,
-            .NewLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
+      .AddPass({
+        .Name = "MaterialShade",
+        .Images = {
+          { visbufferMainImage, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_SAMPLED_READ },
+          { albedoImage, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_READ_WRITE },
+          { normalImage, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_READ_WRITE },
+          { shaderMaterialIdImage, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_READ },
+        },
+        .Buffers = {
+          { tileDispatchBuffer, Graphics::ERenderGraphAccess::E_INDIRECT_COMMAND_READ },
+          { tileBuffer, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_STORAGE_READ },
+        },
+        .Queue = Graphics::EQueueDomain::E_COMPUTE,
+        .Execute = [&](Graphics::CCommandBuffer& commands) noexcept {
+          for (auto shaderId = 0_u32; shaderId < MATERIAL_SHADER_COUNT; ++shaderId) {
+            commands
+              .BindPipeline(*_visbufferResolve.ShadePipelines[shaderId])
+              .BindShaderResourceTable(_device->GetShaderResourceTable())
+              .PushConstants(
+                _visbuffer.MainImage.GetHandle(),
+                _scene->GetMeshletBuffer().GetHandle(),
+                _scene->GetMeshletInstanceBuffer().GetHandle(),
+                _scene->GetTransformBuffer().GetHandle(),
+                _scene->GetVertexBuffer().GetHandle(),
+                _scene->GetPositionBuffer().GetHandle(),
+                _scene->GetIndexBuffer().GetHandle(),
+                _scene->GetPrimitiveBuffer().GetHandle(),
+                _scene->GetMaterialBuffer().GetHandle(),
+                _linearSampler.GetHandle(),
+                viewBuffer.GetHandle(),
+                _visbufferResolve.AlbedoImage.GetHandle(),
+                _visbufferResolve.NormalImage.GetHandle(),
+                _visbufferResolve.ShaderMaterialIdImage.GetHandle(),
+                _visbufferResolve.TileBuffer.GetHandle(),
+                _visbufferResolve.TileCapacity
+              )
+              .DispatchIndirect(*_visbufferResolve.TileDispatchBuffer, shaderId * sizeof(Graphics::SDispatchIndirectCommand));
           }
         },
       })
-      .BeginRendering({
+      .AddPass({
         .Name = "GBufferResolvePass",
-        .ColorAttachments = {
-          {
-            .ImageView = _gbufferPass.MainImage->GetView(),
-            .LoadOperator = Graphics::EAttachmentLoadOperator::E_CLEAR,
-            .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
-            .ClearValue = Graphics::MakeColorClearValue(0.0f),
-          },
+        .Images = {
+          { albedoImage, Graphics::ERenderGraphAccess::E_FRAGMENT_SHADER_SAMPLED_READ },
+          { normalImage, Graphics::ERenderGraphAccess::E_FRAGMENT_SHADER_SAMPLED_READ },
+          { shaderMaterialIdImage, Graphics::ERenderGraphAccess::E_FRAGMENT_SHADER_SAMPLED_READ },
+          { gbufferMainImage, Graphics::ERenderGraphAccess::E_COLOR_ATTACHMENT_WRITE },
+        },
+        .Execute = [&](Graphics::CCommandBuffer& commands) noexcept {
+          commands
+            .BeginRendering({
+              .Name = "GBufferResolvePass",
+              .ColorAttachments = {
+                {
+                  .ImageView = _gbufferPass.MainImage->GetView(),
+                  .LoadOperator = Graphics::EAttachmentLoadOperator::E_CLEAR,
+                  .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
+                  .ClearValue = Graphics::MakeColorClearValue(0.0f),
+                },
+              },
+            })
+            .BindPipeline(*_gbufferPass.MainPipeline)
+            .BindShaderResourceTable(_device->GetShaderResourceTable())
+            .PushConstants(
+              _visbufferResolve.AlbedoImage.GetHandle(),
+              _visbufferResolve.NormalImage.GetHandle(),
+              _visbufferResolve.ShaderMaterialIdImage.GetHandle(),
+              _pointSampler.GetHandle(),
+              _pointSamplerInt.GetHandle()
+            )
+            .Draw(3)
+            .EndRendering();
         },
       })
-      .BindPipeline(*_gbufferPass.MainPipeline)
-      .BindShaderResourceTable(_device->GetShaderResourceTable())
-      .PushConstants(
-        _visbufferResolve.AlbedoImage.GetHandle(),
-        _visbufferResolve.NormalImage.GetHandle(),
-        _visbufferResolve.ShaderMaterialIdImage.GetHandle(),
-        _pointSampler.GetHandle(),
-        _pointSamplerInt.GetHandle()
-      )
-      .Draw(3)
-      .EndRendering();
-    _dlssInstance->Evaluate(commandBuffer, {
-      .Color = *_gbufferPass.MainImage,
-      .Depth = *_visbuffer.DepthImage,
-      .Velocity = *_visbuffer.VelocityImage,
-      .Output = *_dlss.MainImage,
-      .JitterOffset = Details::SampleJitter(_frameTimeline->GetHostTimelineValue(), _dlss.JitterSize),
-      .MotionVectorScale = _dlss.RenderResolution,
-    });
-    commandBuffer
-      .ImageMemoryBarrier({
-        .Image = *_dlss.MainImage,
-        .SourceStage =
-          Graphics::EPipelineStageFlag::E_TRANSFER |
-          Graphics::EPipelineStageFlag::E_COMPUTE_SHADER,
-        .DestStage = Graphics::EPipelineStageFlag::E_FRAGMENT_SHADER,
-        .SourceAccess =
-          Graphics::EResourceAccessFlag::E_SHADER_READ |
-          Graphics::EResourceAccessFlag::E_SHADER_WRITE |
-          Graphics::EResourceAccessFlag::E_TRANSFER_WRITE,
-        .DestAccess = Graphics::EResourceAccessFlag::E_SHADER_SAMPLED_READ,
-        .OldLayout = Graphics::EImageLayout::E_GENERAL,
-        .NewLayout = Graphics::EImageLayout::E_SHADER_READ_ONLY_OPTIMAL,
+      .AddPass({
+        .Name = "DLSS",
+        .Images = {
+          { gbufferMainImage, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_SAMPLED_READ },
+          { visbufferDepthImage, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_SAMPLED_READ },
+          { visbufferVelocityImage, Graphics::ERenderGraphAccess::E_COMPUTE_SHADER_SAMPLED_READ },
+          { dlssMainImage, Graphics::ERenderGraphAccess::E_GENERAL_READ_WRITE },
+        },
+        .Execute = [&](Graphics::CCommandBuffer& commands) noexcept {
+          _dlssInstance->Evaluate(commands, {
+            .Color = *_gbufferPass.MainImage,
+            .Depth = *_visbuffer.DepthImage,
+            .Velocity = *_visbuffer.VelocityImage,
+            .Output = *_dlss.MainImage,
+            .JitterOffset = Details::SampleJitter(_frameTimeline->GetHostTimelineValue(), _dlss.JitterSize),
+            .MotionVectorScale = _dlss.RenderResolution,
+          });
+        },
       })
-      .BeginRendering({
+      .AddPass({
         .Name = "Tonemap",
-        .ColorAttachments = {
-          {
-            .ImageView = _tonemap.MainImage->GetView(),
-            .LoadOperator = Graphics::EAttachmentLoadOperator::E_DONT_CARE,
-            .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
-          }
+        .Images = {
+          { dlssMainImage, Graphics::ERenderGraphAccess::E_FRAGMENT_SHADER_SAMPLED_READ },
+          { tonemapMainImage, Graphics::ERenderGraphAccess::E_COLOR_ATTACHMENT_WRITE },
+        },
+        .Execute = [&](Graphics::CCommandBuffer& commands) noexcept {
+          commands
+            .BeginRendering({
+              .Name = "Tonemap",
+              .ColorAttachments = {
+                {
+                  .ImageView = _tonemap.MainImage->GetView(),
+                  .LoadOperator = Graphics::EAttachmentLoadOperator::E_DONT_CARE,
+                  .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
+                }
+              },
+            })
+            .SetViewport()
+            .SetScissor()
+            .BindPipeline(isTonemapPassthrough ? *_tonemap.PassthroughPipeline : *_tonemap.MainPipeline)
+            .BindShaderResourceTable(_device->GetShaderResourceTable())
+            .PushConstants(
+              _dlss.MainImage.GetHandle(),
+              tonemapWhitePoint
+            )
+            .Draw(3)
+            .EndRendering();
         },
       })
-      .SetViewport()
-      .SetScissor()
-      .BindPipeline(*_tonemap.MainPipeline)
-      .BindShaderResourceTable(_device->GetShaderResourceTable())
-      .PushConstants(
-        _dlss.MainImage.GetHandle(),
-        _tonemap.WhitePoint,
-        static_cast<uint32>(_tonemap.IsPassthrough)
-      )
-      .Draw(3)
-      .EndRendering()
-      .ImageMemoryBarrier({
-        .Image = *_tonemap.MainImage,
-        .SourceStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-        .DestStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-        .SourceAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-        .DestAccess =
-          Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_READ |
-          Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-        .OldLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-        .NewLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-      });
-    _imGuiContext->Render(*_tonemap.MainImage, commandBuffer, [&] noexcept {
-      if (ImGui::Begin("Info")) {
-        ImGui::Text("AFPS: %.2f rad/s", glm::two_pi<float32>() * 1.0f / _timer.GetDeltaTime());
-        ImGui::Text("FPS: %.2f", 1.0f / _timer.GetDeltaTime());
-        ImGui::Text("Frame Time: %.2f ms", _timer.GetDeltaTime() * 1000.0f);
-
-        ImGui::SeparatorText("Camera Info");
-        {
-          const auto position = _camera->GetPosition();
-          const auto front = _camera->GetFront();
-          const auto up = _camera->GetUp();
-          const auto right = _camera->GetRight();
-          ImGui::Text("Position: (%.2f, %.2f, %.2f)", position.x, position.y, position.z);
-          ImGui::Text("Front: (%.2f, %.2f, %.2f)", front.x, front.y, front.z);
-          ImGui::Text("Up: (%.2f, %.2f, %.2f)", up.x, up.y, up.z);
-          ImGui::Text("Right: (%.2f, %.2f, %.2f)", right.x, right.y, right.z);
-          ImGui::Text("Rotation: (%.2f, %.2f)", _camera->GetYaw(), _camera->GetPitch());
-        }
+      .AddPass({
+        .Name = "ImGui",
+        .Images = {
+          { tonemapMainImage, Graphics::ERenderGraphAccess::E_COLOR_ATTACHMENT_READ_WRITE },
+          // Sampled by the texture viewer
+          { albedoImage, Graphics::ERenderGraphAccess::E_FRAGMENT_SHADER_SAMPLED_READ },
+          { normalImage, Graphics::ERenderGraphAccess::E_FRAGMENT_SHADER_SAMPLED_READ },
+        },
+        .Execute = [&](Graphics::CCommandBuffer& commands) noexcept {
+          _imGuiContext->Render(*_tonemap.MainImage, commands, [&] noexcept {
+            if (ImGui::Begin("Info")) {
+              ImGui::Text("AFPS: %.2f rad/s", glm::two_pi<float32>() * 1.0f / _timer.GetDeltaTime());
+              ImGui::Text("FPS: %.2f", 1.0f / _timer.GetDeltaTime());
+              ImGui::Text("Frame Time: %.2f ms", _timer.GetDeltaTime() * 1000.0f);
+
+              ImGui::SeparatorText("Camera Info");
+              {
+                const auto position = _camera->GetPosition();
+                const auto front = _camera->GetFront();
+                const auto up = _camera->GetUp();
+                const auto right = _camera->GetRight();
+                ImGui::Text("Position: (%.2f, %.2f, %.2f)", position.x, position.y, position.z);
+                ImGui::Text("Front: (%.2f, %.2f, %.2f)", front.x, front.y, front.z);
+                ImGui::Text("Up: (%.2f, %.2f, %.2f)", up.x, up.y, up.z);
+                ImGui::Text("Right: (%.2f, %.2f, %.2f)", right.x, right.y, right.z);
+                ImGui::Text("Rotation: (%.2f, %.2f)", _camera->GetYaw(), _camera->GetPitch());
+              }
 
-        ImGui::SeparatorText("Memory Budget");
-        {
-          const auto deviceLocalBudget = _device->GetHeapBudget(
-            Graphics::EMemoryPropertyFlag::E_DEVICE_LOCAL,
-            ~Graphics::EMemoryPropertyFlag::E_DEVICE_LOCAL
-          );
-          const auto hostVisibleBudget = _device->GetHeapBudget(
-            Graphics::EMemoryPropertyFlag::E_HOST_VISIBLE,
-            Graphics::EMemoryPropertyFlag::E_DEVICE_LOCAL
-          );
-          ImGui::Text("Device Local Heap: %.2lf MB / %.2lf MB", deviceLocalBudget.Usage / 1048576.0_f64, deviceLocalBudget.Budget / 1048576.0_f64);
-          ImGui::Text("Host Visible Heap: %.2lf MB / %.2lf MB", hostVisibleBudget.Usage / 1048576.0_f64, hostVisibleBudget.Budget / 1048576.0_f64);
-        }
-      }
-      ImGui::End();
-      if (ImGui::Begin("Settings")) {
-        if (ImGui::CollapsingHeader("Camera", ImGuiTreeNodeFlags_DefaultOpen)) {
-          ImGui::DragFloat("FOV", &_cameraState.Fov, 1.0f, 0.0f, 180.0f);
-          ImGui::DragFloat("Movement Speed", &_cameraState.MovementSpeed, 0.1f, 0.0f, 100.0f);
-          ImGui::DragFloat("View Sensitivity", &_cameraState.ViewSensitivity, 0.01f, 0.0f, 1.0f);
-          ImGui::DragFloat("Near", &_cameraState.Near, 0.01f, 0.0f, 5.0f);
-        }
+              ImGui::SeparatorText("Scene Info");
+              {
+                auto visibleNodeCount = 0_u32;
+                for (const auto& range : _visibleNodeRanges) {
+                  visibleNodeCount += range.Count;
+                }
+                const auto nodeCount = static_cast<uint32>(_scene->GetBvh().GetItems().size());
+                ImGui::Text("Visible Nodes: %u / %u", visibleNodeCount, nodeCount);
+              }
 
-        if (ImGui::CollapsingHeader("DLSS", ImGuiTreeNodeFlags_DefaultOpen)) {
-          {
-            const auto qualityPresetNames = std::to_array<const char*>({
-              "Performance",
-              "Balanced",
-              "Quality",
-              "Native",
-            });
-            auto currentPresetIndex = [&] noexcept {
-              switch (_dlss.Preset) {
-                case Graphics::ENvidiaDlssQualityPreset::E_PERFORMANCE: return 0;
-                case Graphics::ENvidiaDlssQualityPreset::E_BALANCED: return 1;
-                case Graphics::ENvidiaDlssQualityPreset::E_QUALITY: return 2;
-                case Graphics::ENvidiaDlssQualityPreset::E_NATIVE: return 3;
+              ImGui::SeparatorText("Render Graph");
+              {
+                const auto& statistics = _renderGraph->GetStatistics();
+                ImGui::Text("Passes: %u (%u culled)", statistics.PassCount, statistics.CulledPassCount);
+                ImGui::Text("Levels: %u", statistics.LevelCount);
+                ImGui::Text("Barrier Batches: %u", statistics.BarrierBatchCount);
+                ImGui::Text("Image Barriers: %u", statistics.ImageBarrierCount);
+                ImGui::Text("Async Compute Passes: %u", statistics.AsyncComputePassCount);
+                ImGui::Text("Submissions: %u", statistics.SubmissionCount);
               }
-            }();
-            const auto oldPresetIndex = currentPresetIndex;
-            if (ImGui::BeginCombo("Quality Preset", qualityPresetNames[currentPresetIndex])) {
-              if (ImGui::Selectable(qualityPresetNames[0])) {
-                currentPresetIndex = 0;
+
+              ImGui::SeparatorText("Transient Memory");
+              {
+                const auto& statistics = _transientPool->GetStatistics();
+                ImGui::Text("Render Targets: %.2lf MB (%.2lf MB unaliased)", statistics.AllocatedBytes / 1048576.0_f64, statistics.RequestedBytes / 1048576.0_f64);
+                ImGui::Text("Blocks: %u", statistics.BlockCount);
+                ImGui::Text("Lazily Allocated Images: %u", statistics.LazyImageCount);
+              }
+
+              ImGui::SeparatorText("Memory Budget");
+              {
+                const auto deviceLocalBudget = _device->GetHeapBudget(
+                  Graphics::EMemoryPropertyFlag::E_DEVICE_LOCAL,
+                  ~Graphics::EMemoryPropertyFlag::E_DEVICE_LOCAL
+                );
+                const auto hostVisibleBudget = _device->GetHeapBudget(
+                  Graphics::EMemoryPropertyFlag::E_HOST_VISIBLE,
+                  Graphics::EMemoryPropertyFlag::E_DEVICE_LOCAL
+                );
+                ImGui::Text("Device Local Heap: %.2lf MB / %.2lf MB", deviceLocalBudget.Usage / 1048576.0_f64, deviceLocalBudget.Budget / 1048576.0_f64);
+                ImGui::Text("Host Visible Heap: %.2lf MB / %.2lf MB", hostVisibleBudget.Usage / 1048576.0_f64, hostVisibleBudget.Budget / 1048576.0_f64);
               }
-              if (ImGui::Selectable(qualityPresetNames[1])) {
-                currentPresetIndex = 1;
+            }
+            ImGui::End();
+            if (ImGui::Begin("Settings")) {
+              if (ImGui::CollapsingHeader("Camera", ImGuiTreeNodeFlags_DefaultOpen)) {
+                ImGui::DragFloat("FOV", &_cameraState.Fov, 1.0f, 0.0f, 180.0f);
+                ImGui::DragFloat("Movement Speed", &_cameraState.MovementSpeed, 0.1f, 0.0f, 100.0f);
+                ImGui::DragFloat("View Sensitivity", &_cameraState.ViewSensitivity, 0.01f, 0.0f, 1.0f);
+                ImGui::DragFloat("Near", &_cameraState.Near, 0.01f, 0.0f, 5.0f);
               }
-              if (ImGui::Selectable(qualityPresetNames[2])) {
-                currentPresetIndex = 2;
+
+              if (ImGui::CollapsingHeader("DLSS", ImGuiTreeNodeFlags_DefaultOpen)) {
+                {
+                  const auto qualityPresetNames = std::to_array<const char*>({
+                    "Performance",
+                    "Balanced",
+                    "Quality",
+                    "Native",
+                  });
+                  auto currentPresetIndex = [&] noexcept {
+                    switch (_dlss.Preset) {
+                      case Graphics::ENvidiaDlssQualityPreset::E_PERFORMANCE: return 0;
+                      case Graphics::ENvidiaDlssQualityPreset::E_BALANCED: return 1;
+                      case Graphics::ENvidiaDlssQualityPreset::E_QUALITY: return 2;
+                      case Graphics::ENvidiaDlssQualityPreset::E_NATIVE: return 3;
+                    }
+                  }();
+                  const auto oldPresetIndex = currentPresetIndex;
+                  if (ImGui::BeginCombo("Quality Preset", qualityPresetNames[currentPresetIndex])) {
+                    if (ImGui::Selectable(qualityPresetNames[0])) {
+                      currentPresetIndex = 0;
+                    }
+                    if (ImGui::Selectable(qualityPresetNames[1])) {
+                      currentPresetIndex = 1;
+                    }
+                    if (ImGui::Selectable(qualityPresetNames[2])) {
+                      currentPresetIndex = 2;
+                    }
+                    if (ImGui::Selectable(qualityPresetNames[3])) {
+                      currentPresetIndex = 3;
+                    }
+                    ImGui::EndCombo();
+
+                    _dlss.Preset = [&] noexcept {
+                      switch (currentPresetIndex) {
+                        case 0: return Graphics::ENvidiaDlssQualityPreset::E_PERFORMANCE;
+                        case 1: return Graphics::ENvidiaDlssQualityPreset::E_BALANCED;
+                        case 2: return Graphics::ENvidiaDlssQualityPreset::E_QUALITY;
+                        case 3: return Graphics::ENvidiaDlssQualityPreset::E_NATIVE;
+                      }
+                    }();
+                    if (oldPresetIndex != currentPresetIndex) {
+                      _dlss.ShouldResize = true;
+                    }
+                  }
+                }
+                ImGui::Checkbox("Reset", &_dlss.AlwaysReset);
               }
-              if (ImGui::Selectable(qualityPresetNames[3])) {
-                currentPresetIndex = 3;
+
+              if (ImGui::CollapsingHeader("Tonemap", ImGuiTreeNodeFlags_DefaultOpen)) {
+                ImGui::DragFloat("White Point", &_tonemap.WhitePoint, 0.1f, 0.0f, 5.0f);
+                ImGui::Checkbox("Passthrough", &_tonemap.IsPassthrough);
               }
-              ImGui::EndCombo();
-
-              _dlss.Preset = [&] noexcept {
-                switch (currentPresetIndex) {
-                  case 0: return Graphics::ENvidiaDlssQualityPreset::E_PERFORMANCE;
-                  case 1: return Graphics::ENvidiaDlssQualityPreset::E_BALANCED;
-                  case 2: return Graphics::ENvidiaDlssQualityPreset::E_QUALITY;
-                  case 3: return Graphics::ENvidiaDlssQualityPreset::E_NATIVE;
+            }
+            ImGui::End();
+
+            if (ImGui::Begin("Texture Viewer")) {
+              if (ImGui::CollapsingHeader("GBuffer", ImGuiTreeNodeFlags_DefaultOpen)) {
+                {
+                  ImGui::SeparatorText("Albedo");
+                  const auto image = _visbufferResolve.AlbedoImage;
+                  const auto width = ImGui::GetContentRegionAvail().x;
+                  const auto height = width / image->GetAspectRatio();
+                  ImGui::Image(GUI::AsTextureHandle(image), { width, height });
+                }
+                {
+                  ImGui::SeparatorText("Normal");
+                  const auto image = _visbufferResolve.NormalImage;
+                  const auto width = ImGui::GetContentRegionAvail().x;
+                  const auto height = width / image->GetAspectRatio();
+                  ImGui::Image(GUI::AsTextureHandle(image), { width, height });
                 }
-              }();
-              if (oldPresetIndex != currentPresetIndex) {
-                _dlss.ShouldResize = true;
               }
             }
-          }
-          ImGui::Checkbox("Reset", &_dlss.AlwaysReset);
-        }
-
-        if (ImGui::CollapsingHeader("Tonemap", ImGuiTreeNodeFlags_DefaultOpen)) {
-          ImGui::DragFloat("White Point", &_tonemap.WhitePoint, 0.1f, 0.0f, 5.0f);
-          ImGui::Checkbox("Passthrough", &_tonemap.IsPassthrough);
-        }
-      }
-      ImGui::End();
-
-      if (ImGui::Begin("Texture Viewer")) {
-        if (ImGui::CollapsingHeader("GBuffer", ImGuiTreeNodeFlags_DefaultOpen)) {
-          {
-            ImGui::SeparatorText("Albedo");
-            const auto image = _visbufferResolve.AlbedoImage;
-            const auto width = ImGui::GetContentRegionAvail().x;
-            const auto height = width / image->GetAspectRatio();
-            ImGui::Image(GUI::AsTextureHandle(image), { width, height });
-          }
-          {
-            ImGui::SeparatorText("Normal");
-            const auto image = _visbufferResolve.NormalImage;
-            const auto width = ImGui::GetContentRegionAvail().x;
-            const auto height = width / image->GetAspectRatio();
-            ImGui::Image(GUI::AsTextureHandle(image), { width, height });
-          }
-        }
-      }
-      ImGui::End();
-    });
-    commandBuffer
-      .Barrier({
-        .ImageMemoryBarriers = {
-          {
-            .Image = *_tonemap.MainImage,
-            .SourceStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .DestStage = Graphics::EPipelineStageFlag::E_FRAGMENT_SHADER,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_SHADER_SAMPLED_READ,
-            .OldLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-            .NewLayout = Graphics::EImageLayout::E_SHADER_READ_ONLY_OPTIMAL,
-          },
-          {
-            .Image = _swapchain->GetCurrentImage(),
-            .SourceStage = Graphics::EPipelineStageFlag::E_NONE,
-            .DestStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-            .SourceAccess = Graphics::EResourceAccessFlag::E_NONE,
-            .DestAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-            .OldLayout = Graphics::EImageLayout::E_UNDEFINED,
-            .NewLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-          },
+            ImGui::End();
+          });
         },
       })
-      .BeginRendering({
+      .AddPass({
         .Name = "SwapchainCopy",
-        .ColorAttachments = {
-          {
-            .ImageView = _swapchain->GetCurrentImage().GetView(),
-            .LoadOperator = Graphics::EAttachmentLoadOperator::E_DONT_CARE,
-            .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
-          },
+        .Images = {
+          { tonemapMainImage, Graphics::ERenderGraphAccess::E_FRAGMENT_SHADER_SAMPLED_READ },
+          { swapchainImage, Graphics::ERenderGraphAccess::E_COLOR_ATTACHMENT_WRITE },
         },
-      })
-      .SetViewport()
-      .SetScissor()
-      .BindPipeline(*_tonemap.CopyPipeline)
-      .BindShaderResourceTable(_device->GetShaderResourceTable())
-      .PushConstants(_tonemap.MainImage.GetHandle(), _pointSampler.GetHandle())
-      .Draw(3)
-      .EndRendering()
-      .ImageMemoryBarrier({
-        .Image = _swapchain->GetCurrentImage(),
-        .SourceStage = Graphics::EPipelineStageFlag::E_COLOR_ATTACHMENT_OUTPUT,
-        .DestStage = Graphics::EPipelineStageFlag::E_NONE,
-        .SourceAccess = Graphics::EResourceAccessFlag::E_COLOR_ATTACHMENT_WRITE,
-        .DestAccess = Graphics::EResourceAccessFlag::E_NONE,
-        .OldLayout = Graphics::EImageLayout::E_COLOR_ATTACHMENT_OPTIMAL,
-        .NewLayout = Graphics::EImageLayout::E_PRESENT_SRC_KHR,
-      })
-      .EndNamedRegion()
-      .End();
+        .Execute = [&](Graphics::CCommandBuffer& commands) noexcept {
+          commands
+            .BeginRendering({
+              .Name = "SwapchainCopy",
+              .ColorAttachments = {
+                {
+                  .ImageView = _swapchain->GetCurrentImage().GetView(),
+                  .LoadOperator = Graphics::EAttachmentLoadOperator::E_DONT_CARE,
+                  .StoreOperator = Graphics::EAttachmentStoreOperator::E_STORE,
+                },
+              },
+            })
+            .SetViewport()
+            .SetScissor()
+            .BindPipeline(*_tonemap.CopyPipeline)
+            .BindShaderResourceTable(_device->GetShaderResourceTable())
+            .PushConstants(_tonemap.MainImage.GetHandle(), _pointSampler.GetHandle())
+            .Draw(3)
+            .EndRendering();
+        },
+      });
+    commandBuffer.End();
 
-    _device->GetGraphicsQueue().Submit({
+    auto waitSemaphores = Graphics::CQueueSubmitSemaphores {
+      { *_imageAvailableSemaphores[frameIndex], Graphics::EPipelineStageFlag::E_FRAGMENT_SHADER },
+    };
+    // The scene upload overwrites buffers the previous frame's material passes may still read on the compute queue
+    const auto& computeQueue = _device->GetComputeQueue();
+    if (&computeQueue != &_device->GetGraphicsQueue()) {
+      waitSemaphores.PushBack({ computeQueue.GetTimeline(), Graphics::EPipelineStageFlag::E_TRANSFER, computeQueue.GetTimelineValue() });
+    }
+    renderGraph.Submit({
       .CommandBuffers = { commandBuffer },
-      .WaitSemaphores = {
-        { *_imageAvailableSemaphores[frameIndex], Graphics::EPipelineStageFlag::E_FRAGMENT_SHADER },
-      },
+      .WaitSemaphores = waitSemaphores,
       .SignalSemaphores = {
         { *_presentReadySemaphores[frameIndex], Graphics::EPipelineStageFlag::E_BOTTOM_OF_PIPE },
       },
       .Timelines = {
         *_frameTimeline,
         _device->GetMainTimeline(),
-      }
+      },
+      .RecordingThreadCount = RENDER_GRAPH_RECORDING_THREAD_COUNT,
+      .FrameIndex = frameIndex,
     });
 
     if (!_swapchain->Present({ { *_presentReadySemaphores[frameIndex] } })) {
@@ -1069,151 +1166,324 @@ namespace Retina::Sandbox {
     });
   }
 
-  auto CSandboxApplication::InitializeVisbufferPass() noexcept -> void {
+  auto CSandboxApplication::InitializeRenderTargets() noexcept -> void {
     RETINA_PROFILE_SCOPED();
-
-    _device->GetShaderResourceTable().Destroy(_visbuffer.MainImage);
-    _visbuffer.MainImage = _device->GetShaderResourceTable().MakeImage({
-      .Name = "VisbufferMainImage",
-      .Width = static_cast<uint32>(_dlss.RenderResolution.x),
-      .Height = static_cast<uint32>(_dlss.RenderResolution.y),
-      .Format = Graphics::EResourceFormat::E_R32_UINT,
-      .Usage =
-        Graphics::EImageUsageFlag::E_COLOR_ATTACHMENT |
-        Graphics::EImageUsageFlag::E_SAMPLED,
-      .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
-    });
-    _device->GetShaderResourceTable().Destroy(_visbuffer.VelocityImage);
-    _visbuffer.VelocityImage = _device->GetShaderResourceTable().MakeImage({
-      .Name = "VisbufferVelocityImage",
-      .Width = static_cast<uint32>(_dlss.RenderResolution.x),
-      .Height = static_cast<uint32>(_dlss.RenderResolution.y),
-      .Format = Graphics::EResourceFormat::E_R16G16_SFLOAT,
-      .Usage =
-        Graphics::EImageUsageFlag::E_COLOR_ATTACHMENT |
-        Graphics::EImageUsageFlag::E_SAMPLED,
-      .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
+    auto& shaderResourceTable = _device->GetShaderResourceTable();
+    const auto renderTargets = std::to_array({
+      &_visbuffer.MainImage,
+      &_visbuffer.VelocityImage,
+      &_visbuffer.DepthImage,
+      &_visbufferResolve.AlbedoImage,
+      &_visbufferResolve.NormalImage,
+      &_visbufferResolve.ShaderMaterialIdImage,
+      &_gbufferPass.MainImage,
+      &_dlss.MainImage,
+      &_tonemap.MainImage,
     });
-    _device->GetShaderResourceTable().Destroy(_visbuffer.DepthImage);
-    _visbuffer.DepthImage = _device->GetShaderResourceTable().MakeImage({
-      .Name = "VisbufferDepthImage",
-      .Width = static_cast<uint32>(_dlss.RenderResolution.x),
-      .Height = static_cast<uint32>(_dlss.RenderResolution.y),
-      .Format = Graphics::EResourceFormat::E_D32_SFLOAT,
-      .Usage =
-        Graphics::EImageUsageFlag::E_DEPTH_STENCIL_ATTACHMENT |
-        Graphics::EImageUsageFlag::E_SAMPLED,
-      .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
+    for (auto* renderTarget : renderTargets) {
+      shaderResourceTable.Destroy(*renderTarget);
+    }
+
+    const auto renderWidth = static_cast<uint32>(_dlss.RenderResolution.x);
+    const auto renderHeight = static_cast<uint32>(_dlss.RenderResolution.y);
+    const auto outputWidth = static_cast<uint32>(_dlss.OutputResolution.x);
+    const auto outputHeight = static_cast<uint32>(_dlss.OutputResolution.y);
+    // Same order as "renderTargets"
+    const auto transientImages = std::to_array<Graphics::STransientImageInfo>({
+      {
+        .CreateInfo = {
+          .Name = "VisbufferMainImage",
+          .Width = renderWidth,
+          .Height = renderHeight,
+          .Format = Graphics::EResourceFormat::E_R32_UINT,
+          .Usage =
+            Graphics::EImageUsageFlag::E_COLOR_ATTACHMENT |
+            Graphics::EImageUsageFlag::E_SAMPLED,
+          // Read by the material passes on the async compute queue
+          .IsCrossDomain = true,
+          .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
+        },
+        .FirstUse = Details::RENDER_TARGET_PASS_VISBUFFER_RASTER,
+        .LastUse = Details::RENDER_TARGET_PASS_MATERIAL_SHADE,
+      },
+      {
+        .CreateInfo = {
+          .Name = "VisbufferVelocityImage",
+          .Width = renderWidth,
+          .Height = renderHeight,
+          .Format = Graphics::EResourceFormat::E_R16G16_SFLOAT,
+          .Usage =
+            Graphics::EImageUsageFlag::E_COLOR_ATTACHMENT |
+            Graphics::EImageUsageFlag::E_SAMPLED,
+          .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
+        },
+        .FirstUse = Details::RENDER_TARGET_PASS_VISBUFFER_RASTER,
+        .LastUse = Details::RENDER_TARGET_PASS_DLSS,
+      },
+      {
+        .CreateInfo = {
+          .Name = "VisbufferDepthImage",
+          .Width = renderWidth,
+          .Height = renderHeight,
+          .Format = Graphics::EResourceFormat::E_D32_SFLOAT,
+          .Usage =
+            Graphics::EImageUsageFlag::E_DEPTH_STENCIL_ATTACHMENT |
+            Graphics::EImageUsageFlag::E_SAMPLED,
+          .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
+        },
+        .FirstUse = Details::RENDER_TARGET_PASS_VISBUFFER_RASTER,
+        .LastUse = Details::RENDER_TARGET_PASS_DLSS,
+      },
+      {
+        .CreateInfo = {
+          .Name = "VisbufferResolveAlbedoImage",
+          .Width = renderWidth,
+          .Height = renderHeight,
+          .Format = Graphics::EResourceFormat::E_R8G8B8A8_UNORM,
+          .Usage =
+            Graphics::EImageUsageFlag::E_STORAGE |
+            Graphics::EImageUsageFlag::E_SAMPLED,
+          // Written by the material passes on the async compute queue
+          .IsCrossDomain = true,
+          .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
+        },
+        .FirstUse = Details::RENDER_TARGET_PASS_MATERIAL_CLASSIFY,
+        .LastUse = Details::RENDER_TARGET_PASS_IMGUI,
+      },
+      {
+        .CreateInfo = {
+          .Name = "VisbufferResolveNormalImage",
+          .Width = renderWidth,
+          .Height = renderHeight,
+          .Format = Graphics::EResourceFormat::E_R16G16_SFLOAT,
+          .Usage =
+            Graphics::EImageUsageFlag::E_STORAGE |
+            Graphics::EImageUsageFlag::E_SAMPLED,
+          // Written by the material passes on the async compute queue
+          .IsCrossDomain = true,
+          .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
+        },
+        .FirstUse = Details::RENDER_TARGET_PASS_MATERIAL_CLASSIFY,
+        .LastUse = Details::RENDER_TARGET_PASS_IMGUI,
+      },
+      {
+        .CreateInfo = {
+          .Name = "VisbufferResolveShaderMaterialIdImage",
+          .Width = renderWidth,
+          .Height = renderHeight,
+          .Format = Graphics::EResourceFormat::E_R32_UINT,
+          .Usage =
+            Graphics::EImageUsageFlag::E_STORAGE |
+            Graphics::EImageUsageFlag::E_SAMPLED,
+          // Written by the material passes on the async compute queue
+          .IsCrossDomain = true,
+          .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
+        },
+        .FirstUse = Details::RENDER_TARGET_PASS_MATERIAL_CLASSIFY,
+        .LastUse = Details::RENDER_TARGET_PASS_GBUFFER_RESOLVE,
+      },
+      {
+        .CreateInfo = {
+          .Name = "GBufferResolveMainImage",
+          .Width = renderWidth,
+          .Height = renderHeight,
+          .Format = Graphics::EResourceFormat::E_R16G16B16A16_SFLOAT,
+          .Usage =
+            Graphics::EImageUsageFlag::E_COLOR_ATTACHMENT |
+            Graphics::EImageUsageFlag::E_SAMPLED,
+          .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
+        },
+        .FirstUse = Details::RENDER_TARGET_PASS_GBUFFER_RESOLVE,
+        .LastUse = Details::RENDER_TARGET_PASS_DLSS,
+      },
+      {
+        .CreateInfo = {
+          .Name = "DLSSOutputImage",
+          .Width = outputWidth,
+          .Height = outputHeight,
+          .Format = Graphics::EResourceFormat::E_R16G16B16A16_SFLOAT,
+          .Usage =
+            Graphics::EImageUsageFlag::E_TRANSFER_DST |
+            Graphics::EImageUsageFlag::E_STORAGE |
+            Graphics::EImageUsageFlag::E_SAMPLED,
+          .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
+        },
+        .FirstUse = Details::RENDER_TARGET_PASS_DLSS,
+        .LastUse = Details::RENDER_TARGET_PASS_TONEMAP,
+      },
+      {
+        .CreateInfo = {
+          .Name = "TonemapMainImage",
+          .Width = outputWidth,
+          .Height = outputHeight,
+          .Format = Graphics::EResourceFormat::E_R16G16B16A16_SFLOAT,
+          .Usage =
+            Graphics::EImageUsageFlag::E_COLOR_ATTACHMENT |
+            Graphics::EImageUsageFlag::E_SAMPLED,
+          .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
+        },
+        .FirstUse = Details::RENDER_TARGET_PASS_TONEMAP,
+        .LastUse = Details::RENDER_TARGET_PASS_SWAPCHAIN_COPY,
+      },
     });
+    _transientPool->Allocate(transientImages);
+
+    const auto images = _transientPool->GetImages();
+    for (auto i = 0_u32; i < renderTargets.size(); ++i) {
+      *renderTargets[i] = shaderResourceTable.RegisterImage(images[i]);
+    }
+  }
+
+  auto CSandboxApplication::InitializeVisbufferPass() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
     if (!_visbuffer.IsInitialized) {
-      _visbuffer.MainPipeline = Graphics::CMeshShadingPipeline::Make(*_device, {
-        .Name = "VisbufferMainPipeline",
-        .MeshShader = Details::WithShaderPath("Visbuffer.mesh.glsl"),
-        .FragmentShader = Details::WithShaderPath("Visbuffer.frag.glsl"),
-        .IncludeDirectories = { RETINA_SHADER_DIRECTORY },
-        .DescriptorLayouts = {
-          _device->GetShaderResourceTable().GetDescriptorLayout(),
-        },
-        .DepthStencilState = {
-          .DepthTestEnable = true,
-          .DepthWriteEnable = true,
-          .DepthCompareOperator = Graphics::ECompareOperator::E_GREATER,
+      const auto depthStencilState = Graphics::SPipelineDepthStencilStateInfo {
+        .DepthTestEnable = true,
+        .DepthWriteEnable = true,
+        .DepthCompareOperator = Graphics::ECompareOperator::E_GREATER,
+      };
+      const auto dynamicState = Graphics::SPipelineDynamicStateInfo { {
+        Graphics::EDynamicState::E_VIEWPORT,
+        Graphics::EDynamicState::E_SCISSOR,
+      } };
+      const auto renderingInfo = Graphics::SPipelineRenderingInfo {
+        .ColorAttachmentFormats = {
+          _visbuffer.MainImage->GetFormat(),
+          _visbuffer.VelocityImage->GetFormat(),
         },
-        .DynamicState = { {
-          Graphics::EDynamicState::E_VIEWPORT,
-          Graphics::EDynamicState::E_SCISSOR,
-        } },
-        .RenderingInfo = {
+        .DepthAttachmentFormat = _visbuffer.DepthImage->GetFormat(),
+      };
+      if (_device->IsFeatureEnabled(&Graphics::SDeviceFeature::MeshShader)) {
+        _pipelineBuilder->Build(Graphics::SMeshShadingPipelineCreateInfo {
+          .Name = "VisbufferMainPipeline",
+          .MeshShader = Details::WithShaderPath("Visbuffer.mesh.glsl"),
+          .FragmentShader = Details::WithShaderPath("Visbuffer.frag.glsl"),
+          .IncludeDirectories = { RETINA_SHADER_DIRECTORY },
+          .DescriptorLayouts = {
+            _device->GetShaderResourceTable().GetDescriptorLayout(),
+          },
+          .DepthStencilState = depthStencilState,
+          .DynamicState = dynamicState,
+          .RenderingInfo = renderingInfo,
+        }, _visbuffer.MainPipeline);
+      } else {
+        RETINA_SANDBOX_WARN("Mesh shaders not supported, falling back to vertex shader visbuffer rasterization");
+        // One indexed draw per visible meshlet instance, the index buffer stores meshlet-local vertex slots
+        // Both are sized from the scene every frame, see "OnRender"
+        _visbuffer.DrawCommandBuffer = CGpuSceneBuffer<Graphics::SDrawIndexedIndirectCommand>::Make(
+          *_device,
           {
-            .ColorAttachmentFormats = {
-              _visbuffer.MainImage->GetFormat(),
-              _visbuffer.VelocityImage->GetFormat(),
-            },
-            .DepthAttachmentFormat = _visbuffer.DepthImage->GetFormat(),
-          }
-        },
-      });
+            .Name = "VisbufferDrawCommandBuffer",
+            .Usage = Graphics::DEFAULT_BUFFER_USAGE_FLAGS | Graphics::EBufferUsageFlag::E_INDIRECT_BUFFER,
+          },
+          FRAMES_IN_FLIGHT
+        );
+        _visbuffer.DrawCountBuffer = _device->GetShaderResourceTable().MakeBuffer<uint32>({
+          .Name = "VisbufferDrawCountBuffer",
+          .Heap = Graphics::EHeapType::E_DEVICE_ONLY,
+          .Capacity = 2,
+          .Usage = Graphics::DEFAULT_BUFFER_USAGE_FLAGS | Graphics::EBufferUsageFlag::E_INDIRECT_BUFFER,
+        });
+        _visbuffer.ExpandedIndexBuffer = CGpuSceneBuffer<uint32>::Make(
+          *_device,
+          {
+            .Name = "VisbufferExpandedIndexBuffer",
+            .Usage = Graphics::DEFAULT_BUFFER_USAGE_FLAGS | Graphics::EBufferUsageFlag::E_INDEX_BUFFER,
+          },
+          FRAMES_IN_FLIGHT
+        );
+        _pipelineBuilder->Build(Graphics::SComputePipelineCreateInfo {
+          .Name = "VisbufferExpandPipeline",
+          .ComputeShader = Details::WithShaderPath("MeshletExpand.comp.glsl"),
+          .IncludeDirectories = { RETINA_SHADER_DIRECTORY },
+          .DescriptorLayouts = {
+            _device->GetShaderResourceTable().GetDescriptorLayout(),
+          },
+        }, _visbuffer.ExpandPipeline);
+        _pipelineBuilder->Build(Graphics::SGraphicsPipelineCreateInfo {
+          .Name = "VisbufferFallbackPipeline",
+          .VertexShader = Details::WithShaderPath("Visbuffer.vert.glsl"),
+          .FragmentShader = Details::WithShaderPath("Visbuffer.frag.glsl"),
+          .IncludeDirectories = { RETINA_SHADER_DIRECTORY },
+          .DescriptorLayouts = {
+            _device->GetShaderResourceTable().GetDescriptorLayout(),
+          },
+          .DepthStencilState = depthStencilState,
+          .DynamicState = dynamicState,
+          .RenderingInfo = renderingInfo,
+        }, _visbuffer.FallbackPipeline);
+      }
       _visbuffer.IsInitialized = true;
     }
   }
 
   auto CSandboxApplication::InitializeVisbufferResolvePass() noexcept -> void {
     RETINA_PROFILE_SCOPED();
-    _device->GetShaderResourceTable().Destroy(_visbufferResolve.AlbedoImage);
-    _visbufferResolve.AlbedoImage = _device->GetShaderResourceTable().MakeImage({
-      .Name = "VisbufferResolveAlbedoImage",
-      .Width = static_cast<uint32>(_dlss.RenderResolution.x),
-      .Height = static_cast<uint32>(_dlss.RenderResolution.y),
-      .Format = Graphics::EResourceFormat::E_R8G8B8A8_UNORM,
-      .Usage =
-        Graphics::EImageUsageFlag::E_COLOR_ATTACHMENT |
-        Graphics::EImageUsageFlag::E_SAMPLED,
-      .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
-    });
-    _device->GetShaderResourceTable().Destroy(_visbufferResolve.NormalImage);
-    _visbufferResolve.NormalImage = _device->GetShaderResourceTable().MakeImage({
-      .Name = "VisbufferResolveNormalImage",
-      .Width = static_cast<uint32>(_dlss.RenderResolution.x),
-      .Height = static_cast<uint32>(_dlss.RenderResolution.y),
-      .Format = Graphics::EResourceFormat::E_R16G16_SFLOAT,
-      .Usage =
-        Graphics::EImageUsageFlag::E_COLOR_ATTACHMENT |
-        Graphics::EImageUsageFlag::E_SAMPLED,
-      .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
-    });
-    _device->GetShaderResourceTable().Destroy(_visbufferResolve.ShaderMaterialIdImage);
-    _visbufferResolve.ShaderMaterialIdImage = _device->GetShaderResourceTable().MakeImage({
-      .Name = "VisbufferResolveShaderMaterialIdImage",
-      .Width = static_cast<uint32>(_dlss.RenderResolution.x),
-      .Height = static_cast<uint32>(_dlss.RenderResolution.y),
-      .Format = Graphics::EResourceFormat::E_R32_UINT,
-      .Usage =
-        Graphics::EImageUsageFlag::E_COLOR_ATTACHMENT |
-        Graphics::EImageUsageFlag::E_SAMPLED,
-      .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
+    // Every shader gets its own tile list, sized for the worst case of one shader covering the whole screen
+    _visbufferResolve.TileCapacity =
+      Details::DivideRoundUp<uint32>(static_cast<uint32>(_dlss.RenderResolution.x), MATERIAL_TILE_SIZE) *
+      Details::DivideRoundUp<uint32>(static_cast<uint32>(_dlss.RenderResolution.y), MATERIAL_TILE_SIZE);
+    _device->GetShaderResourceTable().Destroy(_visbufferResolve.TileBuffer);
+    _visbufferResolve.TileBuffer = _device->GetShaderResourceTable().MakeBuffer<uint32>({
+      .Name = "VisbufferResolveTileBuffer",
+      .Heap = Graphics::EHeapType::E_DEVICE_ONLY,
+      .Capacity = _visbufferResolve.TileCapacity * MATERIAL_SHADER_COUNT,
+      .Domain = Graphics::EQueueDomain::E_COMPUTE,
     });
     if (!_visbufferResolve.IsInitialized) {
-      _visbufferResolve.MainPipeline = Graphics::CGraphicsPipeline::Make(*_device, {
-        .Name = "VisbufferResolveMainPipeline",
-        .VertexShader = Details::WithShaderPath("Fullscreen.vert.glsl"),
-        .FragmentShader = Details::WithShaderPath("VisbufferResolve.frag.glsl"),
+      const auto tileDispatchCommands = std::vector<Graphics::SDispatchIndirectCommand>(MATERIAL_SHADER_COUNT, { 0, 1, 1 });
+      _visbufferResolve.TileDispatchBuffer = _device->GetShaderResourceTable().MakeBuffer<Graphics::SDispatchIndirectCommand>({
+        .Name = "VisbufferResolveTileDispatchBuffer",
+        .Heap = Graphics::EHeapType::E_DEVICE_ONLY,
+        .Capacity = MATERIAL_SHADER_COUNT,
+        .Usage = Graphics::DEFAULT_BUFFER_USAGE_FLAGS | Graphics::EBufferUsageFlag::E_INDIRECT_BUFFER,
+        .Domain = Graphics::EQueueDomain::E_COMPUTE,
+      });
+      _visbufferResolve.TileDispatchResetBuffer = Graphics::CTypedBuffer<Graphics::SDispatchIndirectCommand>::Make(*_device, {
+        .Name = "VisbufferResolveTileDispatchResetBuffer",
+        .Heap = Graphics::EHeapType::E_DEVICE_MAPPABLE,
+        .Capacity = MATERIAL_SHADER_COUNT,
+        .Usage = Graphics::EBufferUsageFlag::E_TRANSFER_SRC,
+        .Domain = Graphics::EQueueDomain::E_COMPUTE,
+      });
+      _visbufferResolve.TileDispatchResetBuffer->Write(std::span<const Graphics::SDispatchIndirectCommand>(tileDispatchCommands));
+
+      _pipelineBuilder->Build(Graphics::SComputePipelineCreateInfo {
+        .Name = "VisbufferResolveClassifyPipeline",
+        .ComputeShader = Details::WithShaderPath("MaterialClassify.comp.glsl"),
         .IncludeDirectories = { RETINA_SHADER_DIRECTORY },
+        .SpecializationConstants = {
+          { .Id = 0, .Value = MATERIAL_SHADER_COUNT },
+          { .Id = 1, .Value = MATERIAL_TILE_SIZE },
+          { .Id = 2, .Value = MATERIAL_TILE_SIZE },
+        },
         .DescriptorLayouts = {
           _device->GetShaderResourceTable().GetDescriptorLayout(),
         },
-        .DynamicState = { {
-          Graphics::EDynamicState::E_VIEWPORT,
-          Graphics::EDynamicState::E_SCISSOR,
-        } },
-        .RenderingInfo = {
-          {
-            .ColorAttachmentFormats = {
-              _visbufferResolve.AlbedoImage->GetFormat(),
-              _visbufferResolve.NormalImage->GetFormat(),
-              _visbufferResolve.ShaderMaterialIdImage->GetFormat(),
-            },
-          }
-        },
-      });
+      }, _visbufferResolve.ClassifyPipeline);
+      for (auto shaderId = 0_u32; shaderId < MATERIAL_SHADER_COUNT; ++shaderId) {
+        _pipelineBuilder->Build(Graphics::SComputePipelineCreateInfo {
+          .Name = std::format("VisbufferResolveShadePipeline{}", shaderId),
+          .ComputeShader = Details::WithShaderPath("MaterialShade.comp.glsl"),
+          .IncludeDirectories = { RETINA_SHADER_DIRECTORY },
+          .SpecializationConstants = {
+            { .Id = 0, .Value = shaderId },
+            { .Id = 1, .Value = MATERIAL_TILE_SIZE },
+            { .Id = 2, .Value = MATERIAL_TILE_SIZE },
+          },
+          .DescriptorLayouts = {
+            _device->GetShaderResourceTable().GetDescriptorLayout(),
+          },
+        }, _visbufferResolve.ShadePipelines[shaderId]);
+      }
       _visbufferResolve.IsInitialized = true;
     }
   }
-  
+
   auto CSandboxApplication::InitializeGBufferPass() noexcept -> void {
     RETINA_PROFILE_SCOPED();
-    _device->GetShaderResourceTable().Destroy(_gbufferPass.MainImage);
-    _gbufferPass.MainImage = _device->GetShaderResourceTable().MakeImage({
-      .Name = "GBufferResolveMainImage",
-      .Width = static_cast<uint32>(_dlss.RenderResolution.x),
-      .Height = static_cast<uint32>(_dlss.RenderResolution.y),
-      .Format = Graphics::EResourceFormat::E_R16G16B16A16_SFLOAT,
-      .Usage =
-        Graphics::EImageUsageFlag::E_COLOR_ATTACHMENT |
-        Graphics::EImageUsageFlag::E_SAMPLED,
-      .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
-    });
     if (!_gbufferPass.IsInitialized) {
-      _gbufferPass.MainPipeline = Graphics::CGraphicsPipeline::Make(*_device, {
+      _pipelineBuilder->Build(Graphics::SGraphicsPipelineCreateInfo {
         .Name = "GBufferResolvePipeline",
         .VertexShader = Details::WithShaderPath("Fullscreen.vert.glsl"),
         .FragmentShader = Details::WithShaderPath("GBufferResolve.frag.glsl"),
@@ -1230,26 +1500,15 @@ namespace Retina::Sandbox {
             .ColorAttachmentFormats = { _gbufferPass.MainImage->GetFormat() },
           }
         },
-      });
+      }, _gbufferPass.MainPipeline);
       _gbufferPass.IsInitialized = true;
     }
   }
 
   auto CSandboxApplication::InitializeTonemapPass() noexcept -> void {
     RETINA_PROFILE_SCOPED();
-    _device->GetShaderResourceTable().Destroy(_tonemap.MainImage);
-    _tonemap.MainImage = _device->GetShaderResourceTable().MakeImage({
-      .Name = "TonemapMainImage",
-      .Width = static_cast<uint32>(_dlss.OutputResolution.x),
-      .Height = static_cast<uint32>(_dlss.OutputResolution.y),
-      .Format = Graphics::EResourceFormat::E_R16G16B16A16_SFLOAT,
-      .Usage =
-        Graphics::EImageUsageFlag::E_COLOR_ATTACHMENT |
-        Graphics::EImageUsageFlag::E_SAMPLED,
-      .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
-    });
     if (!_tonemap.IsInitialized) {
-      _tonemap.MainPipeline = Graphics::CGraphicsPipeline::Make(*_device, {
+      _pipelineBuilder->Build(Graphics::SGraphicsPipelineCreateInfo {
         .Name = "TonemapPipeline",
         .VertexShader = Details::WithShaderPath("Fullscreen.vert.glsl"),
         .FragmentShader = Details::WithShaderPath("Tonemap.frag.glsl"),
@@ -1266,8 +1525,29 @@ namespace Retina::Sandbox {
             .ColorAttachmentFormats = { _tonemap.MainImage->GetFormat() },
           }
         },
-      });
-      _tonemap.CopyPipeline = Graphics::CGraphicsPipeline::Make(*_device, {
+      }, _tonemap.MainPipeline);
+      _pipelineBuilder->Build(Graphics::SGraphicsPipelineCreateInfo {
+        .Name = "TonemapPassthroughPipeline",
+        .VertexShader = Details::WithShaderPath("Fullscreen.vert.glsl"),
+        .FragmentShader = Details::WithShaderPath("Tonemap.frag.glsl"),
+        .IncludeDirectories = { RETINA_SHADER_DIRECTORY },
+        .SpecializationConstants = {
+          { .Id = 0, .Value = true },
+        },
+        .DescriptorLayouts = {
+          _device->GetShaderResourceTable().GetDescriptorLayout(),
+        },
+        .DynamicState = { {
+          Graphics::EDynamicState::E_VIEWPORT,
+          Graphics::EDynamicState::E_SCISSOR,
+        } },
+        .RenderingInfo = {
+          {
+            .ColorAttachmentFormats = { _tonemap.MainImage->GetFormat() },
+          }
+        },
+      }, _tonemap.PassthroughPipeline);
+      _pipelineBuilder->Build(Graphics::SGraphicsPipelineCreateInfo {
         .Name = "TonemapCopyPipeline",
         .VertexShader = Details::WithShaderPath("Fullscreen.vert.glsl"),
         .FragmentShader = Details::WithShaderPath("CopySwapchain.frag.glsl"),
@@ -1291,7 +1571,7 @@ namespace Retina::Sandbox {
             .ColorAttachmentFormats = { _swapchain->GetFormat() },
           }
         },
-      });
+      }, _tonemap.CopyPipeline);
       _tonemap.IsInitialized = true;
     }
   }
@@ -1316,18 +1596,6 @@ namespace Retina::Sandbox {
       .IsHDR = true,
       .IsReverseDepth = true
     });
-    _device->GetShaderResourceTable().Destroy(_dlss.MainImage);
-    _dlss.MainImage = _device->GetShaderResourceTable().MakeImage({
-      .Name = "DLSSOutputImage",
-      .Width = static_cast<uint32>(_dlss.OutputResolution.x),
-      .Height = static_cast<uint32>(_dlss.OutputResolution.y),
-      .Format = Graphics::EResourceFormat::E_R16G16B16A16_SFLOAT,
-      .Usage =
-        Graphics::EImageUsageFlag::E_TRANSFER_DST |
-        Graphics::EImageUsageFlag::E_STORAGE |
-        Graphics::EImageUsageFlag::E_SAMPLED,
-      .ViewInfo = Graphics::DEFAULT_IMAGE_VIEW_CREATE_INFO,
-    });
     _dlss.IsInitialized = true;
   }
 
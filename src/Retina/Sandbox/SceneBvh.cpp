@@ -0,0 +1,517 @@
+#include <Retina/Sandbox/SceneBvh.hpp>
+
+#include <algorithm>
+#include <array>
+#include <execution>
+#include <functional>
+#include <numeric>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+  // Built for AVX2 whatever the target flags are, only called once the CPU is known to support it
+  #define RETINA_BVH_AVX2_KERNEL __attribute__((target("avx2")))
+#endif
+
+namespace Retina::Sandbox {
+  namespace Details {
+    constexpr static auto bvhBinCount = 16_u32;
+    constexpr static auto bvhBinChunkSize = 4096_u32;
+    constexpr static auto bvhMaxLeafSize = 4_u32;
+    constexpr static auto bvhTraversalCost = 1.0_f32;
+
+    enum class EBvhTestResult {
+      E_OUTSIDE,
+      E_INTERSECTING,
+      E_INSIDE,
+    };
+
+    struct SBvhRangeBounds {
+      SAabb Bounds = {};
+      SAabb CentroidBounds = {};
+    };
+
+    struct SBvhBin {
+      SAabb Bounds = {};
+      uint32 Count = 0;
+    };
+
+    using CBvhBinSet = std::array<SBvhBin, bvhBinCount>;
+
+    // Planes in SoA layout, the two unused lanes hold a plane every point is inside of
+    struct alignas(32) SBvhFrustumPlanes {
+      std::array<float32, 8> X = {};
+      std::array<float32, 8> Y = {};
+      std::array<float32, 8> Z = {};
+      std::array<float32, 8> W = {};
+    };
+
+    RETINA_NODISCARD RETINA_INLINE auto MakeBvhFrustumPlanes(const SFrustum& frustum) noexcept -> SBvhFrustumPlanes {
+      RETINA_PROFILE_SCOPED();
+      auto planes = SBvhFrustumPlanes();
+      planes.W.fill(1.0f);
+      for (auto i = 0_u32; i < frustum.Planes.size(); ++i) {
+        planes.X[i] = frustum.Planes[i].x;
+        planes.Y[i] = frustum.Planes[i].y;
+        planes.Z[i] = frustum.Planes[i].z;
+        planes.W[i] = frustum.Planes[i].w;
+      }
+      return planes;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto IsAvx2Supported() noexcept -> bool {
+#if defined(__AVX2__)
+      return true;
+#elif defined(RETINA_BVH_AVX2_KERNEL)
+      static const auto isSupported = __builtin_cpu_supports("avx2") != 0;
+      return isSupported;
+#else
+      return false;
+#endif
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto MakeSphereAabbResult(bool isIntersecting, bool isInside) noexcept -> EBvhTestResult {
+      if (!isIntersecting) {
+        return EBvhTestResult::E_OUTSIDE;
+      }
+      return isInside ? EBvhTestResult::E_INSIDE : EBvhTestResult::E_INTERSECTING;
+    }
+
+#if defined(RETINA_BVH_AVX2_KERNEL)
+    RETINA_NODISCARD RETINA_BVH_AVX2_KERNEL auto TestFrustumAabbAvx2(const SBvhFrustumPlanes& planes, const SAabb& aabb) noexcept -> EBvhTestResult {
+      const auto zero = _mm256_setzero_ps();
+      const auto planeX = _mm256_load_ps(planes.X.data());
+      const auto planeY = _mm256_load_ps(planes.Y.data());
+      const auto planeZ = _mm256_load_ps(planes.Z.data());
+      const auto planeW = _mm256_load_ps(planes.W.data());
+      const auto signX = _mm256_cmp_ps(planeX, zero, _CMP_GE_OQ);
+      const auto signY = _mm256_cmp_ps(planeY, zero, _CMP_GE_OQ);
+      const auto signZ = _mm256_cmp_ps(planeZ, zero, _CMP_GE_OQ);
+      const auto minX = _mm256_set1_ps(aabb.Min.x);
+      const auto minY = _mm256_set1_ps(aabb.Min.y);
+      const auto minZ = _mm256_set1_ps(aabb.Min.z);
+      const auto maxX = _mm256_set1_ps(aabb.Max.x);
+      const auto maxY = _mm256_set1_ps(aabb.Max.y);
+      const auto maxZ = _mm256_set1_ps(aabb.Max.z);
+
+      // The positive corner lies furthest along the plane normal, the negative corner opposite of it
+      const auto positive = _mm256_add_ps(
+        _mm256_add_ps(
+          _mm256_mul_ps(planeX, _mm256_blendv_ps(minX, maxX, signX)),
+          _mm256_mul_ps(planeY, _mm256_blendv_ps(minY, maxY, signY))
+        ),
+        _mm256_add_ps(
+          _mm256_mul_ps(planeZ, _mm256_blendv_ps(minZ, maxZ, signZ)),
+          planeW
+        )
+      );
+      if (_mm256_movemask_ps(_mm256_cmp_ps(positive, zero, _CMP_LT_OQ)) != 0) {
+        return EBvhTestResult::E_OUTSIDE;
+      }
+      const auto negative = _mm256_add_ps(
+        _mm256_add_ps(
+          _mm256_mul_ps(planeX, _mm256_blendv_ps(maxX, minX, signX)),
+          _mm256_mul_ps(planeY, _mm256_blendv_ps(maxY, minY, signY))
+        ),
+        _mm256_add_ps(
+          _mm256_mul_ps(planeZ, _mm256_blendv_ps(maxZ, minZ, signZ)),
+          planeW
+        )
+      );
+      if (_mm256_movemask_ps(_mm256_cmp_ps(negative, zero, _CMP_LT_OQ)) != 0) {
+        return EBvhTestResult::E_INTERSECTING;
+      }
+      return EBvhTestResult::E_INSIDE;
+    }
+
+    // Tests two boxes at once, each 128-bit half of the registers holds one of them
+    RETINA_NODISCARD RETINA_BVH_AVX2_KERNEL auto TestSphereAabbPairAvx2(
+      const SSphere& sphere,
+      const SAabb& first,
+      const SAabb& second
+    ) noexcept -> std::pair<EBvhTestResult, EBvhTestResult> {
+      const auto radiusSquared = sphere.Radius * sphere.Radius;
+      const auto& center = sphere.Center;
+      const auto zero = _mm256_setzero_ps();
+      const auto centers = _mm256_setr_ps(center.x, center.y, center.z, 0.0f, center.x, center.y, center.z, 0.0f);
+      const auto mins = _mm256_setr_ps(first.Min.x, first.Min.y, first.Min.z, 0.0f, second.Min.x, second.Min.y, second.Min.z, 0.0f);
+      const auto maxs = _mm256_setr_ps(first.Max.x, first.Max.y, first.Max.z, 0.0f, second.Max.x, second.Max.y, second.Max.z, 0.0f);
+
+      const auto closest = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(mins, centers), _mm256_sub_ps(centers, maxs)), zero);
+      const auto furthest = _mm256_max_ps(_mm256_sub_ps(centers, mins), _mm256_sub_ps(maxs, centers));
+      // Lanes 0 and 4 hold the squared closest distances, lanes 1 and 5 the squared furthest distances
+      auto distances = _mm256_hadd_ps(_mm256_mul_ps(closest, closest), _mm256_mul_ps(furthest, furthest));
+      distances = _mm256_hadd_ps(distances, distances);
+      const auto mask = _mm256_movemask_ps(_mm256_cmp_ps(distances, _mm256_set1_ps(radiusSquared), _CMP_LE_OQ));
+      return {
+        MakeSphereAabbResult(mask & 0b000001, mask & 0b000010),
+        MakeSphereAabbResult(mask & 0b010000, mask & 0b100000),
+      };
+    }
+#endif
+
+    RETINA_NODISCARD RETINA_INLINE auto TestFrustumAabb(const SBvhFrustumPlanes& planes, const SAabb& aabb) noexcept -> EBvhTestResult {
+#if defined(RETINA_BVH_AVX2_KERNEL)
+      if (IsAvx2Supported()) {
+        return TestFrustumAabbAvx2(planes, aabb);
+      }
+#endif
+      auto result = EBvhTestResult::E_INSIDE;
+      for (auto i = 0_u32; i < planes.X.size(); ++i) {
+        const auto normal = glm::vec3(planes.X[i], planes.Y[i], planes.Z[i]);
+        const auto positive = glm::mix(aabb.Min, aabb.Max, glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+        const auto negative = glm::mix(aabb.Max, aabb.Min, glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+        if (glm::dot(normal, positive) + planes.W[i] < 0.0f) {
+          return EBvhTestResult::E_OUTSIDE;
+        }
+        if (glm::dot(normal, negative) + planes.W[i] < 0.0f) {
+          result = EBvhTestResult::E_INTERSECTING;
+        }
+      }
+      return result;
+    }
+
+    RETINA_NODISCARD RETINA_INLINE auto TestSphereAabbPair(
+      const SSphere& sphere,
+      const SAabb& first,
+      const SAabb& second
+    ) noexcept -> std::pair<EBvhTestResult, EBvhTestResult> {
+#if defined(RETINA_BVH_AVX2_KERNEL)
+      if (IsAvx2Supported()) {
+        return TestSphereAabbPairAvx2(sphere, first, second);
+      }
+#endif
+      const auto radiusSquared = sphere.Radius * sphere.Radius;
+      const auto test = [&](const SAabb& aabb) noexcept -> EBvhTestResult {
+        const auto closest = glm::max(glm::max(aabb.Min - sphere.Center, sphere.Center - aabb.Max), glm::vec3(0.0f));
+        const auto furthest = glm::max(sphere.Center - aabb.Min, aabb.Max - sphere.Center);
+        return MakeSphereAabbResult(glm::dot(closest, closest) <= radiusSquared, glm::dot(furthest, furthest) <= radiusSquared);
+      };
+      return { test(first), test(second) };
+    }
+
+    RETINA_INLINE auto AppendRange(std::vector<SBvhRange>& ranges, uint32 offset, uint32 count) noexcept -> void {
+      if (!ranges.empty() && ranges.back().Offset + ranges.back().Count == offset) {
+        ranges.back().Count += count;
+      } else {
+        ranges.push_back({ offset, count });
+      }
+    }
+
+    // Partitions "items" around the best binned SAH split, returns the size of the left half or zero for a leaf
+    RETINA_NODISCARD RETINA_INLINE auto PartitionItems(
+      std::span<uint32> items,
+      std::span<const SAabb> bounds,
+      SAabb& nodeBounds
+    ) noexcept -> uint32 {
+      RETINA_PROFILE_SCOPED();
+      const auto itemCount = static_cast<uint32>(items.size());
+      const auto rangeBounds = std::transform_reduce(
+        std::execution::par,
+        items.begin(),
+        items.end(),
+        SBvhRangeBounds(),
+        [](const SBvhRangeBounds& left, const SBvhRangeBounds& right) noexcept -> SBvhRangeBounds {
+          return {
+            MakeAabbUnion(left.Bounds, right.Bounds),
+            MakeAabbUnion(left.CentroidBounds, right.CentroidBounds),
+          };
+        },
+        [&](uint32 item) noexcept -> SBvhRangeBounds {
+          const auto center = GetAabbCenter(bounds[item]);
+          return { bounds[item], { center, center } };
+        }
+      );
+      nodeBounds = rangeBounds.Bounds;
+      if (itemCount <= 1) {
+        return 0;
+      }
+
+      const auto& centroidBounds = rangeBounds.CentroidBounds;
+      const auto extent = centroidBounds.Max - centroidBounds.Min;
+      auto axis = 0_u32;
+      if (extent.y > extent[axis]) {
+        axis = 1;
+      }
+      if (extent.z > extent[axis]) {
+        axis = 2;
+      }
+      // Every centroid is in the same spot, no split plane can separate them
+      if (extent[axis] <= 0.0f) {
+        return itemCount <= bvhMaxLeafSize ? 0 : itemCount / 2;
+      }
+
+      const auto binScale = static_cast<float32>(bvhBinCount) / extent[axis];
+      const auto getBin = [&](uint32 item) noexcept -> uint32 {
+        const auto center = GetAabbCenter(bounds[item])[axis];
+        return std::min(static_cast<uint32>((center - centroidBounds.Min[axis]) * binScale), bvhBinCount - 1);
+      };
+
+      // Nodes near the root cover most of the items, bin them in parallel chunks
+      const auto chunkCount = (itemCount + bvhBinChunkSize - 1) / bvhBinChunkSize;
+      auto chunkBins = std::vector<CBvhBinSet>(chunkCount);
+      auto chunks = std::vector<uint32>(chunkCount);
+      std::iota(chunks.begin(), chunks.end(), 0);
+      std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](uint32 chunk) noexcept {
+        const auto begin = chunk * bvhBinChunkSize;
+        const auto end = std::min(begin + bvhBinChunkSize, itemCount);
+        auto& bins = chunkBins[chunk];
+        for (auto i = begin; i < end; ++i) {
+          auto& bin = bins[getBin(items[i])];
+          bin.Bounds = MakeAabbUnion(bin.Bounds, bounds[items[i]]);
+          bin.Count++;
+        }
+      });
+      auto bins = CBvhBinSet();
+      for (const auto& currentBins : chunkBins) {
+        for (auto i = 0_u32; i < bvhBinCount; ++i) {
+          bins[i].Bounds = MakeAabbUnion(bins[i].Bounds, currentBins[i].Bounds);
+          bins[i].Count += currentBins[i].Count;
+        }
+      }
+
+      // Sweeps from both sides, split "i" puts bins [0, i] to the left
+      auto rightAreas = std::array<float32, bvhBinCount>();
+      auto rightCounts = std::array<uint32, bvhBinCount>();
+      {
+        auto rightBounds = SAabb();
+        auto rightCount = 0_u32;
+        for (auto i = bvhBinCount - 1; i > 0; --i) {
+          rightBounds = MakeAabbUnion(rightBounds, bins[i].Bounds);
+          rightCount += bins[i].Count;
+          rightAreas[i - 1] = GetAabbSurfaceArea(rightBounds);
+          rightCounts[i - 1] = rightCount;
+        }
+      }
+      const auto parentArea = std::max(GetAabbSurfaceArea(nodeBounds), std::numeric_limits<float32>::min());
+      auto bestSplit = -1_u32;
+      auto bestCost = std::numeric_limits<float32>::max();
+      {
+        auto leftBounds = SAabb();
+        auto leftCount = 0_u32;
+        for (auto i = 0_u32; i < bvhBinCount - 1; ++i) {
+          leftBounds = MakeAabbUnion(leftBounds, bins[i].Bounds);
+          leftCount += bins[i].Count;
+          if (leftCount == 0 || rightCounts[i] == 0) {
+            continue;
+          }
+          const auto cost =
+            bvhTraversalCost +
+            (GetAabbSurfaceArea(leftBounds) * leftCount + rightAreas[i] * rightCounts[i]) / parentArea;
+          if (cost < bestCost) {
+            bestCost = cost;
+            bestSplit = i;
+          }
+        }
+      }
+      if (itemCount <= bvhMaxLeafSize && bestCost >= static_cast<float32>(itemCount)) {
+        return 0;
+      }
+
+      const auto middle = std::partition(std::execution::par, items.begin(), items.end(), [&](uint32 item) noexcept {
+        return getBin(item) <= bestSplit;
+      });
+      return static_cast<uint32>(std::distance(items.begin(), middle));
+    }
+  }
+
+  auto CSceneBvh::Make(std::span<const uint32> items, std::span<const SAabb> bounds) noexcept -> CSceneBvh {
+    RETINA_PROFILE_SCOPED();
+    auto self = CSceneBvh();
+    self._items.assign(items.begin(), items.end());
+    self._itemSlots.assign(bounds.size(), -1_u32);
+    if (items.empty()) {
+      return self;
+    }
+
+    // Built breadth first, every node of a level partitions its own item range so a level is processed in parallel
+    self._nodes.push_back({
+      .FirstItem = 0,
+      .ItemCount = static_cast<uint32>(items.size()),
+    });
+    auto level = std::vector<uint32>({ 0 });
+    auto nextLevel = std::vector<uint32>();
+    while (!level.empty()) {
+      nextLevel.clear();
+      self.BuildLevel(level, bounds, nextLevel);
+      std::swap(level, nextLevel);
+    }
+
+    self._itemBounds.resize(items.size());
+    self._itemLeaves.resize(items.size());
+    for (auto slot = 0_u32; slot < self._items.size(); ++slot) {
+      self._itemBounds[slot] = bounds[self._items[slot]];
+      self._itemSlots[self._items[slot]] = slot;
+    }
+    for (auto node = 0_u32; node < self._nodes.size(); ++node) {
+      const auto& current = self._nodes[node];
+      if (current.Child != -1_u32) {
+        continue;
+      }
+      for (auto slot = current.FirstItem; slot < current.FirstItem + current.ItemCount; ++slot) {
+        self._itemLeaves[slot] = node;
+      }
+    }
+    self._isRefitQueued.assign(self._nodes.size(), false);
+    return self;
+  }
+
+  auto CSceneBvh::GetNodes() const noexcept -> std::span<const SBvhNode> {
+    RETINA_PROFILE_SCOPED();
+    return _nodes;
+  }
+
+  auto CSceneBvh::GetItems() const noexcept -> std::span<const uint32> {
+    RETINA_PROFILE_SCOPED();
+    return _items;
+  }
+
+  auto CSceneBvh::Refit(std::span<const SAabb> bounds, std::span<const uint32> dirtyItems) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    for (const auto item : dirtyItems) {
+      if (item >= _itemSlots.size() || _itemSlots[item] == -1_u32) {
+        continue;
+      }
+      const auto slot = _itemSlots[item];
+      _itemBounds[slot] = bounds[item];
+      auto node = _itemLeaves[slot];
+      while (node != -1_u32 && !_isRefitQueued[node]) {
+        _isRefitQueued[node] = true;
+        _refitNodes.emplace_back(node);
+        node = _nodes[node].Parent;
+      }
+    }
+
+    // Children are always stored after their parent, so descending order refits bottom up
+    std::sort(_refitNodes.begin(), _refitNodes.end(), std::greater());
+    for (const auto node : _refitNodes) {
+      auto& current = _nodes[node];
+      if (current.Child == -1_u32) {
+        current.Bounds = {};
+        for (auto slot = current.FirstItem; slot < current.FirstItem + current.ItemCount; ++slot) {
+          current.Bounds = MakeAabbUnion(current.Bounds, _itemBounds[slot]);
+        }
+      } else {
+        current.Bounds = MakeAabbUnion(_nodes[current.Child].Bounds, _nodes[current.Child + 1].Bounds);
+      }
+      _isRefitQueued[node] = false;
+    }
+    _refitNodes.clear();
+  }
+
+  auto CSceneBvh::QueryFrustum(const SFrustum& frustum, std::vector<SBvhRange>& ranges) const noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (_nodes.empty()) {
+      return;
+    }
+    const auto planes = Details::MakeBvhFrustumPlanes(frustum);
+    auto stack = std::vector<uint32>({ 0 });
+    while (!stack.empty()) {
+      const auto& node = _nodes[stack.back()];
+      stack.pop_back();
+      switch (Details::TestFrustumAabb(planes, node.Bounds)) {
+        case Details::EBvhTestResult::E_OUTSIDE:
+          break;
+
+        case Details::EBvhTestResult::E_INSIDE:
+          Details::AppendRange(ranges, node.FirstItem, node.ItemCount);
+          break;
+
+        case Details::EBvhTestResult::E_INTERSECTING:
+          if (node.Child == -1_u32) {
+            for (auto slot = node.FirstItem; slot < node.FirstItem + node.ItemCount; ++slot) {
+              if (Details::TestFrustumAabb(planes, _itemBounds[slot]) != Details::EBvhTestResult::E_OUTSIDE) {
+                Details::AppendRange(ranges, slot, 1);
+              }
+            }
+          } else {
+            stack.emplace_back(node.Child + 1);
+            stack.emplace_back(node.Child);
+          }
+          break;
+      }
+    }
+  }
+
+  auto CSceneBvh::QuerySphere(const SSphere& sphere, std::vector<SBvhRange>& ranges) const noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (_nodes.empty()) {
+      return;
+    }
+    // The stack only holds interior nodes that were already found to intersect, their children are tested as a pair
+    auto stack = std::vector<uint32>();
+    const auto visit = [&](uint32 node, Details::EBvhTestResult result) noexcept {
+      const auto& current = _nodes[node];
+      if (result == Details::EBvhTestResult::E_OUTSIDE) {
+        return;
+      }
+      if (result == Details::EBvhTestResult::E_INSIDE) {
+        Details::AppendRange(ranges, current.FirstItem, current.ItemCount);
+        return;
+      }
+      if (current.Child != -1_u32) {
+        stack.emplace_back(node);
+        return;
+      }
+      const auto end = current.FirstItem + current.ItemCount;
+      for (auto slot = current.FirstItem; slot < end; slot += 2) {
+        const auto next = std::min(slot + 1, end - 1);
+        const auto [first, second] = Details::TestSphereAabbPair(sphere, _itemBounds[slot], _itemBounds[next]);
+        if (first != Details::EBvhTestResult::E_OUTSIDE) {
+          Details::AppendRange(ranges, slot, 1);
+        }
+        if (next != slot && second != Details::EBvhTestResult::E_OUTSIDE) {
+          Details::AppendRange(ranges, next, 1);
+        }
+      }
+    };
+
+    visit(0, Details::TestSphereAabbPair(sphere, _nodes[0].Bounds, _nodes[0].Bounds).first);
+    while (!stack.empty()) {
+      const auto child = _nodes[stack.back()].Child;
+      stack.pop_back();
+      const auto [left, right] = Details::TestSphereAabbPair(sphere, _nodes[child].Bounds, _nodes[child + 1].Bounds);
+      visit(child + 1, right);
+      visit(child, left);
+    }
+  }
+
+  auto CSceneBvh::BuildLevel(
+    std::span<const uint32> level,
+    std::span<const SAabb> bounds,
+    std::vector<uint32>& nextLevel
+  ) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    auto splits = std::vector<uint32>(level.size());
+    auto positions = std::vector<uint32>(level.size());
+    std::iota(positions.begin(), positions.end(), 0);
+    std::for_each(std::execution::par, positions.begin(), positions.end(), [&](uint32 position) noexcept {
+      auto& node = _nodes[level[position]];
+      const auto items = std::span(_items).subspan(node.FirstItem, node.ItemCount);
+      splits[position] = Details::PartitionItems(items, bounds, node.Bounds);
+    });
+
+    for (auto position = 0_u32; position < level.size(); ++position) {
+      const auto node = level[position];
+      const auto split = splits[position];
+      if (split == 0) {
+        continue;
+      }
+      const auto child = static_cast<uint32>(_nodes.size());
+      const auto firstItem = _nodes[node].FirstItem;
+      const auto itemCount = _nodes[node].ItemCount;
+      _nodes[node].Child = child;
+      _nodes.push_back({
+        .FirstItem = firstItem,
+        .ItemCount = split,
+        .Parent = node,
+      });
+      _nodes.push_back({
+        .FirstItem = firstItem + split,
+        .ItemCount = itemCount - split,
+        .Parent = node,
+      });
+      nextLevel.emplace_back(child);
+      nextLevel.emplace_back(child + 1);
+    }
+  }
+}
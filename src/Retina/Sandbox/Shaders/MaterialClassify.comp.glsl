@@ -0,0 +1,93 @@
+#include <Retina/Retina.glsl>
+#include <Meshlet.glsl>
+
+// Tile size and shader count are specialized by the application, see "SandboxApplication.hpp"
+layout (constant_id = 0) const uint MATERIAL_SHADER_COUNT = 1;
+
+RetinaDeclarePushConstant() {
+  uint u_VisbufferMainId;
+  uint u_MeshletInstanceBufferId;
+  uint u_MaterialBufferId;
+  uint u_AlbedoImageId;
+  uint u_NormalImageId;
+  uint u_ShaderMaterialIdImageId;
+  uint u_TileDispatchBufferId;
+  uint u_TileBufferId;
+  uint u_TileCapacity;
+};
+
+RetinaDeclareQualifiedBuffer(restrict readonly, SMeshletInstanceBuffer) {
+  SMeshletInstance[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict readonly, SMaterialBuffer) {
+  SMaterial[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict, STileDispatchBuffer) {
+  SDispatchIndirectCommand[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict writeonly, STileBuffer) {
+  uint[] Data;
+};
+
+RetinaDeclareBufferPointer(SMeshletInstanceBuffer, g_MeshletInstanceBuffer, u_MeshletInstanceBufferId);
+RetinaDeclareBufferPointer(SMaterialBuffer, g_MaterialBuffer, u_MaterialBufferId);
+RetinaDeclareBufferPointer(STileDispatchBuffer, g_TileDispatchBuffer, u_TileDispatchBufferId);
+RetinaDeclareBufferPointer(STileBuffer, g_TileBuffer, u_TileBufferId);
+
+RetinaDeclareStorageImage(writeonly image2D, Image2D);
+RetinaDeclareStorageImage(writeonly uimage2D, UImage2D);
+
+#define g_VisbufferMain RetinaGetSampledImage(Texture2DU, u_VisbufferMainId)
+#define g_AlbedoImage RetinaGetStorageImage(Image2D, u_AlbedoImageId)
+#define g_NormalImage RetinaGetStorageImage(Image2D, u_NormalImageId)
+#define g_ShaderMaterialIdImage RetinaGetStorageImage(UImage2D, u_ShaderMaterialIdImageId)
+
+shared uint sh_TileShaderMask;
+
+uint GetMaterialShaderId(in SMaterial material) {
+  uint shaderId = 0;
+  if (RetinaIsHandleValid(material.BaseColorTexture)) {
+    shaderId |= MATERIAL_SHADER_BASE_COLOR_BIT;
+  }
+  if (RetinaIsHandleValid(material.NormalTexture)) {
+    shaderId |= MATERIAL_SHADER_NORMAL_BIT;
+  }
+  return shaderId;
+}
+
+layout (local_size_x_id = 1, local_size_y_id = 2) in;
+void main() {
+  if (gl_LocalInvocationIndex == 0) {
+    sh_TileShaderMask = 0;
+  }
+  barrier();
+
+  const ivec2 position = ivec2(gl_GlobalInvocationID.xy);
+  const ivec2 size = textureSize(g_VisbufferMain, 0);
+  if (all(lessThan(position, size))) {
+    const uint payload = texelFetch(g_VisbufferMain, position, 0).r;
+    uint materialIndex = -1;
+    if (payload != -1u) {
+      const uint meshletInstanceIndex = payload >> MESHLET_VISBUFFER_PRIMITIVE_ID_BITS;
+      materialIndex = g_MeshletInstanceBuffer.Data[meshletInstanceIndex].MaterialIndex;
+    }
+
+    if (RetinaIsHandleValid(materialIndex)) {
+      const uint shaderId = GetMaterialShaderId(g_MaterialBuffer.Data[materialIndex]);
+      imageStore(g_ShaderMaterialIdImage, position, uvec4(shaderId << 16 | materialIndex));
+      atomicOr(sh_TileShaderMask, 1u << shaderId);
+    } else {
+      // Nothing to shade, resolve the pixel right away so no shading tile needs to touch it
+      imageStore(g_AlbedoImage, position, vec4(0.0, 0.0, 0.0, 1.0));
+      imageStore(g_NormalImage, position, vec4(0.0));
+      imageStore(g_ShaderMaterialIdImage, position, uvec4(-1));
+    }
+  }
+  barrier();
+
+  const uint shaderId = gl_LocalInvocationIndex;
+  if (shaderId < MATERIAL_SHADER_COUNT && (sh_TileShaderMask & (1u << shaderId)) != 0) {
+    const uint tileIndex = atomicAdd(g_TileDispatchBuffer.Data[shaderId].X, 1);
+    g_TileBuffer.Data[shaderId * u_TileCapacity + tileIndex] = gl_WorkGroupID.x << 16 | gl_WorkGroupID.y;
+  }
+}
@@ -2,13 +2,9 @@
 #include <Retina/Utility.glsl>
 #include <Meshlet.glsl>
 
-#define M_GOLDEN_CONJUGATE 0.618033988749895
-
-layout (location = 0) in vec2 i_Uv;
-
-layout (location = 0) precise out vec4 o_Albedo;
-layout (location = 1) precise out vec2 o_Normal;
-layout (location = 2) precise out uint o_ShaderMaterialId;
+// One pipeline per material shader, the branches below are resolved when the pipeline is created
+layout (constant_id = 0) const uint SHADER_ID = 0;
+// Constant ids 1 and 2 specialize the workgroup size to the material tile size
 
 RetinaDeclarePushConstant() {
   uint u_VisbufferMainId;
@@ -22,6 +18,11 @@ RetinaDeclarePushConstant() {
   uint u_MaterialBufferId;
   uint u_LinearSamplerId;
   uint u_ViewBufferId;
+  uint u_AlbedoImageId;
+  uint u_NormalImageId;
+  uint u_ShaderMaterialIdImageId;
+  uint u_TileBufferId;
+  uint u_TileCapacity;
 };
 
 RetinaDeclareQualifiedBuffer(restrict readonly, SMeshletBuffer) {
@@ -31,7 +32,7 @@ RetinaDeclareQualifiedBuffer(restrict readonly, SMeshletInstanceBuffer) {
   SMeshletInstance[] Data;
 };
 RetinaDeclareQualifiedBuffer(restrict readonly, STransformBuffer) {
-  mat4[] Data;
+  STransform[] Data;
 };
 RetinaDeclareQualifiedBuffer(restrict readonly, SVertexBuffer) {
   SMeshletVertex[] Data;
@@ -51,6 +52,9 @@ RetinaDeclareQualifiedBuffer(restrict readonly, SMaterialBuffer) {
 RetinaDeclareQualifiedBuffer(restrict readonly, SViewInfoBuffer) {
   SViewInfo[] Data;
 };
+RetinaDeclareQualifiedBuffer(restrict readonly, STileBuffer) {
+  uint[] Data;
+};
 
 RetinaDeclareBufferPointer(SMeshletBuffer, g_MeshletBuffer, u_MeshletBufferId);
 RetinaDeclareBufferPointer(SMeshletInstanceBuffer, g_MeshletInstanceBuffer, u_MeshletInstanceBufferId);
@@ -61,8 +65,15 @@ RetinaDeclareBufferPointer(SIndexBuffer, g_IndexBuffer, u_IndexBufferId);
 RetinaDeclareBufferPointer(SPrimitiveBuffer, g_PrimitiveBuffer, u_PrimitiveBufferId);
 RetinaDeclareBufferPointer(SMaterialBuffer, g_MaterialBuffer, u_MaterialBufferId);
 RetinaDeclareBufferPointer(SViewInfoBuffer, g_ViewInfoBuffer, u_ViewBufferId);
+RetinaDeclareBufferPointer(STileBuffer, g_TileBuffer, u_TileBufferId);
+
+RetinaDeclareStorageImage(writeonly image2D, Image2D);
+RetinaDeclareStorageImage(readonly uimage2D, UImage2D);
 
 #define g_VisbufferMain RetinaGetSampledImage(Texture2DU, u_VisbufferMainId)
+#define g_AlbedoImage RetinaGetStorageImage(Image2D, u_AlbedoImageId)
+#define g_NormalImage RetinaGetStorageImage(Image2D, u_NormalImageId)
+#define g_ShaderMaterialIdImage RetinaGetStorageImage(UImage2D, u_ShaderMaterialIdImageId)
 
 #define g_LinearSampler RetinaGetSampler(u_LinearSamplerId)
 
@@ -85,7 +96,7 @@ struct SGradientVec3 {
 };
 
 SPartialDerivatives CalculatePartialDerivatives(in vec4 clip0, in vec4 clip1, in vec4 clip2, in vec2 p) {
-  const vec2 screenSize = vec2(textureSize(g_VisbufferMain, 0));
+  const vec2 screenSize = vec2(imageSize(g_AlbedoImage));
   const vec3 invW = 1.0 / vec3(clip0.w, clip1.w, clip2.w);
   const vec2 ndc0 = clip0.xy * invW.x;
   const vec2 ndc1 = clip1.xy * invW.y;
@@ -208,22 +219,28 @@ vec2 EncodeNormalOctahedral(in vec3 normal) {
   return normal.xy * 0.5 + 0.5;
 }
 
+layout (local_size_x_id = 1, local_size_y_id = 2) in;
 void main() {
-  const uint payload = texelFetch(g_VisbufferMain, ivec2(gl_FragCoord.xy), 0).r;
-  const uint shaderId = 0; // TODO: implement
-  if (payload == -1u) {
-    o_Albedo = vec4(0.0, 0.0, 0.0, 1.0);
-    o_Normal = vec2(0.0);
-    o_ShaderMaterialId = -1;
+  const uint tile = g_TileBuffer.Data[SHADER_ID * u_TileCapacity + gl_WorkGroupID.x];
+  const ivec2 position = ivec2(uvec2(tile >> 16, tile & 0xffffu) * gl_WorkGroupSize.xy + gl_LocalInvocationID.xy);
+  const ivec2 size = imageSize(g_AlbedoImage);
+  if (any(greaterThanEqual(position, size))) {
     return;
   }
+  // Tiles are shared between shaders, only shade the pixels this dispatch was binned for
+  const uint shaderMaterialId = imageLoad(g_ShaderMaterialIdImage, position).r;
+  if (shaderMaterialId == -1 || (shaderMaterialId >> 16) != SHADER_ID) {
+    return;
+  }
+  const uint materialIndex = shaderMaterialId & 0xffffu;
+  const uint payload = texelFetch(g_VisbufferMain, position, 0).r;
   const uint meshletInstanceIndex = payload >> MESHLET_VISBUFFER_PRIMITIVE_ID_BITS;
   const uint meshletPrimitiveId = payload & MESHLET_VISBUFFER_PRIMITIVE_ID_MASK;
   const SViewInfo mainView = g_ViewInfoBuffer.Data[0];
   const SMeshletInstance meshletInstance = g_MeshletInstanceBuffer.Data[meshletInstanceIndex];
   const SMeshlet meshlet = g_MeshletBuffer.Data[meshletInstance.MeshletIndex];
-  const mat4 transform = g_TransformBuffer.Data[meshletInstance.TransformIndex];
-  const mat4 pvm = mainView.JitterProj * mainView.View * transform;
+  const STransform transform = g_TransformBuffer.Data[meshletInstance.TransformIndex];
+  const mat4 pvm = mainView.JitterProj * mainView.View * transform.World;
   const uvec3 indices = uvec3(
     meshlet.VertexOffset + g_IndexBuffer.Data[meshlet.IndexOffset + uint(g_PrimitiveBuffer.Data[meshlet.PrimitiveOffset + meshletPrimitiveId * 3 + 0])],
     meshlet.VertexOffset + g_IndexBuffer.Data[meshlet.IndexOffset + uint(g_PrimitiveBuffer.Data[meshlet.PrimitiveOffset + meshletPrimitiveId * 3 + 1])],
@@ -232,51 +249,50 @@ void main() {
   const vec4 clipVertex0 = pvm * vec4(g_PositionBuffer.Data[indices.x], 1.0);
   const vec4 clipVertex1 = pvm * vec4(g_PositionBuffer.Data[indices.y], 1.0);
   const vec4 clipVertex2 = pvm * vec4(g_PositionBuffer.Data[indices.z], 1.0);
-  const SPartialDerivatives derivatives = CalculatePartialDerivatives(clipVertex0, clipVertex1, clipVertex2, i_Uv * 2.0 - 1.0);
+  const vec2 uvPosition = (vec2(position) + 0.5) / vec2(size);
+  const SPartialDerivatives derivatives = CalculatePartialDerivatives(clipVertex0, clipVertex1, clipVertex2, uvPosition * 2.0 - 1.0);
 
   const SMeshletVertex[3] vertexData = SMeshletVertex[](
     g_VertexBuffer.Data[indices.x],
     g_VertexBuffer.Data[indices.y],
     g_VertexBuffer.Data[indices.z]
   );
-  const SGradientVec2 uv = MakeGradient(derivatives, vec2[](
-    vertexData[0].Uv,
-    vertexData[1].Uv,
-    vertexData[2].Uv
-  ));
   const vec3 normal = Interpolate(derivatives, vec3[](
     vertexData[0].Normal,
     vertexData[1].Normal,
     vertexData[2].Normal
   ));
-  const vec4 tangent = Interpolate(derivatives, vec4[](
-    vertexData[0].Tangent,
-    vertexData[1].Tangent,
-    vertexData[2].Tangent
-  ));
-  const vec3 bitangent = cross(normal, tangent.xyz) * tangent.w;
 
-  const mat3 normalTransform = transpose(inverse(mat3(transform)));
-  vec3 albedo = vec3(0.0);
-  vec2 encodedNormal = vec2(0.0);
-  if (meshletInstance.MaterialIndex != uint(-1)) {
-    const SMaterial material = g_MaterialBuffer.Data[meshletInstance.MaterialIndex];
-    const vec3 baseColorFactor = material.BaseColorFactor;
-    const vec3 sampledBaseColor = SampleBaseColor(uv, material.BaseColorTexture);
-    const vec3 sampledBaseNormal = SampleNormal(uv, material.NormalTexture);
-    const mat3 TBN = mat3(
-      normalize(normalTransform * tangent.xyz),
-      normalize(normalTransform * bitangent),
-      normalize(normalTransform * normal)
-    );
-    const vec3 worldNormal = material.NormalTexture == uint(-1)
-      ? TBN[2]
-      : normalize(TBN * (sampledBaseNormal * 2.0 - 1.0));
-    albedo = baseColorFactor * sampledBaseColor;
-    encodedNormal = EncodeNormalOctahedral(worldNormal);
+  const mat3 normalTransform = transform.Normal;
+  const SMaterial material = g_MaterialBuffer.Data[materialIndex];
+  vec3 albedo = material.BaseColorFactor;
+  vec3 worldNormal = normalize(normalTransform * normal);
+  if ((SHADER_ID & (MATERIAL_SHADER_BASE_COLOR_BIT | MATERIAL_SHADER_NORMAL_BIT)) != 0) {
+    const SGradientVec2 uv = MakeGradient(derivatives, vec2[](
+      vertexData[0].Uv,
+      vertexData[1].Uv,
+      vertexData[2].Uv
+    ));
+    if ((SHADER_ID & MATERIAL_SHADER_BASE_COLOR_BIT) != 0) {
+      albedo *= SampleBaseColor(uv, material.BaseColorTexture);
+    }
+    if ((SHADER_ID & MATERIAL_SHADER_NORMAL_BIT) != 0) {
+      const vec4 tangent = Interpolate(derivatives, vec4[](
+        vertexData[0].Tangent,
+        vertexData[1].Tangent,
+        vertexData[2].Tangent
+      ));
+      const vec3 bitangent = cross(normal, tangent.xyz) * tangent.w;
+      const mat3 TBN = mat3(
+        normalize(normalTransform * tangent.xyz),
+        normalize(normalTransform * bitangent),
+        worldNormal
+      );
+      const vec3 sampledBaseNormal = SampleNormal(uv, material.NormalTexture);
+      worldNormal = normalize(TBN * (sampledBaseNormal * 2.0 - 1.0));
+    }
   }
 
-  o_Albedo = vec4(albedo, 1.0);
-  o_Normal = encodedNormal;
-  o_ShaderMaterialId = shaderId << 16 | meshletInstance.MaterialIndex;
+  imageStore(g_AlbedoImage, position, vec4(albedo, 1.0));
+  imageStore(g_NormalImage, position, vec4(EncodeNormalOctahedral(worldNormal), 0.0, 0.0));
 }
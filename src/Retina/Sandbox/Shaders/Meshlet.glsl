@@ -11,6 +11,9 @@
 
 #define SHADOW_CASCADE_COUNT 16
 
+#define MATERIAL_SHADER_BASE_COLOR_BIT 1
+#define MATERIAL_SHADER_NORMAL_BIT 2
+
 struct SMeshlet {
   uint VertexOffset;
   uint IndexOffset;
@@ -31,12 +34,32 @@ struct SMaterial {
   uint NormalTexture;
 };
 
+struct STransform {
+  mat4 World;
+  mat4 PrevWorld;
+  mat3 Normal;
+};
+
 struct SMeshletVertex {
   vec3 Normal;
   vec2 Uv;
   vec4 Tangent;
 };
 
+struct SDispatchIndirectCommand {
+  uint X;
+  uint Y;
+  uint Z;
+};
+
+struct SDrawIndexedIndirectCommand {
+  uint IndexCount;
+  uint InstanceCount;
+  uint FirstIndex;
+  int VertexOffset;
+  uint FirstInstance;
+};
+
 struct SViewInfo {
   mat4 Projection;
   mat4 PrevProjection;
@@ -0,0 +1,167 @@
+#include <Retina/Retina.glsl>
+#include <Meshlet.glsl>
+
+#define WORK_GROUP_SIZE 32
+#define MAX_INDICES_PER_THREAD ((MESHLET_INDEX_COUNT + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE)
+#define MAX_PRIMITIVES_PER_THREAD ((MESHLET_PRIMITIVE_COUNT + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE)
+
+#define CLIP_OUTSIDE_LEFT 1
+#define CLIP_OUTSIDE_RIGHT 2
+#define CLIP_OUTSIDE_BOTTOM 4
+#define CLIP_OUTSIDE_TOP 8
+#define CLIP_OUTSIDE_BEHIND 16
+#define CLIP_OUTSIDE_ALL 31
+
+RetinaDeclarePushConstant() {
+  uint u_MeshletBufferId;
+  uint u_MeshletInstanceBufferId;
+  uint u_TransformBufferId;
+  uint u_PositionBufferId;
+  uint u_IndexBufferId;
+  uint u_PrimitiveBufferId;
+  uint u_ViewBufferId;
+  uint u_DrawCommandBufferId;
+  uint u_DrawCountBufferId;
+  uint u_ExpandedIndexBufferId;
+  uint u_MeshletInstanceCount;
+};
+
+RetinaDeclareQualifiedBuffer(restrict readonly, SMeshletBuffer) {
+  SMeshlet[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict readonly, SMeshletInstanceBuffer) {
+  SMeshletInstance[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict readonly, STransformBuffer) {
+  STransform[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict readonly, SPositionBuffer) {
+  vec3[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict readonly, SIndexBuffer) {
+  uint[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict readonly, SPrimitiveBuffer) {
+  uint8_t[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict readonly, SViewInfoBuffer) {
+  SViewInfo[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict writeonly, SDrawCommandBuffer) {
+  SDrawIndexedIndirectCommand[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict, SDrawCountBuffer) {
+  uint DrawCount;
+  uint IndexCount;
+};
+RetinaDeclareQualifiedBuffer(restrict writeonly, SExpandedIndexBuffer) {
+  uint[] Data;
+};
+
+RetinaDeclareBufferPointer(SMeshletBuffer, g_MeshletBuffer, u_MeshletBufferId);
+RetinaDeclareBufferPointer(SMeshletInstanceBuffer, g_MeshletInstanceBuffer, u_MeshletInstanceBufferId);
+RetinaDeclareBufferPointer(STransformBuffer, g_TransformBuffer, u_TransformBufferId);
+RetinaDeclareBufferPointer(SPositionBuffer, g_PositionBuffer, u_PositionBufferId);
+RetinaDeclareBufferPointer(SIndexBuffer, g_IndexBuffer, u_IndexBufferId);
+RetinaDeclareBufferPointer(SPrimitiveBuffer, g_PrimitiveBuffer, u_PrimitiveBufferId);
+RetinaDeclareBufferPointer(SViewInfoBuffer, g_ViewInfoBuffer, u_ViewBufferId);
+RetinaDeclareBufferPointer(SDrawCommandBuffer, g_DrawCommandBuffer, u_DrawCommandBufferId);
+RetinaDeclareBufferPointer(SDrawCountBuffer, g_DrawCountBuffer, u_DrawCountBufferId);
+RetinaDeclareBufferPointer(SExpandedIndexBuffer, g_ExpandedIndexBuffer, u_ExpandedIndexBufferId);
+
+shared vec3 sh_ClipVertices[MESHLET_INDEX_COUNT];
+shared uint sh_ClipOutsideMask;
+shared uint sh_VisiblePrimitiveCount;
+shared uint sh_FirstIndex;
+
+uint GetClipOutsideMask(in vec4 clip) {
+  uint mask = 0;
+  mask |= clip.x < -clip.w ? CLIP_OUTSIDE_LEFT : 0;
+  mask |= clip.x > clip.w ? CLIP_OUTSIDE_RIGHT : 0;
+  mask |= clip.y < -clip.w ? CLIP_OUTSIDE_BOTTOM : 0;
+  mask |= clip.y > clip.w ? CLIP_OUTSIDE_TOP : 0;
+  mask |= clip.w <= 0.0 ? CLIP_OUTSIDE_BEHIND : 0;
+  return mask;
+}
+
+layout (local_size_x = WORK_GROUP_SIZE) in;
+void main() {
+  const uint meshletInstanceIndex = gl_WorkGroupID.x;
+  if (meshletInstanceIndex >= u_MeshletInstanceCount) {
+    return;
+  }
+  const SMeshletInstance meshletInstance = g_MeshletInstanceBuffer.Data[meshletInstanceIndex];
+  const SMeshlet meshlet = g_MeshletBuffer.Data[meshletInstance.MeshletIndex];
+  const SViewInfo mainView = g_ViewInfoBuffer.Data[0];
+  const STransform transform = g_TransformBuffer.Data[meshletInstance.TransformIndex];
+  const mat4 jitterPvm = mainView.JitterProj * mainView.View * transform.World;
+
+  if (gl_LocalInvocationID.x == 0) {
+    sh_ClipOutsideMask = CLIP_OUTSIDE_ALL;
+    sh_VisiblePrimitiveCount = 0;
+  }
+  barrier();
+
+  for (uint i = 0; i < MAX_INDICES_PER_THREAD; i++) {
+    const uint id = min(gl_LocalInvocationID.x + i * WORK_GROUP_SIZE, meshlet.IndexCount - 1);
+    const uint index = g_IndexBuffer.Data[meshlet.IndexOffset + id];
+    const vec3 position = g_PositionBuffer.Data[meshlet.VertexOffset + index];
+    const vec4 clipJitter = jitterPvm * vec4(position, 1.0);
+    sh_ClipVertices[id] = clipJitter.xyw;
+    atomicAnd(sh_ClipOutsideMask, GetClipOutsideMask(clipJitter));
+  }
+  barrier();
+
+  // The whole meshlet lies outside one of the frustum planes
+  if (sh_ClipOutsideMask != 0) {
+    return;
+  }
+
+  uvec3 primitiveIndices[MAX_PRIMITIVES_PER_THREAD];
+  for (uint i = 0; i < MAX_PRIMITIVES_PER_THREAD; i++) {
+    const uint id = gl_LocalInvocationID.x + i * WORK_GROUP_SIZE;
+    primitiveIndices[i] = uvec3(0);
+    if (id >= meshlet.PrimitiveCount) {
+      continue;
+    }
+    const uvec3 indices = uvec3(
+      uint(g_PrimitiveBuffer.Data[meshlet.PrimitiveOffset + id * 3 + 0]),
+      uint(g_PrimitiveBuffer.Data[meshlet.PrimitiveOffset + id * 3 + 1]),
+      uint(g_PrimitiveBuffer.Data[meshlet.PrimitiveOffset + id * 3 + 2])
+    );
+    const vec3 v0 = sh_ClipVertices[indices.x];
+    const vec3 v1 = sh_ClipVertices[indices.y];
+    const vec3 v2 = sh_ClipVertices[indices.z];
+    if (determinant(mat3(v0, v1, v2)) <= 0.0) {
+      primitiveIndices[i] = indices;
+      atomicAdd(sh_VisiblePrimitiveCount, 1);
+    }
+  }
+  barrier();
+
+  // Every primitive is back facing
+  if (sh_VisiblePrimitiveCount == 0) {
+    return;
+  }
+
+  // Primitives keep their meshlet-local slot so gl_PrimitiveID matches the mesh shading path,
+  // culled primitives are written as degenerate triangles
+  if (gl_LocalInvocationID.x == 0) {
+    const uint indexCount = meshlet.PrimitiveCount * 3;
+    const uint firstIndex = atomicAdd(g_DrawCountBuffer.IndexCount, indexCount);
+    const uint drawIndex = atomicAdd(g_DrawCountBuffer.DrawCount, 1);
+    g_DrawCommandBuffer.Data[drawIndex] = SDrawIndexedIndirectCommand(indexCount, 1, firstIndex, 0, meshletInstanceIndex);
+    sh_FirstIndex = firstIndex;
+  }
+  barrier();
+
+  for (uint i = 0; i < MAX_PRIMITIVES_PER_THREAD; i++) {
+    const uint id = gl_LocalInvocationID.x + i * WORK_GROUP_SIZE;
+    if (id >= meshlet.PrimitiveCount) {
+      continue;
+    }
+    g_ExpandedIndexBuffer.Data[sh_FirstIndex + id * 3 + 0] = primitiveIndices[i].x;
+    g_ExpandedIndexBuffer.Data[sh_FirstIndex + id * 3 + 1] = primitiveIndices[i].y;
+    g_ExpandedIndexBuffer.Data[sh_FirstIndex + id * 3 + 2] = primitiveIndices[i].z;
+  }
+}
@@ -6,10 +6,11 @@ layout (location = 0) in vec2 i_Uv;
 
 layout (location = 0) precise out vec4 o_Pixel;
 
+layout (constant_id = 0) const bool IS_PASSTHROUGH = false;
+
 RetinaDeclarePushConstant() {
   uint u_VisbufferResolveImageId;
   float u_WhitePoint;
-  uint u_IsPassthrough;
 };
 
 #define g_VisbufferResolveImage RetinaGetSampledImage(Texture2D, u_VisbufferResolveImageId)
@@ -27,7 +28,7 @@ vec3 ChangeLuminance(in vec3 color, in float outLum) {
 }
 
 vec3 ApplyExtendedReinhard(in vec3 color) {
-  if (bool(u_IsPassthrough)) {
+  if (IS_PASSTHROUGH) {
     return color;
   }
   const float oldLum = GetLuminance(color);
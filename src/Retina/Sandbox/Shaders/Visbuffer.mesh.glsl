@@ -30,7 +30,7 @@ RetinaDeclareQualifiedBuffer(restrict readonly, SMeshletInstanceBuffer) {
   SMeshletInstance[] Data;
 };
 RetinaDeclareQualifiedBuffer(restrict readonly, STransformBuffer) {
-  mat4[] Data;
+  STransform[] Data;
 };
 RetinaDeclareQualifiedBuffer(restrict readonly, SPositionBuffer) {
   vec3[] Data;
@@ -62,10 +62,10 @@ void main() {
   const SMeshletInstance meshletInstance = g_MeshletInstanceBuffer.Data[meshletInstanceIndex];
   const SMeshlet meshlet = g_MeshletBuffer.Data[meshletInstance.MeshletIndex];
   const SViewInfo mainView = g_ViewInfoBuffer.Data[0];
-  const mat4 transform = g_TransformBuffer.Data[meshletInstance.TransformIndex];
-  const mat4 jitterPvm = mainView.JitterProj * mainView.View * transform;
-  const mat4 pvm = mainView.ProjView * transform;
-  const mat4 prevPvm = mainView.PrevProjView * transform;
+  const STransform transform = g_TransformBuffer.Data[meshletInstance.TransformIndex];
+  const mat4 jitterPvm = mainView.JitterProj * mainView.View * transform.World;
+  const mat4 pvm = mainView.ProjView * transform.World;
+  const mat4 prevPvm = mainView.PrevProjView * transform.PrevWorld;
 
   SetMeshOutputsEXT(meshlet.IndexCount, meshlet.PrimitiveCount);
   for (uint i = 0; i < MAX_INDICES_PER_THREAD; i++) {
@@ -0,0 +1,63 @@
+#include <Retina/Retina.glsl>
+#include <Meshlet.glsl>
+
+layout (location = 0) out SVertexData {
+  flat uint MeshletInstanceIndex;
+  vec4 ClipPosition;
+  vec4 PrevClipPosition;
+} o_VertexData;
+
+RetinaDeclarePushConstant() {
+  uint u_MeshletBufferId;
+  uint u_MeshletInstanceBufferId;
+  uint u_TransformBufferId;
+  uint u_PositionBufferId;
+  uint u_IndexBufferId;
+  uint u_PrimitiveBufferId;
+  uint u_ViewBufferId;
+};
+
+RetinaDeclareQualifiedBuffer(restrict readonly, SMeshletBuffer) {
+  SMeshlet[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict readonly, SMeshletInstanceBuffer) {
+  SMeshletInstance[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict readonly, STransformBuffer) {
+  STransform[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict readonly, SPositionBuffer) {
+  vec3[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict readonly, SIndexBuffer) {
+  uint[] Data;
+};
+RetinaDeclareQualifiedBuffer(restrict readonly, SViewInfoBuffer) {
+  SViewInfo[] Data;
+};
+
+RetinaDeclareBufferPointer(SMeshletBuffer, g_MeshletBuffer, u_MeshletBufferId);
+RetinaDeclareBufferPointer(SMeshletInstanceBuffer, g_MeshletInstanceBuffer, u_MeshletInstanceBufferId);
+RetinaDeclareBufferPointer(STransformBuffer, g_TransformBuffer, u_TransformBufferId);
+RetinaDeclareBufferPointer(SPositionBuffer, g_PositionBuffer, u_PositionBufferId);
+RetinaDeclareBufferPointer(SIndexBuffer, g_IndexBuffer, u_IndexBufferId);
+RetinaDeclareBufferPointer(SViewInfoBuffer, g_ViewInfoBuffer, u_ViewBufferId);
+
+void main() {
+  // Each indirect draw covers one meshlet instance, the index buffer holds meshlet-local vertex slots
+  const uint meshletInstanceIndex = gl_InstanceIndex;
+  const SMeshletInstance meshletInstance = g_MeshletInstanceBuffer.Data[meshletInstanceIndex];
+  const SMeshlet meshlet = g_MeshletBuffer.Data[meshletInstance.MeshletIndex];
+  const SViewInfo mainView = g_ViewInfoBuffer.Data[0];
+  const STransform transform = g_TransformBuffer.Data[meshletInstance.TransformIndex];
+  const mat4 jitterPvm = mainView.JitterProj * mainView.View * transform.World;
+  const mat4 pvm = mainView.ProjView * transform.World;
+  const mat4 prevPvm = mainView.PrevProjView * transform.PrevWorld;
+
+  const uint index = g_IndexBuffer.Data[meshlet.IndexOffset + gl_VertexIndex];
+  const vec3 position = g_PositionBuffer.Data[meshlet.VertexOffset + index];
+  o_VertexData.MeshletInstanceIndex = meshletInstanceIndex;
+  o_VertexData.ClipPosition = pvm * vec4(position, 1.0);
+  o_VertexData.PrevClipPosition = prevPvm * vec4(position, 1.0);
+  gl_Position = jitterPvm * vec4(position, 1.0);
+}
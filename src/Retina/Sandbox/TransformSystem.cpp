@@ -0,0 +1,222 @@
+#include <Retina/Sandbox/TransformSystem.hpp>
+
+#include <algorithm>
+#include <execution>
+#include <iterator>
+
+namespace Retina::Sandbox {
+  auto CTransformSystem::GetCapacity() const noexcept -> usize {
+    RETINA_PROFILE_SCOPED();
+    return _nodeAllocator.GetCapacity();
+  }
+
+  auto CTransformSystem::GetNodeCount() const noexcept -> usize {
+    RETINA_PROFILE_SCOPED();
+    return _nodeAllocator.GetUsedSize();
+  }
+
+  auto CTransformSystem::GetParent(uint32 node) const noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    return _parents[node];
+  }
+
+  auto CTransformSystem::GetLocalTransform(uint32 node) const noexcept -> const glm::mat4& {
+    RETINA_PROFILE_SCOPED();
+    return _localTransforms[node];
+  }
+
+  auto CTransformSystem::GetWorldTransform(uint32 node) const noexcept -> const glm::mat4& {
+    RETINA_PROFILE_SCOPED();
+    return _worldTransforms[node];
+  }
+
+  auto CTransformSystem::GetPrevWorldTransform(uint32 node) const noexcept -> const glm::mat4& {
+    RETINA_PROFILE_SCOPED();
+    return _prevWorldTransforms[node];
+  }
+
+  auto CTransformSystem::GetDirtyRecords() const noexcept -> std::span<const uint32> {
+    RETINA_PROFILE_SCOPED();
+    return _dirtyRecords;
+  }
+
+  auto CTransformSystem::MakeRecord(uint32 node) const noexcept -> STransformRecord {
+    RETINA_PROFILE_SCOPED();
+    const auto& world = _worldTransforms[node];
+    return {
+      .World = world,
+      .PrevWorld = _prevWorldTransforms[node],
+      .Normal = glm::transpose(glm::inverse(glm::mat3(world))),
+    };
+  }
+
+  auto CTransformSystem::AddNodes(std::span<const SNode> nodes, uint32 parent) noexcept -> uint32 {
+    RETINA_PROFILE_SCOPED();
+    const auto count = static_cast<uint32>(nodes.size());
+    if (count == 0) {
+      return -1_u32;
+    }
+    auto firstNode = _nodeAllocator.Allocate(count);
+    if (!firstNode) {
+      Reserve(std::max(_nodeAllocator.GetCapacity() * 2, _nodeAllocator.GetCapacity() + count));
+      firstNode = _nodeAllocator.Allocate(count);
+    }
+    RETINA_ASSERT_WITH(firstNode, "Failed to allocate transform nodes");
+    for (auto i = 0_u32; i < count; ++i) {
+      const auto node = *firstNode + i;
+      const auto localParent = nodes[i].Parent;
+      _parents[node] = localParent == -1_u32 ? parent : *firstNode + localParent;
+      _localTransforms[node] = nodes[i].LocalTransform;
+      _isAlive[node] = true;
+      _isNew[node] = true;
+      _isDirty[node] = true;
+      _dirtyNodes.emplace_back(node);
+    }
+    _isTopologyDirty = true;
+    return *firstNode;
+  }
+
+  auto CTransformSystem::RemoveNodes(uint32 firstNode, uint32 count) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    for (auto node = firstNode; node < firstNode + count; ++node) {
+      _parents[node] = -1_u32;
+      _isAlive[node] = false;
+      _isDirty[node] = false;
+    }
+    _nodeAllocator.Free(firstNode, count);
+    _isTopologyDirty = true;
+  }
+
+  auto CTransformSystem::SetLocalTransform(uint32 node, const glm::mat4& transform) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    _localTransforms[node] = transform;
+    if (!_isDirty[node]) {
+      _isDirty[node] = true;
+      _dirtyNodes.emplace_back(node);
+    }
+  }
+
+  auto CTransformSystem::Update() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    if (_isTopologyDirty) {
+      RebuildChildren();
+    }
+
+    // Nodes that moved last frame still carry the transform from two frames ago, they have to be settled
+    // and uploaded once more even if they did not move again
+    _dirtyRecords.clear();
+    for (const auto node : _changedNodes) {
+      if (_isAlive[node]) {
+        _prevWorldTransforms[node] = _worldTransforms[node];
+        _dirtyRecords.emplace_back(node);
+      }
+    }
+    _changedNodes.clear();
+
+    // A slot removed and added again within a frame is listed twice, a subtree must not be walked twice
+    std::sort(_dirtyNodes.begin(), _dirtyNodes.end());
+    _dirtyNodes.erase(std::unique(_dirtyNodes.begin(), _dirtyNodes.end()), _dirtyNodes.end());
+
+    // Only dirty nodes without a dirty ancestor start a walk, the others are reached from their ancestor
+    _dirtySubtreeCount = 0;
+    for (const auto node : _dirtyNodes) {
+      if (!_isAlive[node] || !_isDirty[node]) {
+        continue;
+      }
+      auto isRoot = true;
+      for (auto parent = _parents[node]; parent != -1_u32; parent = _parents[parent]) {
+        if (_isDirty[parent]) {
+          isRoot = false;
+          break;
+        }
+      }
+      if (isRoot) {
+        if (_dirtySubtreeCount == _dirtySubtrees.size()) {
+          _dirtySubtrees.emplace_back();
+        }
+        _dirtySubtrees[_dirtySubtreeCount++].Root = node;
+      }
+    }
+    _dirtyNodes.clear();
+
+    const auto dirtySubtrees = std::span(_dirtySubtrees).first(_dirtySubtreeCount);
+    std::for_each(std::execution::par, dirtySubtrees.begin(), dirtySubtrees.end(), [this](SDirtySubtree& subtree) noexcept {
+      PropagateSubtree(subtree);
+    });
+    for (const auto& subtree : dirtySubtrees) {
+      _changedNodes.insert(_changedNodes.end(), subtree.ChangedNodes.begin(), subtree.ChangedNodes.end());
+    }
+    std::sort(_changedNodes.begin(), _changedNodes.end());
+
+    _mergedDirtyRecords.clear();
+    std::set_union(
+      _dirtyRecords.begin(),
+      _dirtyRecords.end(),
+      _changedNodes.begin(),
+      _changedNodes.end(),
+      std::back_inserter(_mergedDirtyRecords)
+    );
+    std::swap(_dirtyRecords, _mergedDirtyRecords);
+  }
+
+  auto CTransformSystem::Reserve(uint32 capacity) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    _nodeAllocator.Grow(capacity);
+    _parents.resize(capacity, -1_u32);
+    _localTransforms.resize(capacity, glm::mat4(1.0f));
+    _worldTransforms.resize(capacity, glm::mat4(1.0f));
+    _prevWorldTransforms.resize(capacity, glm::mat4(1.0f));
+    _isAlive.resize(capacity, false);
+    _isNew.resize(capacity, false);
+    _isDirty.resize(capacity, false);
+  }
+
+  auto CTransformSystem::RebuildChildren() noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    // Counting sort of the live nodes by parent
+    const auto capacity = static_cast<uint32>(_parents.size());
+    _childOffsets.assign(capacity + 1, 0);
+    for (auto node = 0_u32; node < capacity; ++node) {
+      if (_isAlive[node] && _parents[node] != -1_u32) {
+        _childOffsets[_parents[node] + 1]++;
+      }
+    }
+    for (auto node = 0_u32; node < capacity; ++node) {
+      _childOffsets[node + 1] += _childOffsets[node];
+    }
+    _children.resize(_childOffsets[capacity]);
+    auto cursors = std::vector<uint32>(_childOffsets.begin(), _childOffsets.end() - 1);
+    for (auto node = 0_u32; node < capacity; ++node) {
+      if (_isAlive[node] && _parents[node] != -1_u32) {
+        _children[cursors[_parents[node]]++] = node;
+      }
+    }
+    _isTopologyDirty = false;
+  }
+
+  auto CTransformSystem::PropagateSubtree(SDirtySubtree& subtree) noexcept -> void {
+    RETINA_PROFILE_SCOPED();
+    // The list doubles as the work queue, every node is reached after its parent was computed
+    auto& changedNodes = subtree.ChangedNodes;
+    changedNodes.clear();
+    changedNodes.emplace_back(subtree.Root);
+    for (auto i = 0_usize; i < changedNodes.size(); ++i) {
+      const auto node = changedNodes[i];
+      const auto parent = _parents[node];
+      if (parent == -1_u32) {
+        _worldTransforms[node] = _localTransforms[node];
+      } else {
+        _worldTransforms[node] = _worldTransforms[parent] * _localTransforms[node];
+      }
+      // Nodes start without any history, so the previous world transform is the current one
+      if (_isNew[node]) {
+        _prevWorldTransforms[node] = _worldTransforms[node];
+        _isNew[node] = false;
+      }
+      _isDirty[node] = false;
+      for (auto child = _childOffsets[node]; child < _childOffsets[node + 1]; ++child) {
+        changedNodes.emplace_back(_children[child]);
+      }
+    }
+  }
+}
@@ -0,0 +1,132 @@
+#include <Retina/Graphics/Pipeline.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <string_view>
+#include <utility>
+
+namespace {
+  using namespace Retina;
+
+  using CShaderCacheEntries = std::map<std::filesystem::path, std::filesystem::file_time_type>;
+
+  auto failureCount = 0_u32;
+
+  auto Check(bool condition, std::string_view message) noexcept -> void {
+    if (!condition) {
+      std::fprintf(stderr, "FAILED: %.*s\n", static_cast<int>(message.size()), message.data());
+      ++failureCount;
+    }
+  }
+
+  auto WriteFile(const std::filesystem::path& path, std::string_view contents) noexcept -> void {
+    auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size());
+  }
+
+  // Other tests or the application may share the cache directory, only entries that appear or change are looked at
+  auto GetShaderCacheEntries() noexcept -> CShaderCacheEntries {
+    auto entries = CShaderCacheEntries();
+    auto error = std::error_code();
+    for (const auto& entry : std::filesystem::directory_iterator(RETINA_SHADER_CACHE_DIRECTORY, error)) {
+      if (entry.path().extension() == ".spv") {
+        entries.emplace(entry.path(), entry.last_write_time());
+      }
+    }
+    return entries;
+  }
+
+  auto CountChangedEntries(const CShaderCacheEntries& before, const CShaderCacheEntries& after) noexcept -> uint32 {
+    auto count = 0_u32;
+    for (const auto& [path, time] : after) {
+      const auto it = before.find(path);
+      if (it == before.end() || it->second != time) {
+        ++count;
+      }
+    }
+    return count;
+  }
+}
+
+auto main() -> int {
+  using namespace Retina::Graphics;
+
+  // Shader paths are part of the cache key, a fresh directory never hits entries of an earlier run
+  const auto ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+  const auto directory = std::filesystem::temp_directory_path() / std::format("RetinaShaderCacheTest{}", ticks);
+  std::filesystem::create_directories(directory);
+  const auto shaderPath = directory / "Test.comp.glsl";
+  const auto includePath = directory / "Common.glsl";
+  const auto includeDirectories = std::array { directory };
+  WriteFile(includePath, "const uint VALUE = 1;\n");
+  WriteFile(shaderPath,
+    "#include \"Common.glsl\"\n"
+    "layout (local_size_x = 1) in;\n"
+    "layout (push_constant) uniform SPushConstants { uint Value; } u_push;\n"
+    "void main() { if (u_push.Value == VALUE) { barrier(); } }\n"
+  );
+  const auto compile = [&] noexcept {
+    return Details::CompileShaderFromSource(shaderPath, includeDirectories, EShaderStageFlag::E_COMPUTE);
+  };
+
+  // Miss, the shader is compiled and stored
+  auto entries = GetShaderCacheEntries();
+  const auto compiled = compile();
+  auto nextEntries = GetShaderCacheEntries();
+  Check(CountChangedEntries(entries, nextEntries) == 1, "First compilation stores one cache entry");
+  Check(!compiled.Spirv.empty() && compiled.PushConstantSize == sizeof(uint32), "First compilation reflects the shader");
+  entries = std::move(nextEntries);
+
+  // Hit, nothing is written and the binary matches the compiled one
+  const auto cached = compile();
+  nextEntries = GetShaderCacheEntries();
+  Check(CountChangedEntries(entries, nextEntries) == 0, "Unchanged shader is served from the cache");
+  Check(
+    cached.Spirv == compiled.Spirv &&
+    cached.Stage == compiled.Stage &&
+    cached.PushConstantSize == compiled.PushConstantSize &&
+    cached.OutputComponentCounts == compiled.OutputComponentCounts,
+    "Cached shader matches the compiled shader"
+  );
+
+  // Editing an include invalidates every shader including it
+  WriteFile(includePath, "const uint VALUE = 2;\n");
+  static_cast<void>(compile());
+  nextEntries = GetShaderCacheEntries();
+  Check(CountChangedEntries(entries, nextEntries) == 1, "Edited include invalidates the cache entry");
+  entries = std::move(nextEntries);
+
+  // Editing the shader itself does as well
+  WriteFile(shaderPath,
+    "#include \"Common.glsl\"\n"
+    "layout (local_size_x = 2) in;\n"
+    "layout (push_constant) uniform SPushConstants { uint Value; } u_push;\n"
+    "void main() { if (u_push.Value == VALUE) { barrier(); } }\n"
+  );
+  static_cast<void>(compile());
+  nextEntries = GetShaderCacheEntries();
+  Check(CountChangedEntries(entries, nextEntries) == 1, "Edited shader invalidates the cache entry");
+  entries = std::move(nextEntries);
+
+  // Sources are read once per batch, an edit during the batch is only seen by the next one
+  Details::BeginShaderSourceBatch();
+  static_cast<void>(compile());
+  WriteFile(includePath, "const uint VALUE = 3;\n");
+  static_cast<void>(compile());
+  nextEntries = GetShaderCacheEntries();
+  Check(CountChangedEntries(entries, nextEntries) == 0, "Sources read during a batch are reused within it");
+  Details::EndShaderSourceBatch();
+  static_cast<void>(compile());
+  nextEntries = GetShaderCacheEntries();
+  Check(CountChangedEntries(entries, nextEntries) == 1, "Ending the batch drops the cached sources");
+
+  auto error = std::error_code();
+  std::filesystem::remove_all(directory, error);
+  return failureCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}